@@ -39,6 +39,9 @@
 #include <langinfo.h>           //  Identify items of langinfo data
 #include <dirent.h>             //  Facilitate directory traversing
 #include <errno.h>              //  Defines the integer variable errno
+#include <unistd.h>             //  close()
+#include <sys/mman.h>           //  mmap(), munmap()
+#include <poll.h>               //  poll()
                                 //*******************************************
 
 /****************************************************************************
@@ -63,7 +66,6 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
-#define SYS_CMD_L               ( 4096 )
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -78,18 +80,6 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
-/**
- *  @param  bytes_read_last     Number of bytes read last count             */
-float                               bytes_read_last;
-/**
- *  @param  bytes_read_last     Total number of bytes read                  */
-float                               total_bytes_read;
-/**
- *  @param  time_now            Seconds since the Epoch                     */
-struct  timeval                     time_now;
-/**
- *  @param  time_last           Seconds since the Epoch                     */
-struct  timeval                     time_last;
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -446,24 +436,21 @@ file_read_text(
     /**
      *  @param  in_line_p       Pointer to the read data buffer             */
     char                        *   in_line_p;
-    /**
-     *  @param  tmp_data_1_p    Pointer to a temporary data buffer          */
-    char                        *   tmp_data_1_p;
-    /**
-     *  @param  tmp_data_2_p    Pointer to a temporary data buffer          */
-    char                        *   tmp_data_2_p;
     /**
      *  @param  eof_p           End-Of-File pointer (NULL == EOF)           */
     char                        *   eof_p;
+    /**
+     *  @param  line_buf        Text line with its continuation lines       */
+    struct  mem_strbuf_t            line_buf;
     /**
      *  @param  eol             End-Of-Line flag                            */
     int                             eol;
     /**
-     *  @param  found           TRUE = found, FALSE = not found             */
-    int                             found;
+     *  @param  in_line_l       Length of the read data                     */
+    size_t                          in_line_l;
     /**
-     *  @param  bytes_read      Total number of bytes read                  */
-    float                           bytes_read;
+     *  @param  qp              Quoted printable decoder                    */
+    struct  text_qp_t               qp;
 
     /************************************************************************
      *  Function Initialization
@@ -477,8 +464,11 @@ file_read_text(
 
     //  Initialize the buffer pointers
     in_line_p       = NULL;
-    tmp_data_1_p    = NULL;
-    tmp_data_2_p    = NULL;
+
+    //  The text line is built up here
+    mem_strbuf_init( &line_buf );
+    text_qp_init( &qp );
+    qp.fractions = true;
 
     /************************************************************************
      *  Read a new line of text
@@ -501,240 +491,463 @@ file_read_text(
         }
         else
         {
-            //  NO:     Update the total number of bytes read.
-            total_bytes_read += strlen( in_line );
+            //  NO:     Update the transfer rate
+            in_line_l = strlen( in_line );
+            FILE__transfer_rate( in_line_l );
 
-            //  What time is it ?
-            gettimeofday( &time_now, NULL );
-
-            //  Is the first time through here ?
-            if ( time_last.tv_sec == 0 )
+            //  Drop the line feed
+            if (    ( in_line_l > 0 )
+                 && ( in_line[ in_line_l - 1 ] == '\n' ) )
             {
-                //  YES:    Update the last display time
-                time_last.tv_sec = time_now.tv_sec;
+                in_line_l -= 1;
             }
 
-            //  Is it time to display ?
-            if ( ( time_last.tv_sec + 60 ) <= time_now.tv_sec )
+            //  Add it to the text line.  Is this the end of the line ?
+            if ( FILE__qp_line( &qp, in_line, in_line_l, &line_buf ) == true )
             {
-                //  YES:    Update the last display time
-                time_last.tv_sec = time_now.tv_sec;
-
-                //  Is this the first time ?
-                if ( bytes_read_last > 0 )
-                {
-                    //  NO:     Calculate the transfer rate.
-                    bytes_read = total_bytes_read - bytes_read_last;
-
-                    //  Log the transfer rate
-                    log_write( MID_DEBUG_0, "file_read_text",
-                               "Transfer rate: %3.2f KB/s\n",
-                               ( ( bytes_read / 1000 ) / 60 ) );
-                }
-
-                //  Save the current count
-                bytes_read_last = total_bytes_read;
+                //  YES:    This is the end of the text line
+                eol = true;
+
+                //  Set the return data pointer
+                in_line_p = mem_strbuf_detach( &line_buf );
             }
+        }
+    }
 
-            //  Remove the CR/LF characters (if present)
-            text_remove_crlf( in_line );
+    //  Was End-Of-File reached in the middle of a continued line ?
+    if ( line_buf.data_p != NULL )
+    {
+        //  YES:    Discard the partial line
+        mem_free( mem_strbuf_detach( &line_buf ) );
+    }
 
-            //  Remove any trailing whitespace from the end of the line
-            text_strip_whitespace( in_line );
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
 
-            //  Move the read data to a temporary buffer
-            tmp_data_2_p = text_copy_to_new( in_line );
+    //  DONE!
+    return( in_line_p );
+}
 
-            log_write( MID_DEBUG_1, "file_api.c", "Line: %d\n", __LINE__ );
+/****************************************************************************/
+/**
+ *  Open a file to be read a line at a time without copying.
+ *
+ *  @param  file_name_p         Pointer to the name of the file.
+ *  @param  mode                FILE_READER_AUTO, FILE_READER_MMAP or
+ *                              FILE_READER_STREAM.
+ *
+ *  @return reader_p            Pointer to the new reader.
+ *
+ *  @note
+ *      A file that cannot be opened is a fatal error, the same as
+ *      file_open_read().
+ *
+ ****************************************************************************/
 
-            //  Is there already data in the read data buffer ?
-            if ( tmp_data_1_p == NULL )
-            {
-                //  NO:     Transfer data from the tmp buffer to the read data buffer.
-                tmp_data_1_p = tmp_data_2_p;
+struct  file_reader_t *
+file_reader_open(
+    const char                  *   file_name_p,
+    enum    file_reader_mode_e      mode
+    )
+{
+    /**
+     *  @param  reader_p        Pointer to the new reader                   */
+    struct  file_reader_t       *   reader_p;
+    /**
+     *  @param  fd              File descriptor                             */
+    int                             fd;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Open the input file for read only
+    fd = open( file_name_p, O_RDONLY );
+
+    //  Was the file open successful ?
+    if ( fd < 0 )
+    {
+        //  NO:     The file open failed.
+        log_write( MID_FATAL, "file_reader_open",
+                   "Unable to open file '%s' for read\n",
+                   file_name_p );
+    }
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    reader_p = file_reader_open_fd( fd, mode );
+
+    //  The reader owns the file descriptor
+    reader_p->close_fd = true;
+
+    //  Log the event
+    log_write( MID_DEBUG_3, "file_reader_open",
+               "Successfully opened file: '%s' (%p)\n",
+               file_name_p, reader_p );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( reader_p );
+}
+
+/****************************************************************************/
+/**
+ *  Read an open file descriptor a line at a time without copying.
+ *
+ *  @param  fd                  File descriptor open for read.
+ *  @param  mode                FILE_READER_AUTO, FILE_READER_MMAP or
+ *                              FILE_READER_STREAM.
+ *
+ *  @return reader_p            Pointer to the new reader.
+ *
+ *  @note
+ *      file_reader_close() does not close the file descriptor.
+ *  @note
+ *      FILE_READER_AUTO maps a regular file into memory and uses a buffer
+ *      for anything else.  FILE_READER_MMAP falls back to a buffer when
+ *      the file cannot be mapped.  A regular file with a size of zero is
+ *      read through a buffer too, as files in /proc report no size.
+ *  @note
+ *      If a mapped file is truncated while it is being read, touching
+ *      the pages past the new end raises SIGBUS.
+ *
+ ****************************************************************************/
+
+struct  file_reader_t *
+file_reader_open_fd(
+    int                             fd,
+    enum    file_reader_mode_e      mode
+    )
+{
+    /**
+     *  @param  reader_p        Pointer to the new reader                   */
+    struct  file_reader_t       *   reader_p;
+    /**
+     *  @param  stat_data       File status                                 */
+    struct  stat                    stat_data;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    reader_p = mem_malloc( sizeof( struct file_reader_t ) );
+
+    reader_p->fd = fd;
+    mem_strbuf_init( &reader_p->line );
 
-                //  clear the temporary data pointer
-                tmp_data_2_p = NULL;
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Should the file be mapped into memory ?
+    if (    ( mode != FILE_READER_STREAM )
+         && ( fstat( fd, &stat_data ) == 0 )
+         && ( S_ISREG( stat_data.st_mode ) ) )
+    {
+        //  YES:    Is it empty ?
+        if ( stat_data.st_size > 0 )
+        {
+            //  NO:     Map it
+            reader_p->mapped = true;
+            reader_p->data_l = stat_data.st_size;
+            reader_p->data_p = mmap( NULL, reader_p->data_l, PROT_READ,
+                                     MAP_PRIVATE, fd, 0 );
+
+            //  Did it work ?
+            if ( reader_p->data_p == MAP_FAILED )
+            {
+                //  NO:     Read it through a buffer
+                reader_p->mapped = false;
+                reader_p->data_l = 0;
             }
             else
             {
-                /**
-                 *  @param  copy_of_p       Pointer to a temporary buffer   */
-                char                        *   copy_of_p;
-                /**
-                 *  @param  data_l          Size (in bytes) of the data     */
-                int                             data_l;
+                //  YES:    It will be read from front to back
+                madvise( reader_p->data_p, reader_p->data_l,
+                         MADV_SEQUENTIAL );
+            }
+        }
+    }
+
+    //  Is the file read through a buffer ?
+    if ( reader_p->mapped == false )
+    {
+        //  YES:    Allocate it
+        reader_p->buffer_l = FILE_READER_BUFFER_L;
+        reader_p->data_p   = mem_malloc_nozero( reader_p->buffer_l );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( reader_p );
+}
+
+/****************************************************************************/
+/**
+ *  Get the next line of a file exactly as it is in the file.
+ *
+ *  @param  reader_p            Pointer to a reader from file_reader_open().
+ *  @param  line_p              Pointer to a view that is set to the line.
+ *                              The line feed is not part of it.
+ *
+ *  @return line_rc             TRUE when a line was read, FALSE at
+ *                              End-Of-File.
+ *
+ *  @note
+ *      The view points into the reader and is only good until the next
+ *      call.  Lines may be any length.
+ *
+ ****************************************************************************/
+
+int
+file_reader_next_line(
+    struct  file_reader_t       *   reader_p,
+    struct  text_view_t         *   line_p
+    )
+{
+    /**
+     *  @param  line_rc         TRUE when a line was read                   */
+    int                             line_rc;
+    /**
+     *  @param  scan_l          Bytes already searched for a line feed      */
+    size_t                          scan_l;
+    /**
+     *  @param  lf_p            Pointer to the line feed                    */
+    char                        *   lf_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
 
-                //  YES:    Calculate the size needed for the two buffers.
-                data_l = strlen( tmp_data_1_p ) + strlen( tmp_data_2_p ) + 1;
+    line_rc = false;
+    scan_l  = 0;
 
-                //  Allocate a new buffer for the two lines.
-                copy_of_p = mem_malloc( data_l );
+    /************************************************************************
+     *  Find the end of the line
+     ************************************************************************/
 
-                log_write( MID_DEBUG_1, "file_api.c", "Line: %d\n", __LINE__ );
+    do
+    {
+        //  Look for the line feed in what has not been searched yet
+        lf_p = memchr( &reader_p->data_p[ reader_p->next_ndx + scan_l ], '\n',
+                       reader_p->data_l - reader_p->next_ndx - scan_l );
 
-                //  Copy the two lines of text to the new buffer
-                strncpy( copy_of_p, tmp_data_1_p, data_l );
-                strncat( copy_of_p, tmp_data_2_p, data_l );
+        scan_l = reader_p->data_l - reader_p->next_ndx;
 
-                //  Free the unused data buffer(s)
-                mem_free( tmp_data_1_p );
-                mem_free( tmp_data_2_p );
+    }   while (    ( lf_p == NULL )
+                && ( reader_p->mapped == false )
+                && ( FILE__reader_fill( reader_p ) == true ) );
 
-                //  This is now the new temporary data 1 buffer
-                tmp_data_1_p = copy_of_p;
-            }
-        }
-        //  Does line of data end with an equals sign '=' ?
-        if (    ( tmp_data_1_p != NULL )
-             && ( tmp_data_1_p[ strlen( tmp_data_1_p ) - 1 ] == '=' )
-             && ( tmp_data_1_p[ strlen( tmp_data_1_p ) - 2 ] != '=' ) )
+    /************************************************************************
+     *  Pass back the line
+     ************************************************************************/
+
+    //  Is there a line ?
+    if ( lf_p != NULL )
+    {
+        //  YES:    It ends at the line feed
+        line_p->text_p = &reader_p->data_p[ reader_p->next_ndx ];
+        line_p->text_l = lf_p - line_p->text_p;
+        reader_p->next_ndx += line_p->text_l + 1;
+        line_rc = true;
+    }
+    //  Is there a last line without a line feed ?
+    else if ( reader_p->next_ndx < reader_p->data_l )
+    {
+        //  YES:    It is the rest of the data
+        line_p->text_p = &reader_p->data_p[ reader_p->next_ndx ];
+        line_p->text_l = reader_p->data_l - reader_p->next_ndx;
+        reader_p->next_ndx = reader_p->data_l;
+        line_rc = true;
+    }
+
+    //  Update the transfer rate
+    if ( line_rc == true )
+    {
+        FILE__transfer_rate( line_p->text_l + 1 );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( line_rc );
+}
+
+/****************************************************************************/
+/**
+ *  Read a single line of text from the file.  The line is cleaned up the
+ *  same way as file_read_text().
+ *
+ *  @param  reader_p            Pointer to a reader from file_reader_open().
+ *  @param  line_p              Pointer to a view that is set to the line.
+ *
+ *  @return line_rc             TRUE when a line was read, FALSE at
+ *                              End-Of-File.
+ *
+ *  @note
+ *      Carriage returns and trailing whitespace are removed, lines ending
+ *      with a quoted printable soft line break '=' are joined with the
+ *      next line and '=XX' is decoded.
+ *  @note
+ *      A line without a CR, '=' or x'00 that does not continue the line
+ *      before it is passed back as it is in the file without being
+ *      copied.  Any other line is built in the reader.  Either way the
+ *      view is only good until the next call.
+ *  @note
+ *      Unlike file_read_text() lines longer than MAX_LINE_L are not
+ *      split.
+ *
+ ****************************************************************************/
+
+int
+file_reader_read_text(
+    struct  file_reader_t       *   reader_p,
+    struct  text_view_t         *   line_p
+    )
+{
+    /**
+     *  @param  line_rc         TRUE when a line was read                   */
+    int                             line_rc;
+    /**
+     *  @param  eol             End-Of-Line flag                            */
+    int                             eol;
+    /**
+     *  @param  raw             The line as it is in the file               */
+    struct  text_view_t             raw;
+    /**
+     *  @param  line_buf_p      Text line with its continuation lines       */
+    struct  mem_strbuf_t        *   line_buf_p;
+    /**
+     *  @param  first           TRUE for the first line read from the file  */
+    int                             first;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    line_rc    = false;
+    eol        = false;
+    first      = true;
+    line_buf_p = &reader_p->line;
+
+    //  Start a new text line
+    line_buf_p->length = 0;
+    text_qp_init( &reader_p->qp );
+    reader_p->qp.fractions = true;
+
+    /************************************************************************
+     *  Read a new line of text
+     ************************************************************************/
+
+    //  Continue to read until End-Of-Line is reached
+    while (    ( eol == false )
+            && ( file_reader_next_line( reader_p, &raw ) == true ) )
+    {
+        //  Is this a whole line that needs no changes ?
+        //  @NOTE   A continuation line is never whole; what came before it
+        //          may still be held in the decoder, not in the line.
+        if (    ( first == true )
+             && ( memchr( raw.text_p, '\r', raw.text_l ) == NULL )
+             && ( memchr( raw.text_p, '=',  raw.text_l ) == NULL )
+             && ( memchr( raw.text_p, '\0', raw.text_l ) == NULL ) )
         {
-            //  YES:    Strip off the equals sign
-            tmp_data_1_p[ strlen( tmp_data_1_p ) - 1 ] = '\0';
+            //  YES:    Pass back the line without copying it
+            text_view_strip_whitespace( &raw );
+            *line_p = raw;
+            line_rc = true;
+            break;
         }
-        else
+
+        first = false;
+
+        //  Add it to the text line.  Is this the end of the line ?
+        if ( FILE__qp_line( &reader_p->qp, raw.text_p, raw.text_l,
+                            line_buf_p ) == true )
         {
-            //  NO:     This is the end of the text line
+            //  YES:    This is the end of the text line
             eol = true;
 
-            //  Set the return data pointer
-            in_line_p = tmp_data_1_p;
+            line_p->text_p = line_buf_p->data_p;
+            line_p->text_l = strlen( line_buf_p->data_p );
+            line_rc = true;
         }
     }
 
-    /********************************************************************
-     *  Change character coding from quoted printable
-     ********************************************************************/
-
-    //  Are we at End-Of-File "
-    if (    ( in_line_p != END_OF_FILE )
-         && ( in_line_p != NULL        ) )
-    {
-        //  Initialize the search pointer
-        tmp_data_2_p = in_line_p;
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
 
-        do
-        {
-            /**
-             *  @param  xlate_char      The translated character                */
-            long int                        xlate_char;
-            /**
-             *  @param  data_l          Size (in bytes) of the data             */
-            int                             data_l;
+    //  DONE!
+    return( line_rc );
+}
 
-            //  Set the found flag to it's default state.
-            found = false;
+/****************************************************************************/
+/**
+ *  Close a reader.
+ *
+ *  @param  reader_p            Pointer to a reader from file_reader_open().
+ *
+ *  @return void
+ *
+ ****************************************************************************/
 
-            //  Look for the first character of a quoted printable string
-            tmp_data_1_p = strchr( tmp_data_2_p, '=' );
+void
+file_reader_close(
+    struct  file_reader_t       *   reader_p
+    )
+{
 
-            //  Did we find one ?
-            if ( tmp_data_1_p != NULL )
-            {
+    /************************************************************************
+     *  Function
+     ************************************************************************/
 
-                //  Is the format correct ?
-                if (    (           tmp_data_1_p[ 0 ] == '=' )
-                     && ( isxdigit( tmp_data_1_p[ 1 ] ) != 0 )
-                     && ( isxdigit( tmp_data_1_p[ 2 ] ) != 0 ) )
-                {
-                    /**
-                     *  @param  in_line         Temporary for HEX to ASCII  */
-                    char                            hex_data[ 3 ];
-
-                    //  YES:    change the state of the found flag
-                    found = true;
-
-                    //  Clear the buffer and copy the hex data string
-                    memset( hex_data, '\0', sizeof( hex_data ) );
-                    memcpy( hex_data, &tmp_data_1_p[ 1 ], 2 );
-
-                    //  Convert the string to a single character
-                    xlate_char = strtol( hex_data, NULL, 16 );
-
-                    //  Is this x'BD (1/2)
-                    if ( xlate_char == 0xBD )
-                    {
-                        //  YES:    Write it out
-                        tmp_data_1_p[ 0 ] = '1';
-                        tmp_data_1_p[ 1 ] = '/';
-                        tmp_data_1_p[ 2 ] = '2';
-                    }
-
-                    //  Is this x'BC (1/4)
-                    if ( xlate_char == 0xBC )
-                    {
-                        //  YES:    Write it out
-                        tmp_data_1_p[ 0 ] = '1';
-                        tmp_data_1_p[ 1 ] = '/';
-                        tmp_data_1_p[ 2 ] = '4';
-                    }
-
-                    //  Is this x'BE (3/4)
-                    if ( xlate_char == 0xBC )
-                    {
-                        //  YES:    Write it out
-                        tmp_data_1_p[ 0 ] = '3';
-                        tmp_data_1_p[ 1 ] = '/';
-                        tmp_data_1_p[ 2 ] = '4';
-                    }
-
-                    else
-                    {
-                        //  None of the above. write the converted character
-                        tmp_data_1_p[ 0 ] = (char)xlate_char;
-
-                        //  Find the string length of the remaining data
-                        data_l = strlen( &tmp_data_1_p[ 3 ] );
-
-                        //  Is there anything else in the string ?
-                        if ( data_l > 0 )
-                        {
-                            /**
-                             *  @param  ndx             Offset into a buffer        */
-                            int                             ndx;
-
-                            //  @note:  I have an interesting problem with the following.
-                            //  Both the 'strcpy' and 'memcpy' are corrupting data.
-                            //  Before:     "B0. Prepare a 9\\" pie pan with cooking spray and flour; set aside. T"
-                            //  strcpy:     ". Prepare 9\\" p pie pan with cooking spray and flour; set aside. T"
-                            //  memcpy:     ". Prepare a  pie pan with cooking spray and flour; set aside. . T"
-                            //  EXPECTED:   ". Prepare a 9\\" pie pan with cooking spray and flour; set aside. T"
-                            //  YES:    Left shift the remainder of the string
-                            for( ndx = 1; tmp_data_1_p[ ndx ] != '\0'; ndx += 1 )
-                            {
-                                tmp_data_1_p[ ndx ] = tmp_data_1_p[ ndx + 2 ];
-                            }
-
-                            //  Set the new search starting pointer
-                            tmp_data_2_p = &tmp_data_1_p[ 1 ];
-                        }
-                        else
-                        {
-                            //  NO:     Terminate the string here
-                            tmp_data_1_p[ 1 ] = '\0';
-                        }
-                    }
-                }
-            }
+    //  Is the file mapped into memory ?
+    if ( reader_p->mapped == true )
+    {
+        //  YES:    Unmap it
+        munmap( reader_p->data_p, reader_p->data_l );
+    }
+    else
+    {
+        //  NO:     Release the buffer
+        mem_free( reader_p->data_p );
+    }
 
-        }   while( found == true );
+    //  Does the reader own the file descriptor ?
+    if ( reader_p->close_fd == true )
+    {
+        //  YES:    Close it
+        close( reader_p->fd );
     }
 
-    //  Remove the CR/LF characters (if present)
-    //  @NOTE:  The line may have ended with =0D
-    if (    ( in_line_p != NULL         )
-         && ( in_line_p != END_OF_FILE  ) )
+    //  Release the text line
+    if ( reader_p->line.data_p != NULL )
     {
-        text_remove_crlf( in_line_p );
+        mem_free( reader_p->line.data_p );
     }
 
+    log_write( MID_DEBUG_3, "file_reader_close",
+               "Successfully closed reader: (%p)\n",
+               reader_p );
+
+    mem_free( reader_p );
+
     /************************************************************************
      *  Function Exit
      ************************************************************************/
 
     //  DONE!
-    return( in_line_p );
 }
 
 /****************************************************************************/
@@ -811,12 +1024,6 @@ file_stat(
     /**
      *  @param  statbuf         File statistics data                        */
     struct  stat                    statbuf;
-    /**
-     *  @param  tm              Time structure                              */
-    struct  tm                  *   tm;
-    /**
-     *  @param  file_info_p     Pointer to file information             */
-//  struct  file_info_t             file_info;
     /**
      *  @param  file_info_p     Pointer to file information             */
     struct  file_info_t    *        file_info_p;
@@ -882,23 +1089,11 @@ file_stat(
     //  Were we successful at getting the statistics data ?
     if ( file_rc != -1 )
     {
-        //  YES:    File Size
-        snprintf( file_info_p->file_size, sizeof( file_info_p->file_size ),
-                "%ld", statbuf.st_size );
-
-        //  File Creation Time
-        tm = localtime( &statbuf.st_mtime );
-#if 0
-        strftime( file_info_p->date_time,
-                  sizeof( file_info_p->date_time ),
-                  nl_langinfo( D_T_FMT ),
-                  tm );
-#else
-        strftime( file_info_p->date_time,
-                  sizeof( file_info_p->date_time ),
-                  "%Y/%m/%d %H:%M:%S",
-                  tm );
-#endif
+        //  YES:    Save and format the size and time
+        file_info_p->size  = statbuf.st_size;
+        file_info_p->mtime = statbuf.st_mtime;
+
+        file_info_format( file_info_p );
     }
     else
     {
@@ -916,6 +1111,49 @@ file_stat(
     return ( file_info_p );
 }
 
+/****************************************************************************/
+/**
+ *  Fill in the date_time and file_size strings of a file information
+ *  structure from its size and mtime.
+ *
+ *  @param  file_info_p         Pointer to a file information structure.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+file_info_format(
+    struct  file_info_t         *   file_info_p
+    )
+{
+    /**
+     *  @param  tm              Time structure                              */
+    struct  tm                      tm;
+
+    /************************************************************************
+     *  Function Body
+     ************************************************************************/
+
+    //  File Size
+    snprintf( file_info_p->file_size, sizeof( file_info_p->file_size ),
+              "%lld", (long long)file_info_p->size );
+
+    //  File Modification Time
+    localtime_r( &file_info_p->mtime, &tm );
+
+    strftime( file_info_p->date_time,
+              sizeof( file_info_p->date_time ),
+              "%Y/%m/%d %H:%M:%S",
+              &tm );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
 /****************************************************************************/
 /**
  *  Create a recursive list of files in a directory tree.
@@ -927,6 +1165,8 @@ file_stat(
  *  @return void                No return information from this function.
  *
  *  @note
+ *      The same as file_scan() with the date_time and file_size strings
+ *      filled in.
  *
  ****************************************************************************/
 
@@ -937,152 +1177,852 @@ file_ls(
     char                        *   include_ext_p
     )
 {
-    /**
-     *  @param  directory_p     Directory pointer                           */
-    DIR                     *   directory_p;
-    /**
-     *  @param  entry           Directory information structure             */
-    struct  dirent          *   entry;
-    /**
-     *  @param  statbuf         File or Directory state data                */
-    struct  stat                statbuf;
-    /**
-     *  @param  full_file_name  Fully qualified file name                   */
-    char                        full_file_name[ MAX_LINE_L ];
-    /**
-     *  @param  file_info_p     Pointer to a file information structure     */
-    struct  file_info_t     *   file_info_p;
-    /**
-     *  @param  stat_data_p     Pointer to a file statistics structure  */
-    struct  file_info_t     *   stat_data_p;
 
     /************************************************************************
-     *  Function Initialization
+     *  Function Body
      ************************************************************************/
 
-    //  Log the progress
-    log_write( MID_DEBUG_0, "file_next",
-               "Scanning: '%s'\n",
-               fd_name );
+    file_scan( file_list_p, fd_name, include_ext_p, true );
 
     /************************************************************************
-     *  Function Body
+     *  Function Exit
      ************************************************************************/
 
-    //  Attempt to open a directory
-    if ( ( directory_p = opendir( fd_name ) ) == NULL )
-    {
-        log_write( MID_FATAL, "file_next",
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Create a recursive list of files in a directory tree.
+ *
+ *  @param  file_list_p         Pointer to a list for the list of files.
+ *  @param  dir_name_p          A directory name.
+ *  @param  include_ext_p       Pointer to a (lowercase) file extension to
+ *                              include or NULL for all files.
+ *  @param  format              TRUE to fill in the date_time and file_size
+ *                              strings, FALSE to only fill in size and
+ *                              mtime.  file_info_format() builds the
+ *                              strings later.
+ *
+ *  @return void                No return information from this function.
+ *
+ *  @note
+ *      Each file is added to the list as a struct file_info_t that the
+ *      caller releases with mem_free().  Symbolic links to directories are
+ *      not followed.
+ *
+ ****************************************************************************/
+
+void
+file_scan(
+    struct  list_base_t         *   file_list_p,
+    const char                  *   dir_name_p,
+    const char                  *   include_ext_p,
+    int                             format
+    )
+{
+    /**
+     *  @param  path            Name of the directory being scanned         */
+    char                            path[ MAX_LINE_L ];
+    /**
+     *  @param  path_l          Length of the directory name                */
+    size_t                          path_l;
+    /**
+     *  @param  dir_fd          Directory file descriptor                   */
+    int                             dir_fd;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    path_l = strlen( dir_name_p );
+
+    //  Will the name fit in the buffer ?
+    if ( path_l >= sizeof( path ) )
+    {
+        //  NO:     Error message
+        log_write( MID_FATAL, "file_scan",
+                   "Directory name is larger than the allocated buffer\n" );
+    }
+
+    memcpy( path, dir_name_p, path_l + 1 );
+
+    /************************************************************************
+     *  Function Body
+     ************************************************************************/
+
+    //  Attempt to open the directory
+    dir_fd = open( dir_name_p, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+
+    if ( dir_fd < 0 )
+    {
+        log_write( MID_FATAL, "file_scan",
                    "File or Directory '%s' does not exist.\n",
-                    fd_name );
+                   dir_name_p );
     }
-    //  Directory:
-    while( ( entry = readdir( directory_p ) ) != NULL )
+
+    //  Build the list
+    FILE__scan( file_list_p, dir_fd, path, path_l, include_ext_p, format );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Walk a directory tree with several threads, passing each file to a
+ *  callback as soon as it is found.
+ *
+ *  @param  dir_name_p          A directory name.
+ *  @param  include_ext_p       Pointer to a (lowercase) file extension to
+ *                              include or NULL for all files.
+ *  @param  callback_p          Called once for each included file with
+ *                              parm_p and the file's information.
+ *  @param  parm_p              Passed to the callback.
+ *  @param  thread_count        Number of threads to use.  Zero or less
+ *                              uses one per online processor.
+ *
+ *  @return file_count          Number of files passed to the callback.
+ *
+ *  @note
+ *      The callback is called from several threads at once.  The
+ *      file_info_t is only good until the callback returns; its
+ *      date_time and file_size strings are empty (see file_info_format()).
+ *  @note
+ *      Each thread keeps a deque of the subdirectories it has found and
+ *      scans the newest one next.  An idle thread steals the oldest
+ *      directory from another thread's deque.
+ *  @note
+ *      file_walk() returns once every directory has been scanned.  A
+ *      subdirectory that cannot be opened is logged and skipped.  Symbolic
+ *      links to directories are not followed.
+ *
+ ****************************************************************************/
+
+long
+file_walk(
+    const char                  *   dir_name_p,
+    const char                  *   include_ext_p,
+    void                            (*callback_p)( void *,
+                                                   struct file_info_t * ),
+    void                        *   parm_p,
+    int                             thread_count
+    )
+{
+    /**
+     *  @param  walk            The walk shared by all of the threads       */
+    struct  file_walk_t             walk;
+    /**
+     *  @param  thread_p        Information for each walker thread          */
+    struct  file_walk_thread_t  *   thread_p;
+    /**
+     *  @param  stat_data       Status of the starting directory            */
+    struct  stat                    stat_data;
+    /**
+     *  @param  item            The starting directory                      */
+    struct  file_walk_item_t        item;
+    /**
+     *  @param  ndx             Thread index                                */
+    int                             ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Is the starting directory there ?
+    if (    ( stat( dir_name_p, &stat_data ) != 0 )
+         || ( S_ISDIR( stat_data.st_mode ) == 0 ) )
     {
-        //  Will the full name fit in the buffer ?
-        if (   ( strlen( fd_name ) + strlen( entry->d_name ) )
-             < ( sizeof( full_file_name ) - 2 ) )
+        //  NO:     This is bad.
+        log_write( MID_FATAL, "file_walk",
+                   "File or Directory '%s' does not exist.\n",
+                   dir_name_p );
+    }
+
+    //  How many threads ?
+    if ( thread_count <= 0 )
+    {
+        thread_count = sysconf( _SC_NPROCESSORS_ONLN );
+    }
+    if ( thread_count <= 0 )
+    {
+        thread_count = 1;
+    }
+    if ( thread_count > FILE_WALK_THREADS_MAX )
+    {
+        thread_count = FILE_WALK_THREADS_MAX;
+    }
+
+    walk.include_ext_p = include_ext_p;
+    walk.callback_p    = callback_p;
+    walk.parm_p        = parm_p;
+    walk.thread_count  = thread_count;
+    walk.running       = thread_count;
+    atomic_init( &walk.pending,    0 );
+    atomic_init( &walk.idle,       0 );
+    atomic_init( &walk.file_count, 0 );
+    pthread_mutex_init( &walk.lock, NULL );
+    pthread_cond_init( &walk.work, NULL );
+    pthread_cond_init( &walk.done, NULL );
+
+    walk.deque_p = mem_malloc( thread_count
+                               * sizeof( struct file_walk_deque_t ) );
+    thread_p     = mem_malloc( thread_count
+                               * sizeof( struct file_walk_thread_t ) );
+
+    for ( ndx = 0; ndx < thread_count; ndx += 1 )
+    {
+        pthread_mutex_init( &walk.deque_p[ ndx ].lock, NULL );
+        walk.deque_p[ ndx ].size    = FILE_WALK_DEQUE_L;
+        walk.deque_p[ ndx ].item_p  = mem_malloc( FILE_WALK_DEQUE_L
+                                * sizeof( struct file_walk_item_t ) );
+
+        thread_p[ ndx ].walk_p     = &walk;
+        thread_p[ ndx ].thread_ndx = ndx;
+    }
+
+    //  The walk starts with the starting directory
+    item.parent_p = NULL;
+    item.path_p   = text_copy_to_new( (char *)dir_name_p );
+    item.name_ndx = 0;
+    FILE__walk_push( &walk, &walk.deque_p[ 0 ], &item );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Start the other threads
+    for ( ndx = 1; ndx < thread_count; ndx += 1 )
+    {
+        thread_new( FILE__walk_thread, &thread_p[ ndx ] );
+    }
+
+    //  This thread is a walker too
+    FILE__walk_thread( &thread_p[ 0 ] );
+
+    //  Wait for the others to leave the walk
+    pthread_mutex_lock( &walk.lock );
+
+    while ( walk.running > 0 )
+    {
+        pthread_cond_wait( &walk.done, &walk.lock );
+    }
+
+    pthread_mutex_unlock( &walk.lock );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    for ( ndx = 0; ndx < thread_count; ndx += 1 )
+    {
+        pthread_mutex_destroy( &walk.deque_p[ ndx ].lock );
+        mem_free( walk.deque_p[ ndx ].item_p );
+    }
+
+    mem_free( walk.deque_p );
+    mem_free( thread_p );
+    pthread_cond_destroy( &walk.done );
+    pthread_cond_destroy( &walk.work );
+    pthread_mutex_destroy( &walk.lock );
+
+    //  DONE!
+    return( atomic_load( &walk.file_count ) );
+}
+
+/****************************************************************************/
+/**
+ *  Start watching a directory tree for files that are added, modified or
+ *  deleted.
+ *
+ *  @param  dir_name_p          A directory name.
+ *  @param  include_ext_p       Pointer to a (lowercase) file extension to
+ *                              include or NULL for all files.
+ *
+ *  @return watch_p             Pointer to the new file watch.
+ *
+ *  @note
+ *      The watch keeps an index of the file_info_t of every included file,
+ *      a table per directory, and keeps it up to date from inotify events
+ *      read by file_watch_poll().  Instead of calling file_ls() and
+ *      comparing the lists, use file_watch_list() once and then
+ *      file_watch_changes() to get only what changed since.
+ *  @note
+ *      A file is reported as modified when it is closed after being
+ *      written or when its size or modification time changes.
+ *  @note
+ *      A file watch is meant to be used by one thread.
+ *
+ ****************************************************************************/
+
+struct  file_watch_t *
+file_watch_new(
+    const char                  *   dir_name_p,
+    const char                  *   include_ext_p
+    )
+{
+    /**
+     *  @param  watch_p         Pointer to the new file watch               */
+    struct  file_watch_t        *   watch_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    watch_p = mem_malloc( sizeof( struct file_watch_t ) );
+
+    watch_p->fd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+
+    //  Was the inotify instance created ?
+    if ( watch_p->fd < 0 )
+    {
+        //  NO:     This is bad.
+        log_write( MID_FATAL, "file_watch_new",
+                   "Unable to create an inotify instance because: %s\n",
+                   strerror( errno ) );
+    }
+
+    //  Save the file extension
+    if ( include_ext_p != NULL )
+    {
+        watch_p->include_ext_p = text_copy_to_new( (char *)include_ext_p );
+    }
+
+    watch_p->journal_p = mem_malloc( FILE_WATCH_JOURNAL_L
+                                     * sizeof( struct file_change_t ) );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Watch the directory tree and build the index
+    if ( FILE__watch_add_dir( watch_p, dir_name_p ) == NULL )
+    {
+        log_write( MID_FATAL, "file_watch_new",
+                   "Directory '%s' cannot be watched.\n",
+                   dir_name_p );
+    }
+
+    //  What is there now is the starting point, not a change.
+    watch_p->cursor = 0;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( watch_p );
+}
+
+/****************************************************************************/
+/**
+ *  Wait for and apply the events of a file watch.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *  @param  timeout_ms          How long to wait for an event in
+ *                              milliseconds.  0 does not wait and -1
+ *                              waits for as long as it takes.
+ *
+ *  @return change_count        Number of changes added to the journal.
+ *
+ ****************************************************************************/
+
+int
+file_watch_poll(
+    struct  file_watch_t        *   watch_p,
+    int                             timeout_ms
+    )
+{
+    /**
+     *  @param  poll_fd         What to wait for                            */
+    struct  pollfd                  poll_fd;
+    /**
+     *  @param  buffer          Buffer the events are read into             */
+    char                            buffer[ FILE_WATCH_EVENT_L ]
+                __attribute__ ( ( aligned( __alignof__( int ) ) ) );
+    /**
+     *  @param  event_p         Pointer to an event                         */
+    struct  inotify_event       *   event_p;
+    /**
+     *  @param  read_l          Number of bytes read                        */
+    ssize_t                         read_l;
+    /**
+     *  @param  ndx             Offset of an event in the buffer            */
+    ssize_t                         ndx;
+    /**
+     *  @param  cursor          Cursor before the events                    */
+    uint64_t                        cursor;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    cursor = watch_p->cursor;
+
+    poll_fd.fd      = watch_p->fd;
+    poll_fd.events  = POLLIN;
+    poll_fd.revents = 0;
+
+    //  Is there anything to read ?
+    if ( poll( &poll_fd, 1, timeout_ms ) <= 0 )
+    {
+        //  NO:     Nothing changed
+        return( 0 );
+    }
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Read until there are no more events
+    while ( ( read_l = read( watch_p->fd, buffer, sizeof( buffer ) ) ) > 0 )
+    {
+        for ( ndx = 0;
+              ndx < read_l;
+              ndx += sizeof( struct inotify_event ) + event_p->len )
         {
-            //  YES:    Expand the name
-            snprintf( full_file_name, sizeof( full_file_name ),
-                      "%s/%s", fd_name, entry->d_name );
+            event_p = (struct inotify_event *)&buffer[ ndx ];
+
+            FILE__watch_event( watch_p, event_p );
         }
-        else
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( (int)( watch_p->cursor - cursor ) );
+}
+
+/****************************************************************************/
+/**
+ *  Get the current position in a file watch's journal.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *
+ *  @return cursor              Number of changes recorded so far.
+ *
+ ****************************************************************************/
+
+uint64_t
+file_watch_cursor(
+    struct  file_watch_t        *   watch_p
+    )
+{
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( watch_p->cursor );
+}
+
+/****************************************************************************/
+/**
+ *  Get the changes made since a cursor.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *  @param  cursor_p            Pointer to the cursor.  Start with 0 (the
+ *                              state file_watch_list() returned right
+ *                              after file_watch_new()).  It is moved past
+ *                              the changes that were returned.
+ *  @param  change_list_p       A file_change_t is added to this list for
+ *                              each change, oldest first.
+ *
+ *  @return change_count        Number of changes added to the list or -1
+ *                              when the journal no longer goes back to
+ *                              the cursor.
+ *
+ *  @note
+ *      When -1 is returned the cursor is moved to the current position;
+ *      use file_watch_list() to get back in step.
+ *  @note
+ *      The caller owns the file_change_t structures and must mem_free()
+ *      them.
+ *
+ ****************************************************************************/
+
+int
+file_watch_changes(
+    struct  file_watch_t        *   watch_p,
+    uint64_t                    *   cursor_p,
+    struct  list_base_t         *   change_list_p
+    )
+{
+    /**
+     *  @param  change_p        Pointer to a copy of a change               */
+    struct  file_change_t       *   change_p;
+    /**
+     *  @param  change_count    Number of changes added to the list         */
+    int                             change_count;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Are the changes still in the journal ?
+    if (    ( *cursor_p > watch_p->cursor )
+         || ( ( watch_p->cursor - *cursor_p ) > FILE_WATCH_JOURNAL_L ) )
+    {
+        //  NO:     The caller has to start over
+        *cursor_p = watch_p->cursor;
+        return( -1 );
+    }
+
+    change_count = 0;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    for ( ; *cursor_p < watch_p->cursor; *cursor_p += 1 )
+    {
+        change_p = mem_malloc_nozero( sizeof( struct file_change_t ) );
+
+        memcpy( change_p,
+                &watch_p->journal_p[ *cursor_p
+                                     & ( FILE_WATCH_JOURNAL_L - 1 ) ],
+                sizeof( struct file_change_t ) );
+
+        list_put_last( change_list_p, change_p );
+        change_count += 1;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( change_count );
+}
+
+/****************************************************************************/
+/**
+ *  Get every file in a file watch's index, the same as file_ls() would.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *  @param  file_list_p         A file_info_t is added to this list for
+ *                              each file.
+ *
+ *  @return void
+ *
+ *  @note
+ *      The caller owns the file_info_t structures and must mem_free()
+ *      them.
+ *
+ ****************************************************************************/
+
+void
+file_watch_list(
+    struct  file_watch_t        *   watch_p,
+    struct  list_base_t         *   file_list_p
+    )
+{
+    /**
+     *  @param  dir_p           Pointer to a watched directory              */
+    struct  file_watch_dir_t    *   dir_p;
+    /**
+     *  @param  file_info_p     Pointer to a copy of the file information   */
+    struct  file_info_t         *   file_info_p;
+    /**
+     *  @param  slot_ndx        Index into the file table                   */
+    size_t                          slot_ndx;
+    /**
+     *  @param  wd              inotify watch descriptor                    */
+    int                             wd;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    for ( wd = 0; wd < watch_p->dir_l; wd += 1 )
+    {
+        if ( ( dir_p = watch_p->dir_pp[ wd ] ) == NULL )
         {
-            //  NO:     Error message
-            log_write( MID_INFO, "file_next",
-                       "Full file name is larger than the allocated buffer\n" );
-            log_write( MID_FATAL, "file_next",
-                       "%s/%s\n", fd_name, entry->d_name );
+            continue;
         }
 
-        // Test for a directory or a file name.
-        lstat( full_file_name, &statbuf );
-
-        //  Is this a directory ?
-        if ( S_ISDIR( statbuf.st_mode ) )
+        for ( slot_ndx = 0; slot_ndx < dir_p->capacity; slot_ndx += 1 )
         {
+            if ( dir_p->slot_pp[ slot_ndx ] != NULL )
+            {
+                file_info_p = mem_malloc_nozero( sizeof( struct file_info_t ) );
 
-            /****************************************************************
-             *  Exclude these directories
-             ****************************************************************/
+                memcpy( file_info_p, &dir_p->slot_pp[ slot_ndx ]->file_info,
+                        sizeof( struct file_info_t ) );
 
-            //  YES:    Does the directory name match any of the following ?
-            if (    ( strcmp( entry->d_name, "."        ) == 0 )
-                 || ( strcmp( entry->d_name, ".."       ) == 0 ) )
-            {
-                //  YES:    Exclude it from processing.
-                continue;
+                list_put_last( file_list_p, file_info_p );
             }
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Stop watching and release a file watch.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+file_watch_kill(
+    struct  file_watch_t        *   watch_p
+    )
+{
+    /**
+     *  @param  dir_p           Pointer to a watched directory              */
+    struct  file_watch_dir_t    *   dir_p;
+    /**
+     *  @param  slot_ndx        Index into the file table                   */
+    size_t                          slot_ndx;
+    /**
+     *  @param  wd              inotify watch descriptor                    */
+    int                             wd;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Closing the inotify instance removes all of its watches
+    close( watch_p->fd );
 
-            //  Build a file list for this directory
-            file_ls( file_list_p, full_file_name, include_ext_p );
+    for ( wd = 0; wd < watch_p->dir_l; wd += 1 )
+    {
+        if ( ( dir_p = watch_p->dir_pp[ wd ] ) == NULL )
+        {
+            continue;
         }
-        else
+
+        for ( slot_ndx = 0; slot_ndx < dir_p->capacity; slot_ndx += 1 )
         {
-            //  Is there a extension exclude type ?
-            if ( include_ext_p != NULL )
+            if ( dir_p->slot_pp[ slot_ndx ] != NULL )
             {
-                /**
-                 *  @param  period_p        Pointer to the last period      */
-                char                        *   period_p;
-                /**
-                 *  @param  extention       Buffer to hold file extention   */
-                char                            extention[ 10 ];
-
-                //  YES:    Locate the start of the file extention
-                period_p = strrchr( full_file_name, '.' );
-
-                //  Is there a file extention ?
-                if ( period_p != NULL )
-                {
-                    //  YES:    Copy the file extention to a new buffer
-                    strncpy( extention, ++period_p, sizeof( extention ) );
-
-                    //  Make the file extention all lowercase
-                    text_to_lowercase( extention );
-
-                    //  Compare the file extention to the include extention.
-                    if ( strncmp( include_ext_p, extention, strlen( include_ext_p ) ) != 0 )
-                    {
-                        //  NO:     This isn't an include file extention
-                        continue;
-                    }
-                }
+                mem_free( dir_p->slot_pp[ slot_ndx ] );
             }
-            //  NO:     Allocate a structure to save the file information
-            file_info_p = mem_malloc( sizeof( struct file_info_t ) );
+        }
+
+        mem_free( dir_p->slot_pp );
+        mem_free( dir_p );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    if ( watch_p->dir_pp != NULL )
+    {
+        mem_free( watch_p->dir_pp );
+    }
+    if ( watch_p->include_ext_p != NULL )
+    {
+        mem_free( watch_p->include_ext_p );
+    }
+    mem_free( watch_p->journal_p );
+    mem_free( watch_p );
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Copy a file.
+ *
+ *  @param  src_name_p          Name of the file to copy.
+ *  @param  dst_name_p          Name of the copy.  An existing file is
+ *                              replaced.
+ *  @param  sync                When TRUE the copy is flushed to the disk
+ *                              before returning.
+ *
+ *  @return copy_rc             TRUE when the file was copied, FALSE (with
+ *                              a warning logged) when it was not.
+ *
+ *  @note
+ *      The data does not pass through user space when the kernel can copy
+ *      it (see FILE__copy_data()).  The copy gets the permissions and the
+ *      access and modification times of the original.  The data is written
+ *      to a temporary file in the directory of the copy which is then
+ *      renamed over the copy, so an existing file is either replaced whole
+ *      or, when the copy fails, left as it was.
+ *  @note
+ *      Only regular files are copied.  Directories, FIFOs, sockets and
+ *      devices are refused.
+ *
+ ****************************************************************************/
+
+int
+file_copy(
+    const char                  *   src_name_p,
+    const char                  *   dst_name_p,
+    int                             sync
+    )
+{
+    /**
+     *  @param  src_fd          File descriptor of the original             */
+    int                             src_fd;
+    /**
+     *  @param  dst_fd          File descriptor of the copy                 */
+    int                             dst_fd;
+    /**
+     *  @param  tmp_name        Name of the copy until it is complete       */
+    char                            tmp_name[ ( FILE_NAME_L * 2 ) + 16 ];
+    /**
+     *  @param  src_stat        File status of the original                 */
+    struct  stat                    src_stat;
+    /**
+     *  @param  dst_stat        File status of the copy                     */
+    struct  stat                    dst_stat;
+    /**
+     *  @param  times           Access and modification times               */
+    struct  timespec                times[ 2 ];
+    /**
+     *  @param  copy_rc         Return code                                 */
+    int                             copy_rc;
+    /**
+     *  @param  error           errno of the failure                        */
+    int                             error;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  @NOTE   O_NONBLOCK keeps the open of a FIFO from waiting for a
+    //          writer.  It does nothing for the regular files that are
+    //          copied.
+    src_fd = open( src_name_p, O_RDONLY | O_CLOEXEC | O_NONBLOCK );
+
+    //  Was the original opened ?
+    if ( src_fd < 0 )
+    {
+        //  NO:     Nothing to copy
+        log_write( MID_WARNING, "file_copy",
+                   "Unable to open '%s' because: %s\n",
+                   src_name_p, strerror( errno ) );
+        return( false );
+    }
+
+    //  Is it a regular file ?
+    //  @NOTE   A directory can't be read, and a FIFO or a device such as
+    //          /dev/zero may never reach End-Of-File.
+    if (    ( fstat( src_fd, &src_stat ) != 0 )
+         || ( S_ISREG( src_stat.st_mode ) == 0 ) )
+    {
+        //  NO:     Don't try
+        log_write( MID_WARNING, "file_copy",
+                   "'%s' is not a regular file and cannot be copied.\n",
+                   src_name_p );
+        close( src_fd );
+        return( false );
+    }
+
+    //  Is the copy the original ?
+    if (    ( stat( dst_name_p, &dst_stat ) == 0 )
+         && ( dst_stat.st_dev == src_stat.st_dev )
+         && ( dst_stat.st_ino == src_stat.st_ino ) )
+    {
+        //  YES:    Nothing to do
+        log_write( MID_WARNING, "file_copy",
+                   "'%s' and '%s' are the same file.\n",
+                   src_name_p, dst_name_p );
+        close( src_fd );
+        return( false );
+    }
+
+    //  Will the temporary name fit ?
+    if ( strlen( dst_name_p ) + 8 >= sizeof( tmp_name ) )
+    {
+        //  NO:     Don't truncate it to some other name
+        log_write( MID_WARNING, "file_copy",
+                   "'%s' is too long a name for a copy.\n",
+                   dst_name_p );
+        close( src_fd );
+        return( false );
+    }
+
+    snprintf( tmp_name, sizeof( tmp_name ), "%s.XXXXXX", dst_name_p );
+
+    dst_fd = mkstemp( tmp_name );
+
+    //  Was the copy created ?
+    if ( dst_fd < 0 )
+    {
+        //  NO:     Nowhere to copy to
+        log_write( MID_WARNING, "file_copy",
+                   "Unable to create '%s' because: %s\n",
+                   tmp_name, strerror( errno ) );
+        close( src_fd );
+        return( false );
+    }
 
-            log_write( MID_DEBUG_1, "file_api.c", "Line: %d\n", __LINE__ );
+    fcntl( dst_fd, F_SETFD, FD_CLOEXEC );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
 
-            //  Get the file statics data
-            stat_data_p = file_stat( full_file_name, entry->d_name );
+    copy_rc = FILE__copy_data( src_fd, dst_fd, S_ISREG( src_stat.st_mode ) );
 
-            //  Clean th destination buffers
-            memset( file_info_p->dir_name,  '\0', sizeof( file_info_p->dir_name  ) );
-            memset( file_info_p->file_name, '\0', sizeof( file_info_p->file_name ) );
-            memset( file_info_p->date_time, '\0', sizeof( file_info_p->date_time ) );
-            memset( file_info_p->file_size, '\0', sizeof( file_info_p->file_size ) );
+    //  Was it copied ?
+    if ( copy_rc == true )
+    {
+        //  YES:    Give it the same permissions and times as the original
+        times[ 0 ] = src_stat.st_atim;
+        times[ 1 ] = src_stat.st_mtim;
 
-            //  Save the file information
-            strncpy(  file_info_p->dir_name,
-                      fd_name,
-                      sizeof( file_info_p->dir_name  ) - 1 );
+        if (    ( fchmod( dst_fd, src_stat.st_mode & 07777 ) != 0 )
+             || ( futimens( dst_fd, times ) != 0 ) )
+        {
+            copy_rc = false;
+        }
+        //  Should it be flushed to the disk ?
+        else if ( sync == true )
+        {
+            //  YES:    Flush the data before it gets the new name
+            copy_rc = ( fsync( dst_fd ) == 0 );
+        }
+    }
 
-            strncpy(  file_info_p->file_name,
-                      stat_data_p->file_name,
-                      sizeof( file_info_p->file_name ) - 1 );
+    error = errno;
 
-            strncpy(  file_info_p->date_time,
-                      stat_data_p->date_time,
-                      sizeof( file_info_p->date_time ) - 1 );
+    close( src_fd );
 
-            strncpy(  file_info_p->file_size,
-                      stat_data_p->file_size,
-                      sizeof( file_info_p->file_size ) - 1 );
+    if ( ( close( dst_fd ) != 0 ) && ( copy_rc == true ) )
+    {
+        error   = errno;
+        copy_rc = false;
+    }
 
-            //  Add the new file to the list
-            list_put_last( file_list_p, file_info_p );
+    //  Is the copy complete ?
+    if ( copy_rc == true )
+    {
+        //  YES:    Replace the old file with it
+        if ( rename( tmp_name, dst_name_p ) != 0 )
+        {
+            error   = errno;
+            copy_rc = false;
+        }
+        //  Should the new name be flushed to the disk ?
+        else if (    ( sync == true )
+                  && ( FILE__sync_dir( dst_name_p ) == false ) )
+        {
+            //  YES:    And it could not be
+            log_write( MID_WARNING, "file_copy",
+                       "Unable to flush '%s' because: %s\n",
+                       dst_name_p, strerror( errno ) );
+            return( false );
         }
     }
 
@@ -1090,10 +2030,105 @@ file_ls(
      *  Function Exit
      ************************************************************************/
 
-    //  At the end of the directory, close it.
-    closedir( directory_p );
+    //  Did the copy fail ?
+    if ( copy_rc == false )
+    {
+        //  YES:    Don't leave part of it behind
+        unlink( tmp_name );
+
+        log_write( MID_WARNING, "file_copy",
+                   "Unable to copy '%s' to '%s' because: %s\n",
+                   src_name_p, dst_name_p, strerror( error ) );
+        errno = error;
+    }
+
+    //  DONE!
+    return( copy_rc );
+}
+
+/****************************************************************************/
+/**
+ *  Move (rename) a file.
+ *
+ *  @param  src_name_p          Name of the file to move.
+ *  @param  dst_name_p          New name of the file.  An existing file is
+ *                              replaced.
+ *  @param  sync                When TRUE the move is flushed to the disk
+ *                              before returning.
+ *
+ *  @return move_rc             TRUE when the file was moved, FALSE (with
+ *                              a warning logged) when it was not.
+ *
+ *  @note
+ *      On the same file system only the name changes.  Across file
+ *      systems the file is copied with file_copy() and the original
+ *      deleted, so only a regular file can be moved there.
+ *
+ ****************************************************************************/
+
+int
+file_move(
+    const char                  *   src_name_p,
+    const char                  *   dst_name_p,
+    int                             sync
+    )
+{
+
+    /************************************************************************
+     *  Same file system
+     ************************************************************************/
+
+    //  Can the file simply be renamed ?
+    if ( rename( src_name_p, dst_name_p ) == 0 )
+    {
+        //  YES:    Should the new name be flushed to the disk ?
+        if ( ( sync == true ) && ( FILE__sync_dir( dst_name_p ) == false ) )
+        {
+            //  YES:    And it could not be
+            log_write( MID_WARNING, "file_move",
+                       "Unable to flush '%s' because: %s\n",
+                       dst_name_p, strerror( errno ) );
+            return( false );
+        }
+
+        return( true );
+    }
+
+    //  Is the new name on another file system ?
+    if ( errno != EXDEV )
+    {
+        //  NO:     The move failed
+        log_write( MID_WARNING, "file_move",
+                   "Unable to move '%s' to '%s' because: %s\n",
+                   src_name_p, dst_name_p, strerror( errno ) );
+        return( false );
+    }
+
+    /************************************************************************
+     *  Different file systems
+     ************************************************************************/
+
+    //  Copy it
+    if ( file_copy( src_name_p, dst_name_p, sync ) == false )
+    {
+        return( false );
+    }
+
+    //  Remove the original
+    if ( unlink( src_name_p ) != 0 )
+    {
+        log_write( MID_WARNING, "file_move",
+                   "Unable to remove '%s' because: %s\n",
+                   src_name_p, strerror( errno ) );
+        return( false );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
 
     //  DONE!
+    return( true );
 }
 
 /****************************************************************************/
@@ -1160,225 +2195,106 @@ file_path_to_lib(
 
 /****************************************************************************/
 /**
- *  Recursively find and extract all "*.zip" files in the target directory.
+ *  Extract a ZIP archive.
  *
- *  @param  dir_p               Pointer to the starting directory
+ *  @param  zip_name_p          Name of the archive.
+ *  @param  extract_to_p        Directory to extract into.  It is created
+ *                              when it does not exist.
  *
- *  @return void                No information is returned from this function.
+ *  @return file_count          Number of files extracted or -1 when the
+ *                              file is not a ZIP archive.
  *
  *  @note
+ *      Stored and deflated entries are extracted.  An entry that is a
+ *      "*.zip" file is itself extracted into a new directory instead of
+ *      being saved.  Entries are written as they are inflated, so their
+ *      size does not matter.  Encrypted entries, links,
+ *      entries with a bad CRC and entries that would land outside of
+ *      the extract to directory are skipped with a warning.
  *
  ****************************************************************************/
 
 int
-file_unzip(
-    char                    *   path_p
+file_zip_extract(
+    const char                  *   zip_name_p,
+    const char                  *   extract_to_p
     )
 {
     /**
-     *  @param  unzip_count     Number of files UnZipped                    */
-    int                         unzip_count;
-    /**
-     *  @param  found_zip       Flag showing a "*.zip" file was found.      */
-    int                         found_zip;
-    /**
-     *  @param  file_list       Pointer to a list of files                  */
-    struct  list_base_t     *   file_list_p;
-    /**
-     *  @param  file_info_p     Pointer to a file information structure     */
-    struct  file_info_t     *   file_info_p;
-    /**
-     *  @param  file_name       Buffer to hold the directory/file name      */
-    char                        file_name[ ( FILE_NAME_L * 3 ) ];
-    /**
-     *  @param  extract_to      Name of the directory to extract into       */
-    char                        extract_to[ ( FILE_NAME_L * 4 ) ];
-    /**
-     *  @param  saved_dir_name  Saved directory name                        */
-    char                        saved_dir_name[ ( FILE_NAME_L * 3 ) ];
-    /**
-     *  @param  tmp_p           Temporary data pointer                      */
-    char                    *   tmp_p;
-    /**
-     *  @param  command         System command buffer                       */
-    char                        command[ SYS_CMD_L ];
-    /**
-     *  @param  extention       Buffer to hold file extention               */
-    char                        extention[ 10 ];
-    /**
-     *  @param  dir_created     Directory was created                       */
-    int                         dir_created;
-    /**
-     *  @param  dir_ndx         Directory name index                        */
-    int                         dir_ndx;
+     *  @param  archive_count   Number of nested archives extracted         */
+    atomic_int                      archive_count;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
-    //  Create the file-list
-    file_list_p = list_new( );
+    atomic_init( &archive_count, 0 );
 
-    //  Reset the number of unzipped files.
-    unzip_count = 0;
+    //  Create the directory to extract into
+    if (    ( mkdir( extract_to_p, S_IRWXU | S_IRWXG | S_IRWXO ) != 0 )
+         && ( errno != EEXIST ) )
+    {
+        //  Something bad happened.
+        log_write( MID_FATAL, "file_zip_extract",
+                   "Unable to create '%s' because: %s\n",
+                   extract_to_p, strerror( errno ) );
+    }
 
     /************************************************************************
-     *  Function
+     *  Function Exit
      ************************************************************************/
 
-    //  Keep looping until there are no more "*.zip" files
-    do
-    {
-        //  Assume that we will NOT find a "*.zip" file
-        found_zip = false;
-
-        //  Build the file list
-        file_ls( file_list_p, path_p, "zip" );
+    //  DONE!
+    return( FILE__zip_file( zip_name_p, extract_to_p, 0,
+                            &archive_count ) );
+}
 
-        //  Scan the list
-        for( file_info_p = list_get_first( file_list_p );
-             file_info_p != NULL;
-             file_info_p = list_get_next( file_list_p, file_info_p ) )
-        {
-            //  Remove it from the list
-            list_delete_payload( file_list_p, file_info_p );
+/****************************************************************************/
+/**
+ *  Recursively find and extract all "*.zip" files in the target directory.
+ *
+ *  @param  dir_p               Pointer to the starting directory
+ *
+ *  @return unzip_count         Number of archives extracted.
+ *
+ *  @note
+ *      Each archive is extracted into a new directory next to it and then
+ *      deleted.  Archives inside of archives are extracted as soon as
+ *      they are written, so one pass over the directory tree finds them
+ *      all.  The archives
+ *      are extracted in parallel by the file_walk() threads.
+ *
+ ****************************************************************************/
 
-            //  Will the fully qualified file name will fit in the buffer ?
-            if (     (   ( strlen( file_info_p->dir_name  ) )
-                       + ( strlen( file_info_p->file_name ) ) )
-                  >= ( sizeof( file_name ) ) )
-            {
-                //  NO:     This is bad..
-                log_write( MID_WARNING, "file_unzip",
-                              "The file name is too big for the buffer provided. \n" );
-                log_write( MID_FATAL, "file_unzip",
-                              "'%s/%s'\n",
-                              file_info_p->dir_name, file_info_p->file_name );
-            }
-            else
-            {
-                //  YES:    build the full file name.
-                snprintf( file_name, sizeof( file_name ) - 1,
-                           "%s/%s",
-                           file_info_p->dir_name, file_info_p->file_name );
-                snprintf( extract_to, sizeof( extract_to ) - 1,
-                           "%s/%s",
-                           file_info_p->dir_name, file_info_p->file_name );
-            }
+int
+file_unzip(
+    char                    *   path_p
+    )
+{
+    /**
+     *  @param  unzip_count     Number of files UnZipped                    */
+    atomic_int                  unzip_count;
 
-            //  Find the file extension
-            tmp_p = strrchr( extract_to, '.' );
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
 
-            //  Is there one ?
-            if ( tmp_p != NULL )
-            {
-                //  YES:    Is this a "*.zip" file ?
-                if ( strncasecmp( ++tmp_p, "zip", 3 ) == 0 )
-                {
-                    //  YES:    Null terminate at the period
-                    (--tmp_p)[ 0 ] = '\0';
-
-                    //  Save the directory name
-                    strncpy( saved_dir_name, extract_to, sizeof( saved_dir_name ) );
-
-                    //  Initialize the directory index value
-                    dir_ndx = 0;
-#if 1
-                    do
-                    {
-                        //  Create a directory to extract into.
-                        dir_created = mkdir( extract_to, S_IRWXU | S_IRWXG | S_IRWXO );
-
-                        //  Was the directory creation successful ?
-                        if ( dir_created == 0 )
-                        {
-                            //  YES:    Log it.
-                            log_write( MID_INFO, "file_unzip",
-                                      "Extracting: '%s'\n", file_name );
-
-                            // Build the unzip command
-                            snprintf( command, sizeof ( command ),
-                                     "unzip -q -o \"%s\" -d \"%s\"",
-                                     file_name,
-                                     extract_to );
-
-                            // Uncompress the file into the new directory
-                            system( command );
-
-                            //  Finally, delete the zip file.
-                            remove( file_name );
-
-                            //  Change the flag, we extracted a "*.zip" file
-                            found_zip = true;
-
-                            //  Increment the number of files unzipped
-                            unzip_count += 1;
-                        }
-                        else
-                        {
-                            //  NO:     Does the directory already exist ?
-                            if ( errno == EEXIST )
-                            {
-                                //  YES:    Increment the index and try again
-                                snprintf( extract_to, sizeof( extract_to ),
-                                         "%s_%02d", saved_dir_name, ++dir_ndx );
-                            }
-                            else
-                            {
-                                //  NO:     Something bad happened.
-                                log_write( MID_FATAL, "file_unzip", "%s\n",
-                                           "Unable to create the extraction "
-                                           "directory because: %s\n",
-                                           strerror( errno ) );
-                            }
-                        }
-
-                    }   while( dir_created != 0 );
-#else
-                    //  Make a new directory for the uncompressed file(s).
-                    if ( mkdir( extract_to, S_IRWXU | S_IRWXG | S_IRWXO ) == 0 )
-                    {
-                        //  YES:    Log it.
-                        log_write( MID_INFO, "file_unzip",
-                                  "Extracting: '%s'\n", file_name );
-
-                        // Build the unzip command
-                        snprintf( command, sizeof ( command ),
-                                 "unzip -q -o \"%s\" -d \"%s\"",
-                                 file_name,
-                                 extract_to );
-
-                        // Uncompress the file into the new directory
-                        system( command );
-
-                        //  Finally, delete the zip file.
-                        remove( file_name );
-
-                        //  Change the flag, we extracted a "*.zip" file
-                        found_zip = true;
-
-                        //  Increment the number of files unzipped
-                        unzip_count += 1;
-                    }
-#endif
-                }
-            }
+    //  Reset the number of unzipped files.
+    atomic_init( &unzip_count, 0 );
 
-            //  Release storage for the File Information structure
-            mem_free( file_info_p );
-        }
+    /************************************************************************
+     *  Function
+     ************************************************************************/
 
-    }   while( found_zip == true );
+    //  Extract every "*.zip" file
+    file_walk( path_p, "zip", FILE__unzip_found, &unzip_count, 0 );
 
     /************************************************************************
      *  Function Exit
      ************************************************************************/
 
-    //  Create the file-list
-    list_kill( file_list_p );
-
     //  DONE!
-    return( unzip_count );
+    return( atomic_load( &unzip_count ) );
 }
 
 /****************************************************************************/
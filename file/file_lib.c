@@ -17,6 +17,7 @@
  *  Compiler directives
  ****************************************************************************/
 
+#define _GNU_SOURCE             //  copy_file_range()
 
 /****************************************************************************
  * System Function API
@@ -26,6 +27,19 @@
 #include <stdint.h>             //  Alternative storage types
 #include <stdbool.h>            //  TRUE, FALSE, etc.
                                 //*******************************************
+#include <string.h>             //  Functions for managing strings
+#include <errno.h>              //  Defines the integer variable errno
+#include <unistd.h>             //  read()
+#include <sys/time.h>           //  gettimeofday()
+#include <fcntl.h>              //  openat()
+#include <sys/stat.h>           //  fstatat()
+#include <dirent.h>             //  fdopendir(), readdir()
+#include <stdio.h>              //  snprintf(), remove()
+#include <strings.h>            //  strncasecmp()
+#include <time.h>               //  mktime()
+#include <sys/mman.h>           //  mmap(), munmap()
+#include <sys/sendfile.h>       //  sendfile()
+                                //*******************************************
 
 /****************************************************************************
  * Application APIs
@@ -63,6 +77,52 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+/**
+ *  One time creation of the CRC table and the fixed Huffman codes         */
+pthread_once_t                      file_zip_once = PTHREAD_ONCE_INIT;
+/**
+ *  CRC-32 of each byte value                                               */
+uint32_t                            file_crc_table[ 256 ];
+/**
+ *  Fixed literal/length and distance codes of deflate                      */
+struct  file_huffman_t              file_fixed_litlen;
+struct  file_huffman_t              file_fixed_dist;
+//----------------------------------------------------------------------------
+/**
+ *  Base value and extra bits of the deflate length symbols 257 - 285      */
+const uint16_t                      file_length_base[ 29 ] =
+{
+      3,    4,    5,    6,    7,    8,    9,   10,   11,   13,
+     15,   17,   19,   23,   27,   31,   35,   43,   51,   59,
+     67,   83,   99,  115,  131,  163,  195,  227,  258
+};
+const uint8_t                       file_length_extra[ 29 ] =
+{
+      0,    0,    0,    0,    0,    0,    0,    0,    1,    1,
+      1,    1,    2,    2,    2,    2,    3,    3,    3,    3,
+      4,    4,    4,    4,    5,    5,    5,    5,    0
+};
+/**
+ *  Base value and extra bits of the deflate distance symbols               */
+const uint16_t                      file_dist_base[ FILE_HUFF_DIST_N ] =
+{
+      1,    2,    3,    4,    5,    7,    9,   13,   17,   25,
+     33,   49,   65,   97,  129,  193,  257,  385,  513,  769,
+   1025, 1537, 2049, 3073, 4097, 6145, 8193,12289,16385,24577
+};
+const uint8_t                       file_dist_extra[ FILE_HUFF_DIST_N ] =
+{
+      0,    0,    0,    0,    1,    1,    2,    2,    3,    3,
+      4,    4,    5,    5,    6,    6,    7,    7,    8,    8,
+      9,    9,   10,   10,   11,   11,   12,   12,   13,   13
+};
+/**
+ *  Order the code length code lengths are sent in                          */
+const uint8_t                       file_code_order[ 19 ] =
+{
+     16,   17,   18,    0,    8,    7,    9,    6,   10,    5,
+     11,    4,   12,    3,   13,    2,   14,    1,   15
+};
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -70,3 +130,4733 @@
  ****************************************************************************/
 
 /****************************************************************************/
+
+/****************************************************************************/
+/**
+ *  Count bytes read and now and then log the transfer rate.
+ *
+ *  @param  bytes_read          Number of bytes just read.
+ *
+ *  @return void
+ *
+ *  @note
+ *      The clock is only read every FILE_RATE_LINES calls, not for every
+ *      line.
+ *
+ ****************************************************************************/
+
+void
+FILE__transfer_rate(
+    size_t                          bytes_read
+    )
+{
+    /**
+     *  @param  rate_bytes      Bytes read since the last log message       */
+    float                           rate_bytes;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Update the total number of bytes read.
+    total_bytes_read += bytes_read;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is it time to look at the clock ?
+    if (    ( ++lines_read      >= FILE_RATE_LINES )
+         || ( time_last.tv_sec ==        0        ) )
+    {
+        //  YES:    What time is it ?
+        lines_read = 0;
+        gettimeofday( &time_now, NULL );
+
+        //  Is the first time through here ?
+        if ( time_last.tv_sec == 0 )
+        {
+            //  YES:    Update the last display time
+            time_last.tv_sec = time_now.tv_sec;
+        }
+
+        //  Is it time to display ?
+        if ( ( time_last.tv_sec + FILE_RATE_SECONDS ) <= time_now.tv_sec )
+        {
+            //  YES:    Update the last display time
+            time_last.tv_sec = time_now.tv_sec;
+
+            //  Is this the first time ?
+            if ( bytes_read_last > 0 )
+            {
+                //  NO:     Calculate the transfer rate.
+                rate_bytes = total_bytes_read - bytes_read_last;
+
+                //  Log the transfer rate
+                log_write( MID_DEBUG_0, "file_read_text",
+                           "Transfer rate: %3.2f KB/s\n",
+                           ( ( rate_bytes / 1000 ) / FILE_RATE_SECONDS ) );
+            }
+
+            //  Save the current count
+            bytes_read_last = total_bytes_read;
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Add one line read from the file to a text line.
+ *
+ *  @param  qp_p                Pointer to the quoted printable decoder.
+ *  @param  piece_p             Pointer to the line as it is in the file,
+ *                              without the line feed.
+ *  @param  piece_l             Number of characters in the line.
+ *  @param  line_buf_p          Pointer to the text line being built.
+ *
+ *  @return eol                 TRUE when the text line is finished, FALSE
+ *                              when the next line continues it.
+ *
+ *  @note
+ *      The line is cleaned up like text_remove_crlf() and
+ *      text_strip_whitespace() would, then a trailing '=' (but not '==')
+ *      is taken as a soft line break.  The rest is decoded from quoted
+ *      printable as it is added.  Nothing is copied or changed in place.
+ *  @note
+ *      The decoder is expected to have qp_p->fractions set, so =BC, =BD
+ *      and =BE become 1/4, 1/2 and 3/4 the same as file_read_text() has
+ *      always done for recipe text.
+ *
+ ****************************************************************************/
+
+int
+FILE__qp_line(
+    struct  text_qp_t           *   qp_p,
+    const char                  *   piece_p,
+    size_t                          piece_l,
+    struct  mem_strbuf_t        *   line_buf_p
+    )
+{
+    /**
+     *  @param  eol             End-Of-Line flag                            */
+    int                             eol;
+    /**
+     *  @param  view            The part of the line that is kept           */
+    struct  text_view_t             view;
+    /**
+     *  @param  nul_p           Pointer to the first x'00                   */
+    const char                  *   nul_p;
+    /**
+     *  @param  cr_p            Pointer to the first CR                     */
+    const char                  *   cr_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Nothing after a x'00 is part of the line
+    nul_p = memchr( piece_p, '\0', piece_l );
+
+    if ( nul_p != NULL )
+    {
+        piece_l = nul_p - piece_p;
+    }
+
+    //  The first CR is treated as a space
+    cr_p = memchr( piece_p, '\r', piece_l );
+
+    /************************************************************************
+     *  Remove any trailing whitespace from the end of the line
+     ************************************************************************/
+
+    view.text_p = piece_p;
+    view.text_l = piece_l;
+    text_view_strip_whitespace( &view );
+
+    //  Is the CR the last thing left ?
+    if (    ( cr_p != NULL )
+         && ( view.text_l == (size_t)( cr_p - piece_p ) + 1 ) )
+    {
+        //  YES:    It goes too
+        view.text_l -= 1;
+        text_view_strip_whitespace( &view );
+    }
+
+    //  Was the CR stripped off ?
+    if (    ( cr_p != NULL )
+         && ( view.text_l <= (size_t)( cr_p - piece_p ) ) )
+    {
+        //  YES:    Forget about it
+        cr_p = NULL;
+    }
+
+    /************************************************************************
+     *  Look for a soft line break
+     ************************************************************************/
+
+    //  Does line of data end with an equals sign '=' ?
+    if (    ( view.text_l > 0 )
+         && ( view.text_p[ view.text_l - 1 ] == '=' )
+         && (    ( view.text_l == 1 )
+              || ( view.text_p[ view.text_l - 2 ] != '=' ) ) )
+    {
+        //  YES:    Strip off the equals sign
+        view.text_l -= 1;
+        eol = false;
+    }
+    else
+    {
+        //  NO:     This is the end of the text line
+        eol = true;
+    }
+
+    /************************************************************************
+     *  Change character coding from quoted printable
+     ************************************************************************/
+
+    //  Is there a CR in the line ?
+    if ( cr_p != NULL )
+    {
+        //  YES:    Decode around it
+        text_qp_decode_stream( qp_p, view.text_p, cr_p - view.text_p,
+                               line_buf_p );
+        text_qp_decode_stream( qp_p, " ", 1, line_buf_p );
+        text_qp_decode_stream( qp_p, &cr_p[ 1 ],
+                               view.text_l - ( cr_p - view.text_p ) - 1,
+                               line_buf_p );
+    }
+    else
+    {
+        //  NO:     Decode all of it
+        text_qp_decode_stream( qp_p, view.text_p, view.text_l, line_buf_p );
+    }
+
+    //  Is the text line finished ?
+    if ( eol == true )
+    {
+        //  YES:    Flush the decoder
+        text_qp_finish( qp_p, line_buf_p );
+
+        //  Make sure it is NUL terminated even if it is empty
+        mem_strbuf_append( line_buf_p, "", 0 );
+
+        //  Remove the CR/LF characters (if present)
+        //  @NOTE:  The line may have ended with =0D
+        text_remove_crlf( line_buf_p->data_p );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( eol );
+}
+
+/****************************************************************************/
+/**
+ *  Read more data into a stream reader's buffer.
+ *
+ *  @param  reader_p            Pointer to a stream reader.
+ *
+ *  @return fill_rc             TRUE when more data was read, FALSE at
+ *                              End-Of-File.
+ *
+ *  @note
+ *      The data that has not been used yet is moved to the front of the
+ *      buffer first.  When that fills the whole buffer the buffer is made
+ *      twice as large.
+ *
+ ****************************************************************************/
+
+int
+FILE__reader_fill(
+    struct  file_reader_t       *   reader_p
+    )
+{
+    /**
+     *  @param  fill_rc         TRUE when more data was read                */
+    int                             fill_rc;
+    /**
+     *  @param  read_l          Number of bytes read                        */
+    ssize_t                         read_l;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    fill_rc = false;
+
+    //  Move the unused data to the front of the buffer
+    reader_p->data_l -= reader_p->next_ndx;
+    memmove( reader_p->data_p, &reader_p->data_p[ reader_p->next_ndx ],
+             reader_p->data_l );
+    reader_p->next_ndx = 0;
+
+    //  Is the buffer full ?
+    if ( reader_p->data_l == reader_p->buffer_l )
+    {
+        //  YES:    Make it larger
+        reader_p->buffer_l *= 2;
+        reader_p->data_p    = mem_realloc( reader_p->data_p,
+                                           reader_p->buffer_l );
+    }
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is there more data to read ?
+    while ( reader_p->eof == false )
+    {
+        //  YES:    Read it
+        read_l = read( reader_p->fd, &reader_p->data_p[ reader_p->data_l ],
+                       reader_p->buffer_l - reader_p->data_l );
+
+        //  Was something read ?
+        if ( read_l > 0 )
+        {
+            //  YES:    Add it to the buffer
+            reader_p->data_l += read_l;
+            fill_rc = true;
+            break;
+        }
+        //  Is this End-Of-File ?
+        else if (    ( read_l == 0 )
+                  || ( errno  != EINTR ) )
+        {
+            //  YES:    There is no more
+            reader_p->eof = true;
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( fill_rc );
+}
+
+/****************************************************************************/
+/**
+ *  Test a file name against an include extension.
+ *
+ *  @param  include_ext_p       Pointer to the (lowercase) extension to
+ *                              include or NULL to include everything.
+ *  @param  path_p              Pointer to the directory name.
+ *  @param  file_name_p         Pointer to the file name.
+ *
+ *  @return include             TRUE when the file is to be included.
+ *
+ *  @note
+ *      The extension is everything after the last period in the full
+ *      name "path/file".  It matches when it starts with include_ext_p
+ *      without regard to case.  A name without any period is always
+ *      included.
+ *
+ ****************************************************************************/
+
+int
+FILE__ext_match(
+    const char                  *   include_ext_p,
+    const char                  *   path_p,
+    const char                  *   file_name_p
+    )
+{
+    /**
+     *  @param  include         TRUE when the file is included              */
+    int                             include;
+    /**
+     *  @param  period_p        Pointer to the last period                  */
+    const char                  *   period_p;
+    /**
+     *  @param  extension       Buffer to hold file extension               */
+    char                            extension[ 10 + 1 ];
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    include = true;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is there a extension include type ?
+    if ( include_ext_p != NULL )
+    {
+        //  YES:    Is there a period in the file name ?
+        if ( ( period_p = strrchr( file_name_p, '.' ) ) != NULL )
+        {
+            //  YES:    Copy the file extension to a new buffer
+            snprintf( extension, sizeof( extension ), "%s", &period_p[ 1 ] );
+        }
+        //  Is there a period in the directory name ?
+        else if ( ( period_p = strrchr( path_p, '.' ) ) != NULL )
+        {
+            //  YES:    The extension runs on into the file name
+            snprintf( extension, sizeof( extension ), "%s/%s",
+                      &period_p[ 1 ], file_name_p );
+        }
+
+        //  Is there a file extension ?
+        if ( period_p != NULL )
+        {
+            //  YES:    Make the file extension all lowercase
+            text_to_lowercase( extension );
+
+            //  Compare the file extension to the include extension.
+            if ( strncmp( include_ext_p, extension,
+                          strlen( include_ext_p ) ) != 0 )
+            {
+                //  NO:     This isn't an include file extension
+                include = false;
+            }
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( include );
+}
+
+/****************************************************************************/
+/**
+ *  Tell if a directory entry is a directory.
+ *
+ *  @param  dir_fd              File descriptor of the open directory.
+ *  @param  entry_p             Pointer to the directory entry.
+ *
+ *  @return is_dir              TRUE when the entry is a directory.
+ *
+ *  @note
+ *      The entry type from readdir() is used when the file system fills
+ *      it in.  Otherwise the entry is looked up with fstatat().  Symbolic
+ *      links are never followed.
+ *
+ ****************************************************************************/
+
+int
+FILE__entry_is_dir(
+    int                             dir_fd,
+    struct  dirent              *   entry_p
+    )
+{
+    /**
+     *  @param  is_dir          TRUE when the entry is a directory          */
+    int                             is_dir;
+    /**
+     *  @param  statbuf         File or Directory state data                */
+    struct  stat                    statbuf;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Does the directory entry say what it is ?
+    if ( entry_p->d_type != DT_UNKNOWN )
+    {
+        //  YES:    Use it
+        is_dir = ( entry_p->d_type == DT_DIR );
+    }
+    else
+    {
+        //  NO:     Look it up without following a symbolic link
+        is_dir = (    ( fstatat( dir_fd, entry_p->d_name, &statbuf,
+                                 AT_SYMLINK_NOFOLLOW ) == 0 )
+                   && ( S_ISDIR( statbuf.st_mode ) ) );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( is_dir );
+}
+
+/****************************************************************************/
+/**
+ *  Add the files in a directory (and all of its subdirectories) to a list.
+ *
+ *  @param  file_list_p         Pointer to a list for the list of files.
+ *  @param  dir_fd              File descriptor of the open directory.  It
+ *                              is closed before returning.
+ *  @param  path_p              Pointer to a MAX_LINE_L buffer holding the
+ *                              name of the directory.  Subdirectory names
+ *                              are built at the end of it.
+ *  @param  path_l              Length of the name in path_p.
+ *  @param  include_ext_p       Pointer to a file extension to include.
+ *  @param  format              TRUE to fill in the date_time and file_size
+ *                              strings.
+ *
+ *  @return void
+ *
+ *  @note
+ *      Everything is looked up relative to the directory's file descriptor
+ *      so no full path names are built for files.  The directory entry
+ *      type tells files from directories and only a file is stat()ed, once,
+ *      for its size and time.  A file system that does not fill in the
+ *      type costs one more fstatat() per entry.
+ *
+ ****************************************************************************/
+
+void
+FILE__scan(
+    struct  list_base_t         *   file_list_p,
+    int                             dir_fd,
+    char                        *   path_p,
+    size_t                          path_l,
+    const char                  *   include_ext_p,
+    int                             format
+    )
+{
+    /**
+     *  @param  directory_p     Directory pointer                           */
+    DIR                         *   directory_p;
+    /**
+     *  @param  entry           Directory information structure             */
+    struct  dirent              *   entry;
+    /**
+     *  @param  statbuf         File or Directory state data                */
+    struct  stat                    statbuf;
+    /**
+     *  @param  file_info_p     Pointer to a file information structure     */
+    struct  file_info_t         *   file_info_p;
+    /**
+     *  @param  sub_fd          File descriptor of a subdirectory           */
+    int                             sub_fd;
+    /**
+     *  @param  name_l          Length of the entry name                    */
+    size_t                          name_l;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Log the progress
+    log_write( MID_DEBUG_0, "file_next",
+               "Scanning: '%s'\n",
+               path_p );
+
+    //  Attempt to read the directory
+    if ( ( directory_p = fdopendir( dir_fd ) ) == NULL )
+    {
+        log_write( MID_FATAL, "file_next",
+                   "File or Directory '%s' does not exist.\n",
+                   path_p );
+    }
+
+    /************************************************************************
+     *  Function Body
+     ************************************************************************/
+
+    while( ( entry = readdir( directory_p ) ) != NULL )
+    {
+        //  Is this a directory ?
+        if ( FILE__entry_is_dir( dir_fd, entry ) == true )
+        {
+            //  YES:    Does the directory name match any of the following ?
+            if (    ( strcmp( entry->d_name, "."        ) == 0 )
+                 || ( strcmp( entry->d_name, ".."       ) == 0 ) )
+            {
+                //  YES:    Exclude it from processing.
+                continue;
+            }
+
+            name_l = strlen( entry->d_name );
+
+            //  Will the full name fit in the buffer ?
+            if ( ( path_l + 1 + name_l ) >= MAX_LINE_L )
+            {
+                //  NO:     Error message
+                log_write( MID_INFO, "file_next",
+                           "Full file name is larger than the allocated "
+                           "buffer\n" );
+                log_write( MID_FATAL, "file_next",
+                           "%s/%s\n", path_p, entry->d_name );
+            }
+
+            //  Open it
+            sub_fd = openat( dir_fd, entry->d_name,
+                             O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC );
+
+            if ( sub_fd < 0 )
+            {
+                log_write( MID_FATAL, "file_next",
+                           "File or Directory '%s/%s' does not exist.\n",
+                           path_p, entry->d_name );
+            }
+
+            //  Build a file list for this directory
+            path_p[ path_l ] = '/';
+            memcpy( &path_p[ path_l + 1 ], entry->d_name, name_l + 1 );
+
+            FILE__scan( file_list_p, sub_fd, path_p, path_l + 1 + name_l,
+                        include_ext_p, format );
+
+            path_p[ path_l ] = '\0';
+        }
+        //  Is this a file with an included extension ?
+        else if ( FILE__ext_match( include_ext_p, path_p,
+                                  entry->d_name ) == true )
+        {
+            //  YES:    Allocate a structure to save the file information
+            file_info_p = mem_malloc( sizeof( struct file_info_t ) );
+
+            //  Save the file information
+            memcpy( file_info_p->dir_name, path_p,
+                    ( path_l < FILE_NAME_L ) ? path_l : FILE_NAME_L );
+
+            strncpy( file_info_p->file_name, entry->d_name,
+                     sizeof( file_info_p->file_name ) - 1 );
+
+            //  Get the file statistics data
+            if ( fstatat( dir_fd, entry->d_name, &statbuf, 0 ) == 0 )
+            {
+                file_info_p->size  = statbuf.st_size;
+                file_info_p->mtime = statbuf.st_mtime;
+
+                //  Are the strings wanted now ?
+                if ( format == true )
+                {
+                    //  YES:    Build them
+                    file_info_format( file_info_p );
+                }
+            }
+
+            //  Add the new file to the list
+            list_put_last( file_list_p, file_info_p );
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  At the end of the directory, close it.  This closes dir_fd.
+    closedir( directory_p );
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Give up a reference to the directory a subdirectory is opened from.
+ *
+ *  @param  parent_p            Pointer to the parent directory.
+ *
+ *  @return void
+ *
+ *  @note
+ *      The last reference closes the directory.
+ *
+ ****************************************************************************/
+
+void
+FILE__walk_release(
+    struct  file_walk_parent_t  *   parent_p
+    )
+{
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Was that the last reference ?
+    if ( atomic_fetch_sub( &parent_p->ref_count, 1 ) == 1 )
+    {
+        //  YES:    Close it
+        close( parent_p->fd );
+        mem_free( parent_p );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Add a directory to a walker thread's deque.
+ *
+ *  @param  walk_p              Pointer to the walk.
+ *  @param  deque_p             Pointer to the deque of the thread that
+ *                              found the directory.
+ *  @param  item_p              Pointer to the directory.  The deque owns
+ *                              its name and parent reference from now on.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+FILE__walk_push(
+    struct  file_walk_t         *   walk_p,
+    struct  file_walk_deque_t   *   deque_p,
+    struct  file_walk_item_t    *   item_p
+    )
+{
+    /**
+     *  @param  queued_l        Number of directories in the deque          */
+    int                             queued_l;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  One more directory to be scanned
+    atomic_fetch_add( &walk_p->pending, 1 );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    pthread_mutex_lock( &deque_p->lock );
+
+    queued_l = deque_p->tail - deque_p->head;
+
+    //  Is the deque full ?
+    if ( deque_p->tail == deque_p->size )
+    {
+        //  YES:    Is more than half of it already taken ?
+        if ( deque_p->head > ( deque_p->size / 2 ) )
+        {
+            //  YES:    Slide what is left to the front
+            memmove( deque_p->item_p, &deque_p->item_p[ deque_p->head ],
+                     queued_l * sizeof( struct file_walk_item_t ) );
+        }
+        else
+        {
+            //  NO:     Make it bigger
+            deque_p->size  *= 2;
+            deque_p->item_p = mem_realloc( deque_p->item_p,
+                                           deque_p->size
+                                         * sizeof( struct file_walk_item_t ) );
+            memmove( deque_p->item_p, &deque_p->item_p[ deque_p->head ],
+                     queued_l * sizeof( struct file_walk_item_t ) );
+        }
+
+        deque_p->head = 0;
+        deque_p->tail = queued_l;
+    }
+
+    deque_p->item_p[ deque_p->tail ] = *item_p;
+    deque_p->tail += 1;
+
+    pthread_mutex_unlock( &deque_p->lock );
+
+    //  Is any thread waiting for work ?
+    if ( atomic_load( &walk_p->idle ) > 0 )
+    {
+        //  YES:    Wake one up
+        pthread_mutex_lock( &walk_p->lock );
+        pthread_cond_signal( &walk_p->work );
+        pthread_mutex_unlock( &walk_p->lock );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Find the next directory for a walker thread to scan.
+ *
+ *  @param  walk_p              Pointer to the walk.
+ *  @param  thread_ndx          Which thread is looking.
+ *  @param  item_p              Pointer to where the directory is returned.
+ *
+ *  @return found               TRUE when a directory was found, FALSE when
+ *                              all of the deques are empty.
+ *
+ *  @note
+ *      A thread takes the directory it found last from its own deque so it
+ *      works depth first.  When its own deque is empty it steals the oldest
+ *      directory, the one closest to the top of the tree, from another
+ *      thread.
+ *
+ ****************************************************************************/
+
+int
+FILE__walk_pop(
+    struct  file_walk_t         *   walk_p,
+    int                             thread_ndx,
+    struct  file_walk_item_t    *   item_p
+    )
+{
+    /**
+     *  @param  found           TRUE when a directory was found             */
+    int                             found;
+    /**
+     *  @param  deque_p         Pointer to the deque being looked at        */
+    struct  file_walk_deque_t   *   deque_p;
+    /**
+     *  @param  ndx             Offset from this thread's deque             */
+    int                             ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    found = false;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    for ( ndx = 0;
+          ( found == false ) && ( ndx < walk_p->thread_count );
+          ndx += 1 )
+    {
+        deque_p = &walk_p->deque_p[ ( thread_ndx + ndx )
+                                    % walk_p->thread_count ];
+
+        pthread_mutex_lock( &deque_p->lock );
+
+        //  Is there anything in this deque ?
+        if ( deque_p->tail > deque_p->head )
+        {
+            //  YES:    Is it this thread's own deque ?
+            if ( ndx == 0 )
+            {
+                //  YES:    Take the newest
+                deque_p->tail -= 1;
+                *item_p = deque_p->item_p[ deque_p->tail ];
+            }
+            else
+            {
+                //  NO:     Steal the oldest
+                *item_p = deque_p->item_p[ deque_p->head ];
+                deque_p->head += 1;
+            }
+
+            found = true;
+        }
+
+        pthread_mutex_unlock( &deque_p->lock );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( found );
+}
+
+/****************************************************************************/
+/**
+ *  Scan one directory of a walk.
+ *
+ *  @param  walk_p              Pointer to the walk.
+ *  @param  deque_p             Pointer to this thread's deque.
+ *  @param  item_p              Pointer to the directory.
+ *  @param  file_info_p         Pointer to this thread's file information
+ *                              structure that is passed to the callback.
+ *
+ *  @return void
+ *
+ *  @note
+ *      Subdirectories are added to the deque for any thread to scan and
+ *      every included file is passed to the callback right away.
+ *  @note
+ *      A subdirectory is opened with openat() from its parent without
+ *      following a symbolic link, so a directory that is replaced by a
+ *      link after it was found can't lead the walk out of the tree.
+ *
+ ****************************************************************************/
+
+void
+FILE__walk_dir(
+    struct  file_walk_t         *   walk_p,
+    struct  file_walk_deque_t   *   deque_p,
+    struct  file_walk_item_t    *   item_p,
+    struct  file_info_t         *   file_info_p
+    )
+{
+    /**
+     *  @param  directory_p     Directory pointer                           */
+    DIR                         *   directory_p;
+    /**
+     *  @param  entry           Directory information structure             */
+    struct  dirent              *   entry;
+    /**
+     *  @param  statbuf         File state data                             */
+    struct  stat                    statbuf;
+    /**
+     *  @param  dir_fd          Directory file descriptor                   */
+    int                             dir_fd;
+    /**
+     *  @param  path_l          Length of the directory name                */
+    size_t                          path_l;
+    /**
+     *  @param  name_l          Length of the entry name                    */
+    size_t                          name_l;
+    /**
+     *  @param  path_p          Name of the directory                       */
+    const char                  *   path_p;
+    /**
+     *  @param  parent_p        This directory, for its subdirectories      */
+    struct  file_walk_parent_t  *   parent_p;
+    /**
+     *  @param  sub_item        A subdirectory                              */
+    struct  file_walk_item_t        sub_item;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    path_p   = item_p->path_p;
+    parent_p = NULL;
+
+    //  Log the progress
+    log_write( MID_DEBUG_0, "file_walk",
+               "Scanning: '%s'\n",
+               path_p );
+
+    path_l = strlen( path_p );
+
+    //  Every file in this directory has the same directory name
+    memset( file_info_p, 0x00, sizeof( struct file_info_t ) );
+    memcpy( file_info_p->dir_name, path_p,
+            ( path_l < FILE_NAME_L ) ? path_l : FILE_NAME_L );
+
+    //  Is this the starting directory ?
+    if ( item_p->parent_p == NULL )
+    {
+        //  YES:    Attempt to open the directory
+        dir_fd = open( path_p, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+    }
+    else
+    {
+        //  NO:     Open it from its parent and let go of the parent
+        dir_fd = openat( item_p->parent_p->fd, &path_p[ item_p->name_ndx ],
+                         O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC );
+        FILE__walk_release( item_p->parent_p );
+    }
+
+    if (    ( dir_fd < 0 )
+         || ( ( directory_p = fdopendir( dir_fd ) ) == NULL ) )
+    {
+        //  NO:     Skip it
+        log_write( MID_WARNING, "file_walk",
+                   "Unable to open directory '%s'\n",
+                   path_p );
+
+        if ( dir_fd >= 0 )
+        {
+            close( dir_fd );
+        }
+
+        return;
+    }
+
+    /************************************************************************
+     *  Function Body
+     ************************************************************************/
+
+    while( ( entry = readdir( directory_p ) ) != NULL )
+    {
+        //  Is this a directory ?
+        if ( FILE__entry_is_dir( dir_fd, entry ) == true )
+        {
+            //  YES:    Does the directory name match any of the following ?
+            if (    ( strcmp( entry->d_name, "."        ) == 0 )
+                 || ( strcmp( entry->d_name, ".."       ) == 0 ) )
+            {
+                //  YES:    Exclude it from processing.
+                continue;
+            }
+
+            //  Is this the first subdirectory ?
+            if ( parent_p == NULL )
+            {
+                //  YES:    Keep a descriptor to open them from.
+                parent_p = mem_malloc( sizeof( struct file_walk_parent_t ) );
+                parent_p->fd = fcntl( dir_fd, F_DUPFD_CLOEXEC, 0 );
+
+                //  Was the descriptor duplicated ?
+                if ( parent_p->fd < 0 )
+                {
+                    //  NO:     Skip the subdirectories
+                    log_write( MID_WARNING, "file_walk",
+                               "Unable to open the subdirectories of '%s'\n",
+                               path_p );
+                    mem_free( parent_p );
+                    parent_p = NULL;
+                    continue;
+                }
+
+                //  This scan holds a reference until it is done
+                atomic_init( &parent_p->ref_count, 1 );
+            }
+
+            //  Build the subdirectory name and queue it
+            name_l = strlen( entry->d_name );
+            sub_item.parent_p = parent_p;
+            sub_item.name_ndx = path_l + 1;
+            sub_item.path_p   = mem_malloc_nozero( path_l + 1 + name_l + 1 );
+
+            memcpy( sub_item.path_p, path_p, path_l );
+            sub_item.path_p[ path_l ] = '/';
+            memcpy( &sub_item.path_p[ path_l + 1 ], entry->d_name,
+                    name_l + 1 );
+
+            atomic_fetch_add( &parent_p->ref_count, 1 );
+            FILE__walk_push( walk_p, deque_p, &sub_item );
+        }
+        //  Is this a file with an included extension ?
+        else if ( FILE__ext_match( walk_p->include_ext_p, path_p,
+                                   entry->d_name ) == true )
+        {
+            //  YES:    Fill in the file information
+            strncpy( file_info_p->file_name, entry->d_name,
+                     sizeof( file_info_p->file_name ) - 1 );
+
+            if ( fstatat( dir_fd, entry->d_name, &statbuf, 0 ) == 0 )
+            {
+                file_info_p->size  = statbuf.st_size;
+                file_info_p->mtime = statbuf.st_mtime;
+            }
+            else
+            {
+                file_info_p->size  = 0;
+                file_info_p->mtime = 0;
+            }
+
+            file_info_p->date_time[ 0 ] = '\0';
+            file_info_p->file_size[ 0 ] = '\0';
+
+            //  Hand it over
+            atomic_fetch_add( &walk_p->file_count, 1 );
+            walk_p->callback_p( walk_p->parm_p, file_info_p );
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  At the end of the directory, close it.  This closes dir_fd.
+    closedir( directory_p );
+
+    //  Were any subdirectories queued ?
+    if ( parent_p != NULL )
+    {
+        //  YES:    The last one to be opened closes the parent.
+        FILE__walk_release( parent_p );
+    }
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  A walker thread.  It scans directories until there are none left.
+ *
+ *  @param  void_p              Pointer to the walk thread's
+ *                              struct file_walk_thread_t.
+ *
+ *  @return void
+ *
+ *  @note
+ *      A thread that finds nothing to do waits on walk_p->work.  When the
+ *      last directory is finished (pending reaches zero) every thread is
+ *      woken up and leaves.
+ *
+ ****************************************************************************/
+
+void
+FILE__walk_thread(
+    void                        *   void_p
+    )
+{
+    /**
+     *  @param  thread_p        Pointer to this thread's information        */
+    struct  file_walk_thread_t  *   thread_p;
+    /**
+     *  @param  walk_p          Pointer to the walk                         */
+    struct  file_walk_t         *   walk_p;
+    /**
+     *  @param  item            The directory to scan                       */
+    struct  file_walk_item_t        item;
+    /**
+     *  @param  found           TRUE when there is a directory to scan      */
+    int                             found;
+    /**
+     *  @param  file_info       Passed to the callback                      */
+    struct  file_info_t             file_info;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    thread_p = void_p;
+    walk_p   = thread_p->walk_p;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    while ( true )
+    {
+        //  Is there a directory to scan ?
+        found = FILE__walk_pop( walk_p, thread_p->thread_ndx, &item );
+
+        if ( found == false )
+        {
+            //  NO:     Wait for another thread to find one
+            pthread_mutex_lock( &walk_p->lock );
+            atomic_fetch_add( &walk_p->idle, 1 );
+
+            //  Look again now that pushers know someone may be waiting
+            while (    ( atomic_load( &walk_p->pending ) > 0 )
+                    && ( ( found = FILE__walk_pop( walk_p,
+                                                   thread_p->thread_ndx,
+                                                   &item ) ) == false ) )
+            {
+                pthread_cond_wait( &walk_p->work, &walk_p->lock );
+            }
+
+            atomic_fetch_sub( &walk_p->idle, 1 );
+            pthread_mutex_unlock( &walk_p->lock );
+
+            //  Is the walk finished ?
+            if ( found == false )
+            {
+                //  YES:    Leave
+                break;
+            }
+        }
+
+        //  Scan it
+        FILE__walk_dir( walk_p, &walk_p->deque_p[ thread_p->thread_ndx ],
+                        &item, &file_info );
+        mem_free( item.path_p );
+
+        //  Was that the last one ?
+        if ( atomic_fetch_sub( &walk_p->pending, 1 ) == 1 )
+        {
+            //  YES:    Wake everyone up to leave
+            pthread_mutex_lock( &walk_p->lock );
+            pthread_cond_broadcast( &walk_p->work );
+            pthread_mutex_unlock( &walk_p->lock );
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  Tell file_walk() this thread is done with the walk
+    pthread_mutex_lock( &walk_p->lock );
+    walk_p->running -= 1;
+    pthread_cond_signal( &walk_p->done );
+    pthread_mutex_unlock( &walk_p->lock );
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Build the CRC-32 table and the fixed Huffman codes of deflate.
+ *  Called once through file_zip_once.
+ *
+ *  @param  void
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+FILE__zip_init(
+    void
+    )
+{
+    /**
+     *  @param  crc             CRC being built                             */
+    uint32_t                        crc;
+    /**
+     *  @param  length          Code lengths of the fixed codes             */
+    uint8_t                         length[ FILE_HUFF_LITLEN_N ];
+    /**
+     *  @param  ndx             Index                                       */
+    int                             ndx;
+    /**
+     *  @param  bit_ndx         Bit index                                   */
+    int                             bit_ndx;
+
+    /************************************************************************
+     *  CRC-32 (polynomial 0xEDB88320)
+     ************************************************************************/
+
+    for ( ndx = 0; ndx < 256; ndx += 1 )
+    {
+        crc = ndx;
+
+        for ( bit_ndx = 0; bit_ndx < 8; bit_ndx += 1 )
+        {
+            crc = ( crc & 1 ) ? ( crc >> 1 ) ^ 0xEDB88320 : ( crc >> 1 );
+        }
+
+        file_crc_table[ ndx ] = crc;
+    }
+
+    /************************************************************************
+     *  Fixed Huffman codes (RFC 1951 3.2.6)
+     ************************************************************************/
+
+    for ( ndx = 0; ndx < FILE_HUFF_LITLEN_N; ndx += 1 )
+    {
+        length[ ndx ] = ( ndx < 144 ) ? 8
+                      : ( ndx < 256 ) ? 9
+                      : ( ndx < 280 ) ? 7
+                      :                 8;
+    }
+
+    FILE__huffman_build( &file_fixed_litlen, length, FILE_HUFF_LITLEN_N );
+
+    for ( ndx = 0; ndx < FILE_HUFF_DIST_N; ndx += 1 )
+    {
+        length[ ndx ] = 5;
+    }
+
+    FILE__huffman_build( &file_fixed_dist, length, FILE_HUFF_DIST_N );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Compute the CRC-32 of a block of data, the way ZIP does.
+ *
+ *  @param  crc                 CRC-32 of the data before this block, or 0
+ *                              for the first block.
+ *  @param  data_p              Pointer to the data.
+ *  @param  data_l              Number of bytes of data.
+ *
+ *  @return crc                 The CRC-32 of the data so far.
+ *
+ ****************************************************************************/
+
+uint32_t
+FILE__crc32(
+    uint32_t                        crc,
+    const uint8_t               *   data_p,
+    size_t                          data_l
+    )
+{
+    /**
+     *  @param  ndx             Index into the data                         */
+    size_t                          ndx;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    crc ^= 0xFFFFFFFF;
+
+    for ( ndx = 0; ndx < data_l; ndx += 1 )
+    {
+        crc = file_crc_table[ ( crc ^ data_p[ ndx ] ) & 0xFF ] ^ ( crc >> 8 );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( crc ^ 0xFFFFFFFF );
+}
+
+/****************************************************************************/
+/**
+ *  Write the next block of an extracted file.
+ *
+ *  @param  fd                  File descriptor of the file.
+ *  @param  data_p              Pointer to the data.
+ *  @param  data_l              Number of bytes of data.
+ *  @param  crc_p               Pointer to the CRC-32 of what was written
+ *                              so far.  It is updated.
+ *
+ *  @return put_rc              TRUE when all of it was written, FALSE
+ *                              (with errno set) when it was not.
+ *
+ ****************************************************************************/
+
+int
+FILE__zip_put(
+    int                             fd,
+    const uint8_t               *   data_p,
+    size_t                          data_l,
+    uint32_t                    *   crc_p
+    )
+{
+    /**
+     *  @param  write_l         Number of bytes written                     */
+    ssize_t                         write_l;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    *crc_p = FILE__crc32( *crc_p, data_p, data_l );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    while ( data_l > 0 )
+    {
+        write_l = write( fd, data_p, data_l );
+
+        if ( write_l < 0 )
+        {
+            //  Was it interrupted ?
+            if ( errno == EINTR )
+            {
+                //  YES:    Try again
+                continue;
+            }
+
+            return( false );
+        }
+
+        data_p += write_l;
+        data_l -= write_l;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( true );
+}
+
+/****************************************************************************/
+/**
+ *  Build the decoding tables of a canonical Huffman code.
+ *
+ *  @param  huffman_p           Pointer to the tables to build.
+ *  @param  length_p            Code length of each symbol (0 = not used).
+ *  @param  symbol_n            Number of symbols.
+ *
+ *  @return build_rc            TRUE when the code is usable, FALSE when
+ *                              there are more codes than lengths allow.
+ *
+ *  @note
+ *      Codes up to FILE_HUFF_FAST_BITS long are decoded with a single
+ *      look up in fast[].  An incomplete code is allowed; using one of
+ *      its missing codes is caught when decoding.
+ *
+ ****************************************************************************/
+
+int
+FILE__huffman_build(
+    struct  file_huffman_t      *   huffman_p,
+    const uint8_t               *   length_p,
+    int                             symbol_n
+    )
+{
+    /**
+     *  @param  offset          First symbol[] slot for each code length    */
+    uint16_t                        offset[ FILE_HUFF_MAX_BITS + 2 ];
+    /**
+     *  @param  left            Number of codes not used yet                */
+    int                             left;
+    /**
+     *  @param  code            Canonical code                              */
+    int                             code;
+    /**
+     *  @param  reversed        The code with its bits reversed             */
+    int                             reversed;
+    /**
+     *  @param  len             Code length                                 */
+    int                             len;
+    /**
+     *  @param  ndx             Index                                       */
+    int                             ndx;
+    /**
+     *  @param  bit_ndx         Bit index                                   */
+    int                             bit_ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    memset( huffman_p->fast,  0x00, sizeof( huffman_p->fast  ) );
+    memset( huffman_p->count, 0x00, sizeof( huffman_p->count ) );
+
+    /************************************************************************
+     *  Count the codes of each length
+     ************************************************************************/
+
+    for ( ndx = 0; ndx < symbol_n; ndx += 1 )
+    {
+        huffman_p->count[ length_p[ ndx ] ] += 1;
+    }
+
+    huffman_p->count[ 0 ] = 0;
+
+    //  Are there too many codes of any length ?
+    for ( len = 1, left = 1; len <= FILE_HUFF_MAX_BITS; len += 1 )
+    {
+        left = ( left << 1 ) - huffman_p->count[ len ];
+
+        if ( left < 0 )
+        {
+            //  YES:    This is not a code
+            return( false );
+        }
+    }
+
+    /************************************************************************
+     *  Sort the symbols by code
+     ************************************************************************/
+
+    offset[ 1 ] = 0;
+
+    for ( len = 1; len <= FILE_HUFF_MAX_BITS; len += 1 )
+    {
+        offset[ len + 1 ] = offset[ len ] + huffman_p->count[ len ];
+    }
+
+    for ( ndx = 0; ndx < symbol_n; ndx += 1 )
+    {
+        if ( length_p[ ndx ] != 0 )
+        {
+            huffman_p->symbol[ offset[ length_p[ ndx ] ]++ ] = ndx;
+        }
+    }
+
+    /************************************************************************
+     *  Fill in the fast look up table
+     ************************************************************************/
+
+    for ( len = 1, code = 0, ndx = 0; len <= FILE_HUFF_FAST_BITS; len += 1 )
+    {
+        for ( left = huffman_p->count[ len ]; left > 0; left -= 1 )
+        {
+            //  The code is sent most significant bit first
+            for ( bit_ndx = 0, reversed = 0; bit_ndx < len; bit_ndx += 1 )
+            {
+                reversed |= ( ( code >> bit_ndx ) & 1 )
+                            << ( len - 1 - bit_ndx );
+            }
+
+            //  Every index that starts with the code decodes to it
+            for ( ; reversed < ( 1 << FILE_HUFF_FAST_BITS );
+                  reversed += ( 1 << len ) )
+            {
+                huffman_p->fast[ reversed ] = ( huffman_p->symbol[ ndx ] << 4 )
+                                            | len;
+            }
+
+            code += 1;
+            ndx  += 1;
+        }
+
+        code <<= 1;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( true );
+}
+
+/****************************************************************************/
+/**
+ *  Make sure the bit buffer holds enough bits.
+ *
+ *  @param  inflate_p           Pointer to the inflate state.
+ *  @param  bits_l              Number of bits needed (up to 56).
+ *
+ *  @return need_rc             TRUE when the bits are there, FALSE when
+ *                              the deflated data ran out.
+ *
+ ****************************************************************************/
+
+int
+FILE__inflate_need(
+    struct  file_inflate_t      *   inflate_p,
+    int                             bits_l
+    )
+{
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Top off the bit buffer
+    while (    ( inflate_p->bits_l <= 56 )
+            && ( inflate_p->in_ndx < inflate_p->in_l ) )
+    {
+        inflate_p->bits   |= (uint64_t)inflate_p->in_p[ inflate_p->in_ndx ]
+                             << inflate_p->bits_l;
+        inflate_p->in_ndx += 1;
+        inflate_p->bits_l += 8;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( inflate_p->bits_l >= bits_l );
+}
+
+/****************************************************************************/
+/**
+ *  Write what has been inflated into the buffer but not written yet.
+ *
+ *  @param  inflate_p           Pointer to the inflate state.
+ *
+ *  @return flush_rc            TRUE when it was written, FALSE when it
+ *                              could not be (errno is set) or there is
+ *                              more data than the entry is supposed to
+ *                              have (errno is 0).
+ *
+ ****************************************************************************/
+
+int
+FILE__inflate_flush(
+    struct  file_inflate_t      *   inflate_p
+    )
+{
+    /**
+     *  @param  data_l          Number of bytes to write                    */
+    size_t                          data_l;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    data_l = inflate_p->out_ndx - inflate_p->written_ndx;
+
+    //  Is it bigger than it is supposed to be ?
+    if ( data_l > inflate_p->size - inflate_p->total_l )
+    {
+        //  YES:    The data is broken
+        errno = 0;
+        return( false );
+    }
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    if ( FILE__zip_put( inflate_p->fd,
+                        &inflate_p->out_p[ inflate_p->written_ndx ],
+                        data_l, &inflate_p->crc ) == false )
+    {
+        return( false );
+    }
+
+    inflate_p->total_l     += data_l;
+    inflate_p->written_ndx  = inflate_p->out_ndx;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( true );
+}
+
+/****************************************************************************/
+/**
+ *  Make room in the buffer for more inflated data.
+ *
+ *  @param  inflate_p           Pointer to the inflate state.
+ *  @param  need_l              Number of bytes needed (up to
+ *                              FILE_INFLATE_BUFFER_L - FILE_INFLATE_WINDOW_L).
+ *
+ *  @return room_rc             TRUE when there is room, FALSE when the
+ *                              buffer could not be written.
+ *
+ *  @note
+ *      When the buffer is full it is written out and only the last
+ *      FILE_INFLATE_WINDOW_L bytes are kept, which is as far back as a
+ *      match can reach.
+ *
+ ****************************************************************************/
+
+int
+FILE__inflate_room(
+    struct  file_inflate_t      *   inflate_p,
+    size_t                          need_l
+    )
+{
+    /**
+     *  @param  keep_l          Number of bytes kept for matches            */
+    size_t                          keep_l;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Is there already room ?
+    if ( ( inflate_p->out_l - inflate_p->out_ndx ) >= need_l )
+    {
+        //  YES:    Nothing to do
+        return( true );
+    }
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    if ( FILE__inflate_flush( inflate_p ) == false )
+    {
+        return( false );
+    }
+
+    //  Slide the window to the front of the buffer
+    keep_l = ( inflate_p->out_ndx < FILE_INFLATE_WINDOW_L )
+           ? inflate_p->out_ndx : FILE_INFLATE_WINDOW_L;
+
+    memmove( inflate_p->out_p,
+             &inflate_p->out_p[ inflate_p->out_ndx - keep_l ], keep_l );
+
+    inflate_p->out_ndx     = keep_l;
+    inflate_p->written_ndx = keep_l;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( true );
+}
+
+/****************************************************************************/
+/**
+ *  Take some bits off the front of the deflated data.
+ *
+ *  @param  inflate_p           Pointer to the inflate state.
+ *  @param  bits_l              Number of bits (up to 16).
+ *
+ *  @return value               The bits, first bit in the low bit, or -1
+ *                              when the deflated data ran out.
+ *
+ ****************************************************************************/
+
+int
+FILE__inflate_bits(
+    struct  file_inflate_t      *   inflate_p,
+    int                             bits_l
+    )
+{
+    /**
+     *  @param  value           The bits                                    */
+    int                             value;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Are there enough bits ?
+    if ( FILE__inflate_need( inflate_p, bits_l ) == false )
+    {
+        //  NO:     The data is broken
+        return( -1 );
+    }
+
+    value = inflate_p->bits & ( ( 1 << bits_l ) - 1 );
+
+    inflate_p->bits   >>= bits_l;
+    inflate_p->bits_l  -= bits_l;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( value );
+}
+
+/****************************************************************************/
+/**
+ *  Decode the next symbol.
+ *
+ *  @param  inflate_p           Pointer to the inflate state.
+ *  @param  huffman_p           Pointer to the code to decode with.
+ *
+ *  @return symbol              The symbol or -1 for a bad code.
+ *
+ *  @note
+ *      A code longer than FILE_HUFF_FAST_BITS is decoded a bit at a time
+ *      from the canonical counts.
+ *
+ ****************************************************************************/
+
+int
+FILE__inflate_decode(
+    struct  file_inflate_t      *   inflate_p,
+    const struct file_huffman_t *   huffman_p
+    )
+{
+    /**
+     *  @param  entry           Fast table entry                            */
+    int                             entry;
+    /**
+     *  @param  bits            Bits not looked at yet                      */
+    uint64_t                        bits;
+    /**
+     *  @param  code            Code read so far                            */
+    int                             code;
+    /**
+     *  @param  first           First code of the current length            */
+    int                             first;
+    /**
+     *  @param  index           First symbol[] slot of the current length   */
+    int                             index;
+    /**
+     *  @param  len             Code length                                 */
+    int                             len;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    FILE__inflate_need( inflate_p, FILE_HUFF_MAX_BITS );
+
+    /************************************************************************
+     *  Short codes
+     ************************************************************************/
+
+    entry = huffman_p->fast[ inflate_p->bits
+                             & ( ( 1 << FILE_HUFF_FAST_BITS ) - 1 ) ];
+
+    //  Is this a short code ?
+    if ( entry != 0 )
+    {
+        //  YES:    Are all of its bits really there ?
+        if ( ( entry & 0x0F ) > inflate_p->bits_l )
+        {
+            //  NO:     The data is broken
+            return( -1 );
+        }
+
+        inflate_p->bits   >>= ( entry & 0x0F );
+        inflate_p->bits_l  -= ( entry & 0x0F );
+
+        return( entry >> 4 );
+    }
+
+    /************************************************************************
+     *  Long codes
+     ************************************************************************/
+
+    bits  = inflate_p->bits;
+    code  = 0;
+    first = 0;
+    index = 0;
+
+    for ( len = 1;
+          ( len <= FILE_HUFF_MAX_BITS ) && ( len <= inflate_p->bits_l );
+          len += 1 )
+    {
+        code |= bits & 1;
+        bits >>= 1;
+
+        //  Is the code this long ?
+        if ( code - huffman_p->count[ len ] < first )
+        {
+            //  YES:    Use it
+            inflate_p->bits   >>= len;
+            inflate_p->bits_l  -= len;
+
+            return( huffman_p->symbol[ index + ( code - first ) ] );
+        }
+
+        index += huffman_p->count[ len ];
+        first += huffman_p->count[ len ];
+        first <<= 1;
+        code  <<= 1;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!   Not a code
+    return( -1 );
+}
+
+/****************************************************************************/
+/**
+ *  Copy a stored (not compressed) block.
+ *
+ *  @param  inflate_p           Pointer to the inflate state.
+ *
+ *  @return block_rc            TRUE when the block was good.
+ *
+ ****************************************************************************/
+
+int
+FILE__inflate_stored(
+    struct  file_inflate_t      *   inflate_p
+    )
+{
+    /**
+     *  @param  block_l         Size of the block                           */
+    size_t                          block_l;
+    /**
+     *  @param  check_l         One's complement of the size                */
+    size_t                          check_l;
+    /**
+     *  @param  copy_l          Number of bytes copied at once              */
+    size_t                          copy_l;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Skip to the next byte and give back the whole bytes in the buffer
+    inflate_p->in_ndx -= inflate_p->bits_l / 8;
+    inflate_p->bits    = 0;
+    inflate_p->bits_l  = 0;
+
+    //  Is the block header there ?
+    if ( ( inflate_p->in_l - inflate_p->in_ndx ) < 4 )
+    {
+        //  NO:     The data is broken
+        return( false );
+    }
+
+    block_l = FILE__le16( &inflate_p->in_p[ inflate_p->in_ndx     ] );
+    check_l = FILE__le16( &inflate_p->in_p[ inflate_p->in_ndx + 2 ] );
+    inflate_p->in_ndx += 4;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is the block good ?
+    if (    ( block_l != ( ~check_l & 0xFFFF ) )
+         || ( block_l > ( inflate_p->in_l  - inflate_p->in_ndx  ) ) )
+    {
+        //  NO:     The data is broken
+        return( false );
+    }
+
+    //  Copy it as it fits into the buffer
+    while ( block_l > 0 )
+    {
+        if ( FILE__inflate_room( inflate_p, 1 ) == false )
+        {
+            return( false );
+        }
+
+        copy_l = inflate_p->out_l - inflate_p->out_ndx;
+
+        if ( copy_l > block_l )
+        {
+            copy_l = block_l;
+        }
+
+        memcpy( &inflate_p->out_p[ inflate_p->out_ndx ],
+                &inflate_p->in_p[ inflate_p->in_ndx ], copy_l );
+
+        inflate_p->in_ndx  += copy_l;
+        inflate_p->out_ndx += copy_l;
+        block_l            -= copy_l;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( true );
+}
+
+/****************************************************************************/
+/**
+ *  Inflate the literals and matches of a compressed block.
+ *
+ *  @param  inflate_p           Pointer to the inflate state.
+ *  @param  litlen_p            Pointer to the literal/length code.
+ *  @param  dist_p              Pointer to the distance code.
+ *
+ *  @return block_rc            TRUE when the block was good.
+ *
+ ****************************************************************************/
+
+int
+FILE__inflate_codes(
+    struct  file_inflate_t      *   inflate_p,
+    const struct file_huffman_t *   litlen_p,
+    const struct file_huffman_t *   dist_p
+    )
+{
+    /**
+     *  @param  symbol          Decoded symbol                              */
+    int                             symbol;
+    /**
+     *  @param  extra           Extra bits of a length or distance          */
+    int                             extra;
+    /**
+     *  @param  match_l         Length of a match                           */
+    size_t                          match_l;
+    /**
+     *  @param  distance        Distance back to a match                    */
+    size_t                          distance;
+    /**
+     *  @param  from_p          Where a match is copied from                */
+    uint8_t                     *   from_p;
+    /**
+     *  @param  to_p            Where a match is copied to                  */
+    uint8_t                     *   to_p;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    while ( true )
+    {
+        symbol = FILE__inflate_decode( inflate_p, litlen_p );
+
+        //  Is it a literal ?
+        if ( ( symbol >= 0 ) && ( symbol < 256 ) )
+        {
+            //  YES:    Is there room for it ?
+            if ( FILE__inflate_room( inflate_p, 1 ) == false )
+            {
+                //  NO:     It could not be written
+                return( false );
+            }
+
+            inflate_p->out_p[ inflate_p->out_ndx++ ] = symbol;
+            continue;
+        }
+
+        //  Is it the end of the block ?
+        if ( symbol == 256 )
+        {
+            //  YES:    Done with the block
+            break;
+        }
+
+        //  Is it a length ?
+        if ( ( symbol < 257 ) || ( symbol > 285 ) )
+        {
+            //  NO:     The data is broken
+            return( false );
+        }
+
+        //  Get the length of the match
+        symbol -= 257;
+        extra   = FILE__inflate_bits( inflate_p, file_length_extra[ symbol ] );
+        match_l = file_length_base[ symbol ] + extra;
+
+        //  Get the distance to the match
+        symbol = FILE__inflate_decode( inflate_p, dist_p );
+
+        if (    ( extra  <  0 )
+             || ( symbol <  0 )
+             || ( symbol >= FILE_HUFF_DIST_N ) )
+        {
+            //  NO:     The data is broken
+            return( false );
+        }
+
+        extra    = FILE__inflate_bits( inflate_p, file_dist_extra[ symbol ] );
+        distance = file_dist_base[ symbol ] + extra;
+
+        //  Is there room for the match ?
+        if ( FILE__inflate_room( inflate_p, match_l ) == false )
+        {
+            //  NO:     It could not be written
+            return( false );
+        }
+
+        //  Is the match inside of what has been inflated ?
+        if (    ( extra    < 0 )
+             || ( distance > inflate_p->out_ndx ) )
+        {
+            //  NO:     The data is broken
+            return( false );
+        }
+
+        //  Copy the match
+        to_p   = &inflate_p->out_p[ inflate_p->out_ndx ];
+        from_p = to_p - distance;
+        inflate_p->out_ndx += match_l;
+
+        //  Does the match overlap what it is copied to ?
+        if ( distance >= match_l )
+        {
+            //  NO:     Copy it all at once
+            memcpy( to_p, from_p, match_l );
+        }
+        else
+        {
+            //  YES:    Copy a byte at a time so it repeats
+            while ( match_l-- > 0 )
+            {
+                *to_p++ = *from_p++;
+            }
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( true );
+}
+
+/****************************************************************************/
+/**
+ *  Read the codes of a dynamic block and inflate it.
+ *
+ *  @param  inflate_p           Pointer to the inflate state.
+ *
+ *  @return block_rc            TRUE when the block was good.
+ *
+ ****************************************************************************/
+
+int
+FILE__inflate_dynamic(
+    struct  file_inflate_t      *   inflate_p
+    )
+{
+    /**
+     *  @param  litlen          Literal/length code                         */
+    struct  file_huffman_t          litlen;
+    /**
+     *  @param  dist            Distance code (and the code length code)    */
+    struct  file_huffman_t          dist;
+    /**
+     *  @param  length          Code lengths                                */
+    uint8_t                         length[ FILE_HUFF_LITLEN_N
+                                            + FILE_HUFF_DIST_N ];
+    /**
+     *  @param  litlen_n        Number of literal/length codes              */
+    int                             litlen_n;
+    /**
+     *  @param  dist_n          Number of distance codes                    */
+    int                             dist_n;
+    /**
+     *  @param  code_n          Number of code length codes                 */
+    int                             code_n;
+    /**
+     *  @param  symbol          Decoded symbol                              */
+    int                             symbol;
+    /**
+     *  @param  repeat          Length to repeat                            */
+    int                             repeat;
+    /**
+     *  @param  repeat_n        Number of times to repeat it                */
+    int                             repeat_n;
+    /**
+     *  @param  ndx             Index                                       */
+    int                             ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    litlen_n = FILE__inflate_bits( inflate_p, 5 ) + 257;
+    dist_n   = FILE__inflate_bits( inflate_p, 5 ) + 1;
+    code_n   = FILE__inflate_bits( inflate_p, 4 ) + 4;
+
+    if (    ( litlen_n < 257 ) || ( litlen_n > 286 )
+         || ( dist_n   <   1 ) || ( dist_n   >  30 )
+         || ( code_n   <   4 ) )
+    {
+        //  NO:     The data is broken
+        return( false );
+    }
+
+    /************************************************************************
+     *  The code length code
+     ************************************************************************/
+
+    memset( length, 0x00, sizeof( length ) );
+
+    for ( ndx = 0; ndx < code_n; ndx += 1 )
+    {
+        if ( ( symbol = FILE__inflate_bits( inflate_p, 3 ) ) < 0 )
+        {
+            return( false );
+        }
+
+        length[ file_code_order[ ndx ] ] = symbol;
+    }
+
+    if ( FILE__huffman_build( &dist, length, 19 ) == false )
+    {
+        return( false );
+    }
+
+    /************************************************************************
+     *  The literal/length and distance code lengths
+     ************************************************************************/
+
+    for ( ndx = 0; ndx < ( litlen_n + dist_n ); )
+    {
+        symbol = FILE__inflate_decode( inflate_p, &dist );
+
+        //  Is it a code length ?
+        if ( ( symbol >= 0 ) && ( symbol < 16 ) )
+        {
+            //  YES:    Save it
+            length[ ndx++ ] = symbol;
+            continue;
+        }
+
+        //  NO:     It repeats a code length
+        if ( symbol == 16 )
+        {
+            //  Repeat the last length 3 to 6 times
+            if ( ndx == 0 )
+            {
+                return( false );
+            }
+
+            repeat   = length[ ndx - 1 ];
+            repeat_n = FILE__inflate_bits( inflate_p, 2 ) + 3;
+        }
+        else if ( symbol == 17 )
+        {
+            //  Repeat a zero length 3 to 10 times
+            repeat   = 0;
+            repeat_n = FILE__inflate_bits( inflate_p, 3 ) + 3;
+        }
+        else if ( symbol == 18 )
+        {
+            //  Repeat a zero length 11 to 138 times
+            repeat   = 0;
+            repeat_n = FILE__inflate_bits( inflate_p, 7 ) + 11;
+        }
+        else
+        {
+            //  The data is broken
+            return( false );
+        }
+
+        if (    ( repeat_n < 3 )
+             || ( ( ndx + repeat_n ) > ( litlen_n + dist_n ) ) )
+        {
+            return( false );
+        }
+
+        memset( &length[ ndx ], repeat, repeat_n );
+        ndx += repeat_n;
+    }
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Build the codes.  There must be an end of block code.
+    if (    ( length[ 256 ] == 0 )
+         || ( FILE__huffman_build( &litlen, length, litlen_n ) == false )
+         || ( FILE__huffman_build( &dist, &length[ litlen_n ],
+                                   dist_n ) == false ) )
+    {
+        return( false );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( FILE__inflate_codes( inflate_p, &litlen, &dist ) );
+}
+
+/****************************************************************************/
+/**
+ *  Inflate deflated (RFC 1951) data into a file.
+ *
+ *  @param  in_p                Pointer to the deflated data.
+ *  @param  in_l                Size of the deflated data.
+ *  @param  fd                  File descriptor the data is written to.
+ *  @param  size                Exact size of the inflated data.
+ *  @param  crc_p               Pointer to where the CRC-32 of the inflated
+ *                              data is put.
+ *
+ *  @return inflate_rc          TRUE when the data inflated to exactly
+ *                              size bytes, FALSE when it is broken (errno
+ *                              is 0) or could not be written (errno is
+ *                              set).
+ *
+ *  @note
+ *      The data is inflated through a FILE_INFLATE_BUFFER_L buffer and
+ *      written as the buffer fills, so the size of the entry does not
+ *      matter.
+ *
+ ****************************************************************************/
+
+int
+FILE__inflate(
+    const uint8_t               *   in_p,
+    size_t                          in_l,
+    int                             fd,
+    uint64_t                        size,
+    uint32_t                    *   crc_p
+    )
+{
+    /**
+     *  @param  inflate         Inflate state                               */
+    struct  file_inflate_t          inflate;
+    /**
+     *  @param  inflate_rc      TRUE while the data is good                 */
+    int                             inflate_rc;
+    /**
+     *  @param  last            TRUE after the last block                   */
+    int                             last;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    pthread_once( &file_zip_once, FILE__zip_init );
+
+    inflate.in_p        = in_p;
+    inflate.in_l        = in_l;
+    inflate.in_ndx      = 0;
+    inflate.bits        = 0;
+    inflate.bits_l      = 0;
+    inflate.out_p       = mem_malloc_nozero( FILE_INFLATE_BUFFER_L );
+    inflate.out_l       = FILE_INFLATE_BUFFER_L;
+    inflate.out_ndx     = 0;
+    inflate.written_ndx = 0;
+    inflate.fd          = fd;
+    inflate.crc         = 0;
+    inflate.total_l     = 0;
+    inflate.size        = size;
+
+    inflate_rc = true;
+    last       = false;
+    errno      = 0;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    while ( ( inflate_rc == true ) && ( last == false ) )
+    {
+        last = FILE__inflate_bits( &inflate, 1 );
+
+        switch( FILE__inflate_bits( &inflate, 2 ) )
+        {
+            case    0:
+            {
+                inflate_rc = FILE__inflate_stored( &inflate );
+            }   break;
+            case    1:
+            {
+                inflate_rc = FILE__inflate_codes( &inflate, &file_fixed_litlen,
+                                                  &file_fixed_dist );
+            }   break;
+            case    2:
+            {
+                inflate_rc = FILE__inflate_dynamic( &inflate );
+            }   break;
+            default:
+            {
+                //  Block type 3 or out of data
+                inflate_rc = false;
+            }
+        }
+
+        if ( last < 0 )
+        {
+            inflate_rc = false;
+        }
+    }
+
+    //  Write what is left in the buffer
+    if ( inflate_rc == true )
+    {
+        inflate_rc = FILE__inflate_flush( &inflate );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    mem_free( inflate.out_p );
+
+    *crc_p = inflate.crc;
+
+    //  DONE!
+    return( ( inflate_rc == true ) && ( inflate.total_l == size ) );
+}
+
+/****************************************************************************/
+/**
+ *  Read a little endian 16 bit value.
+ *
+ *  @param  data_p              Pointer to the value.
+ *
+ *  @return value               The value.
+ *
+ ****************************************************************************/
+
+uint32_t
+FILE__le16(
+    const uint8_t               *   data_p
+    )
+{
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( (uint32_t)data_p[ 0 ] | ( (uint32_t)data_p[ 1 ] << 8 ) );
+}
+
+/****************************************************************************/
+/**
+ *  Read a little endian 32 bit value.
+ *
+ *  @param  data_p              Pointer to the value.
+ *
+ *  @return value               The value.
+ *
+ ****************************************************************************/
+
+uint32_t
+FILE__le32(
+    const uint8_t               *   data_p
+    )
+{
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( FILE__le16( data_p ) | ( FILE__le16( data_p + 2 ) << 16 ) );
+}
+
+/****************************************************************************/
+/**
+ *  Read a little endian 64 bit value.
+ *
+ *  @param  data_p              Pointer to the value.
+ *
+ *  @return value               The value.
+ *
+ ****************************************************************************/
+
+uint64_t
+FILE__le64(
+    const uint8_t               *   data_p
+    )
+{
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return(   (uint64_t)FILE__le32( data_p )
+            | ( (uint64_t)FILE__le32( data_p + 4 ) << 32 ) );
+}
+
+/****************************************************************************/
+/**
+ *  Create the directory at the front of the extracted file name along
+ *  with any of its parents that are missing.
+ *
+ *  @param  zip_p               Pointer to the extract state.  The directory
+ *                              is the first dir_l bytes of zip_p->path.
+ *  @param  dir_l               Length of the directory name.
+ *
+ *  @return make_rc             TRUE when the directory is there.
+ *
+ *  @note
+ *      Archives list their files a directory at a time, so the directory
+ *      made last is remembered and not made again.
+ *
+ ****************************************************************************/
+
+int
+FILE__make_dirs(
+    struct  file_zip_t          *   zip_p,
+    size_t                          dir_l
+    )
+{
+    /**
+     *  @param  save_char       The character after the directory name      */
+    char                            save_char;
+    /**
+     *  @param  make_rc         Return code                                 */
+    int                             make_rc;
+    /**
+     *  @param  ndx             Index into the name                         */
+    size_t                          ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Was this directory the last one made ?
+    if (    ( strlen( zip_p->made_dir ) == dir_l )
+         && ( memcmp( zip_p->made_dir, zip_p->path, dir_l ) == 0 ) )
+    {
+        //  YES:    It is already there
+        return( true );
+    }
+
+    save_char = zip_p->path[ dir_l ];
+    zip_p->path[ dir_l ] = '\0';
+    make_rc = true;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Make each directory below the extract to directory
+    for ( ndx = zip_p->path_l; ndx <= dir_l; ndx += 1 )
+    {
+        //  Is this the end of a directory name ?
+        if ( ( zip_p->path[ ndx ] == '/' ) || ( ndx == dir_l ) )
+        {
+            //  YES:    Make it
+            zip_p->path[ ndx ] = '\0';
+
+            if (    ( mkdir( zip_p->path, S_IRWXU | S_IRWXG | S_IRWXO ) != 0 )
+                 && ( errno != EEXIST ) )
+            {
+                log_write( MID_WARNING, "FILE__make_dirs",
+                           "Unable to create '%s' because: %s\n",
+                           zip_p->path, strerror( errno ) );
+                make_rc = false;
+            }
+
+            if ( ndx != dir_l )
+            {
+                zip_p->path[ ndx ] = '/';
+            }
+
+            if ( make_rc == false )
+            {
+                break;
+            }
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  Remember it
+    if ( make_rc == true )
+    {
+        memcpy( zip_p->made_dir, zip_p->path, dir_l + 1 );
+    }
+
+    zip_p->path[ dir_l ] = save_char;
+
+    //  DONE!
+    return( make_rc );
+}
+
+/****************************************************************************/
+/**
+ *  Create a new directory to extract an archive into.  When the name is
+ *  taken "_01", "_02", ... is added to it until one is not.
+ *
+ *  @param  extract_to_p        Buffer [FILE_ZIP_PATH_L] holding the name
+ *                              of the directory.  Updated with the name
+ *                              that was created.
+ *  @param  extract_to_l        Length of the directory name.
+ *
+ *  @return dir_rc              TRUE when the directory was created, FALSE
+ *                              (with errno set) when it could not be.
+ *
+ ****************************************************************************/
+
+int
+FILE__unzip_dir(
+    char                        *   extract_to_p,
+    size_t                          extract_to_l
+    )
+{
+    /**
+     *  @param  dir_ndx         Directory name index                        */
+    int                             dir_ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Is there room for the index ?
+    if ( ( extract_to_l + 16 ) >= FILE_ZIP_PATH_L )
+    {
+        //  NO:     The name is too long
+        errno = ENAMETOOLONG;
+        return( false );
+    }
+
+    extract_to_p[ extract_to_l ] = '\0';
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    for ( dir_ndx = 0;
+          mkdir( extract_to_p, S_IRWXU | S_IRWXG | S_IRWXO ) != 0;
+          )
+    {
+        //  Does the directory already exist ?
+        if ( errno != EEXIST )
+        {
+            //  NO:     Something bad happened.
+            return( false );
+        }
+
+        //  YES:    Increment the index and try again
+        snprintf( &extract_to_p[ extract_to_l ], 16, "_%02d", ++dir_ndx );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( true );
+}
+
+/****************************************************************************/
+/**
+ *  Extract the data of an entry into a new temporary file next to where it
+ *  goes.
+ *
+ *  @param  zip_p               Pointer to the extract state.  zip_p->path
+ *                              is the name of the file.
+ *  @param  data_p              Pointer to the (compressed) data.
+ *  @param  comp_size           Size of the (compressed) data.
+ *  @param  size                Size of the extracted data.
+ *  @param  central_p           Pointer to the central directory entry.
+ *  @param  tmp_name_p          Buffer [FILE_ZIP_PATH_L] for the name of
+ *                              the temporary file.
+ *
+ *  @return save_rc             TRUE when the data was extracted and its
+ *                              CRC is good, FALSE (with a warning logged)
+ *                              when it was not.
+ *
+ *  @note
+ *      The data is written as it is inflated and its CRC is computed on
+ *      the way, so no entry is held in memory.  The caller renames the
+ *      temporary file; when the data is bad it is removed and whatever
+ *      was there before is left alone.
+ *  @note
+ *      The file gets the modification time stored in the archive and,
+ *      for archives made on Unix, its permissions.  The temporary name
+ *      is the name with ".unzip" (then "_01", "_02", ...) added, so it
+ *      is never taken for an archive.
+ *
+ ****************************************************************************/
+
+int
+FILE__zip_save(
+    struct  file_zip_t          *   zip_p,
+    const uint8_t               *   data_p,
+    uint64_t                        comp_size,
+    uint64_t                        size,
+    const uint8_t               *   central_p,
+    char                        *   tmp_name_p
+    )
+{
+    /**
+     *  @param  fd              File descriptor of the new file             */
+    int                             fd;
+    /**
+     *  @param  mode            Permissions of the new file                 */
+    mode_t                          mode;
+    /**
+     *  @param  dos_time        MS-DOS time and date of the file            */
+    uint32_t                        dos_time;
+    /**
+     *  @param  date_time       The time and date broken down               */
+    struct  tm                      date_time;
+    /**
+     *  @param  times           Access and modification time                */
+    struct  timespec                times[ 2 ];
+    /**
+     *  @param  crc             CRC-32 of the extracted data                */
+    uint32_t                        crc;
+    /**
+     *  @param  save_rc         TRUE when the data was extracted            */
+    int                             save_rc;
+    /**
+     *  @param  tmp_ndx         Temporary name index                        */
+    int                             tmp_ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Was the archive made on Unix ?
+    mode = 0666;
+
+    if (    ( ( FILE__le16( central_p + 4 ) >> 8 ) == 3 )
+         && ( ( ( FILE__le32( central_p + 38 ) >> 16 ) & 0777 ) != 0 ) )
+    {
+        //  YES:    Use its permissions
+        mode = ( FILE__le32( central_p + 38 ) >> 16 ) & 0777;
+    }
+
+    //  Is there room for the temporary name ?
+    if ( strlen( zip_p->path ) + 16 >= FILE_ZIP_PATH_L )
+    {
+        //  NO:     Skip it
+        log_write( MID_WARNING, "FILE__zip_save",
+                   "Skipping '%s', its name is too long.\n",
+                   zip_p->path );
+        return( false );
+    }
+
+    //  Create the temporary file, it is never an old one
+    for ( tmp_ndx = 0; ; tmp_ndx += 1 )
+    {
+        if ( tmp_ndx == 0 )
+        {
+            snprintf( tmp_name_p, FILE_ZIP_PATH_L, "%s.unzip", zip_p->path );
+        }
+        else
+        {
+            snprintf( tmp_name_p, FILE_ZIP_PATH_L, "%s.unzip_%02d",
+                      zip_p->path, tmp_ndx );
+        }
+
+        fd = open( tmp_name_p, O_WRONLY | O_CREAT | O_EXCL
+                             | O_NOFOLLOW | O_CLOEXEC, mode );
+
+        //  Is the name already taken ?
+        if ( ( fd >= 0 ) || ( errno != EEXIST ) || ( tmp_ndx >= 99 ) )
+        {
+            //  NO:     Use it
+            break;
+        }
+    }
+
+    //  Was the file created ?
+    if ( fd < 0 )
+    {
+        //  NO:     Skip it
+        log_write( MID_WARNING, "FILE__zip_save",
+                   "Unable to create '%s' because: %s\n",
+                   tmp_name_p, strerror( errno ) );
+        return( false );
+    }
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    crc = 0;
+
+    //  Is the data compressed ?
+    if ( FILE__le16( central_p + 10 ) == FILE_ZIP_STORED )
+    {
+        //  NO:     Write it from where it is
+        errno   = 0;
+        save_rc = FILE__zip_put( fd, data_p, size, &crc );
+    }
+    else
+    {
+        //  YES:    Inflate it
+        save_rc = FILE__inflate( data_p, comp_size, fd, size, &crc );
+    }
+
+    //  Was it written ?
+    if ( save_rc == false )
+    {
+        //  NO:     Was the data bad ?
+        if ( errno == 0 )
+        {
+            //  YES:    Say so
+            log_write( MID_WARNING, "FILE__zip_save",
+                       "Skipping '%s', its data is bad.\n", zip_p->path );
+        }
+        else
+        {
+            log_write( MID_WARNING, "FILE__zip_save",
+                       "Unable to write '%s' because: %s\n",
+                       tmp_name_p, strerror( errno ) );
+        }
+    }
+    //  Is the data what was put into the archive ?
+    else if ( crc != FILE__le32( central_p + 16 ) )
+    {
+        //  NO:     Skip it
+        log_write( MID_WARNING, "FILE__zip_save",
+                   "Skipping '%s', its CRC is bad.\n", zip_p->path );
+        save_rc = false;
+    }
+    else
+    {
+        //  YES:    Set the modification time
+        dos_time = FILE__le32( central_p + 12 );
+
+        memset( &date_time, 0x00, sizeof( date_time ) );
+        date_time.tm_sec   = ( dos_time & 0x1F ) * 2;
+        date_time.tm_min   = ( dos_time >>  5 ) & 0x3F;
+        date_time.tm_hour  = ( dos_time >> 11 ) & 0x1F;
+        date_time.tm_mday  = ( dos_time >> 16 ) & 0x1F;
+        date_time.tm_mon   = ( ( dos_time >> 21 ) & 0x0F ) - 1;
+        date_time.tm_year  = ( ( dos_time >> 25 ) & 0x7F ) + 80;
+        date_time.tm_isdst = -1;
+
+        times[ 0 ].tv_sec  = 0;
+        times[ 0 ].tv_nsec = UTIME_OMIT;
+        times[ 1 ].tv_sec  = mktime( &date_time );
+        times[ 1 ].tv_nsec = 0;
+
+        if ( times[ 1 ].tv_sec != (time_t)-1 )
+        {
+            futimens( fd, times );
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    close( fd );
+
+    //  Was it extracted ?
+    if ( save_rc == false )
+    {
+        //  NO:     Throw it away
+        unlink( tmp_name_p );
+    }
+
+    //  DONE!
+    return( save_rc );
+}
+
+/****************************************************************************/
+/**
+ *  Extract one entry of an archive.
+ *
+ *  @param  zip_p               Pointer to the extract state.
+ *  @param  data_p              Pointer to the whole archive.
+ *  @param  data_l              Size of the archive.
+ *  @param  central_p           Pointer to the central directory entry.
+ *                              The caller has checked that all of it is
+ *                              inside of the archive.
+ *
+ *  @return file_count          Number of files extracted.
+ *
+ *  @note
+ *      Each entry is written to a temporary file (see FILE__zip_save())
+ *      and only given its name once its CRC is good.  An entry that is an
+ *      archive is extracted from that file into a new directory and the
+ *      file is removed.  Entries that cannot be extracted safely
+ *      (encrypted, unknown compression, links, names outside of the
+ *      extract to directory, bad CRC) are skipped with a warning.
+ *
+ ****************************************************************************/
+
+int
+FILE__zip_write(
+    struct  file_zip_t          *   zip_p,
+    const uint8_t               *   data_p,
+    size_t                          data_l,
+    const uint8_t               *   central_p
+    )
+{
+    /**
+     *  @param  name_p          Name of the entry                           */
+    const char                  *   name_p;
+    /**
+     *  @param  name_l          Length of the name                          */
+    size_t                          name_l;
+    /**
+     *  @param  extra_p         Extra fields of the entry                   */
+    const uint8_t               *   extra_p;
+    /**
+     *  @param  extra_l         Length of the extra fields                  */
+    size_t                          extra_l;
+    /**
+     *  @param  field_l         Length of one extra field                   */
+    size_t                          field_l;
+    /**
+     *  @param  method          Compression method                          */
+    uint32_t                        method;
+    /**
+     *  @param  size            Size of the extracted entry                 */
+    uint64_t                        size;
+    /**
+     *  @param  comp_size       Size of the compressed entry                */
+    uint64_t                        comp_size;
+    /**
+     *  @param  offset          Offset of the local header                  */
+    uint64_t                        offset;
+    /**
+     *  @param  tmp_name        Name the entry is extracted to first        */
+    char                            tmp_name[ FILE_ZIP_PATH_L ];
+    /**
+     *  @param  extract_to      Directory an archive entry is extracted to  */
+    char                            extract_to[ FILE_ZIP_PATH_L ];
+    /**
+     *  @param  slash_p         Last '/' in the name                        */
+    char                        *   slash_p;
+    /**
+     *  @param  file_count      Number of files extracted                   */
+    int                             file_count;
+    /**
+     *  @param  ndx             Index into the name                         */
+    size_t                          ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    method    = FILE__le16( central_p + 10 );
+    comp_size = FILE__le32( central_p + 20 );
+    size      = FILE__le32( central_p + 24 );
+    offset    = FILE__le32( central_p + 42 );
+    name_p    = (const char *)( central_p + FILE_ZIP_CENTRAL_L );
+    name_l    = FILE__le16( central_p + 28 );
+    extra_p   = central_p + FILE_ZIP_CENTRAL_L + name_l;
+    extra_l   = FILE__le16( central_p + 30 );
+
+
+    /************************************************************************
+     *  ZIP64 sizes and offset
+     ************************************************************************/
+
+    for ( ; extra_l >= 4; extra_p += field_l + 4, extra_l -= field_l + 4 )
+    {
+        field_l = FILE__le16( extra_p + 2 );
+
+        if ( field_l + 4 > extra_l )
+        {
+            break;
+        }
+
+        //  Is this the ZIP64 field ?
+        if ( FILE__le16( extra_p ) == 0x0001 )
+        {
+            //  YES:    It holds the values that did not fit, in order
+            ndx = 4;
+
+            if ( ( size == 0xFFFFFFFF ) && ( ndx + 8 <= field_l + 4 ) )
+            {
+                size = FILE__le64( extra_p + ndx );
+                ndx += 8;
+            }
+            if ( ( comp_size == 0xFFFFFFFF ) && ( ndx + 8 <= field_l + 4 ) )
+            {
+                comp_size = FILE__le64( extra_p + ndx );
+                ndx += 8;
+            }
+            if ( ( offset == 0xFFFFFFFF ) && ( ndx + 8 <= field_l + 4 ) )
+            {
+                offset = FILE__le64( extra_p + ndx );
+            }
+            break;
+        }
+    }
+
+    /************************************************************************
+     *  Check the name
+     ************************************************************************/
+
+    //  Is the name usable ?
+    if (    ( name_l == 0 )
+         || ( memchr( name_p, '\0', name_l ) != NULL )
+         || ( zip_p->path_l + name_l >= sizeof( zip_p->path ) ) )
+    {
+        //  NO:     Skip it
+        log_write( MID_WARNING, "FILE__zip_write",
+                   "Skipping an entry with a bad name.\n" );
+        return( 0 );
+    }
+
+    memcpy( &zip_p->path[ zip_p->path_l ], name_p, name_l );
+    zip_p->path[ zip_p->path_l + name_l ] = '\0';
+
+    //  Would the entry land outside of the extract to directory ?
+    for ( ndx = 0; ndx < name_l; ndx += 1 )
+    {
+        if (    ( ( ndx == 0 ) || ( name_p[ ndx - 1 ] == '/' ) )
+             && (    ( name_p[ ndx ] == '/' )
+                  || (    ( strncmp( &name_p[ ndx ], "..", 2 ) == 0 )
+                       && (    ( ndx + 2 == name_l )
+                            || ( name_p[ ndx + 2 ] == '/' ) ) ) ) )
+        {
+            //  YES:    Skip it
+            log_write( MID_WARNING, "FILE__zip_write",
+                       "Skipping '%s', it is outside of the archive.\n",
+                       &zip_p->path[ zip_p->path_l ] );
+            return( 0 );
+        }
+    }
+
+    //  Is this a directory ?
+    if ( name_p[ name_l - 1 ] == '/' )
+    {
+        //  YES:    Just make it
+        FILE__make_dirs( zip_p, zip_p->path_l + name_l - 1 );
+        return( 0 );
+    }
+
+    /************************************************************************
+     *  Check the entry
+     ************************************************************************/
+
+    //  Is the entry encrypted, a link or compressed some other way ?
+    if ( ( FILE__le16( central_p + 8 ) & 0x0001 ) != 0 )
+    {
+        log_write( MID_WARNING, "FILE__zip_write",
+                   "Skipping '%s', it is encrypted.\n", zip_p->path );
+        return( 0 );
+    }
+    if (    ( ( FILE__le16( central_p + 4 ) >> 8 ) == 3 )
+         && (    ( ( FILE__le32( central_p + 38 ) >> 16 ) & S_IFMT )
+              == S_IFLNK ) )
+    {
+        log_write( MID_WARNING, "FILE__zip_write",
+                   "Skipping '%s', it is a link.\n", zip_p->path );
+        return( 0 );
+    }
+    if ( ( method != FILE_ZIP_STORED ) && ( method != FILE_ZIP_DEFLATED ) )
+    {
+        log_write( MID_WARNING, "FILE__zip_write",
+                   "Skipping '%s', compression method %u is not supported.\n",
+                   zip_p->path, method );
+        return( 0 );
+    }
+
+    //  Is the local header and the data inside of the archive ?
+    if (    ( data_l < FILE_ZIP_LOCAL_L )
+         || ( offset > data_l - FILE_ZIP_LOCAL_L )
+         || ( FILE__le32( data_p + offset ) != FILE_ZIP_LOCAL_SIG ) )
+    {
+        log_write( MID_WARNING, "FILE__zip_write",
+                   "Skipping '%s', its local header is missing.\n",
+                   zip_p->path );
+        return( 0 );
+    }
+
+    offset += FILE_ZIP_LOCAL_L
+            + FILE__le16( data_p + offset + 26 )
+            + FILE__le16( data_p + offset + 28 );
+
+    if (    ( offset > data_l )
+         || ( comp_size > data_l - offset )
+         || ( ( method == FILE_ZIP_STORED ) && ( size != comp_size ) ) )
+    {
+        log_write( MID_WARNING, "FILE__zip_write",
+                   "Skipping '%s', its size is bad.\n", zip_p->path );
+        return( 0 );
+    }
+
+    /************************************************************************
+     *  Extract the data
+     ************************************************************************/
+
+    //  Make the directory it goes into
+    slash_p = strrchr( &zip_p->path[ zip_p->path_l ], '/' );
+
+    if (    ( slash_p != NULL )
+         && ( FILE__make_dirs( zip_p, slash_p - zip_p->path ) == false ) )
+    {
+        return( 0 );
+    }
+
+    //  Was the data extracted ?
+    if ( FILE__zip_save( zip_p, data_p + offset, comp_size, size,
+                         central_p, tmp_name ) == false )
+    {
+        //  NO:     Skip it
+        return( 0 );
+    }
+
+    file_count = -1;
+
+    //  Is this an archive that should be extracted too ?
+    if (    ( zip_p->depth < FILE_ZIP_DEPTH_MAX )
+         && ( name_l > 4 )
+         && ( strncasecmp( &name_p[ name_l - 4 ], ".zip", 4 ) == 0 ) )
+    {
+        //  YES:    Extract it into a new directory
+        memcpy( extract_to, zip_p->path, zip_p->path_l + name_l - 4 );
+
+        if ( FILE__unzip_dir( extract_to,
+                              zip_p->path_l + name_l - 4 ) == true )
+        {
+            file_count = FILE__zip_file( tmp_name, extract_to,
+                                         zip_p->depth + 1,
+                                         zip_p->archive_count_p );
+
+            //  Was it an archive ?
+            if ( file_count < 0 )
+            {
+                //  NO:     Save it as a file
+                rmdir( extract_to );
+            }
+            else
+            {
+                //  YES:    Count it, it is not needed anymore
+                atomic_fetch_add( zip_p->archive_count_p, 1 );
+                unlink( tmp_name );
+            }
+        }
+    }
+
+    //  Does the entry still need to be saved ?
+    if ( file_count < 0 )
+    {
+        //  YES:    Give it its name
+        if ( rename( tmp_name, zip_p->path ) == 0 )
+        {
+            file_count = 1;
+        }
+        else
+        {
+            log_write( MID_WARNING, "FILE__zip_write",
+                       "Unable to rename '%s' to '%s' because: %s\n",
+                       tmp_name, zip_p->path, strerror( errno ) );
+            unlink( tmp_name );
+            file_count = 0;
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( file_count );
+}
+
+/****************************************************************************/
+/**
+ *  Extract every entry of an archive that is in memory.
+ *
+ *  @param  data_p              Pointer to the archive.
+ *  @param  data_l              Size of the archive.
+ *  @param  extract_to_p        Directory to extract into.
+ *  @param  depth               How many archives this one is inside of.
+ *  @param  archive_count_p     Counts the archives found inside of this
+ *                              one.
+ *
+ *  @return file_count          Number of files extracted or -1 when the
+ *                              data is not an archive.
+ *
+ *  @note
+ *      The entries are found through the central directory at the end
+ *      of the archive, the same way unzip finds them.
+ *
+ ****************************************************************************/
+
+int
+FILE__zip_extract(
+    const uint8_t               *   data_p,
+    size_t                          data_l,
+    const char                  *   extract_to_p,
+    int                             depth,
+    atomic_int                  *   archive_count_p
+    )
+{
+    /**
+     *  @param  zip             Extract state                               */
+    struct  file_zip_t              zip;
+    /**
+     *  @param  end_p           End of central directory record            */
+    const uint8_t               *   end_p;
+    /**
+     *  @param  zip64_p         ZIP64 end of central directory record       */
+    const uint8_t               *   zip64_p;
+    /**
+     *  @param  entry_n         Number of entries                           */
+    uint64_t                        entry_n;
+    /**
+     *  @param  central_off     Offset of the central directory             */
+    uint64_t                        central_off;
+    /**
+     *  @param  central_l       Size of the central directory               */
+    uint64_t                        central_l;
+    /**
+     *  @param  entry_l         Size of one central directory entry         */
+    uint64_t                        entry_l;
+    /**
+     *  @param  offset          Offset of a record                          */
+    uint64_t                        offset;
+    /**
+     *  @param  file_count      Number of files extracted                   */
+    int                             file_count;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    pthread_once( &file_zip_once, FILE__zip_init );
+
+    //  Is it big enough to be an archive ?
+    if ( data_l < FILE_ZIP_END_L )
+    {
+        //  NO:     Not an archive
+        return( -1 );
+    }
+
+    /************************************************************************
+     *  Find the end of central directory record
+     ************************************************************************/
+
+    //  It is last, followed only by the archive comment
+    for ( offset = data_l - FILE_ZIP_END_L; ; offset -= 1 )
+    {
+        if ( FILE__le32( data_p + offset ) == FILE_ZIP_END_SIG )
+        {
+            break;
+        }
+
+        if (    ( offset == 0 )
+             || ( data_l - offset >= FILE_ZIP_END_L + FILE_ZIP_COMMENT_L ) )
+        {
+            //  Not an archive
+            return( -1 );
+        }
+    }
+
+    end_p       = data_p + offset;
+    entry_n     = FILE__le16( end_p + 10 );
+    central_l   = FILE__le32( end_p + 12 );
+    central_off = FILE__le32( end_p + 16 );
+
+    //  Is there a ZIP64 end of central directory record ?
+    if (    ( offset >= FILE_ZIP64_LOCATOR_L )
+         && (    FILE__le32( end_p - FILE_ZIP64_LOCATOR_L )
+              == FILE_ZIP64_LOCATOR_SIG ) )
+    {
+        //  YES:    Use it
+        offset = FILE__le64( end_p - FILE_ZIP64_LOCATOR_L + 8 );
+
+        if (    ( data_l < FILE_ZIP64_END_L )
+             || ( offset > data_l - FILE_ZIP64_END_L )
+             || ( FILE__le32( data_p + offset ) != FILE_ZIP64_END_SIG ) )
+        {
+            //  Not an archive
+            return( -1 );
+        }
+
+        zip64_p     = data_p + offset;
+        entry_n     = FILE__le64( zip64_p + 32 );
+        central_l   = FILE__le64( zip64_p + 40 );
+        central_off = FILE__le64( zip64_p + 48 );
+    }
+
+    //  Is the central directory inside of the archive ?
+    if ( ( central_off > data_l ) || ( central_l > data_l - central_off ) )
+    {
+        //  NO:     Not an archive
+        return( -1 );
+    }
+
+    //  Is there room for the name of an extracted file ?
+    zip.path_l = strlen( extract_to_p ) + 1;
+
+    if ( zip.path_l >= sizeof( zip.path ) )
+    {
+        //  NO:     Nothing can be extracted
+        return( -1 );
+    }
+
+    snprintf( zip.path, sizeof( zip.path ), "%s/", extract_to_p );
+    zip.made_dir[ 0 ]     = '\0';
+    zip.depth             = depth;
+    zip.archive_count_p   = archive_count_p;
+
+    file_count = 0;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    for ( offset = central_off;
+          entry_n > 0;
+          offset += entry_l, entry_n -= 1 )
+    {
+        //  Is the entry inside of the central directory ?
+        if (    ( central_off + central_l - offset < FILE_ZIP_CENTRAL_L )
+             || ( FILE__le32( data_p + offset ) != FILE_ZIP_CENTRAL_SIG ) )
+        {
+            //  NO:     The archive is broken
+            log_write( MID_WARNING, "FILE__zip_extract",
+                       "The central directory of '%s' is broken.\n",
+                       extract_to_p );
+            break;
+        }
+
+        entry_l = FILE_ZIP_CENTRAL_L
+                + FILE__le16( data_p + offset + 28 )
+                + FILE__le16( data_p + offset + 30 )
+                + FILE__le16( data_p + offset + 32 );
+
+        if ( central_off + central_l - offset < entry_l )
+        {
+            log_write( MID_WARNING, "FILE__zip_extract",
+                       "The central directory of '%s' is broken.\n",
+                       extract_to_p );
+            break;
+        }
+
+        file_count += FILE__zip_write( &zip, data_p, data_l, data_p + offset );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( file_count );
+}
+
+/****************************************************************************/
+/**
+ *  Extract every entry of an archive file.
+ *
+ *  @param  zip_name_p          Name of the archive.
+ *  @param  extract_to_p        Directory to extract into.
+ *  @param  depth               How many archives this one is inside of.
+ *  @param  archive_count_p     Counts the archives found inside of this
+ *                              one.
+ *
+ *  @return file_count          Number of files extracted or -1 when the
+ *                              file is not an archive.
+ *
+ ****************************************************************************/
+
+int
+FILE__zip_file(
+    const char                  *   zip_name_p,
+    const char                  *   extract_to_p,
+    int                             depth,
+    atomic_int                  *   archive_count_p
+    )
+{
+    /**
+     *  @param  fd              File descriptor of the archive              */
+    int                             fd;
+    /**
+     *  @param  stat_data       File status of the archive                  */
+    struct  stat                    stat_data;
+    /**
+     *  @param  data_p          The mapped archive                          */
+    uint8_t                     *   data_p;
+    /**
+     *  @param  file_count      Number of files extracted                   */
+    int                             file_count;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    fd = open( zip_name_p, O_RDONLY | O_CLOEXEC );
+
+    //  Was the archive opened ?
+    if ( fd < 0 )
+    {
+        //  NO:     Nothing to extract
+        log_write( MID_WARNING, "FILE__zip_file",
+                   "Unable to open '%s' because: %s\n",
+                   zip_name_p, strerror( errno ) );
+        return( -1 );
+    }
+
+    //  Can it be mapped ?
+    if (    ( fstat( fd, &stat_data ) != 0 )
+         || ( S_ISREG( stat_data.st_mode ) == 0 )
+         || ( stat_data.st_size < FILE_ZIP_END_L ) )
+    {
+        //  NO:     It is not an archive
+        close( fd );
+        return( -1 );
+    }
+
+    data_p = mmap( NULL, stat_data.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+
+    if ( data_p == MAP_FAILED )
+    {
+        log_write( MID_WARNING, "FILE__zip_file",
+                   "Unable to map '%s' because: %s\n",
+                   zip_name_p, strerror( errno ) );
+        return( -1 );
+    }
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    file_count = FILE__zip_extract( data_p, stat_data.st_size,
+                                    extract_to_p, depth, archive_count_p );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    munmap( data_p, stat_data.st_size );
+
+    //  DONE!
+    return( file_count );
+}
+
+/****************************************************************************/
+/**
+ *  file_walk() callback of file_unzip().  Extracts a "*.zip" file into a
+ *  new directory next to it and deletes it.
+ *
+ *  @param  parm_p              Pointer to the atomic_int counting the
+ *                              archives that were extracted.
+ *  @param  file_info_p         Pointer to the file information.
+ *
+ *  @return void
+ *
+ *  @note
+ *      An archive that cannot be read is left where it is.
+ *
+ ****************************************************************************/
+
+void
+FILE__unzip_found(
+    void                        *   parm_p,
+    struct  file_info_t         *   file_info_p
+    )
+{
+    /**
+     *  @param  file_name       Name of the archive                         */
+    char                            file_name[ FILE_ZIP_PATH_L ];
+    /**
+     *  @param  extract_to      Name of the directory to extract into       */
+    char                            extract_to[ FILE_ZIP_PATH_L ];
+    /**
+     *  @param  tmp_p           Temporary data pointer                      */
+    char                        *   tmp_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Will the fully qualified file name fit in the buffer ?
+    if (    snprintf( file_name, sizeof( file_name ), "%s/%s",
+                      file_info_p->dir_name, file_info_p->file_name )
+         >= (int)sizeof( file_name ) )
+    {
+        //  NO:     This is bad..
+        log_write( MID_WARNING, "file_unzip",
+                   "The file name is too big for the buffer provided. \n" );
+        log_write( MID_FATAL, "file_unzip",
+                   "'%s/%s'\n",
+                   file_info_p->dir_name, file_info_p->file_name );
+    }
+
+    memcpy( extract_to, file_name, sizeof( extract_to ) );
+
+    //  Is this a "*.zip" file ?
+    tmp_p = strrchr( extract_to, '.' );
+
+    if ( ( tmp_p == NULL ) || ( strncasecmp( tmp_p + 1, "zip", 3 ) != 0 ) )
+    {
+        //  NO:     Leave it alone
+        return;
+    }
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Create a directory to extract into.
+    if ( FILE__unzip_dir( extract_to, tmp_p - extract_to ) == false )
+    {
+        //  Something bad happened.
+        log_write( MID_FATAL, "file_unzip",
+                   "Unable to create the extraction directory "
+                   "because: %s\n", strerror( errno ) );
+    }
+
+    log_write( MID_INFO, "file_unzip",
+               "Extracting: '%s'\n", file_name );
+
+    //  Was the archive extracted ?
+    if ( FILE__zip_file( file_name, extract_to, 0, parm_p ) >= 0 )
+    {
+        //  YES:    Finally, delete the zip file.
+        remove( file_name );
+        atomic_fetch_add( (atomic_int *)parm_p, 1 );
+    }
+    else
+    {
+        //  NO:     Keep it
+        log_write( MID_WARNING, "file_unzip",
+                   "'%s' is not a ZIP archive.\n", file_name );
+        rmdir( extract_to );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Hash a file name for a watched directory's file table.
+ *
+ *  @param  file_name_p         Pointer to the file name.
+ *
+ *  @return hash                The hash value.
+ *
+ ****************************************************************************/
+
+uint32_t
+FILE__watch_hash(
+    const char                  *   file_name_p
+    )
+{
+    /**
+     *  @param  hash            The hash value                              */
+    uint32_t                        hash;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  FNV offset basis
+    hash = 2166136261u;
+
+    /************************************************************************
+     *  Hash the name
+     ************************************************************************/
+
+    for ( ; *file_name_p != '\0'; file_name_p += 1 )
+    {
+        hash ^= (uint8_t)*file_name_p;
+        hash *= 16777619u;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( hash );
+}
+
+/****************************************************************************/
+/**
+ *  Find a file in a watched directory's file table.
+ *
+ *  @param  dir_p               Pointer to the watched directory.
+ *  @param  file_name_p         Pointer to the file name.
+ *  @param  hash                FILE__watch_hash() of the file name.
+ *
+ *  @return slot_ndx            The slot holding the file or, when the
+ *                              file is not in the table, the empty slot
+ *                              it would go into.
+ *
+ ****************************************************************************/
+
+size_t
+FILE__watch_find(
+    struct  file_watch_dir_t    *   dir_p,
+    const char                  *   file_name_p,
+    uint32_t                        hash
+    )
+{
+    /**
+     *  @param  slot_ndx        Index into the file table                   */
+    size_t                          slot_ndx;
+    /**
+     *  @param  mask            Slot index mask                             */
+    size_t                          mask;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    mask = ( dir_p->capacity - 1 );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    for ( slot_ndx = ( hash & mask );
+          dir_p->slot_pp[ slot_ndx ] != NULL;
+          slot_ndx = ( ( slot_ndx + 1 ) & mask ) )
+    {
+        //  Is this the file ?
+        if (    ( dir_p->slot_pp[ slot_ndx ]->hash == hash )
+             && ( strcmp( dir_p->slot_pp[ slot_ndx ]->file_info.file_name,
+                          file_name_p ) == 0 ) )
+        {
+            //  YES:    Stop looking
+            break;
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( slot_ndx );
+}
+
+/****************************************************************************/
+/**
+ *  Double the size of a watched directory's file table.
+ *
+ *  @param  dir_p               Pointer to the watched directory.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+FILE__watch_grow(
+    struct  file_watch_dir_t    *   dir_p
+    )
+{
+    /**
+     *  @param  old_pp          The old file table                          */
+    struct  file_watch_entry_t  **  old_pp;
+    /**
+     *  @param  old_capacity    Number of slots in the old file table       */
+    size_t                          old_capacity;
+    /**
+     *  @param  old_ndx         Index into the old file table               */
+    size_t                          old_ndx;
+    /**
+     *  @param  slot_ndx        Index into the new file table               */
+    size_t                          slot_ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    old_pp       = dir_p->slot_pp;
+    old_capacity = dir_p->capacity;
+
+    dir_p->capacity = old_capacity * 2;
+    dir_p->slot_pp  = mem_malloc( dir_p->capacity
+                                  * sizeof( struct file_watch_entry_t * ) );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Move every file to its slot in the new table
+    for ( old_ndx = 0; old_ndx < old_capacity; old_ndx += 1 )
+    {
+        if ( old_pp[ old_ndx ] != NULL )
+        {
+            for ( slot_ndx = ( old_pp[ old_ndx ]->hash
+                               & ( dir_p->capacity - 1 ) );
+                  dir_p->slot_pp[ slot_ndx ] != NULL;
+                  slot_ndx = ( ( slot_ndx + 1 ) & ( dir_p->capacity - 1 ) ) )
+            {
+                //  Keep looking for an empty slot
+            }
+
+            dir_p->slot_pp[ slot_ndx ] = old_pp[ old_ndx ];
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    mem_free( old_pp );
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Add a change to a file watch's journal.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *  @param  change              What happened to the file.
+ *  @param  file_info_p         Pointer to the file information.
+ *
+ *  @return void
+ *
+ *  @note
+ *      The journal is a ring.  Once it is full each new change replaces
+ *      the oldest one.
+ *
+ ****************************************************************************/
+
+void
+FILE__watch_record(
+    struct  file_watch_t        *   watch_p,
+    enum    file_change_e           change,
+    struct  file_info_t         *   file_info_p
+    )
+{
+    /**
+     *  @param  change_p        Pointer to the journal entry                */
+    struct  file_change_t       *   change_p;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    watch_p->cursor += 1;
+
+    change_p = &watch_p->journal_p[ ( watch_p->cursor - 1 )
+                                    & ( FILE_WATCH_JOURNAL_L - 1 ) ];
+
+    change_p->change = change;
+    change_p->cursor = watch_p->cursor;
+    memcpy( &change_p->file_info, file_info_p, sizeof( struct file_info_t ) );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Remove a file from a watched directory's file table and record that
+ *  it was deleted.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *  @param  dir_p               Pointer to the watched directory.
+ *  @param  slot_ndx            The slot holding the file.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+FILE__watch_remove(
+    struct  file_watch_t        *   watch_p,
+    struct  file_watch_dir_t    *   dir_p,
+    size_t                          slot_ndx
+    )
+{
+    /**
+     *  @param  next_ndx        Index of the slot being examined for a shift*/
+    size_t                          next_ndx;
+    /**
+     *  @param  home_ndx        Preferred slot of the entry at next_ndx     */
+    size_t                          home_ndx;
+    /**
+     *  @param  mask            Slot index mask                             */
+    size_t                          mask;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    mask = ( dir_p->capacity - 1 );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    FILE__watch_record( watch_p, FILE_CHANGE_DELETED,
+                        &dir_p->slot_pp[ slot_ndx ]->file_info );
+
+    //  Empty the slot
+    mem_free( dir_p->slot_pp[ slot_ndx ] );
+    dir_p->slot_pp[ slot_ndx ] = NULL;
+    dir_p->count -= 1;
+
+    //  Shift back anything in the probe run that can move closer
+    //  to its preferred slot.
+    for ( next_ndx = ( ( slot_ndx + 1 ) & mask );
+          dir_p->slot_pp[ next_ndx ] != NULL;
+          next_ndx = ( ( next_ndx + 1 ) & mask ) )
+    {
+        home_ndx = ( dir_p->slot_pp[ next_ndx ]->hash & mask );
+
+        //  Does the empty slot lie between the preferred slot and
+        //  where the entry is now (cyclically) ?
+        if ( ( ( next_ndx - home_ndx ) & mask )
+             >= ( ( next_ndx - slot_ndx ) & mask ) )
+        {
+            //  YES:    Move it into the empty slot
+            dir_p->slot_pp[ slot_ndx ] = dir_p->slot_pp[ next_ndx ];
+            dir_p->slot_pp[ next_ndx ] = NULL;
+            slot_ndx = next_ndx;
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Bring a file's entry in a watched directory up to date.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *  @param  dir_p               Pointer to the watched directory.
+ *  @param  file_name_p         Pointer to the file name.
+ *  @param  written             TRUE when the file was just written, so it
+ *                              has changed even if its size and time
+ *                              have not.
+ *
+ *  @return void
+ *
+ *  @note
+ *      A file that is new is added, one that changed is updated and one
+ *      that is gone is removed.  Each is recorded in the journal.
+ *
+ ****************************************************************************/
+
+void
+FILE__watch_file(
+    struct  file_watch_t        *   watch_p,
+    struct  file_watch_dir_t    *   dir_p,
+    const char                  *   file_name_p,
+    int                             written
+    )
+{
+    /**
+     *  @param  entry_p         Pointer to the file's entry                 */
+    struct  file_watch_entry_t  *   entry_p;
+    /**
+     *  @param  statbuf         File status                                 */
+    struct  stat                    statbuf;
+    /**
+     *  @param  full_name       Directory and file name                     */
+    char                            full_name[ ( FILE_NAME_L * 2 ) + 2 ];
+    /**
+     *  @param  hash            Hash of the file name                       */
+    uint32_t                        hash;
+    /**
+     *  @param  slot_ndx        Index into the file table                   */
+    size_t                          slot_ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Is this a file with an included extension ?
+    if (    ( strlen( file_name_p ) > FILE_NAME_L )
+         || ( FILE__ext_match( watch_p->include_ext_p, dir_p->path,
+                               file_name_p ) == false ) )
+    {
+        //  NO:     Leave it out
+        return;
+    }
+
+    hash     = FILE__watch_hash( file_name_p );
+    slot_ndx = FILE__watch_find( dir_p, file_name_p, hash );
+    entry_p  = dir_p->slot_pp[ slot_ndx ];
+
+    snprintf( full_name, sizeof( full_name ), "%s/%s",
+              dir_p->path, file_name_p );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is the file still there ?
+    if (    ( stat( full_name, &statbuf ) != 0 )
+         || ( S_ISDIR( statbuf.st_mode ) != 0 ) )
+    {
+        //  NO:     Was it in the table ?
+        if ( entry_p != NULL )
+        {
+            //  YES:    It is gone now
+            FILE__watch_remove( watch_p, dir_p, slot_ndx );
+        }
+    }
+    //  Is it a new file ?
+    else if ( entry_p == NULL )
+    {
+        //  YES:    Make room for it
+        if ( ( ( dir_p->count + 1 ) * 2 ) > dir_p->capacity )
+        {
+            FILE__watch_grow( dir_p );
+            slot_ndx = FILE__watch_find( dir_p, file_name_p, hash );
+        }
+
+        //  Add it
+        entry_p = mem_malloc( sizeof( struct file_watch_entry_t ) );
+
+        entry_p->hash = hash;
+        entry_p->mark = watch_p->mark;
+        memcpy( entry_p->file_info.dir_name, dir_p->path,
+                sizeof( dir_p->path ) );
+        memcpy( entry_p->file_info.file_name, file_name_p,
+                strlen( file_name_p ) + 1 );
+        entry_p->file_info.size  = statbuf.st_size;
+        entry_p->file_info.mtime = statbuf.st_mtime;
+        file_info_format( &entry_p->file_info );
+
+        dir_p->slot_pp[ slot_ndx ] = entry_p;
+        dir_p->count += 1;
+
+        FILE__watch_record( watch_p, FILE_CHANGE_ADDED,
+                            &entry_p->file_info );
+    }
+    else
+    {
+        //  NO:     Has it changed ?
+        entry_p->mark = watch_p->mark;
+
+        if (    ( written == true )
+             || ( entry_p->file_info.size  != statbuf.st_size  )
+             || ( entry_p->file_info.mtime != statbuf.st_mtime ) )
+        {
+            //  YES:    Update it
+            entry_p->file_info.size  = statbuf.st_size;
+            entry_p->file_info.mtime = statbuf.st_mtime;
+            file_info_format( &entry_p->file_info );
+
+            FILE__watch_record( watch_p, FILE_CHANGE_MODIFIED,
+                                &entry_p->file_info );
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Start watching a directory and everything below it.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *  @param  path_p              Pointer to the directory name.
+ *
+ *  @return dir_p               Pointer to the watched directory or NULL
+ *                              when it cannot be watched.
+ *
+ *  @note
+ *      The watch is added before the directory is read so that nothing
+ *      created in between is missed.
+ *  @note
+ *      A directory that is already watched under another name was moved
+ *      while events were lost, so it is renamed and read again.
+ *
+ ****************************************************************************/
+
+struct  file_watch_dir_t *
+FILE__watch_add_dir(
+    struct  file_watch_t        *   watch_p,
+    const char                  *   path_p
+    )
+{
+    /**
+     *  @param  dir_p           Pointer to the watched directory            */
+    struct  file_watch_dir_t    *   dir_p;
+    /**
+     *  @param  wd              inotify watch descriptor                    */
+    int                             wd;
+    /**
+     *  @param  dir_l           New number of entries in dir_pp             */
+    int                             dir_l;
+    /**
+     *  @param  statbuf         Directory status                            */
+    struct  stat                    statbuf;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Will the name fit ?
+    if ( strlen( path_p ) > FILE_NAME_L )
+    {
+        //  NO:     Skip it
+        log_write( MID_WARNING, "FILE__watch_add_dir",
+                   "Directory name is too long to watch: '%s'\n", path_p );
+        return( NULL );
+    }
+
+    wd = inotify_add_watch( watch_p->fd, path_p, FILE_WATCH_EVENTS );
+
+    //  Is it being watched ?
+    if ( wd < 0 )
+    {
+        //  NO:     Skip it
+        log_write( MID_WARNING, "FILE__watch_add_dir",
+                   "Unable to watch '%s' because: %s\n",
+                   path_p, strerror( errno ) );
+        return( NULL );
+    }
+
+    //  Was it already being watched ?
+    if ( ( wd < watch_p->dir_l ) && ( watch_p->dir_pp[ wd ] != NULL ) )
+    {
+        //  YES:    Was it under another name ?
+        dir_p = watch_p->dir_pp[ wd ];
+
+        if ( strcmp( dir_p->path, path_p ) != 0 )
+        {
+            //  YES:    It was moved
+            FILE__watch_rename( watch_p, dir_p, path_p );
+        }
+
+        return( dir_p );
+    }
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is there room for it in the directory table ?
+    if ( wd >= watch_p->dir_l )
+    {
+        //  NO:     Make the table bigger
+        for ( dir_l = ( ( watch_p->dir_l > 0 ) ? watch_p->dir_l : 64 );
+              dir_l <= wd;
+              dir_l *= 2 )
+        {
+            //  Keep doubling
+        }
+
+        watch_p->dir_pp = mem_realloc( watch_p->dir_pp,
+                                       dir_l * sizeof( *watch_p->dir_pp ) );
+        memset( &watch_p->dir_pp[ watch_p->dir_l ], 0x00,
+                ( dir_l - watch_p->dir_l ) * sizeof( *watch_p->dir_pp ) );
+        watch_p->dir_l = dir_l;
+    }
+
+    dir_p = mem_malloc( sizeof( struct file_watch_dir_t ) );
+
+    dir_p->wd       = wd;
+    dir_p->capacity = FILE_WATCH_SLOTS_L;
+    dir_p->slot_pp  = mem_malloc( FILE_WATCH_SLOTS_L
+                                  * sizeof( struct file_watch_entry_t * ) );
+    strncpy( dir_p->path, path_p, FILE_NAME_L );
+
+    //  Remember which directory it is
+    if ( stat( path_p, &statbuf ) == 0 )
+    {
+        dir_p->dev = statbuf.st_dev;
+        dir_p->ino = statbuf.st_ino;
+    }
+
+    watch_p->dir_pp[ wd ] = dir_p;
+
+    //  Add what is already in it
+    FILE__watch_scan( watch_p, dir_p );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( dir_p );
+}
+
+/****************************************************************************/
+/**
+ *  Give a watched directory that was moved its new name.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *  @param  dir_p               Pointer to the watched directory.
+ *  @param  path_p              Pointer to the new directory name.
+ *
+ *  @return void
+ *
+ *  @note
+ *      Every file in it is recorded as deleted under the old name and
+ *      added under the new one, the same as when the move is seen as it
+ *      happens.  The directory is then read again, which renames its
+ *      subdirectories the same way as they are found.
+ *
+ ****************************************************************************/
+
+void
+FILE__watch_rename(
+    struct  file_watch_t        *   watch_p,
+    struct  file_watch_dir_t    *   dir_p,
+    const char                  *   path_p
+    )
+{
+    /**
+     *  @param  entry_p         Pointer to a file's entry                   */
+    struct  file_watch_entry_t  *   entry_p;
+    /**
+     *  @param  slot_ndx        Index into the file table                   */
+    size_t                          slot_ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Log the progress
+    log_write( MID_DEBUG_0, "FILE__watch_rename",
+               "'%s' was moved to '%s'\n",
+               dir_p->path, path_p );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Move every file to the new name
+    for ( slot_ndx = 0; slot_ndx < dir_p->capacity; slot_ndx += 1 )
+    {
+        entry_p = dir_p->slot_pp[ slot_ndx ];
+
+        if ( entry_p != NULL )
+        {
+            FILE__watch_record( watch_p, FILE_CHANGE_DELETED,
+                                &entry_p->file_info );
+
+            memset( entry_p->file_info.dir_name, 0x00,
+                    sizeof( entry_p->file_info.dir_name ) );
+            memcpy( entry_p->file_info.dir_name, path_p,
+                    strlen( path_p ) );
+
+            FILE__watch_record( watch_p, FILE_CHANGE_ADDED,
+                                &entry_p->file_info );
+        }
+    }
+
+    //  Rename the directory, it is where it is supposed to be now
+    memset( dir_p->path, 0x00, sizeof( dir_p->path ) );
+    memcpy( dir_p->path, path_p, strlen( path_p ) );
+    dir_p->stale = false;
+
+    //  Read it again
+    //  @NOTE   The mark is not changed here; this is called from inside
+    //          the scan of the new parent, which is using it.
+    FILE__watch_scan( watch_p, dir_p );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Read a watched directory and bring its file table up to date.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *  @param  dir_p               Pointer to the watched directory.
+ *
+ *  @return scan_rc             TRUE when the directory was read, FALSE
+ *                              when it is gone.
+ *
+ *  @note
+ *      Subdirectories are watched (and read) as they are found.  Files
+ *      in the table that were not seen by this scan are removed.
+ *
+ ****************************************************************************/
+
+int
+FILE__watch_scan(
+    struct  file_watch_t        *   watch_p,
+    struct  file_watch_dir_t    *   dir_p
+    )
+{
+    /**
+     *  @param  directory_p     Pointer to the open directory               */
+    DIR                         *   directory_p;
+    /**
+     *  @param  entry_p         Pointer to a directory entry                */
+    struct  dirent              *   entry_p;
+    /**
+     *  @param  sub_path        Name of a subdirectory                      */
+    char                            sub_path[ ( FILE_NAME_L * 2 ) + 2 ];
+    /**
+     *  @param  slot_ndx        Index into the file table                   */
+    size_t                          slot_ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    directory_p = opendir( dir_p->path );
+
+    //  Is the directory still there ?
+    if ( directory_p == NULL )
+    {
+        //  NO:     Nothing to read
+        return( false );
+    }
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    while( ( entry_p = readdir( directory_p ) ) != NULL )
+    {
+        //  Is this a directory ?
+        if ( FILE__entry_is_dir( dirfd( directory_p ), entry_p ) == true )
+        {
+            //  YES:    Does the directory name match any of the following ?
+            if (    ( strcmp( entry_p->d_name, "."  ) == 0 )
+                 || ( strcmp( entry_p->d_name, ".." ) == 0 ) )
+            {
+                //  YES:    Exclude it from processing.
+                continue;
+            }
+
+            //  Watch it
+            snprintf( sub_path, sizeof( sub_path ), "%s/%s",
+                      dir_p->path, entry_p->d_name );
+
+            FILE__watch_add_dir( watch_p, sub_path );
+        }
+        else
+        {
+            //  NO:     Bring the file up to date
+            FILE__watch_file( watch_p, dir_p, entry_p->d_name, false );
+        }
+    }
+
+    closedir( directory_p );
+
+    /************************************************************************
+     *  Remove the files that are gone
+     ************************************************************************/
+
+    for ( slot_ndx = 0; slot_ndx < dir_p->capacity; )
+    {
+        if (    ( dir_p->slot_pp[ slot_ndx ] != NULL )
+             && ( dir_p->slot_pp[ slot_ndx ]->mark != watch_p->mark ) )
+        {
+            //  Another file may be shifted into this slot, so look again
+            FILE__watch_remove( watch_p, dir_p, slot_ndx );
+        }
+        else
+        {
+            slot_ndx += 1;
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( true );
+}
+
+/****************************************************************************/
+/**
+ *  Find out if a watched directory is no longer found at its name.
+ *
+ *  @param  dir_p               Pointer to the watched directory.
+ *
+ *  @return moved_rc            TRUE when the name is gone or is now a
+ *                              different directory, else FALSE.
+ *
+ ****************************************************************************/
+
+int
+FILE__watch_moved(
+    struct  file_watch_dir_t    *   dir_p
+    )
+{
+    /**
+     *  @param  statbuf         Directory status                            */
+    struct  stat                    statbuf;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is the same directory still there ?
+    if (    ( stat( dir_p->path, &statbuf ) == 0 )
+         && ( statbuf.st_dev == dir_p->dev )
+         && ( statbuf.st_ino == dir_p->ino ) )
+    {
+        //  YES:    It hasn't moved
+        return( false );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( true );
+}
+
+/****************************************************************************/
+/**
+ *  Stop watching one directory.  Every file that was in it is recorded as
+ *  deleted.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *  @param  dir_p               Pointer to the watched directory.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+FILE__watch_drop_dir(
+    struct  file_watch_t        *   watch_p,
+    struct  file_watch_dir_t    *   dir_p
+    )
+{
+    /**
+     *  @param  slot_ndx        Index into the file table                   */
+    size_t                          slot_ndx;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Every file in it is gone
+    for ( slot_ndx = 0; slot_ndx < dir_p->capacity; slot_ndx += 1 )
+    {
+        if ( dir_p->slot_pp[ slot_ndx ] != NULL )
+        {
+            FILE__watch_record( watch_p, FILE_CHANGE_DELETED,
+                                &dir_p->slot_pp[ slot_ndx ]->file_info );
+            mem_free( dir_p->slot_pp[ slot_ndx ] );
+        }
+    }
+
+    //  Stop watching it
+    inotify_rm_watch( watch_p->fd, dir_p->wd );
+
+    watch_p->dir_pp[ dir_p->wd ] = NULL;
+    mem_free( dir_p->slot_pp );
+    mem_free( dir_p );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Stop watching a directory and everything below it that is no longer
+ *  found at its name.  Every file that was in them is recorded as deleted.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *  @param  path_p              Pointer to the directory name.
+ *
+ *  @return void
+ *
+ *  @note
+ *      Directories are only deleted or moved now and then, so the
+ *      directory table is simply searched for the name.
+ *  @note
+ *      Events are read some time after they happen.  By then a directory
+ *      may already have been found under its new name by a later scan (see
+ *      FILE__watch_add_dir()), or another one may have taken the name, so
+ *      a directory that is still where it is supposed to be is kept.
+ *
+ ****************************************************************************/
+
+void
+FILE__watch_drop(
+    struct  file_watch_t        *   watch_p,
+    const char                  *   path_p
+    )
+{
+    /**
+     *  @param  dir_p           Pointer to a watched directory              */
+    struct  file_watch_dir_t    *   dir_p;
+    /**
+     *  @param  path_l          Length of the directory name                */
+    size_t                          path_l;
+    /**
+     *  @param  wd              inotify watch descriptor                    */
+    int                             wd;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    path_l = strlen( path_p );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    for ( wd = 0; wd < watch_p->dir_l; wd += 1 )
+    {
+        dir_p = watch_p->dir_pp[ wd ];
+
+        //  Is this the directory or one below it ?
+        if (    ( dir_p == NULL )
+             || ( strncmp( dir_p->path, path_p, path_l ) != 0 )
+             || (    ( dir_p->path[ path_l ] != '\0' )
+                  && ( dir_p->path[ path_l ] != '/'  ) ) )
+        {
+            //  NO:     Leave it alone
+            continue;
+        }
+
+        //  Is it still where it is supposed to be ?
+        if ( FILE__watch_moved( dir_p ) == false )
+        {
+            //  YES:    Keep watching it
+            continue;
+        }
+
+        //  YES:    Stop watching it
+        FILE__watch_drop_dir( watch_p, dir_p );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Read every watched directory again after inotify events were lost.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *
+ *  @return void
+ *
+ *  @note
+ *      Directories may have been deleted, replaced or moved without an
+ *      event, so their names can't be trusted.  First every directory that
+ *      is no longer found at its name is marked stale.  Then the others
+ *      are read; a stale directory that turns up under a new name while
+ *      they are read is renamed (see FILE__watch_add_dir()).  Whatever is
+ *      still stale after that is gone and is dropped.  A directory that
+ *      now has the name of a stale one is never read as the stale one.
+ *
+ ****************************************************************************/
+
+void
+FILE__watch_rescan(
+    struct  file_watch_t        *   watch_p
+    )
+{
+    /**
+     *  @param  dir_p           Pointer to a watched directory              */
+    struct  file_watch_dir_t    *   dir_p;
+    /**
+     *  @param  wd              inotify watch descriptor                    */
+    int                             wd;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Files not seen by the scans are gone
+    watch_p->mark += 1;
+
+    /************************************************************************
+     *  Find the directories that are not where they were
+     ************************************************************************/
+
+    for ( wd = 0; wd < watch_p->dir_l; wd += 1 )
+    {
+        dir_p = watch_p->dir_pp[ wd ];
+
+        if ( dir_p != NULL )
+        {
+            dir_p->stale = FILE__watch_moved( dir_p );
+        }
+    }
+
+    /************************************************************************
+     *  Read the directories that are
+     ************************************************************************/
+
+    for ( wd = 0; wd < watch_p->dir_l; wd += 1 )
+    {
+        dir_p = watch_p->dir_pp[ wd ];
+
+        //  Is the directory where it was ?
+        if (    ( dir_p != NULL )
+             && ( dir_p->stale == false )
+             && ( FILE__watch_scan( watch_p, dir_p ) == false ) )
+        {
+            //  NO:     It went away while we were looking
+            dir_p->stale = true;
+        }
+    }
+
+    /************************************************************************
+     *  Drop the directories that were not found
+     ************************************************************************/
+
+    for ( wd = 0; wd < watch_p->dir_l; wd += 1 )
+    {
+        dir_p = watch_p->dir_pp[ wd ];
+
+        if (    ( dir_p != NULL )
+             && ( dir_p->stale == true ) )
+        {
+            FILE__watch_drop_dir( watch_p, dir_p );
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Apply one inotify event to a file watch.
+ *
+ *  @param  watch_p             Pointer to the file watch.
+ *  @param  event_p             Pointer to the event.
+ *
+ *  @return void
+ *
+ *  @note
+ *      When the kernel's event queue overflows events are lost, so every
+ *      watched directory is read again.
+ *
+ ****************************************************************************/
+
+void
+FILE__watch_event(
+    struct  file_watch_t        *   watch_p,
+    struct  inotify_event       *   event_p
+    )
+{
+    /**
+     *  @param  dir_p           Pointer to the watched directory            */
+    struct  file_watch_dir_t    *   dir_p;
+    /**
+     *  @param  path            Directory name                              */
+    char                            path[ ( FILE_NAME_L * 2 ) + 2 ];
+
+    /************************************************************************
+     *  Lost events
+     ************************************************************************/
+
+    //  Did the event queue overflow ?
+    if ( ( event_p->mask & IN_Q_OVERFLOW ) != 0 )
+    {
+        //  YES:    Read everything again
+        log_write( MID_WARNING, "FILE__watch_event",
+                   "inotify events were lost, rescanning.\n" );
+
+        FILE__watch_rescan( watch_p );
+
+        return;
+    }
+
+    //  Is this a directory that is still being watched ?
+    if (    ( event_p->wd < 0 )
+         || ( event_p->wd >= watch_p->dir_l )
+         || ( watch_p->dir_pp[ event_p->wd ] == NULL ) )
+    {
+        //  NO:     The event is stale
+        return;
+    }
+
+    dir_p = watch_p->dir_pp[ event_p->wd ];
+
+    /************************************************************************
+     *  Events on the watched directory itself
+     ************************************************************************/
+
+    //  Did the watched directory go away ?
+    if ( ( event_p->mask & ( IN_IGNORED | IN_DELETE_SELF
+                                        | IN_MOVE_SELF ) ) != 0 )
+    {
+        //  YES:    Has it already been found under its new name ?
+        //  @NOTE   The kernel has removed the watch when IN_IGNORED is
+        //          seen, so the directory is dropped wherever it is.
+        if (    ( ( event_p->mask & IN_IGNORED ) == 0 )
+             && ( FILE__watch_moved( dir_p ) == false ) )
+        {
+            //  YES:    Keep watching it
+            return;
+        }
+
+        //  NO:     Stop watching it and whatever below it is gone too
+        strncpy( path, dir_p->path, sizeof( path ) );
+        FILE__watch_drop_dir( watch_p, dir_p );
+        FILE__watch_drop( watch_p, path );
+        return;
+    }
+
+    //  Is the event about something in the directory ?
+    if ( event_p->len == 0 )
+    {
+        //  NO:     Nothing to do
+        return;
+    }
+
+    /************************************************************************
+     *  Events on something in the directory
+     ************************************************************************/
+
+    //  Is it a directory ?
+    if ( ( event_p->mask & IN_ISDIR ) != 0 )
+    {
+        //  YES:    Start or stop watching it
+        snprintf( path, sizeof( path ), "%s/%s",
+                  dir_p->path, event_p->name );
+
+        if ( ( event_p->mask & ( IN_CREATE | IN_MOVED_TO ) ) != 0 )
+        {
+            FILE__watch_add_dir( watch_p, path );
+        }
+        else if ( ( event_p->mask & ( IN_DELETE | IN_MOVED_FROM ) ) != 0 )
+        {
+            FILE__watch_drop( watch_p, path );
+        }
+    }
+    else
+    {
+        //  NO:     Bring the file up to date
+        FILE__watch_file( watch_p, dir_p, event_p->name,
+                          ( ( event_p->mask & IN_CLOSE_WRITE ) != 0 ) );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Copy everything left in one file to another.
+ *
+ *  @param  src_fd              File descriptor to copy from.
+ *  @param  dst_fd              File descriptor to copy to.
+ *  @param  regular             TRUE when the source is a regular file.
+ *
+ *  @return copy_rc             TRUE when everything was copied, FALSE
+ *                              (with errno set) when it was not.
+ *
+ *  @note
+ *      The copy is done with the cheapest method that works, each one
+ *      carrying on from where the one before it stopped:
+ *      copy_file_range() (the kernel copies or shares the blocks),
+ *      sendfile() (the kernel copies the pages) and last of all a
+ *      read()/write() loop.  Only regular files are copied in the kernel.
+ *
+ ****************************************************************************/
+
+int
+FILE__copy_data(
+    int                             src_fd,
+    int                             dst_fd,
+    int                             regular
+    )
+{
+    /**
+     *  @param  buffer_p        Buffer for the read()/write() loop          */
+    char                        *   buffer_p;
+    /**
+     *  @param  copy_l          Number of bytes copied by one call          */
+    ssize_t                         copy_l;
+    /**
+     *  @param  write_l         Number of bytes written by one call         */
+    ssize_t                         write_l;
+    /**
+     *  @param  write_ndx       Number of bytes of the buffer written       */
+    ssize_t                         write_ndx;
+
+    /************************************************************************
+     *  Kernel copies
+     ************************************************************************/
+
+    //  Is this a regular file ?
+    if ( regular == true )
+    {
+        //  YES:    Let the file system copy it
+        do
+        {
+            copy_l = copy_file_range( src_fd, NULL, dst_fd, NULL,
+                                      FILE_COPY_L, 0 );
+        }   while (    ( copy_l > 0 )
+                    || ( ( copy_l < 0 ) && ( errno == EINTR ) ) );
+
+        //  Is the copy done ?
+        if ( copy_l == 0 )
+        {
+            //  YES:    Nothing more to do
+            return( true );
+        }
+
+        //  NO:     Let the kernel copy the pages
+        do
+        {
+            copy_l = sendfile( dst_fd, src_fd, NULL, FILE_COPY_L );
+        }   while (    ( copy_l > 0 )
+                    || ( ( copy_l < 0 ) && ( errno == EINTR ) ) );
+
+        if ( copy_l == 0 )
+        {
+            return( true );
+        }
+    }
+
+    /************************************************************************
+     *  read() / write() loop
+     ************************************************************************/
+
+    buffer_p = mem_malloc_nozero( FILE_COPY_BUFFER_L );
+
+    while ( ( copy_l = read( src_fd, buffer_p, FILE_COPY_BUFFER_L ) ) != 0 )
+    {
+        //  Did the read fail ?
+        if ( copy_l < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            break;
+        }
+
+        //  Write all of it
+        for ( write_ndx = 0; write_ndx < copy_l; write_ndx += write_l )
+        {
+            write_l = write( dst_fd, &buffer_p[ write_ndx ],
+                             copy_l - write_ndx );
+
+            if ( write_l < 0 )
+            {
+                if ( errno == EINTR )
+                {
+                    write_l = 0;
+                    continue;
+                }
+                break;
+            }
+        }
+
+        if ( write_ndx < copy_l )
+        {
+            copy_l = -1;
+            break;
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    mem_free( buffer_p );
+
+    //  DONE!
+    return( copy_l == 0 );
+}
+
+/****************************************************************************/
+/**
+ *  Flush the directory holding a file, so a new name for the file is on
+ *  the disk.
+ *
+ *  @param  file_name_p         Pointer to the file name.
+ *
+ *  @return sync_rc             TRUE when the directory was flushed.
+ *
+ ****************************************************************************/
+
+int
+FILE__sync_dir(
+    const char                  *   file_name_p
+    )
+{
+    /**
+     *  @param  dir_name        Name of the directory                       */
+    char                            dir_name[ ( FILE_NAME_L * 2 ) + 2 ];
+    /**
+     *  @param  slash_p         Last '/' in the file name                   */
+    char                        *   slash_p;
+    /**
+     *  @param  dir_fd          File descriptor of the directory            */
+    int                             dir_fd;
+    /**
+     *  @param  sync_rc         Return code                                 */
+    int                             sync_rc;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    snprintf( dir_name, sizeof( dir_name ), "%s", file_name_p );
+
+    slash_p = strrchr( dir_name, '/' );
+
+    //  Is there a directory in the name ?
+    if ( slash_p == NULL )
+    {
+        //  NO:     It is the current directory
+        snprintf( dir_name, sizeof( dir_name ), "." );
+    }
+    else
+    {
+        //  YES:    Keep "/" for the root directory
+        slash_p[ ( slash_p == dir_name ) ? 1 : 0 ] = '\0';
+    }
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    dir_fd = open( dir_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+
+    if ( dir_fd < 0 )
+    {
+        return( false );
+    }
+
+    sync_rc = ( fsync( dir_fd ) == 0 );
+
+    close( dir_fd );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( sync_rc );
+}
+
+/****************************************************************************/
@@ -31,6 +31,11 @@
  ****************************************************************************/
 
                                 //*******************************************
+#include <sys/time.h>           //  struct timeval
+#include <sys/types.h>          //  dev_t, ino_t
+#include <dirent.h>             //  struct dirent
+#include <stdatomic.h>          //  Atomic walk counters
+#include <sys/inotify.h>        //  inotify_event
                                 //*******************************************
 
 /****************************************************************************
@@ -45,6 +50,86 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+/**
+ *  Size of a stream reader's buffer.  It grows if a line is longer.        */
+#define FILE_READER_BUFFER_L    ( 1024 * 1024 )
+/**
+ *  Number of lines read between looks at the clock for the transfer rate   */
+#define FILE_RATE_LINES         ( 4096 )
+/**
+ *  Seconds between transfer rate log messages                              */
+#define FILE_RATE_SECONDS       ( 60 )
+/**
+ *  Number of directories a walker thread's deque starts out holding        */
+#define FILE_WALK_DEQUE_L       ( 64 )
+/**
+ *  Most threads file_walk() will use                                       */
+#define FILE_WALK_THREADS_MAX   ( 64 )
+/**
+ *  ZIP record signatures                                                   */
+#define FILE_ZIP_LOCAL_SIG      ( 0x04034B50 )
+#define FILE_ZIP_CENTRAL_SIG    ( 0x02014B50 )
+#define FILE_ZIP_END_SIG        ( 0x06054B50 )
+#define FILE_ZIP64_END_SIG      ( 0x06064B50 )
+#define FILE_ZIP64_LOCATOR_SIG  ( 0x07064B50 )
+/**
+ *  Size of the fixed part of the ZIP records                               */
+#define FILE_ZIP_LOCAL_L        ( 30 )
+#define FILE_ZIP_CENTRAL_L      ( 46 )
+#define FILE_ZIP_END_L          ( 22 )
+#define FILE_ZIP64_END_L        ( 56 )
+#define FILE_ZIP64_LOCATOR_L    ( 20 )
+/**
+ *  Size of the longest ZIP file comment                                    */
+#define FILE_ZIP_COMMENT_L      ( 0xFFFF )
+/**
+ *  ZIP compression methods                                                 */
+#define FILE_ZIP_STORED         ( 0 )
+#define FILE_ZIP_DEFLATED       ( 8 )
+/**
+ *  How deep archives inside of archives are extracted                      */
+#define FILE_ZIP_DEPTH_MAX      ( 8 )
+/**
+ *  Size of the buffer for the name of an extracted file                    */
+#define FILE_ZIP_PATH_L         ( FILE_NAME_L * 4 )
+/**
+ *  Number of bits looked up at once when decoding a Huffman code           */
+#define FILE_HUFF_FAST_BITS     ( 10 )
+/**
+ *  Longest Huffman code used by deflate                                    */
+#define FILE_HUFF_MAX_BITS      ( 15 )
+/**
+ *  Number of literal/length and distance symbols                           */
+#define FILE_HUFF_LITLEN_N      ( 288 )
+#define FILE_HUFF_DIST_N        ( 30 )
+/**
+ *  How far back a deflate match can reach                                  */
+#define FILE_INFLATE_WINDOW_L   ( 32 * 1024 )
+/**
+ *  Size of the buffer an entry is inflated into before it is written       */
+#define FILE_INFLATE_BUFFER_L   ( 256 * 1024 )
+/**
+ *  Most bytes asked of copy_file_range() or sendfile() in one call         */
+#define FILE_COPY_L             ( 1024 * 1024 * 1024 )
+/**
+ *  Size of the buffer used when the kernel cannot copy a file              */
+#define FILE_COPY_BUFFER_L      ( 1024 * 1024 )
+/**
+ *  Starting number of file slots in a watched directory (a power of two)  */
+#define FILE_WATCH_SLOTS_L      ( 64 )
+/**
+ *  Number of changes a file watch remembers (a power of two)              */
+#define FILE_WATCH_JOURNAL_L    ( 1024 )
+/**
+ *  Size of the buffer inotify events are read into                         */
+#define FILE_WATCH_EVENT_L      ( 64 * 1024 )
+/**
+ *  inotify events a file watch asks for on each directory                  */
+#define FILE_WATCH_EVENTS       ( IN_CREATE | IN_CLOSE_WRITE | IN_ATTRIB   \
+                                | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO   \
+                                | IN_DELETE_SELF | IN_MOVE_SELF             \
+                                | IN_ONLYDIR | IN_DONT_FOLLOW               \
+                                | IN_EXCL_UNLINK )
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -59,6 +144,279 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+struct  file_reader_t
+{
+    /**
+     *  @param  fd              File descriptor being read                  */
+    int                             fd;
+    /**
+     *  @param  close_fd        TRUE when file_reader_close() closes fd     */
+    int                             close_fd;
+    /**
+     *  @param  mapped          TRUE when data_p is the mmap()ed file       */
+    int                             mapped;
+    /**
+     *  @param  eof             TRUE once read() has returned End-Of-File   */
+    int                             eof;
+    /**
+     *  @param  data_p          The mapped file or the stream buffer        */
+    char                        *   data_p;
+    /**
+     *  @param  data_l          Number of bytes of data in data_p           */
+    size_t                          data_l;
+    /**
+     *  @param  buffer_l        Size of the stream buffer                   */
+    size_t                          buffer_l;
+    /**
+     *  @param  next_ndx        Where the next line starts in data_p        */
+    size_t                          next_ndx;
+    /**
+     *  @param  line            Text line built by file_reader_read_text()  */
+    struct  mem_strbuf_t            line;
+    /**
+     *  @param  qp              Quoted printable decoder for line           */
+    struct  text_qp_t               qp;
+};
+//----------------------------------------------------------------------------
+struct  file_walk_parent_t
+{
+    /**
+     *  @param  ref_count       The scan of the directory plus each of its
+     *                          subdirectories that has not been opened yet */
+    atomic_int                      ref_count;
+    /**
+     *  @param  fd              Directory file descriptor                   */
+    int                             fd;
+};
+//----------------------------------------------------------------------------
+struct  file_walk_item_t
+{
+    /**
+     *  @param  parent_p        Directory the subdirectory is opened from,
+     *                          NULL for the starting directory             */
+    struct  file_walk_parent_t  *   parent_p;
+    /**
+     *  @param  path_p          Full name of the directory                  */
+    char                        *   path_p;
+    /**
+     *  @param  name_ndx        Where the name in parent_p starts in path_p */
+    size_t                          name_ndx;
+};
+//----------------------------------------------------------------------------
+struct  file_walk_deque_t
+{
+    /**
+     *  @param  lock            Protects the rest of the deque              */
+    pthread_mutex_t                 lock;
+    /**
+     *  @param  item_p          Directories waiting to be scanned           */
+    struct  file_walk_item_t    *   item_p;
+    /**
+     *  @param  head            Oldest entry, where other threads steal     */
+    int                             head;
+    /**
+     *  @param  tail            One past the newest entry                   */
+    int                             tail;
+    /**
+     *  @param  size            Number of entries item_p can hold           */
+    int                             size;
+};
+//----------------------------------------------------------------------------
+struct  file_walk_t
+{
+    /**
+     *  @param  include_ext_p   File extension to include or NULL           */
+    const char                  *   include_ext_p;
+    /**
+     *  @param  callback_p      Called for every included file              */
+    void                            (*callback_p)( void *,
+                                                   struct file_info_t * );
+    /**
+     *  @param  parm_p          Passed to the callback                      */
+    void                        *   parm_p;
+    /**
+     *  @param  thread_count    Number of walker threads                    */
+    int                             thread_count;
+    /**
+     *  @param  deque_p         One deque for each walker thread            */
+    struct  file_walk_deque_t   *   deque_p;
+    /**
+     *  @param  pending         Directories queued or being scanned         */
+    atomic_int                      pending;
+    /**
+     *  @param  idle            Threads waiting on work                     */
+    atomic_int                      idle;
+    /**
+     *  @param  file_count      Number of files passed to the callback      */
+    atomic_long                     file_count;
+    /**
+     *  @param  lock            Protects running and the conditions         */
+    pthread_mutex_t                 lock;
+    /**
+     *  @param  work            Signaled when a directory is queued
+     *                          and when the walk is finished               */
+    pthread_cond_t                  work;
+    /**
+     *  @param  done            Signaled when a thread leaves the walk      */
+    pthread_cond_t                  done;
+    /**
+     *  @param  running         Threads that have not left the walk yet     */
+    int                             running;
+};
+//----------------------------------------------------------------------------
+struct  file_walk_thread_t
+{
+    /**
+     *  @param  walk_p          The walk the thread is part of              */
+    struct  file_walk_t         *   walk_p;
+    /**
+     *  @param  thread_ndx      Which deque belongs to the thread           */
+    int                             thread_ndx;
+};
+//----------------------------------------------------------------------------
+struct  file_watch_entry_t
+{
+    /**
+     *  @param  hash            Hash of the file name                       */
+    uint32_t                        hash;
+    /**
+     *  @param  mark            Scan that last saw the file                 */
+    uint32_t                        mark;
+    /**
+     *  @param  file_info       The file information                        */
+    struct  file_info_t             file_info;
+};
+//----------------------------------------------------------------------------
+struct  file_watch_dir_t
+{
+    /**
+     *  @param  wd              inotify watch descriptor                    */
+    int                             wd;
+    /**
+     *  @param  path            Name of the directory                       */
+    char                            path[ FILE_NAME_L + 1 ];
+    /**
+     *  @param  dev, ino        Identity of the directory, to tell whether
+     *                          path still names it                         */
+    dev_t                           dev;
+    ino_t                           ino;
+    /**
+     *  @param  stale           TRUE during a rescan until the directory is
+     *                          found at its path (or a new one)            */
+    int                             stale;
+    /**
+     *  @param  slot_pp         Open addressing table of the files in the
+     *                          directory, keyed by file name               */
+    struct  file_watch_entry_t  **  slot_pp;
+    /**
+     *  @param  capacity        Number of slots (a power of two)            */
+    size_t                          capacity;
+    /**
+     *  @param  count           Number of files in the table                */
+    size_t                          count;
+};
+//----------------------------------------------------------------------------
+struct  file_watch_t
+{
+    /**
+     *  @param  fd              inotify file descriptor                     */
+    int                             fd;
+    /**
+     *  @param  include_ext_p   File extension to include or NULL           */
+    char                        *   include_ext_p;
+    /**
+     *  @param  dir_pp          Watched directories, indexed by wd          */
+    struct  file_watch_dir_t    **  dir_pp;
+    /**
+     *  @param  dir_l           Number of entries in dir_pp                 */
+    int                             dir_l;
+    /**
+     *  @param  mark            Number of the current scan                  */
+    uint32_t                        mark;
+    /**
+     *  @param  cursor          Number of changes recorded so far           */
+    uint64_t                        cursor;
+    /**
+     *  @param  journal_p       The last FILE_WATCH_JOURNAL_L changes       */
+    struct  file_change_t       *   journal_p;
+};
+//----------------------------------------------------------------------------
+struct  file_huffman_t
+{
+    /**
+     *  @param  fast            Indexed by the next FILE_HUFF_FAST_BITS
+     *                          bits: ( symbol << 4 ) | code length, or 0
+     *                          for a longer code                           */
+    uint16_t                        fast[ 1 << FILE_HUFF_FAST_BITS ];
+    /**
+     *  @param  count           Number of codes of each length              */
+    uint16_t                        count[ FILE_HUFF_MAX_BITS + 1 ];
+    /**
+     *  @param  symbol          Symbols in canonical code order             */
+    uint16_t                        symbol[ FILE_HUFF_LITLEN_N ];
+};
+//----------------------------------------------------------------------------
+struct  file_inflate_t
+{
+    /**
+     *  @param  in_p            Deflated data                               */
+    const uint8_t               *   in_p;
+    /**
+     *  @param  in_l            Size of the deflated data                   */
+    size_t                          in_l;
+    /**
+     *  @param  in_ndx          Next byte to go into the bit buffer         */
+    size_t                          in_ndx;
+    /**
+     *  @param  bits            Bit buffer, next bit in the low bit         */
+    uint64_t                        bits;
+    /**
+     *  @param  bits_l          Number of bits in the bit buffer            */
+    int                             bits_l;
+    /**
+     *  @param  out_p           Buffer the data is inflated into            */
+    uint8_t                     *   out_p;
+    /**
+     *  @param  out_l           Size of out_p                               */
+    size_t                          out_l;
+    /**
+     *  @param  out_ndx         Number of bytes in out_p                    */
+    size_t                          out_ndx;
+    /**
+     *  @param  written_ndx     Number of bytes in out_p already written    */
+    size_t                          written_ndx;
+    /**
+     *  @param  fd              File descriptor the data is written to      */
+    int                             fd;
+    /**
+     *  @param  crc             CRC-32 of the data written so far           */
+    uint32_t                        crc;
+    /**
+     *  @param  total_l         Number of bytes written so far              */
+    uint64_t                        total_l;
+    /**
+     *  @param  size            Size the inflated data is supposed to be    */
+    uint64_t                        size;
+};
+//----------------------------------------------------------------------------
+struct  file_zip_t
+{
+    /**
+     *  @param  path            Name of the file being extracted            */
+    char                            path[ FILE_ZIP_PATH_L ];
+    /**
+     *  @param  path_l          Length of the extract to directory + '/'    */
+    size_t                          path_l;
+    /**
+     *  @param  made_dir        Directory most recently created (or found)  */
+    char                            made_dir[ FILE_ZIP_PATH_L ];
+    /**
+     *  @param  depth           How many archives this one is inside of     */
+    int                             depth;
+    /**
+     *  @param  archive_count_p Counts every archive that was extracted     */
+    atomic_int                  *   archive_count_p;
+};
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -71,12 +429,353 @@
 FILE_EXT
 struct  file_info_t                 file_stat_data;
 //----------------------------------------------------------------------------
+/**
+ *  @param  bytes_read_last     Number of bytes read last count             */
+FILE_EXT
+float                               bytes_read_last;
+/**
+ *  @param  total_bytes_read    Total number of bytes read                  */
+FILE_EXT
+float                               total_bytes_read;
+/**
+ *  @param  lines_read          Lines read since the clock was last read    */
+FILE_EXT
+int                                 lines_read;
+/**
+ *  @param  time_now            Seconds since the Epoch                     */
+FILE_EXT
+struct  timeval                     time_now;
+/**
+ *  @param  time_last           Seconds since the Epoch                     */
+FILE_EXT
+struct  timeval                     time_last;
+//----------------------------------------------------------------------------
 
 /****************************************************************************
  * Library Private Prototypes
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+void
+FILE__transfer_rate(
+    size_t                          bytes_read
+    );
+//----------------------------------------------------------------------------
+int
+FILE__qp_line(
+    struct  text_qp_t           *   qp_p,
+    const char                  *   piece_p,
+    size_t                          piece_l,
+    struct  mem_strbuf_t        *   line_buf_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__reader_fill(
+    struct  file_reader_t       *   reader_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__ext_match(
+    const char                  *   include_ext_p,
+    const char                  *   path_p,
+    const char                  *   file_name_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__entry_is_dir(
+    int                             dir_fd,
+    struct  dirent              *   entry_p
+    );
+//----------------------------------------------------------------------------
+void
+FILE__scan(
+    struct  list_base_t         *   file_list_p,
+    int                             dir_fd,
+    char                        *   path_p,
+    size_t                          path_l,
+    const char                  *   include_ext_p,
+    int                             format
+    );
+//----------------------------------------------------------------------------
+void
+FILE__walk_release(
+    struct  file_walk_parent_t  *   parent_p
+    );
+//----------------------------------------------------------------------------
+void
+FILE__walk_push(
+    struct  file_walk_t         *   walk_p,
+    struct  file_walk_deque_t   *   deque_p,
+    struct  file_walk_item_t    *   item_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__walk_pop(
+    struct  file_walk_t         *   walk_p,
+    int                             thread_ndx,
+    struct  file_walk_item_t    *   item_p
+    );
+//----------------------------------------------------------------------------
+void
+FILE__walk_dir(
+    struct  file_walk_t         *   walk_p,
+    struct  file_walk_deque_t   *   deque_p,
+    struct  file_walk_item_t    *   item_p,
+    struct  file_info_t         *   file_info_p
+    );
+//----------------------------------------------------------------------------
+void
+FILE__walk_thread(
+    void                        *   void_p
+    );
+//----------------------------------------------------------------------------
+uint32_t
+FILE__watch_hash(
+    const char                  *   file_name_p
+    );
+//----------------------------------------------------------------------------
+size_t
+FILE__watch_find(
+    struct  file_watch_dir_t    *   dir_p,
+    const char                  *   file_name_p,
+    uint32_t                        hash
+    );
+//----------------------------------------------------------------------------
+void
+FILE__watch_grow(
+    struct  file_watch_dir_t    *   dir_p
+    );
+//----------------------------------------------------------------------------
+void
+FILE__watch_record(
+    struct  file_watch_t        *   watch_p,
+    enum    file_change_e           change,
+    struct  file_info_t         *   file_info_p
+    );
+//----------------------------------------------------------------------------
+void
+FILE__watch_remove(
+    struct  file_watch_t        *   watch_p,
+    struct  file_watch_dir_t    *   dir_p,
+    size_t                          slot_ndx
+    );
+//----------------------------------------------------------------------------
+void
+FILE__watch_file(
+    struct  file_watch_t        *   watch_p,
+    struct  file_watch_dir_t    *   dir_p,
+    const char                  *   file_name_p,
+    int                             written
+    );
+//----------------------------------------------------------------------------
+struct  file_watch_dir_t *
+FILE__watch_add_dir(
+    struct  file_watch_t        *   watch_p,
+    const char                  *   path_p
+    );
+//----------------------------------------------------------------------------
+void
+FILE__watch_rename(
+    struct  file_watch_t        *   watch_p,
+    struct  file_watch_dir_t    *   dir_p,
+    const char                  *   path_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__watch_scan(
+    struct  file_watch_t        *   watch_p,
+    struct  file_watch_dir_t    *   dir_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__watch_moved(
+    struct  file_watch_dir_t    *   dir_p
+    );
+//----------------------------------------------------------------------------
+void
+FILE__watch_drop_dir(
+    struct  file_watch_t        *   watch_p,
+    struct  file_watch_dir_t    *   dir_p
+    );
+//----------------------------------------------------------------------------
+void
+FILE__watch_drop(
+    struct  file_watch_t        *   watch_p,
+    const char                  *   path_p
+    );
+//----------------------------------------------------------------------------
+void
+FILE__watch_rescan(
+    struct  file_watch_t        *   watch_p
+    );
+//----------------------------------------------------------------------------
+void
+FILE__watch_event(
+    struct  file_watch_t        *   watch_p,
+    struct  inotify_event       *   event_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__copy_data(
+    int                             src_fd,
+    int                             dst_fd,
+    int                             regular
+    );
+//----------------------------------------------------------------------------
+int
+FILE__sync_dir(
+    const char                  *   file_name_p
+    );
+//----------------------------------------------------------------------------
+void
+FILE__zip_init(
+    void
+    );
+//----------------------------------------------------------------------------
+uint32_t
+FILE__le16(
+    const uint8_t               *   data_p
+    );
+//----------------------------------------------------------------------------
+uint32_t
+FILE__le32(
+    const uint8_t               *   data_p
+    );
+//----------------------------------------------------------------------------
+uint64_t
+FILE__le64(
+    const uint8_t               *   data_p
+    );
+//----------------------------------------------------------------------------
+uint32_t
+FILE__crc32(
+    uint32_t                        crc,
+    const uint8_t               *   data_p,
+    size_t                          data_l
+    );
+//----------------------------------------------------------------------------
+int
+FILE__zip_put(
+    int                             fd,
+    const uint8_t               *   data_p,
+    size_t                          data_l,
+    uint32_t                    *   crc_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__huffman_build(
+    struct  file_huffman_t      *   huffman_p,
+    const uint8_t               *   length_p,
+    int                             symbol_n
+    );
+//----------------------------------------------------------------------------
+int
+FILE__inflate_need(
+    struct  file_inflate_t      *   inflate_p,
+    int                             bits_l
+    );
+//----------------------------------------------------------------------------
+int
+FILE__inflate_flush(
+    struct  file_inflate_t      *   inflate_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__inflate_room(
+    struct  file_inflate_t      *   inflate_p,
+    size_t                          need_l
+    );
+//----------------------------------------------------------------------------
+int
+FILE__inflate_bits(
+    struct  file_inflate_t      *   inflate_p,
+    int                             bits_l
+    );
+//----------------------------------------------------------------------------
+int
+FILE__inflate_decode(
+    struct  file_inflate_t      *   inflate_p,
+    const struct file_huffman_t *   huffman_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__inflate_stored(
+    struct  file_inflate_t      *   inflate_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__inflate_codes(
+    struct  file_inflate_t      *   inflate_p,
+    const struct file_huffman_t *   litlen_p,
+    const struct file_huffman_t *   dist_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__inflate_dynamic(
+    struct  file_inflate_t      *   inflate_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__inflate(
+    const uint8_t               *   in_p,
+    size_t                          in_l,
+    int                             fd,
+    uint64_t                        size,
+    uint32_t                    *   crc_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__make_dirs(
+    struct  file_zip_t          *   zip_p,
+    size_t                          dir_l
+    );
+//----------------------------------------------------------------------------
+int
+FILE__unzip_dir(
+    char                        *   extract_to_p,
+    size_t                          extract_to_l
+    );
+//----------------------------------------------------------------------------
+int
+FILE__zip_save(
+    struct  file_zip_t          *   zip_p,
+    const uint8_t               *   data_p,
+    uint64_t                        comp_size,
+    uint64_t                        size,
+    const uint8_t               *   central_p,
+    char                        *   tmp_name_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__zip_write(
+    struct  file_zip_t          *   zip_p,
+    const uint8_t               *   data_p,
+    size_t                          data_l,
+    const uint8_t               *   central_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__zip_extract(
+    const uint8_t               *   data_p,
+    size_t                          data_l,
+    const char                  *   extract_to_p,
+    int                             depth,
+    atomic_int                  *   archive_count_p
+    );
+//----------------------------------------------------------------------------
+int
+FILE__zip_file(
+    const char                  *   zip_name_p,
+    const char                  *   extract_to_p,
+    int                             depth,
+    atomic_int                  *   archive_count_p
+    );
+//----------------------------------------------------------------------------
+void
+FILE__unzip_found(
+    void                        *   parm_p,
+    struct  file_info_t         *   file_info_p
+    );
 //----------------------------------------------------------------------------
 
 /****************************************************************************/
@@ -0,0 +1,137 @@
+/*
+ * File:   TEST__file_reader.c
+ *
+ * Compares the lines from file_reader_read_text() with file_read_text() for
+ * input with quoted printable soft line breaks, reading from a mapped file,
+ * a buffered file and a pipe.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <libtools_api.h>
+
+/*
+ * Simple C Test Suite
+ */
+
+static const char * test_input[ ] =
+{
+    "=4=\n1\n",
+    "=4= \n\n",
+    "abc=\ndef\nghi\n",
+    "=\n1\n",
+    "plain\n=3D=\n=\nend\n",
+};
+
+#define TEST_INPUT_L    ( sizeof( test_input ) / sizeof( test_input[ 0 ] ) )
+
+static
+int
+compare_lines(
+    const char                  *   input_p,
+    struct  file_reader_t       *   reader_p,
+    FILE                        *   file_fp,
+    const char                  *   mode_p
+    )
+{
+    struct  text_view_t             line;
+    char                        *   expect_p;
+    int                             line_rc;
+    int                             failed;
+
+    failed = 0;
+
+    do {
+        expect_p = file_read_text( file_fp, RTO_NONE );
+        line_rc  = file_reader_read_text( reader_p, &line );
+
+        if ( expect_p == END_OF_FILE ) {
+            if ( line_rc == 1 ) {
+                printf("%%TEST_FAILED%% time=0 testname=testFile_reader_soft_break (TEST__file_reader) message=%s: extra line '%.*s' for '%s'\n",
+                       mode_p, (int)line.text_l, line.text_p, input_p);
+                failed = 1;
+            }
+            break;
+        }
+
+        if (    line_rc != 1
+             || line.text_l != strlen( expect_p )
+             || memcmp( line.text_p, expect_p, line.text_l ) != 0 ) {
+            printf("%%TEST_FAILED%% time=0 testname=testFile_reader_soft_break (TEST__file_reader) message=%s: '%.*s' instead of '%s' for '%s'\n",
+                   mode_p, ( line_rc == 1 ) ? (int)line.text_l : 0,
+                   ( line_rc == 1 ) ? line.text_p : "", expect_p, input_p);
+            failed = 1;
+        }
+
+        mem_free( expect_p );
+    } while ( failed == 0 );
+
+    return( failed );
+}
+
+void testFile_reader_soft_break() {
+    char file_name[ ] = "/tmp/TEST__file_reader_XXXXXX";
+    struct file_reader_t * reader_p;
+    FILE * file_fp;
+    size_t input_ndx;
+    int pipe_fd[ 2 ];
+    int fd;
+
+    for ( input_ndx = 0; input_ndx < TEST_INPUT_L; input_ndx += 1 ) {
+        strcpy( file_name, "/tmp/TEST__file_reader_XXXXXX" );
+        fd = mkstemp( file_name );
+        if (    fd < 0
+             || write( fd, test_input[ input_ndx ],
+                       strlen( test_input[ input_ndx ] ) ) < 0 ) {
+            printf("%%TEST_FAILED%% time=0 testname=testFile_reader_soft_break (TEST__file_reader) message=unable to write test file\n");
+            return;
+        }
+        close( fd );
+
+        file_fp  = fopen( file_name, "r" );
+        reader_p = file_reader_open( file_name, FILE_READER_MMAP );
+        compare_lines( test_input[ input_ndx ], reader_p, file_fp, "mmap" );
+        file_reader_close( reader_p );
+        fclose( file_fp );
+
+        file_fp  = fopen( file_name, "r" );
+        reader_p = file_reader_open( file_name, FILE_READER_STREAM );
+        compare_lines( test_input[ input_ndx ], reader_p, file_fp, "stream" );
+        file_reader_close( reader_p );
+        fclose( file_fp );
+
+        if (    pipe( pipe_fd ) != 0
+             || write( pipe_fd[ 1 ], test_input[ input_ndx ],
+                       strlen( test_input[ input_ndx ] ) ) < 0 ) {
+            printf("%%TEST_FAILED%% time=0 testname=testFile_reader_soft_break (TEST__file_reader) message=unable to write pipe\n");
+            return;
+        }
+        close( pipe_fd[ 1 ] );
+
+        file_fp  = fopen( file_name, "r" );
+        reader_p = file_reader_open_fd( pipe_fd[ 0 ], FILE_READER_AUTO );
+        compare_lines( test_input[ input_ndx ], reader_p, file_fp, "pipe" );
+        file_reader_close( reader_p );
+        fclose( file_fp );
+        close( pipe_fd[ 0 ] );
+
+        unlink( file_name );
+    }
+}
+
+int main(int argc, char** argv) {
+    printf("%%SUITE_STARTING%% TEST__file_reader\n");
+    printf("%%SUITE_STARTED%%\n");
+
+    printf("%%TEST_STARTED%%  testFile_reader_soft_break (TEST__file_reader)\n");
+    testFile_reader_soft_break();
+    printf("%%TEST_FINISHED%% time=0 testFile_reader_soft_break (TEST__file_reader)\n");
+
+    printf("%%SUITE_FINISHED%% time=0\n");
+
+    return (EXIT_SUCCESS);
+}
@@ -0,0 +1,135 @@
+/*
+ * File:   TEST__file_watch.c
+ *
+ * Regression test for a watched directory that is moved into a directory
+ * created in the same poll (mkdir root/p && mv root/n root/p/n).  The scan
+ * of root/p finds n under its new name before n's IN_MOVE_SELF event is
+ * read, and that event must not drop it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <libtools_api.h>
+
+/*
+ * Simple C Test Suite
+ */
+
+static
+int
+count_files(
+    struct  list_base_t         *   file_list_p
+    )
+{
+    void                        *   payload_p;
+    int                             count;
+
+    count = list_query_count( file_list_p );
+
+    while ( ( payload_p = list_get_first( file_list_p ) ) != NULL )
+    {
+        list_delete_payload( file_list_p, payload_p );
+        mem_free( payload_p );
+    }
+
+    return( count );
+}
+
+void testFile_watch_move_into_new_dir() {
+    char root[ ] = "/tmp/TEST__file_watch_XXXXXX";
+    char path[ 256 ];
+    char path_2[ 256 ];
+    struct file_watch_t * watch_p;
+    struct list_base_t * list_p;
+    struct file_change_t * change_p;
+    uint64_t cursor;
+    int watch_count;
+    int scan_count;
+    int added;
+    FILE * file_fp;
+
+    if ( mkdtemp( root ) == NULL ) {
+        printf("%%TEST_FAILED%% time=0 testname=testFile_watch_move_into_new_dir (TEST__file_watch) message=mkdtemp failed\n");
+        return;
+    }
+
+    snprintf( path, sizeof( path ), "%s/n", root );
+    mkdir( path, 0700 );
+    snprintf( path, sizeof( path ), "%s/n/f", root );
+    file_fp = fopen( path, "w" );
+    fclose( file_fp );
+
+    watch_p = file_watch_new( root, NULL );
+    cursor = file_watch_cursor( watch_p );
+
+    //  Both happen before the events are read
+    snprintf( path, sizeof( path ), "%s/p", root );
+    mkdir( path, 0700 );
+    snprintf( path, sizeof( path ), "%s/n", root );
+    snprintf( path_2, sizeof( path_2 ), "%s/p/n", root );
+    rename( path, path_2 );
+
+    file_watch_poll( watch_p, 1000 );
+
+    list_p = list_new( );
+    file_watch_list( watch_p, list_p );
+    watch_count = count_files( list_p );
+    file_scan( list_p, root, NULL, 0 );
+    scan_count = count_files( list_p );
+
+    if ( watch_count != 1 || scan_count != 1 ) {
+        printf("%%TEST_FAILED%% time=0 testname=testFile_watch_move_into_new_dir (TEST__file_watch) message=watch has %d files, scan has %d\n",
+               watch_count, scan_count);
+    }
+
+    //  A file created in the moved directory must be reported
+    file_watch_changes( watch_p, &cursor, list_p );
+    count_files( list_p );
+
+    snprintf( path, sizeof( path ), "%s/p/n/g", root );
+    file_fp = fopen( path, "w" );
+    fclose( file_fp );
+
+    file_watch_poll( watch_p, 1000 );
+    file_watch_changes( watch_p, &cursor, list_p );
+
+    added = 0;
+    while ( ( change_p = list_get_first( list_p ) ) != NULL ) {
+        if (    change_p->change == FILE_CHANGE_ADDED
+             && strcmp( change_p->file_info.file_name, "g" ) == 0 ) {
+            added = 1;
+        }
+        list_delete_payload( list_p, change_p );
+        mem_free( change_p );
+    }
+
+    if ( added == 0 ) {
+        printf("%%TEST_FAILED%% time=0 testname=testFile_watch_move_into_new_dir (TEST__file_watch) message=new file in moved directory was not reported\n");
+    }
+
+    list_kill( list_p );
+    file_watch_kill( watch_p );
+
+    snprintf( path, sizeof( path ), "rm -rf '%s'", root );
+    if ( system( path ) != 0 ) {
+        printf("%%TEST_FAILED%% time=0 testname=testFile_watch_move_into_new_dir (TEST__file_watch) message=cleanup failed\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    printf("%%SUITE_STARTING%% TEST__file_watch\n");
+    printf("%%SUITE_STARTED%%\n");
+
+    printf("%%TEST_STARTED%%  testFile_watch_move_into_new_dir (TEST__file_watch)\n");
+    testFile_watch_move_into_new_dir();
+    printf("%%TEST_FINISHED%% time=0 testFile_watch_move_into_new_dir (TEST__file_watch)\n");
+
+    printf("%%SUITE_FINISHED%% time=0\n");
+
+    return (EXIT_SUCCESS);
+}
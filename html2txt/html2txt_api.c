@@ -105,18 +105,56 @@ html2txt(
     /**
      *  @param  render_p        Pointer to the rendered text                */
     char                        *   render_p;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Render the text in heap memory
+    render_p = html2txt_arena( NULL, html_p );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( render_p );
+}
+
+/****************************************************************************/
+/**
+ *  Same as html2txt() with every buffer, including the rendered output,
+ *  allocated from an arena.
+ *
+ *  @param  arena_p             Pointer to an arena or NULL for the heap.
+ *  @param  html_p              Pointer to the HTML source buffer.
+ *
+ *  @return render_p            Upon successful completion a pointer to
+ *                              a buffer containing the rendered text.
+ *                              Upon failure, NULL is returned.
+ *
+ *  @note
+ *      With an arena the rendered output lives until the arena is reset
+ *      or released; a whole document conversion is released at once.
+ *      Without one the output must be released with mem_free().
+ *
+ ****************************************************************************/
+
+char    *
+html2txt_arena(
+    struct  mem_arena_t         *   arena_p,
+    char                        *   html_p
+    )
+{
+    /**
+     *  @param  render_p        Pointer to the rendered text                */
+    char                        *   render_p;
     /**
      *  @param  work_p          Pointer to a work buffer                    */
     char                        *   work_p;
-    /**
-     *  @param  tmp_p           Pointer to a temporary buffer               */
-    char                        *   tmp_p;
     /**
      *  @parm   html_l          Size of the HTML data string                */
     int                             html_l;
-    /**
-     *  @parm   work_l          Size of the work data string                */
-    int                             work_l;
 
     /************************************************************************
      *  Function Initialization
@@ -128,15 +166,8 @@ html2txt(
     //  Get the size of the HTML buffer
     html_l = strlen( html_p );
 
-    //  Set the size of the work buffer
-    work_l = html_l * 2;
-
-    //  Allocate the work buffer
-    work_p = mem_malloc( work_l + 1 );
-    log_write( MID_DEBUG_1, "html2txt_api.c", "Line: %d\n", __LINE__ );
-
-    //  Allocate the temporary buffer
-    tmp_p = mem_malloc( work_l + 1 );
+    //  Allocate the work buffer.  The text is never longer than the HTML.
+    work_p = mem_arena_alloc( arena_p, html_l + 1 );
     log_write( MID_DEBUG_1, "html2txt_api.c", "Line: %d\n", __LINE__ );
 
     //  Copy the source data buffer to the work data buffer.
@@ -146,19 +177,8 @@ html2txt(
      *  Function
      ************************************************************************/
 
-    HTML2TXT__remove_comments( work_p );
-
-    //  Delete CR & LF
-    work_p = HTML2TXT__crlf_replace( work_p, tmp_p, work_l );
-
-    //  Delete consecutive spaces
-//  work_p = HTML2TXT__remove_spaces( work_p, work_l );
-
-    //  Delete HTML style
-    work_p = HTML2TXT__remove_style( work_p, work_l );
-
-    //  Delete HTML tags
-    work_p = HTML2TXT__tag_scan( work_p, work_l );
+    //  Delete CR, comments, style and HTML tags
+    work_p = HTML2TXT__tag_scan( work_p );
 
     //  Convert HTML and UNICODE strings to characters.
     HTML2TXT__str_2_char( work_p );
@@ -170,9 +190,6 @@ html2txt(
     //  Set the return buffer pointer
     render_p = work_p;
 
-    //  We are done with the temporary buffer so release it.
-    mem_free( tmp_p );
-
     //  DONE!
     return( render_p );
 }
@@ -220,3 +237,169 @@ html2txt_str_2_char(
 }
 
 /****************************************************************************/
+/**
+ *  Start converting a document that arrives in pieces.
+ *
+ *  @param  output_p            Function called with each piece of rendered
+ *                              text as ( parm_p, text_p, text_l ), or NULL
+ *                              to have html2txt_stream_finish() return all
+ *                              of the text.
+ *  @param  parm_p              Passed to output_p.
+ *
+ *  @return stream_p            Pointer to the new stream.
+ *
+ *  @note
+ *      The text passed to output_p is not NUL terminated and is only good
+ *      for the duration of the call.  With an output function the memory
+ *      used does not depend on the size of the document.
+ *
+ ****************************************************************************/
+
+struct  html2txt_stream_t *
+html2txt_stream_new(
+    void                            (*output_p)( void *, const char *, int ),
+    void                        *   parm_p
+    )
+{
+    /**
+     *  @param  stream_p        Pointer to the new stream                   */
+    struct  html2txt_stream_t   *   stream_p;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Allocate the stream
+    stream_p = mem_malloc_nozero( sizeof( struct html2txt_stream_t ) );
+
+    //  Initialize it
+    HTML2TXT__scan_init( &stream_p->scan );
+    mem_strbuf_init( &stream_p->collect );
+    stream_p->output_p  = output_p;
+    stream_p->parm_p    = parm_p;
+    stream_p->text_l    = 0;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( stream_p );
+}
+
+/****************************************************************************/
+/**
+ *  Convert the next piece of a document.
+ *
+ *  @param  stream_p            Pointer to a stream from html2txt_stream_new
+ *  @param  chunk_p             Pointer to the next piece of HTML.
+ *  @param  chunk_l             Number of bytes in the piece.
+ *
+ *  @return void
+ *
+ *  @note
+ *      A piece may end anywhere, even in the middle of a tag or entity.
+ *
+ ****************************************************************************/
+
+void
+html2txt_stream_feed(
+    struct  html2txt_stream_t   *   stream_p,
+    const char                  *   chunk_p,
+    int                             chunk_l
+    )
+{
+    /**
+     *  @param  piece_l         Bytes of the chunk scanned at once          */
+    int                             piece_l;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Scan the chunk a buffer full at a time
+    while ( chunk_l > 0 )
+    {
+        piece_l = ( chunk_l < HTML_STREAM_L ) ? chunk_l : HTML_STREAM_L;
+
+        //  Remove the tags
+        stream_p->text_l += HTML2TXT__scan(
+                &stream_p->scan, chunk_p, piece_l,
+                &stream_p->text[ stream_p->text_l ] );
+
+        //  Decode and deliver the text
+        HTML2TXT__stream_flush( stream_p, false );
+
+        chunk_p += piece_l;
+        chunk_l -= piece_l;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Finish converting a document and release the stream.
+ *
+ *  @param  stream_p            Pointer to a stream from html2txt_stream_new
+ *
+ *  @return render_p            When the stream has no output function all
+ *                              of the rendered text, which must be released
+ *                              with mem_free().  Else NULL.
+ *
+ ****************************************************************************/
+
+char    *
+html2txt_stream_finish(
+    struct  html2txt_stream_t   *   stream_p
+    )
+{
+    /**
+     *  @param  render_p        Pointer to the rendered text                */
+    char                        *   render_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    render_p = NULL;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Deliver the rest of the text
+    stream_p->text_l += HTML2TXT__scan_finish(
+                &stream_p->scan, &stream_p->text[ stream_p->text_l ] );
+    HTML2TXT__stream_flush( stream_p, true );
+
+    //  Is the text being collected ?
+    if ( stream_p->output_p == NULL )
+    {
+        //  YES:    Return it
+        render_p = mem_strbuf_detach( &stream_p->collect );
+
+        //  Was there any ?
+        if ( render_p == NULL )
+        {
+            //  NO:     Return an empty string
+            render_p = mem_malloc( 1 );
+        }
+    }
+
+    //  Release the stream
+    mem_free( stream_p );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( render_p );
+}
+
+/****************************************************************************/
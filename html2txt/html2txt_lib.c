@@ -55,7 +55,6 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
-#define HTML_TAG_L              (   16 )
 #define HTML_TAG_BEG_DEL        ( 0x10 )
 #define HTML_TAG_BEG_CRLF       ( 0x20 )
 #define HTML_TAG_END_DEL        ( 0x01 )
@@ -66,6 +65,12 @@
 #define HTML_TAG_CRLF_CRLF      ( HTML_TAG_BEG_CRLF | HTML_TAG_END_CRLF )
 #define HTML_TAG_END            ( 0x00 )
 //----------------------------------------------------------------------------
+#define HTML_TAG_HASH_L         (  128 )    //  Must be a power of two
+#define HTML_ENTITY_HASH_L      (  512 )    //  Must be a power of two
+#define HTML_ENTITY_NAME_L      (    8 )    //  Longest name in html_table
+#define HTML_ENTITY_DIGITS      (    7 )    //  Digits in a numeric entity
+#define HTML_UNICODE_DIGITS     (    6 )    //  Digits in a U+hhhh string
+//----------------------------------------------------------------------------
 
 /****************************************************************************
  * Structures local to this file
@@ -158,6 +163,14 @@ struct  html_tag_t              html_tag_list[ ] =
     {   "0000000000",   99, HTML_TAG_END,       0   }   //  57
 };
 //----------------------------------------------------------------------------
+/**
+ *  @param  html_tag_hash       html_tag_list index of each tag name
+ *                              (-1 = empty)                                */
+int16_t                             html_tag_hash[ HTML_TAG_HASH_L ];
+/**
+ *  @param  html_tag_once       Builds html_tag_hash on first use           */
+pthread_once_t                      html_tag_once = PTHREAD_ONCE_INIT;
+//----------------------------------------------------------------------------
 /**
  *  @param  html_char           Table with all the translations             */
 struct  html_char_t                 html_table[ ] =
@@ -227,37 +240,37 @@ struct  html_char_t                 html_table[ ] =
     {   "&frac12;",  0xBD   },  //  '½' - fraction one-half
     {   "&frac34;",  0xBE   },  //  '¾' - fraction three-quarters
     {   "&iquest;",  0xBF   },  //  '¿' - inverted question mark
-    {   "&agrave;",  0xC0   },  //  'À' - capital A, grave accent
-    {   "&aacute;",  0xC1   },  //  'Á' - capital A, acute accent
-    {   "&acirc;",   0xC2   },  //  'Â' - capital A, circumflex accent
-    {   "&atilde;",  0xC3   },  //  'Ã' - capital A, tilde
-    {   "&auml;",    0xC4   },  //  'Ä' - capital A, dieresis or umlaut mark
-    {   "&aring;",   0xC5   },  //  'Å' - capital A, ring
-    {   "&aElig;",   0xC6   },  //  'Æ' - capital AE diphthong (ligature)
-    {   "&ccedil;",  0xC7   },  //  'Ç' - capital C, cedilla
-    {   "&egrave;",  0xC8   },  //  'È' - capital E, grave accent
-    {   "&eacute;",  0xC9   },  //  'É' - capital E, acute accent
-    {   "&ecirc;",   0xCA   },  //  'Ê' - capital E, circumflex accent
-    {   "&euml;",    0xCB   },  //  'Ë' - capital E, dieresis or umlaut mark
-    {   "&igrave;",  0xCC   },  //  'Ì' - capital I, grave accent
-    {   "&iacute;",  0xCD   },  //  'Í' - capital I, acute accent
-    {   "&icirc;",   0xCE   },  //  'Î' - capital I, circumflex accent
-    {   "&iuml;",    0xCF   },  //  'Ï' - capital I, dieresis or umlaut mark
-    {   "&eth;",     0xD0   },  //  'Ð' - capital Eth, Icelandic
-    {   "&ntilde;",  0xD1   },  //  'Ñ' - capital N, tilde
-    {   "&ograve;",  0xD2   },  //  'Ò' - capital O, grave accent
-    {   "&oacute;",  0xD3   },  //  'Ó' - capital O, acute accent
-    {   "&ocirc;",   0xD4   },  //  'Ô' - capital O, circumflex accent
-    {   "&otilde;",  0xD5   },  //  'Õ' - capital O, tilde
-    {   "&ouml;",    0xD6   },  //  'Ö' - capital O, dieresis or umlaut mark
+    {   "&Agrave;",  0xC0   },  //  'À' - capital A, grave accent
+    {   "&Aacute;",  0xC1   },  //  'Á' - capital A, acute accent
+    {   "&Acirc;",   0xC2   },  //  'Â' - capital A, circumflex accent
+    {   "&Atilde;",  0xC3   },  //  'Ã' - capital A, tilde
+    {   "&Auml;",    0xC4   },  //  'Ä' - capital A, dieresis or umlaut mark
+    {   "&Aring;",   0xC5   },  //  'Å' - capital A, ring
+    {   "&AElig;",   0xC6   },  //  'Æ' - capital AE diphthong (ligature)
+    {   "&Ccedil;",  0xC7   },  //  'Ç' - capital C, cedilla
+    {   "&Egrave;",  0xC8   },  //  'È' - capital E, grave accent
+    {   "&Eacute;",  0xC9   },  //  'É' - capital E, acute accent
+    {   "&Ecirc;",   0xCA   },  //  'Ê' - capital E, circumflex accent
+    {   "&Euml;",    0xCB   },  //  'Ë' - capital E, dieresis or umlaut mark
+    {   "&Igrave;",  0xCC   },  //  'Ì' - capital I, grave accent
+    {   "&Iacute;",  0xCD   },  //  'Í' - capital I, acute accent
+    {   "&Icirc;",   0xCE   },  //  'Î' - capital I, circumflex accent
+    {   "&Iuml;",    0xCF   },  //  'Ï' - capital I, dieresis or umlaut mark
+    {   "&ETH;",     0xD0   },  //  'Ð' - capital Eth, Icelandic
+    {   "&Ntilde;",  0xD1   },  //  'Ñ' - capital N, tilde
+    {   "&Ograve;",  0xD2   },  //  'Ò' - capital O, grave accent
+    {   "&Oacute;",  0xD3   },  //  'Ó' - capital O, acute accent
+    {   "&Ocirc;",   0xD4   },  //  'Ô' - capital O, circumflex accent
+    {   "&Otilde;",  0xD5   },  //  'Õ' - capital O, tilde
+    {   "&Ouml;",    0xD6   },  //  'Ö' - capital O, dieresis or umlaut mark
     {   "&times;",   0xD7   },  //  '×' - multiply sign
-    {   "&oslash;",  0xD8   },  //  'Ø' - capital O, slash
-    {   "&ugrave;",  0xD9   },  //  'Ù' - capital U, grave accent
-    {   "&uacute;",  0xDA   },  //  'Ú' - capital U, acute accent
-    {   "&ucirc;",   0xDB   },  //  'Û' - capital U, circumflex accent
-    {   "&uuml;",    0xDC   },  //  'Ü' - capital U, dieresis or umlaut mark
-    {   "&yacute;",  0xDD   },  //  'Ý' - capital Y, acute accent
-    {   "&thorn;",   0xDE   },  //  'Þ' - capital THORN, Icelandic
+    {   "&Oslash;",  0xD8   },  //  'Ø' - capital O, slash
+    {   "&Ugrave;",  0xD9   },  //  'Ù' - capital U, grave accent
+    {   "&Uacute;",  0xDA   },  //  'Ú' - capital U, acute accent
+    {   "&Ucirc;",   0xDB   },  //  'Û' - capital U, circumflex accent
+    {   "&Uuml;",    0xDC   },  //  'Ü' - capital U, dieresis or umlaut mark
+    {   "&Yacute;",  0xDD   },  //  'Ý' - capital Y, acute accent
+    {   "&THORN;",   0xDE   },  //  'Þ' - capital THORN, Icelandic
     {   "&szlig;",   0xDF   },  //  'ß' - small sharp s, German (sz ligature)
     {   "&agrave;",  0xE0   },  //  'à' - small a, grave accent
     {   "&aacute;",  0xE1   },  //  'á' - small a, acute accent
@@ -295,6 +308,30 @@ struct  html_char_t                 html_table[ ] =
     {   "END",       0x00   },  //  'E' - Table end.
 };
 //----------------------------------------------------------------------------
+/**
+ *  @param  html_entity_hash    html_table index of each entity name,
+ *                              hashed without regard to case (-1 = empty)  */
+int16_t                             html_entity_hash[ HTML_ENTITY_HASH_L ];
+/**
+ *  @param  html_entity_once    Builds html_entity_hash on first use        */
+pthread_once_t                      html_entity_once = PTHREAD_ONCE_INIT;
+//----------------------------------------------------------------------------
+/**
+ *  @param  html_text_class     Ends a run of plain text in the scanner     */
+struct  text_class_t                html_text_class;
+/**
+ *  @param  html_raw_class      Ends a run of a style or script body        */
+struct  text_class_t                html_raw_class;
+/**
+ *  @param  html_decl_class     Ends a declaration                          */
+struct  text_class_t                html_decl_class;
+/**
+ *  @param  html_decode_class   Ends a run of text with nothing to decode   */
+struct  text_class_t                html_decode_class;
+/**
+ *  @param  html_class_once     Builds the character classes on first use   */
+pthread_once_t                      html_class_once = PTHREAD_ONCE_INIT;
+//----------------------------------------------------------------------------
 
 
 /****************************************************************************
@@ -303,207 +340,197 @@ struct  html_char_t                 html_table[ ] =
 
 /****************************************************************************/
 /**
- *  Locate the end of the current tag.
+ *  Remove consecutive spaces leaving only the first space.
  *
- *  @param  html_p              Pointer to the HTML source buffer.
+ *  @param  work_p              Pointer to the HTML source buffer.
+ *  @param  tmp_p               Pointer to a temporary buffer.
+ *  @param  buffer_l            size of both buffers.
  *
- *  @return tag_end_p           Upon successful completion a pointer to
- *                              The last character of a tag, else NULL
- *                              is returned.
+ *  @return render_p            Upon successful completion a pointer to
+ *                              a buffer containing the rendered text.
+ *                              Upon failure, NULL is returned.
  *
  *  @note
  *
  ****************************************************************************/
 
 char    *
-HTML2TXT__locate_tag_end(
-    char                        *   html_p
+HTML2TXT__remove_spaces(
+    char                        *   html_p,
+    int                             buffer_l
     )
 {
     /**
-     *  @param  tag_end_p       Tag End pointer                             */
-    char                        *   tag_end_p;
+     *  @param  html_offset_p   Pointer to the first space in HTML buffer   */
+    char                        *   html_offset_p;
+    /**
+     *  @param  found           Flag indicating a blank character was found */
+    int                             found;
+    /**
+     *  @param  delete_l        Number of spaces to be deleted              */
+    int                             delete_l;
+    /**
+     *  @param  html_l          Length of the text in the buffer            */
+    int                             html_l;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
-    //  Set the starting point
-    tag_end_p = html_p;
+    //  Set the start of the buffer
+    html_offset_p = html_p;
+    html_l = strlen( html_p );
 
     /************************************************************************
-     *  Find and remove Carriage Returns
+     *  Remove consecutive spaces
      ************************************************************************/
 
-    //  Is this a comment tag ?
-    if ( strncmp( html_p, "<!--", 4 ) == 0 )
+    //  Loop through the buffer as many times as needed.
+    do
     {
-        //  Find the end of the comment.
-        tag_end_p = strstr( html_p, "-->" );
+        //  The assumption is that we ar done here.
+        found = false;
 
-        //  Locate the tag end character
-        tag_end_p = strchr( tag_end_p, '>' );
+        //  Locate the next space in both buffers.
+        html_offset_p = strchr( &html_offset_p[ 1 ], ' ' );
 
-    }
-    else
-    {
-        //  NO:     Lets find the end
-        tag_end_p = strchr( html_p, '>' );
-    }
+        //  Did we find a space in the buffer ?
+        if ( html_offset_p != NULL )
+        {
+            //  YES:    Count the number of sequential spaces
+            for( delete_l = 0;
+                 isblank( html_offset_p[ delete_l ] ) != 0;
+                 delete_l += 1 )
+            {
+                //  Nothing to do here; the above statement will walk
+                //  the pointer to the next non-space character.
+            }
+
+            //  Is there more then one blank character ?
+            if ( delete_l > 1 )
+            {
+                //  YES:    Delete all but the first blank character.
+                html_l = ( html_offset_p - html_p )
+                       + text_remove_len( html_offset_p,
+                                          html_l - ( html_offset_p - html_p ),
+                                          1, ( delete_l - 1 ) );
+            }
+
+            //  A blank was found.  Do another pass.
+            found = true;
+        }
+
+    }   while( found == true );
 
     /************************************************************************
      *  Function Exit
      ************************************************************************/
 
     //  DONE!
-    return( tag_end_p );
+    return( html_p );
 }
 
 /****************************************************************************/
 /**
- *  Test the current string for a valid HTML tag.  When a valid HTML tag is
- *  discovered, unneeded spaces are removed.
+ *  Hash an entity or tag name without regard to case.
  *
- *  @param  html_p              Pointer to the beginning of the HTML buffer.
- *  @param  tag_p               Pointer to the beginning of the possible tag.
- *  @param  format              0 & 1 = Start tag, 2 = end tag.
+ *  @param  name_p              Pointer to the name.
+ *  @param  name_l              Length of the name.
  *
- *  @return tag_start_p         When 'tag_p' is pointing to a valid HTML tag
- *                              a pointer to the first character of the tag
- *                              is returned.  Else NULL is returned.
+ *  @return hash                Hash value of the name.
  *
  *  @note
- *      Format 0    -   <tag>
- *      Format 1    -   <tag ... >
- *      Format 3    -   </tag>
  *
  ****************************************************************************/
 
-char    *
-HTML2TXT__tag_clean(
-    char                        *   html_p,
-    char                        *   tag_start_p,
-    int                             tag_l,
-    int                             format
+uint32_t
+HTML2TXT__name_hash(
+    const char                  *   name_p,
+    int                             name_l
     )
 {
     /**
-     *  @param  tmp_start_p     Pointer to the start of the tag             */
-    char                        *   tmp_start_p;
-    /**
-     *  @param  tmp_end_p       Pointer to the end of the tag               */
-    char                        *   tmp_end_p;
+     *  @param  hash            FNV-1a hash of the name                     */
+    uint32_t                        hash;
     /**
-     *  @param  delete_offset   Offset to data to be removed.               */
-    int                             delete_offset;
-    /**
-     *  @param  end_offset      Offset to end of the tag.                   */
-    int                             end_offset;
+     *  @param  ndx             Index into the name                         */
+    int                             ndx;
 
     /************************************************************************
-     *  Function Initialization
+     *  Function
      ************************************************************************/
 
-    //  Set the default delete offset.
-    delete_offset = 1;
+    hash = 2166136261u;
 
-    //  Set the default end offset.
-    end_offset = 1;
+    for ( ndx = 0;
+          ndx < name_l;
+          ndx += 1 )
+    {
+        hash ^= (uint32_t)tolower( (unsigned char)name_p[ ndx ] );
+        hash *= 16777619u;
+    }
 
     /************************************************************************
-     *  Remove spaces from the start of a tag.
+     *  Function Exit
      ************************************************************************/
 
-    for ( tmp_start_p = &tag_start_p[ -1 ];
-          tmp_start_p >= html_p;
-          tmp_start_p -= 1 )
-    {
-        //  Is this a blank character ?
-        if ( isblank( tmp_start_p[ 0 ] ) == 0 )
-        {
-            //  NO:     We are done looking
-            break;
-        }
-    }
+    //  DONE!
+    return( hash );
+}
 
-    //  Could this be a HTML end-tag ?
-    if (    ( format               == 2   )
-         && ( tmp_start_p[ 0 ] == '/' ) )
-    {
-        //  YES:    Are there blank characters to be removed ?
-        if ( ( tag_start_p - tmp_start_p ) > delete_offset )
-        {
-            //  YES:    Remove them
-            text_remove( tmp_start_p, delete_offset,
-                         ( tag_start_p - tmp_start_p - 1 ) );
-        }
-        //  Clean between '<' and '/' ?
-        tmp_start_p = HTML2TXT__tag_clean( html_p, tmp_start_p, tag_l, -1 );
-    }
+/****************************************************************************/
+/**
+ *  Build the tag hash table from html_tag_list.  Called once.
+ *
+ *  @param  void                No parameters
+ *
+ *  @return void
+ *
+ *  @note
+ *      Entries are inserted in table order so the first entry of a tag
+ *      that is listed more than once is the one that is used.
+ *
+ ****************************************************************************/
 
-    //  Is this a valid HTML start tag ?
-    else
-    if ( tmp_start_p[ 0 ] == '<' )
-    {
-        //  YES:    Are there blank characters to be removed ?
-        if ( ( tag_start_p - tmp_start_p ) > delete_offset )
-        {
-            //  YES:    Remove them
-            text_remove( tmp_start_p, delete_offset,
-                         ( tag_start_p - tmp_start_p - 1 ) );
-        }
-    }
-    else
-    {
-        //  NO:     Not a valid HTML tag
-        tmp_start_p = NULL;
-    }
+void
+HTML2TXT__tag_init(
+    void
+    )
+{
+    /**
+     *  @param  ndx             Index into the tag table                    */
+    int                             ndx;
+    /**
+     *  @param  slot            Hash table slot                             */
+    uint32_t                        slot;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Mark every slot empty
+    memset( html_tag_hash, 0xFF, sizeof( html_tag_hash ) );
 
     /************************************************************************
-     *  Remove spaces from the end of a tag.
+     *  Function
      ************************************************************************/
 
-    //  Should we remove spaces from the end of the tag ?
-    if(    ( tmp_start_p != NULL )
-        && (    ( format == 0 )
-             || ( format == 2 ) ) )
+    //  Loop through the search table
+    for ( ndx = 0;
+          html_tag_list[ ndx ].name_l != 99;
+          ndx += 1 )
     {
-        //  YES:    Is this a format 2 tag search
-        if ( format == 2 )
-        {
-            //  YES:    Increase the end offset
-            end_offset += 1;
-        }
+        slot = HTML2TXT__name_hash( html_tag_list[ ndx ].name,
+                                    html_tag_list[ ndx ].name_l );
 
-        //  YES:
-        for ( tmp_end_p = &tmp_start_p[ tag_l + end_offset ];
-              tmp_end_p[ 0 ] != '\0';
-              tmp_end_p += 1 )
+        //  Find an empty slot
+        for ( slot &= ( HTML_TAG_HASH_L - 1 );
+              html_tag_hash[ slot ] >= 0;
+              slot = ( slot + 1 ) & ( HTML_TAG_HASH_L - 1 ) )
         {
-            //  Is this a blank character ?
-            if ( isblank( tmp_end_p[ 0 ] ) == 0 )
-            {
-                //  NO:     We are done looking
-                break;
-            }
         }
 
-        //  Is this a valid HTML start tag ?
-        if ( tmp_end_p[ 0 ] == '>'  )
-        {
-            //  YES:    Are there blank characters to be removed ?
-            if ( ( tmp_end_p - &tmp_start_p[ tag_l + end_offset ] ) > 1 )
-            {
-                //  YES:    Remove them
-                text_remove( tmp_start_p, ( tag_l + end_offset ),
-                            ( tmp_end_p - &tmp_start_p[ tag_l + end_offset ] ) );
-            }
-        }
-        else
-        {
-            //  NO:     Not a valid HTML tag
-            tmp_start_p = NULL;
-        }
+        html_tag_hash[ slot ] = ndx;
     }
 
     /************************************************************************
@@ -511,183 +538,136 @@ HTML2TXT__tag_clean(
      ************************************************************************/
 
     //  DONE!
-    return( tmp_start_p );
 }
 
 /****************************************************************************/
 /**
- *  Remove Carriage Return & Line Feed
+ *  Look up what to do with a tag.
  *
- *  @param  work_p              Pointer to the HTML source buffer.
- *  @param  tmp_p               Pointer to a temporary buffer.
- *  @param  buffer_l            size of both buffers.
+ *  @param  name_p              Lowercase tag name.
+ *  @param  name_l              Length of the tag name.
  *
- *  @return render_p            Upon successful completion a pointer to
- *                              a buffer containing the rendered text.
- *                              Upon failure, NULL is returned.
+ *  @return task                The HTML_TAG_xxx_xxx task for the tag.
  *
  *  @note
+ *      A tag that is not in html_tag_list is deleted.
  *
  ****************************************************************************/
 
-char    *
-HTML2TXT__crlf_replace(
-    char                        *   html_p,
-    char                        *   tmp_p,
-    int                             buffer_l
+int
+HTML2TXT__tag_lookup(
+    const char                  *   name_p,
+    int                             name_l
     )
 {
     /**
-     *  @param  html_offset_p   Pointer to the first space in HTML buffer   */
-    char                        *   html_offset_p;
+     *  @param  task            What to do with the tag                     */
+    int                             task;
+    /**
+     *  @param  slot            Hash table slot                             */
+    uint32_t                        slot;
     /**
-     *  @param  altered         Flag indicating the buffer was altered      */
-    int                             altered;
+     *  @param  tag_p           Pointer to a tag table entry                */
+    struct  html_tag_t          *   tag_p;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
+    task = HTML_TAG_DEL_DEL;
 
-    /************************************************************************
-     *  Find and remove Carriage Returns
-     ************************************************************************/
-
-    //  Initialize the pointers
-    html_offset_p = html_p;
-
-    //  Loop through the buffer as many times as needed.
-    do
-    {
-        //  Assume there is more to do.
-        altered = false;
-
-        //  Locate the next space in both buffers.
-        html_offset_p = strchr( html_offset_p, '\r' );
-
-        //  Did we find a Carriage Return in the buffer ?
-        if ( html_offset_p != NULL )
-        {
-            //  YES:    Remove it from the data buffer
-            text_remove( html_offset_p, 0, 1 );
-
-            //  Found it and removed it.
-            altered = true;
-        }
-
-    }   while( altered == true );
+    //  Build the hash table the first time through
+    pthread_once( &html_tag_once, HTML2TXT__tag_init );
 
     /************************************************************************
-     *  Find and remove Line Feed
+     *  Function
      ************************************************************************/
-#if 0
-    //  Initialize the pointers
-    html_offset_p = html_p;
 
-    //  Loop through the buffer as many times as needed.
-    do
+    //  Probe until an empty slot is found
+    for ( slot = ( HTML2TXT__name_hash( name_p, name_l )
+                   & ( HTML_TAG_HASH_L - 1 ) );
+          html_tag_hash[ slot ] >= 0;
+          slot = ( slot + 1 ) & ( HTML_TAG_HASH_L - 1 ) )
     {
-        //  Assume there is more to do.
-        altered = false;
-
-        //  Locate the next space in both buffers.
-        html_offset_p = strchr( html_offset_p, '\n' );
+        tag_p = &html_tag_list[ html_tag_hash[ slot ] ];
 
-        //  Did we find a Line Feed in the buffer ?
-        if ( html_offset_p != NULL )
+        //  Is this the tag ?
+        if (    ( tag_p->name_l == name_l )
+             && ( memcmp( tag_p->name, name_p, name_l ) == 0 ) )
         {
-            //  YES:    Copy the remaining temporary buffer to the HTML buffer
-#if 1
-            text_replace( html_offset_p, buffer_l, 0, "<br>", 1 );
-#else
-            text_remove( html_offset_p, 0, 1 );
-#endif
-            //  There are no more spaces in the buffer
-            altered = true;
+            //  YES:    This is the one
+            task = tag_p->task;
+            break;
         }
-
-    }   while( altered == true );
-#endif
+    }
 
     /************************************************************************
      *  Function Exit
      ************************************************************************/
 
     //  DONE!
-    return( html_p );
+    return( task );
 }
 
 /****************************************************************************/
 /**
- *  Remove HTML comments <!-- through -->
- *
- *  @param  html_p              Pointer to the HTML source buffer.
+ *  Build the character classes used to skip over runs of characters that
+ *  need no work.  Called once.
  *
- *  @return void                There is no return code for this function.
+ *  @param  void                No parameters
  *
- *  @note
+ *  @return void
  *
  ****************************************************************************/
 
 void
-HTML2TXT__remove_comments(
-    char                        *   html_p
+HTML2TXT__class_init(
+    void
     )
 {
-    /**
-     *  @param  comment_start_p Pointer to the start of a comment.          */
-    char                        *   comment_start_p;
-    /**
-     *  @param  comment_end_p   Pointer to the end of a comment.            */
-    char                        *   comment_end_p;
-    /**
-     *  @param  comment_l       Size of the comment string.                 */
-    int                             comment_l;
-    /**
-     *  @param  found           Flag indicating a blank character was found */
-    int                             found;
 
     /************************************************************************
-     *  Function Initialization
+     *  Function
      ************************************************************************/
 
-    //  Set the start of the buffer
-    comment_start_p = html_p;
+    text_class_init( &html_text_class,   "<\r",  1,    0    );
+    text_class_init( &html_raw_class,    "<",    1,    0    );
+    text_class_init( &html_decl_class,   ">",    1,    0    );
+    text_class_init( &html_decode_class, "&Uu",  0x80, 0xFF );
 
     /************************************************************************
-     *  Remove consecutive spaces
+     *  Function Exit
      ************************************************************************/
 
-    //  Loop through the buffer as many times as needed.
-    do
-    {
-        //  The assumption is that we ar done here.
-        found = false;
+    //  DONE!
+}
 
-        //  Scan the HTML buffer for the start of a comment
-        comment_start_p = strstr( comment_start_p, "<!--" );
+/****************************************************************************/
+/**
+ *  Prepare a tag scanner for a new document.
+ *
+ *  @param  scan_p              Pointer to the scanner state.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
 
-        //  Did we find a comment start ?
-        if( comment_start_p != NULL )
-        {
-            //  YES:    Scan the HTML buffer for the end of a comment
-            comment_end_p = strstr( comment_start_p, "-->" );
+void
+HTML2TXT__scan_init(
+    struct  html_scan_t         *   scan_p
+    )
+{
 
-            //  Did we find a comment end ?
-            if ( comment_end_p != NULL )
-            {
-                //  YES:    Set the comment size
-                comment_l = ( (comment_end_p - comment_start_p ) + 3 );
+    /************************************************************************
+     *  Function
+     ************************************************************************/
 
-                //  Remove the comment from the buffer
-                text_remove( comment_start_p, 0, comment_l );
+    memset( scan_p, 0x00, sizeof( struct html_scan_t ) );
 
-                //  Change the flag to show a comment was found
-                found = true;
-            }
-        }
+    scan_p->state = HTML_SCAN_TEXT;
 
-    }   while( found == true );
+    //  Build the character classes the first time through
+    pthread_once( &html_class_once, HTML2TXT__class_init );
 
     /************************************************************************
      *  Function Exit
@@ -698,408 +678,491 @@ HTML2TXT__remove_comments(
 
 /****************************************************************************/
 /**
- *  Remove consecutive spaces leaving only the first space.
- *
- *  @param  work_p              Pointer to the HTML source buffer.
- *  @param  tmp_p               Pointer to a temporary buffer.
- *  @param  buffer_l            size of both buffers.
+ *  Finish the tag that has just been closed by a '>'.
  *
- *  @return render_p            Upon successful completion a pointer to
- *                              a buffer containing the rendered text.
- *                              Upon failure, NULL is returned.
+ *  @param  scan_p              Pointer to the scanner state.
+ *  @param  out_p               Where the tag's output goes.
  *
- *  @note
+ *  @return out_l               Number of characters written to out_p.
  *
  ****************************************************************************/
 
-char    *
-HTML2TXT__remove_spaces(
-    char                        *   html_p,
-    int                             buffer_l
+int
+HTML2TXT__scan_tag(
+    struct  html_scan_t         *   scan_p,
+    char                        *   out_p
     )
 {
     /**
-     *  @param  html_offset_p   Pointer to the first space in HTML buffer   */
-    char                        *   html_offset_p;
+     *  @param  out_l           Number of characters written                */
+    int                             out_l;
     /**
-     *  @param  found           Flag indicating a blank character was found */
-    int                             found;
+     *  @param  task            What to do with the tag                     */
+    int                             task;
     /**
-     *  @param  delete_l        Number of spaces to be deleted              */
-    int                             delete_l;
+     *  @param  process_type    Tells us what to do with the tag            */
+    int                             process_type;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
-    //  Set the start of the buffer
-    html_offset_p = html_p;
+    out_l = 0;
+
+    //  Unless it starts a style or script body the text comes next
+    scan_p->state = HTML_SCAN_TEXT;
 
     /************************************************************************
-     *  Remove consecutive spaces
+     *  Function
      ************************************************************************/
 
-    //  Loop through the buffer as many times as needed.
-    do
+    //  Is the tag name too long to be a known tag ?
+    if ( scan_p->name_l > HTML_TAG_L )
     {
-        //  The assumption is that we ar done here.
-        found = false;
-
-        //  Locate the next space in both buffers.
-        html_offset_p = strchr( &html_offset_p[ 1 ], ' ' );
+        //  YES:    Delete it
+        task = HTML_TAG_DEL_DEL;
+    }
+    else
+    {
+        //  NO:     Look it up
+        task = HTML2TXT__tag_lookup( scan_p->name, scan_p->name_l );
+    }
 
-        //  Did we find a space in the buffer ?
-        if ( html_offset_p != NULL )
-        {
-            //  YES:    Count the number of sequential spaces
-            for( delete_l = 0;
-                 isblank( html_offset_p[ delete_l ] ) != 0;
-                 delete_l += 1 )
-            {
-                //  Nothing to do here; the above statement will walk
-                //  the pointer to the next non-space character.
-            }
+    //  What should we do with the source data ?
+    if ( scan_p->end_tag == false )
+    {
+        process_type = ( task >> 4 ) & 0x0F;
+    }
+    else
+    {
+        process_type =   task        & 0x0F;
+    }
 
-            //  Is there more then one blank character ?
-            if ( delete_l > 1 )
-            {
-                //  YES:    Delete all but the first blank character.
-                text_remove( html_offset_p, 1, ( delete_l - 1 ) );
-            }
+    //  Should the tag be replaced with a new line ?
+    if ( process_type == HTML_TAG_END_CRLF )
+    {
+        //  YES:    Insert it
+        out_p[ out_l++ ] = '\n';
+    }
 
-            //  A blank was found.  Do another pass.
-            found = true;
-        }
+    //  Does a style or script body follow ?
+    if (    ( scan_p->end_tag    == false )
+         && ( scan_p->self_close == false ) )
+    {
+        scan_p->name[ scan_p->name_l < HTML_TAG_L ? scan_p->name_l
+                                                  : HTML_TAG_L ] = '\0';
 
-    }   while( found == true );
+        if (    ( strcmp( scan_p->name, "style"  ) == 0 )
+             || ( strcmp( scan_p->name, "script" ) == 0 ) )
+        {
+            //  YES:    Skip it
+            scan_p->state   = HTML_SCAN_RAW;
+            scan_p->match_l = 0;
+        }
+    }
 
     /************************************************************************
      *  Function Exit
      ************************************************************************/
 
     //  DONE!
-    return( html_p );
+    return( out_l );
 }
 
 /****************************************************************************/
 /**
- *  Remove HTML tags from the buffer
+ *  Run part of a document through the tag scanner.  Tags are replaced by
+ *  a new line or deleted, comments, declarations and style and script
+ *  bodies are deleted and carriage returns are removed.
  *
- *  @param  work_p              Pointer to the HTML source buffer.
- *  @param  tmp_p               Pointer to a temporary buffer.
- *  @param  buffer_l            size of both buffers.
+ *  @param  scan_p              Pointer to the scanner state.
+ *  @param  in_p                Pointer to the HTML source data.
+ *  @param  in_l                Number of bytes of source data.
+ *  @param  out_p               Where the text goes.  It may be the same
+ *                              buffer as in_p.
  *
- *  @return render_p            Upon successful completion a pointer to
- *                              a buffer containing the rendered text.
- *                              Upon failure, NULL is returned.
+ *  @return out_l               Number of characters written to out_p.
  *
  *  @note
+ *      The scanner keeps its state between calls so a document can be
+ *      passed through in any number of pieces.  No more than in_l + 1
+ *      characters are written, and no more than the number of characters
+ *      read so far when out_p is the source buffer.
  *
  ****************************************************************************/
 
-char    *
-HTML2TXT__remove_style(
-    char                        *   html_p,
-    int                             buffer_l
+int
+HTML2TXT__scan(
+    struct  html_scan_t         *   scan_p,
+    const char                  *   in_p,
+    int                             in_l,
+    char                        *   out_p
     )
 {
     /**
-     *  @param  html_offset_p   Pointer to the first space in HTML buffer   */
-    char                        *   html_offset_p;
+     *  @param  out_l           Number of characters written                */
+    int                             out_l;
     /**
-     *  @param  tmp_offset_p    Pointer to the last space in the tmp buffer */
-    char                        *   tmp_offset_p;
+     *  @param  ndx             Index into the source data                  */
+    int                             ndx;
     /**
-     *  @param  altered         Flag indicating the buffer was altered      */
-    int                             altered;
+     *  @param  in_char         The current source character                */
+    int                             in_char;
     /**
-     *  @param  replace_l       Size of the string to be deleted.           */
-    int                             delete_l;
+     *  @param  want_char       Next character of a style or script end tag */
+    int                             want_char;
+    /**
+     *  @param  run_l           Number of characters in a run of text       */
+    int                             run_l;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
+    out_l = 0;
 
     /************************************************************************
      *  Function
      ************************************************************************/
 
-    //  Loop through the buffer as many times as needed.
-    do
+    for ( ndx = 0;
+          ndx < in_l;
+          ndx += 1 )
     {
-        //  The flag will be changed when a '<style...' is removed.
-        altered = false;
+        in_char = (unsigned char)in_p[ ndx ];
 
-        //  Locate the next '<style' string
-        html_offset_p = strcasestr( html_p, "<style" );
+        //  Carriage returns are always removed
+        if ( in_char == '\r' )
+        {
+            continue;
+        }
 
-        //  Did we find it ?
-        if( html_offset_p != NULL )
+        switch( scan_p->state )
         {
-            /****************************************************************
-             *  <style> ... </style>
-             *  <style ... />
-             *  <style ... > ... </style>
-             ****************************************************************/
-
-            //  YES:    <style> ... </style> ?
-            if (    ( html_offset_p[ 6 ]== '>' )
-                 || ( html_offset_p[ 7 ]== '>' ) )
+            //  Text between tags
+            case    HTML_SCAN_TEXT:
             {
-                //  YES:    Find the end '</style>' tag
-                tmp_offset_p = strcasestr( html_offset_p, "</style>" );
-
-                //  Did we find it ?
-                if ( tmp_offset_p != NULL )
+                //  Is this the start of a tag ?
+                if ( in_char == '<' )
                 {
-                    //  YES:    Set the remove length.
-                    delete_l = ( ( tmp_offset_p + 8 ) - html_offset_p );
+                    //  YES:    Find out what kind
+                    scan_p->state       = HTML_SCAN_OPEN;
+                    scan_p->name_l      = 0;
+                    scan_p->end_tag     = false;
+                    scan_p->self_close  = false;
                 }
                 else
                 {
-                    //  NO:     Delete to the end
-                    delete_l = strlen( html_offset_p );
+                    //  NO:     Keep it and the rest of the run of text
+                    run_l = text_find_class( &in_p[ ndx ], in_l - ndx,
+                                             &html_text_class );
+                    memmove( &out_p[ out_l ], &in_p[ ndx ], run_l );
+                    out_l += run_l;
+                    ndx   += run_l - 1;
                 }
-            }
-            //  YES:
-            else
+            }   break;
+
+            //  The character following a '<'
+            case    HTML_SCAN_OPEN:
             {
-                tmp_offset_p = strchr( html_offset_p, '>' );
+                //  Is this an end tag ?
+                if ( in_char == '/' )
+                {
+                    //  YES:    The name comes next
+                    scan_p->end_tag = true;
+                    scan_p->state   = HTML_SCAN_NAME;
+                }
+                //  Is this the first character of a tag name ?
+                else if ( isalpha( in_char ) != 0 )
+                {
+                    //  YES:    Start the name
+                    scan_p->name[ scan_p->name_l++ ] = tolower( in_char );
+                    scan_p->state = HTML_SCAN_NAME;
+                }
+                //  Is this a comment or a declaration ?
+                else if ( in_char == '!' )
+                {
+                    //  YES:    Count the dashes to find out which
+                    scan_p->match_l = 0;
+                    scan_p->state   = HTML_SCAN_BANG;
+                }
+                //  Is this a processing instruction ?
+                else if ( in_char == '?' )
+                {
+                    //  YES:    Skip it
+                    scan_p->state = HTML_SCAN_DECL;
+                }
+                else
+                {
+                    //  NO:     The '<' was just text
+                    out_p[ out_l++ ] = '<';
 
-                //  Did we find the end of the start tag ?
-                if ( tmp_offset_p != NULL )
+                    //  Is this another '<' ?
+                    if ( in_char != '<' )
+                    {
+                        //  NO:     Keep it
+                        out_p[ out_l++ ] = in_char;
+                        scan_p->state = HTML_SCAN_TEXT;
+                    }
+                }
+            }   break;
+
+            //  The tag name
+            case    HTML_SCAN_NAME:
+            {
+                //  Is this part of the name ?
+                if ( isalnum( in_char ) != 0 )
                 {
-                    //  YES:    Is it a '/>' ?
-                    if ( tmp_offset_p[ -1 ] == '/' )
+                    //  YES:    Save it if there is room
+                    if ( scan_p->name_l < HTML_TAG_L )
                     {
-                        //  YES:    <style ... /> ?
-                        delete_l = ( tmp_offset_p - html_offset_p );
+                        scan_p->name[ scan_p->name_l ] = tolower( in_char );
                     }
-                    else
+
+                    //  An over long name stops at HTML_TAG_L + 1
+                    if ( scan_p->name_l <= HTML_TAG_L )
                     {
-                        //  NO:     <style ... > ... </style>
-                        tmp_offset_p = strcasestr( html_offset_p, "</style>" );
-
-                        //  Did we find it ?
-                        if ( tmp_offset_p != NULL )
-                        {
-                            //  YES:    Set the remove length.
-                            delete_l = ( ( tmp_offset_p + 8 ) - html_offset_p );
-                        }
-                        else
-                        {
-                            //  NO:     Delete to the end
-                            delete_l = strlen( html_offset_p );
-                        }
+                        scan_p->name_l += 1;
                     }
                 }
+                //  Is this the end of the tag ?
+                else if ( in_char == '>' )
+                {
+                    //  YES:    Process it
+                    out_l += HTML2TXT__scan_tag( scan_p, &out_p[ out_l ] );
+                }
                 else
                 {
-                    //  NO:     Delete to the end
-                    delete_l = strlen( html_offset_p );
+                    //  NO:     Skip the attributes
+                    scan_p->self_close = ( in_char == '/' );
+                    scan_p->state      = HTML_SCAN_ATTR;
                 }
-            }
+            }   break;
 
-            //  Now delete the '<style> ... </style>' from the buffer.
-            text_remove( html_offset_p, 0, delete_l );
+            //  The tag attributes
+            case    HTML_SCAN_ATTR:
+            {
+                //  Is this the end of the tag ?
+                if ( in_char == '>' )
+                {
+                    //  YES:    Process it
+                    out_l += HTML2TXT__scan_tag( scan_p, &out_p[ out_l ] );
+                }
+                else if ( isspace( in_char ) == 0 )
+                {
+                    //  NO:     Remember if it might end with '/>'
+                    scan_p->self_close = ( in_char == '/' );
+                }
+            }   break;
 
-            //  Change the flag so we can look for another one.
-            altered = true;
-        }
+            //  The characters following '<!'
+            case    HTML_SCAN_BANG:
+            {
+                //  Is this a dash ?
+                if ( in_char == '-' )
+                {
+                    //  YES:    Is this the start of a comment ?
+                    scan_p->match_l += 1;
+
+                    if ( scan_p->match_l == 2 )
+                    {
+                        //  YES:    Skip to the end of the comment
+                        scan_p->match_l = 0;
+                        scan_p->state   = HTML_SCAN_COMMENT;
+                    }
+                }
+                //  Is this the end of the declaration ?
+                else if ( in_char == '>' )
+                {
+                    //  YES:    Back to text
+                    scan_p->state = HTML_SCAN_TEXT;
+                }
+                else
+                {
+                    //  NO:     It is a declaration
+                    scan_p->state = HTML_SCAN_DECL;
+                }
+            }   break;
+
+            //  A comment
+            case    HTML_SCAN_COMMENT:
+            {
+                //  Is this the end of the comment ?
+                if (    ( in_char         == '>' )
+                     && ( scan_p->match_l >=  2  ) )
+                {
+                    //  YES:    Back to text
+                    scan_p->state = HTML_SCAN_TEXT;
+                }
+                else
+                {
+                    //  NO:     Count the dashes
+                    scan_p->match_l = ( in_char == '-' ) ? scan_p->match_l + 1
+                                                         : 0;
+                }
+            }   break;
+
+            //  A declaration or a processing instruction
+            case    HTML_SCAN_DECL:
+            {
+                //  Is this the end of it ?
+                if ( in_char == '>' )
+                {
+                    //  YES:    Back to text
+                    scan_p->state = HTML_SCAN_TEXT;
+                }
+                else
+                {
+                    //  NO:     Skip to the next '>'
+                    ndx += text_find_class( &in_p[ ndx + 1 ], in_l - ndx - 1,
+                                            &html_decl_class );
+                }
+            }   break;
 
-    }   while( altered == true );
+            //  The body of a style or script tag
+            case    HTML_SCAN_RAW:
+            {
+                //  What is the next character of the '</name' end tag ?
+                if ( scan_p->match_l < 2 )
+                {
+                    want_char = "</"[ scan_p->match_l ];
+                }
+                else
+                {
+                    want_char = scan_p->name[ scan_p->match_l - 2 ];
+                }
+
+                //  Does this character match it ?
+                if ( tolower( in_char ) == want_char )
+                {
+                    //  YES:    Is that the whole end tag name ?
+                    scan_p->match_l += 1;
+
+                    if ( scan_p->match_l == ( scan_p->name_l + 2 ) )
+                    {
+                        //  YES:    Skip to the end of the tag
+                        scan_p->state = HTML_SCAN_DECL;
+                    }
+                }
+                //  Is this the start of an end tag ?
+                else if ( in_char == '<' )
+                {
+                    //  YES:    Start over with it
+                    scan_p->match_l = 1;
+                }
+                else
+                {
+                    //  NO:     Start over at the next '<'
+                    scan_p->match_l = 0;
+                    ndx += text_find_class( &in_p[ ndx + 1 ], in_l - ndx - 1,
+                                            &html_raw_class );
+                }
+            }   break;
+        }
+    }
 
     /************************************************************************
      *  Function Exit
      ************************************************************************/
 
     //  DONE!
-    return( html_p );
+    return( out_l );
 }
 
 /****************************************************************************/
 /**
- *  Find and convert to text HTML tags.
+ *  Finish scanning a document.
  *
- *  @param  work_p              Pointer to the HTML source buffer.
- *  @param  tmp_p               Pointer to a temporary buffer.
- *  @param  buffer_l            size of both buffers.
+ *  @param  scan_p              Pointer to the scanner state.
+ *  @param  out_p               Where any remaining text goes.
  *
- *  @return render_p            Upon successful completion a pointer to
- *                              a buffer containing the rendered text.
- *                              Upon failure, NULL is returned.
+ *  @return out_l               Number of characters written to out_p.
  *
  *  @note
+ *      A document ending inside a tag, comment or style or script body
+ *      loses the unfinished part.
  *
  ****************************************************************************/
 
-char    *
-HTML2TXT__tag_scan(
-    char                        *   html_p,
-    int                             buffer_l
+int
+HTML2TXT__scan_finish(
+    struct  html_scan_t         *   scan_p,
+    char                        *   out_p
     )
 {
     /**
-     *  @param  html_offset_p   Pointer to the first space in HTML buffer   */
-    char                        *   html_offset_p;
-    /**
-     *  @param  tmp_offset_p    Pointer to the last space in the tmp buffer */
-    char                        *   tmp_offset_p;
-    /**
-     *  @param  found           Flag indicating something was found         */
-    int                             found;
-    /**
-     *  @param  html_tag        A buffer holding the HTML tag from the array*/
-    char                            html_tag[ 32 ];
-    /**
-     *  @param  ndx             Index into the array table                  */
-    int                             ndx;
-    /**
-     *  @param  type            HTML tag type to build                      */
-    int                             format;
-    /**
-     *  @param  process_type    Tells us what to do with the tag            */
-    int                             process_type;
+     *  @param  out_l           Number of characters written                */
+    int                             out_l;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
+    out_l = 0;
 
     /************************************************************************
      *  Function
      ************************************************************************/
 
-    //  Loop through the search table
-    for ( ndx = 0;
-          html_tag_list[ ndx ].name_l != 99;
-          ndx += 1 )
+    //  Did the document end with a '<' ?
+    if ( scan_p->state == HTML_SCAN_OPEN )
     {
-{
-    //  DEBUG TRAP CODE
-    if ( ndx == 54 ) {
-        tmp_offset_p = html_tag_list[ ndx ].name; }
+        //  YES:    It was just text
+        out_p[ out_l++ ] = '<';
+    }
+
+    //  Ready for another document
+    HTML2TXT__scan_init( scan_p );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( out_l );
 }
-        //  Search the array using the three tag format types
-        for( format = 0;
-             format < 3;
-             format += 1 )
-        {
-            //  Clean out the HTML tag buffer
-            memset( html_tag, '\0', sizeof( html_tag ) );
 
-            //  Reset the buffer starting point.
-            html_offset_p = html_p;
+/****************************************************************************/
+/**
+ *  Find and convert to text HTML tags.  Comments, carriage returns and
+ *  style and script bodies are removed in the same pass.
+ *
+ *  @param  html_p              Pointer to the HTML source buffer.
+ *
+ *  @return html_p              The rendered text, in place.
+ *
+ *  @note
+ *
+ ****************************************************************************/
 
-            //  Set the search string
-            snprintf( html_tag, sizeof( html_tag ),
-                      "%s", html_tag_list[ ndx ].name );
+char    *
+HTML2TXT__tag_scan(
+    char                        *   html_p
+    )
+{
+    /**
+     *  @param  scan            Tag scanner state                           */
+    struct  html_scan_t             scan;
+    /**
+     *  @param  out_l           Size of the rendered text                   */
+    int                             out_l;
 
-            //  Loop through the buffer as many times as needed.
-            do
-            {
-                //  The assume is that we are done.
-                found = false;
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
 
-                //  Locate the next possible tag.
-                html_offset_p = strcasestr( html_offset_p, html_tag );
+    HTML2TXT__scan_init( &scan );
 
-                //  Did we find a match to the tag name ?
-                if ( html_offset_p != NULL )
-                {
-                    //  Clean up the start of the tag
-                    tmp_offset_p = HTML2TXT__tag_clean( html_p,
-                                                        html_offset_p,
-                                                        strlen( html_tag ),
-                                                        format );
-
-                    //  Is this the start of a valid HTML tag ?
-                    if ( tmp_offset_p != NULL )
-                    {
-                        //  Update the pointer with the new tag start location
-                        html_offset_p = tmp_offset_p;
-
-                        //  What should we do with the source data ?
-                        if ( format == 0 || format == 1 )
-                        {
-                            process_type = ( html_tag_list[ ndx ].task >> 4 ) & 0x0F;
-                        }
-                        else
-                        {
-                            process_type =   html_tag_list[ ndx ].task        & 0x0F;
-                        }
-
-                        //  YES:    What should we do with it ?
-                        switch( process_type )
-                        {
-                            //  Remove the tag_start and the tag_end
-                            case    HTML_TAG_END_DEL:
-                            {
-                                //  Locate the end of the tag
-                                tmp_offset_p = HTML2TXT__locate_tag_end( html_offset_p );
-
-                                //  Did we locate the end of the tag ?
-                                if ( tmp_offset_p != NULL )
-                                {
-                                    //  YES:    Now delete the '<style> ... </style>' from the buffer.
-                                    text_remove( html_offset_p, 0,
-                                                 ( tmp_offset_p - html_offset_p + 1 ) );
-                                }
-                                else
-                                {
-                                    //  NO:     Not good.  Delete the remainder
-                                    //          of the buffer
-                                    html_offset_p[ 0 ] = '\0';
-                                }
-
-                                //  A HTML tag was found and removed
-                                found = true;
-
-                            }   break;
-
-                            case    HTML_TAG_END_CRLF:
-                            {
-                                //  Insert a Carriage Return
-                                html_offset_p[ 0 ] = '\n';
-
-                                //  Locate the end of the tag
-                                tmp_offset_p = HTML2TXT__locate_tag_end( html_offset_p );
-
-                                //  Did we locate the end of the tag ?
-                                if ( tmp_offset_p != NULL )
-                                {
-                                    //  YES:    Now delete the '<style> ... </style>' from the buffer.
-                                text_remove( html_offset_p, 1,
-                                             ( tmp_offset_p - html_offset_p     ) );
-
-                                }
-                                else
-                                {
-                                    //  NO:     Not good.  Delete the remainder
-                                    //          of the buffer
-                                    html_offset_p[ 0 ] = '\0';
-                                }
-                                //  A HTML tag was found and removed
-                                found = true;
-
-                            }   break;
-                        }
-                    }
-                    else
-                    {
-                        //  Not a valid HTML tag but something was found.
-                        found = true;
+    /************************************************************************
+     *  Function
+     ************************************************************************/
 
-                        //  Advance the search start so we don't look at the
-                        //  same thing over and over and over and over ...
-                        html_offset_p += 1;
-                    }
-                }
+    //  Scan the buffer in place
+    out_l  = HTML2TXT__scan( &scan, html_p, strlen( html_p ), html_p );
+    out_l += HTML2TXT__scan_finish( &scan, &html_p[ out_l ] );
 
-            }   while(  found == true );
-        }
-    }
+    //  Terminate the rendered text
+    html_p[ out_l ] = '\0';
 
     /************************************************************************
      *  Function Exit
@@ -1111,79 +1174,42 @@ HTML2TXT__tag_scan(
 
 /****************************************************************************/
 /**
- *  The html_str_2_char function will search a buffer for a HTML special
- *  character string [example &equals;] and replace it in the buffer with
- *  the character it represents.  In this example it will be a '=' equal
- *  sign.
+ *  Build the entity hash table from html_table.  Called once.
  *
- *  @param  html_p              Pointer to the HTML source buffer.
+ *  @param  void                No parameters
  *
- *  @return count               Number of character conversions that occurred.
+ *  @return void
  *
  *  @note
- *      The conversion will always take a string of at minimum four (4)
- *      characters and reduce it to a single character resulting in the
- *      buffer containing fewer characters after the conversion.
+ *      Entries are inserted in table order so a probe meets the first
+ *      entry of a name that appears more than once first.
  *
  ****************************************************************************/
 
 void
-HTML2TXT__str_2_char(
-    char                        *   html_p
+HTML2TXT__entity_init(
+    void
     )
 {
-    /**
-     *  @param  found           Flag indicating the search was locatd       */
-    int                             found;
     /**
      *  @param  html_table_ndx  Index into the HTML conversion table        */
     int                             html_table_ndx;
     /**
-     *  @param  html_offset_p   Pointer to the first space in HTML buffer   */
-    char                        *   html_offset_p;
-    /**
-     *  @param  tmp_offset_p    Pointer to the last space in the tmp buffer */
-    char                        *   tmp_offset_p;
-    /**
-     *  @param  replace_l       Size of the replace string                  */
-    int                             replace_l;
-    /**
-     *  @param  ndx             Index into the search buffer                */
-    int                             ndx;
+     *  @param  slot            Hash table slot                             */
+    uint32_t                        slot;
     /**
-     *  @param  insert_str      Date to be inserted                         */
-    char                            insert_str[ 10 ];
-    /**
-     *  @param  u_html_p        Unsigned char pointer                       */
-    unsigned char               *   u_html_p;
+     *  @param  name_l          Length of the entity name                   */
+    int                             name_l;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
+    //  Mark every slot empty
+    memset( html_entity_hash, 0xFF, sizeof( html_entity_hash ) );
 
     /************************************************************************
-     *  Extended ASCII characters to space [ ]
-     ************************************************************************/
-
-    //  We need an unsigned character pointer here.
-    u_html_p = (unsigned char *)html_p;
-
-    //  Scan the entire buffer
-    for ( ndx = 0;
-          ndx < strlen( (char*)u_html_p );
-          ndx += 1 )
-    {
-        //  Is this an extended ASCII character ?
-        if ( u_html_p[ ndx ] >= 0x80 )
-        {
-            //  YES:    Replace it with a space
-            u_html_p[ ndx ] = ' ';
-        }
-    }
-
-    /************************************************************************
-     *  Replace all 'html_entry' strings with it's hex code.
+     *  Function
      ************************************************************************/
 
     //  Loop through all entries in the HTML conversion table
@@ -1191,274 +1217,589 @@ HTML2TXT__str_2_char(
          html_table[ html_table_ndx ].hex_code != 0;
          html_table_ndx += 1 )
     {
-        //  Loop until all translations are done.
-        do
-        {
-            //  The flag will be changed when something is translated.
-            found = false;
+        //  The name is what is between the '&' and the ';'
+        name_l = strlen( html_table[ html_table_ndx ].html_entity ) - 2;
 
-            //  Look for this string in the HTML buffer
-            tmp_offset_p = strcasestr( html_p,
-                                       html_table[ html_table_ndx ].html_entity );
+        slot = HTML2TXT__name_hash(
+                &html_table[ html_table_ndx ].html_entity[ 1 ], name_l );
 
-            //  Did we find the string ?
-            if ( tmp_offset_p != NULL )
-            {
-                //  YES:    Create a string of the insert character
-                insert_str[ 0 ] = html_table[ html_table_ndx ].hex_code;
-                insert_str[ 1 ] = '\0';
-
-                //  Replace the string with the character
-                text_replace( tmp_offset_p,
-                              strlen( tmp_offset_p ),
-                              0,
-                              insert_str,
-                              strlen( html_table[ html_table_ndx ].html_entity ) );
-
-                //  Change the flag to show something was found and translated
-                found = true;
-            }
+        //  Find an empty slot
+        for ( slot &= ( HTML_ENTITY_HASH_L - 1 );
+              html_entity_hash[ slot ] >= 0;
+              slot = ( slot + 1 ) & ( HTML_ENTITY_HASH_L - 1 ) )
+        {
+        }
 
-        }   while ( found == true );
+        html_entity_hash[ slot ] = html_table_ndx;
     }
 
     /************************************************************************
-     *  Replace all HTML-Character [&#nn] strings with it's hex code.
+     *  Function Exit
      ************************************************************************/
 
-    //  Set the start point to search
-    html_offset_p = html_p;
+    //  DONE!
+}
 
-    //  Loop until all translations are done.
-    do
-    {
-        //  The flag will be changed when something is translated.
-        found = false;
+/****************************************************************************/
+/**
+ *  Look up a named entity.
+ *
+ *  @param  name_p              Pointer to the entity name (after the '&').
+ *  @param  name_l              Length of the entity name.
+ *
+ *  @return hex_code            The character the entity represents or
+ *                              zero when the name is unknown.
+ *
+ *  @note
+ *      An exact match is preferred, so '&eacute;' and '&Eacute;' are
+ *      different characters.  A name that only matches without regard
+ *      to case takes the first such entry of html_table.
+ *
+ ****************************************************************************/
 
-        //  Locate the next potential code string
-        tmp_offset_p = strchr( html_offset_p, '&' );
+int
+HTML2TXT__entity_lookup(
+    const char                  *   name_p,
+    int                             name_l
+    )
+{
+    /**
+     *  @param  hex_code        The character the entity represents         */
+    int                             hex_code;
+    /**
+     *  @param  slot            Hash table slot                             */
+    uint32_t                        slot;
+    /**
+     *  @param  entity_p        Entity string of a table entry              */
+    const char                  *   entity_p;
 
-        //  Did we find something to test ?
-        if ( tmp_offset_p != NULL )
-        {
-            //  YES:    Is this decimal code ?
-            if (    (    (          tmp_offset_p[ 1 ]   ==  '#' )
-                      && ( isdigit( tmp_offset_p[ 2 ] ) !=   0  )
-                      && ( isdigit( tmp_offset_p[ 3 ] ) !=   0  )
-                      && (          tmp_offset_p[ 4 ]   ==  ';' ) )
-                 || (    (          tmp_offset_p[ 1 ]   ==  '#' )
-                      && ( isdigit( tmp_offset_p[ 2 ] ) !=   0  )
-                      && ( isdigit( tmp_offset_p[ 3 ] ) !=   0  )
-                      && ( isdigit( tmp_offset_p[ 4 ] ) !=   0  )
-                      && (          tmp_offset_p[ 5 ]   ==  ';' ) ) )
-            {
-                //  YES:    Create a string of the insert character
-                insert_str[ 0 ] = atoi( &( tmp_offset_p[ 1 ] ) );
-                insert_str[ 1 ] = '\0';
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
 
-                //  Is the replace string length equal to four ?
-                if ( tmp_offset_p[ 4 ] == ';' )
-                {
-                    //  YES:    Set the length to four
-                    replace_l = 5;
-                }
-                else
-                {
-                    //  NO:     Then set the replace length to five
-                    replace_l = 6;
-                }
+    hex_code = 0;
+
+    //  Build the hash table the first time through
+    pthread_once( &html_entity_once, HTML2TXT__entity_init );
 
-                //  Replace the string with the character
-                text_replace( tmp_offset_p,
-                              strlen( tmp_offset_p ),
-                              0,
-                              insert_str,
-                              replace_l );
+    /************************************************************************
+     *  Function
+     ************************************************************************/
 
-                //  Update the search starting position
-                html_offset_p = tmp_offset_p;
+    //  Probe until an empty slot is found
+    for ( slot = ( HTML2TXT__name_hash( name_p, name_l )
+                   & ( HTML_ENTITY_HASH_L - 1 ) );
+          html_entity_hash[ slot ] >= 0;
+          slot = ( slot + 1 ) & ( HTML_ENTITY_HASH_L - 1 ) )
+    {
+        entity_p = html_table[ html_entity_hash[ slot ] ].html_entity;
 
-                //  Change the flag to show something was found and translated
-                found = true;
-            }
-            else
+        //  Is this the same name ?
+        if (    ( entity_p[ name_l + 1 ] == ';' )
+             && ( strncasecmp( &entity_p[ 1 ], name_p, name_l ) == 0 ) )
+        {
+            //  YES:    Is it an exact match ?
+            if ( strncmp( &entity_p[ 1 ], name_p, name_l ) == 0 )
             {
-                //  NO:     Look again from here.
-                found = true;
+                //  YES:    This is the one
+                hex_code = html_table[ html_entity_hash[ slot ] ].hex_code;
+                break;
+            }
 
-                //  Move the search pointer to avoid an infinite loop.
-                html_offset_p = &tmp_offset_p[ 1 ];
+            //  Remember the first match without regard to case
+            if ( hex_code == 0 )
+            {
+                hex_code = html_table[ html_entity_hash[ slot ] ].hex_code;
             }
         }
-
-    }   while ( found == true );
+    }
 
     /************************************************************************
-     *  Replace all HTML-Character [&#Xnn] strings with it's hex code.
+     *  Function Exit
      ************************************************************************/
 
-    //  Set the start point to search
-    html_offset_p = html_p;
+    //  DONE!
+    return( hex_code );
+}
 
-    //  Loop until all translations are done.
-    do
-    {
-        //  The flag will be changed when something is translated.
-        found = false;
+/****************************************************************************/
+/**
+ *  Decode a character reference or a named entity.
+ *
+ *  @param  entity_p            Pointer to the '&' that starts the entity.
+ *  @param  hex_code_p          Where to put the character it represents.
+ *
+ *  @return entity_l            Number of characters in the entity or zero
+ *                              when entity_p is not a known entity.
+ *
+ *  @note
+ *      Recognized are '&name;', '&#NNN;' and '&#xHH;'.  A numeric
+ *      reference is only decoded when it fits in a single character.
+ *
+ ****************************************************************************/
 
-        //  Locate the next potential code string
-        tmp_offset_p = strchr( html_offset_p, '&' );
+int
+HTML2TXT__entity_decode(
+    const char                  *   entity_p,
+    unsigned char               *   hex_code_p
+    )
+{
+    /**
+     *  @param  entity_l        Number of characters in the entity          */
+    int                             entity_l;
+    /**
+     *  @param  ndx             Index into the entity                       */
+    int                             ndx;
+    /**
+     *  @param  start           Index of the first digit or name character  */
+    int                             start;
+    /**
+     *  @param  value           Value of a numeric reference                */
+    long                            value;
+    /**
+     *  @param  digit           Value of a single digit                     */
+    int                             digit;
 
-        //  Did we find something to test ?
-        if ( tmp_offset_p != NULL )
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    entity_l = 0;
+    value    = 0;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is this a numeric character reference ?
+    if ( entity_p[ 1 ] == '#' )
+    {
+        //  YES:    Is it hexadecimal ?
+        if ( tolower( (unsigned char)entity_p[ 2 ] ) == 'x' )
         {
-            //  YES:    Is this decimal code ?
-            if (    (          tmp_offset_p[ 1 ]   ==  '#' )
-                 && ( tolower( tmp_offset_p[ 2 ] ) ==  'x' )
-                 && ( isdigit( tmp_offset_p[ 3 ] ) !=   0  )
-                 && ( isdigit( tmp_offset_p[ 4 ] ) !=   0  )
-                 && (          tmp_offset_p[ 5 ]   ==  ';' ) )
+            //  YES:    Convert the hex digits
+            for ( ndx = start = 3;
+                  ( isxdigit( (unsigned char)entity_p[ ndx ] ) != 0 )
+                  && ( ndx - start ) < HTML_ENTITY_DIGITS;
+                  ndx += 1 )
             {
-                //  YES:    Translate the string
-                insert_str[ 0 ] = tmp_offset_p[ 3 ];
-                insert_str[ 1 ] = tmp_offset_p[ 4 ];
-                insert_str[ 2 ] = '\0';
-                sscanf( insert_str, "%X", (int*)insert_str );
-
-                //  Replace the string with the character
-                text_replace( tmp_offset_p,
-                              strlen( tmp_offset_p ),
-                              0,
-                              insert_str,
-                              5 );
-
-                //  Update the search starting position
-                html_offset_p = tmp_offset_p;
-
-                //  Change the flag to show something was found and translated
-                found = true;
+                digit = tolower( (unsigned char)entity_p[ ndx ] );
+                digit = ( isdigit( digit ) != 0 ) ? ( digit - '0' )
+                                                  : ( digit - 'a' + 10 );
+                value = ( value * 16 ) + digit;
             }
-            else
+        }
+        else
+        {
+            //  NO:     Convert the decimal digits
+            for ( ndx = start = 2;
+                  ( isdigit( (unsigned char)entity_p[ ndx ] ) != 0 )
+                  && ( ndx - start ) < HTML_ENTITY_DIGITS;
+                  ndx += 1 )
             {
-                //  NO:     Look again from here.
-                found = true;
+                value = ( value * 10 ) + ( entity_p[ ndx ] - '0' );
+            }
+        }
+
+        //  Is this a complete reference to a single character ?
+        if (    ( ndx > start )
+             && ( entity_p[ ndx ] == ';' )
+             && ( value > 0 )
+             && ( value <= 0xFF ) )
+        {
+            //  YES:    Decode it
+            *hex_code_p = (unsigned char)value;
+            entity_l = ndx + 1;
+        }
+    }
+    else
+    {
+        //  NO:     Find the end of the name
+        for ( ndx = start = 1;
+              ( isalnum( (unsigned char)entity_p[ ndx ] ) != 0 )
+              && ( ndx - start ) < HTML_ENTITY_NAME_L;
+              ndx += 1 )
+        {
+        }
 
-                //  Move the search pointer to avoid an infinite loop.
-                html_offset_p = &tmp_offset_p[ 1 ];
+        //  Is this a complete entity name ?
+        if (    ( ndx > start )
+             && ( entity_p[ ndx ] == ';' ) )
+        {
+            //  YES:    Look it up
+            value = HTML2TXT__entity_lookup( &entity_p[ start ],
+                                             ( ndx - start ) );
+
+            //  Is it a known entity ?
+            if ( value != 0 )
+            {
+                //  YES:    Decode it
+                *hex_code_p = (unsigned char)value;
+                entity_l = ndx + 1;
             }
         }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
 
-    }   while ( found == true );
+    //  DONE!
+    return( entity_l );
+}
+
+/****************************************************************************/
+/**
+ *  Decode a 'U+hhhh' unicode string.
+ *
+ *  @param  unicode_p           Pointer to the 'U' that starts the string.
+ *  @param  hex_code_p          Where to put the character it represents.
+ *
+ *  @return unicode_l           Number of characters in the string or zero
+ *                              when it is not a unicode string that fits
+ *                              in a single character.
+ *
+ *  @note
+ *
+ ****************************************************************************/
+
+int
+HTML2TXT__unicode_decode(
+    const char                  *   unicode_p,
+    unsigned char               *   hex_code_p
+    )
+{
+    /**
+     *  @param  unicode_l       Number of characters in the string          */
+    int                             unicode_l;
+    /**
+     *  @param  ndx             Index into the string                       */
+    int                             ndx;
+    /**
+     *  @param  value           Value of the code point                     */
+    long                            value;
+    /**
+     *  @param  digit           Value of a single digit                     */
+    int                             digit;
 
     /************************************************************************
-     *  Replace all 'html_entry' strings with it's hex code.
+     *  Function Initialization
      ************************************************************************/
 
-    //  Set the start point to search
-    html_offset_p = html_p;
+    unicode_l = 0;
+    value     = 0;
 
-    //  Loop until all translations are done.
-    do
-    {
-        //  The flag will be changed when something is translated.
-        found = false;
+    /************************************************************************
+     *  Function
+     ************************************************************************/
 
-        //  Locate the next potential code string
-        tmp_offset_p = strchr( html_offset_p, '#' );
+    //  Convert the hex digits
+    for ( ndx = 2;
+          ( isxdigit( (unsigned char)unicode_p[ ndx ] ) != 0 );
+          ndx += 1 )
+    {
+        digit = tolower( (unsigned char)unicode_p[ ndx ] );
+        digit = ( isdigit( digit ) != 0 ) ? ( digit - '0' )
+                                          : ( digit - 'a' + 10 );
+        value = ( value * 16 ) + digit;
 
-        //  Did we find something to test ?
-        if ( tmp_offset_p != NULL )
+        //  Too many digits ?
+        if ( ( ndx - 2 ) >= HTML_UNICODE_DIGITS )
         {
-            //  YES:    Is this decimal code ?
-            if (    (           tmp_offset_p[ 0 ]   ==  '#' )
-                 && ( tolower(  tmp_offset_p[ 1 ] ) ==  'x' )
-                 && ( isxdigit( tmp_offset_p[ 2 ] ) !=   0  )
-                 && ( isxdigit( tmp_offset_p[ 3 ] ) !=   0  )
-                 && (           tmp_offset_p[ 4 ]   ==  ';' ) )
-            {
-                //  YES:    Translate the string
-                insert_str[ 0 ] = tmp_offset_p[ 2 ];
-                insert_str[ 1 ] = tmp_offset_p[ 3 ];
-                insert_str[ 2 ] = '\0';
-                sscanf( insert_str, "%X", (int*)insert_str );
-
-                //  Replace the string with the character
-                text_replace( tmp_offset_p,
-                              strlen( tmp_offset_p ),
-                              0,
-                              insert_str,
-                              replace_l );
-
-                //  Update the search starting position
-                html_offset_p = tmp_offset_p;
-
-                //  Change the flag to show something was found and translated
-                found = true;
-            }
+            //  YES:    This isn't a code point
+            value = 0;
+            break;
         }
+    }
 
-    }   while ( found == true );
+    //  Is this a code point that fits in a single character ?
+    if (    ( ( ndx - 2 ) >= 4 )
+         && ( value > 0 )
+         && ( value <= 0xFF ) )
+    {
+        //  YES:    Decode it
+        *hex_code_p = (unsigned char)value;
+        unicode_l = ndx;
+    }
 
-    /********************************************************************
-     *  Translate UNICODE Strings
-     ********************************************************************/
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
 
-    //  Set the start point to search
-    html_offset_p = html_p;
+    //  DONE!
+    return( unicode_l );
+}
 
-    //  Loop until all translations are done.
-    do
+/****************************************************************************/
+/**
+ *  Decode the HTML and UNICODE strings in a buffer.  Extended ASCII
+ *  characters in the source become spaces, characters produced by an
+ *  entity are kept.
+ *
+ *  @param  html_p              Pointer to the text.  html_p[ html_l ] must
+ *                              be a NUL.
+ *  @param  html_l              Number of characters of text.
+ *  @param  used_l_p            NULL to decode all of the text.  Otherwise
+ *                              decoding stops at a '&' or 'U+' too close to
+ *                              the end to be sure it is complete, and the
+ *                              number of characters used is put here.
+ *
+ *  @return out_l               Number of characters of decoded text.
+ *
+ *  @note
+ *      The buffer is decoded in a single left to right pass.  The output
+ *      is written behind the input so it never needs more room.
+ *
+ ****************************************************************************/
+
+int
+HTML2TXT__decode(
+    char                        *   html_p,
+    int                             html_l,
+    int                         *   used_l_p
+    )
+{
+    /**
+     *  @param  in_p            Next character to be decoded                */
+    unsigned char               *   in_p;
+    /**
+     *  @param  out_p           Where the next decoded character goes       */
+    unsigned char               *   out_p;
+    /**
+     *  @param  end_p           End of the text                             */
+    unsigned char               *   end_p;
+    /**
+     *  @param  hold_p          Where an entity may be incomplete           */
+    unsigned char               *   hold_p;
+    /**
+     *  @param  entity_l        Number of characters in the entity          */
+    int                             entity_l;
+    /**
+     *  @param  hex_code        The character an entity represents          */
+    unsigned char                   hex_code;
+    /**
+     *  @param  run_l           Number of characters with nothing to decode */
+    size_t                          run_l;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Build the character classes the first time through
+    pthread_once( &html_class_once, HTML2TXT__class_init );
+
+    in_p  = (unsigned char *)html_p;
+    out_p = (unsigned char *)html_p;
+    end_p = (unsigned char *)&html_p[ html_l ];
+
+    //  Is the rest of the text still to come ?
+    if (    ( used_l_p != NULL )
+         && ( html_l > HTML_DECODE_HOLD_L ) )
     {
-        //  The flag will be changed when something is translated.
-        found = false;
+        //  YES:    Entities starting here may not be complete
+        hold_p = end_p - HTML_DECODE_HOLD_L;
+    }
+    else if ( used_l_p != NULL )
+    {
+        hold_p = in_p;
+    }
+    else
+    {
+        hold_p = end_p;
+    }
+
+    /************************************************************************
+     *  Decode the buffer
+     ************************************************************************/
 
-        //  Locate the next potential UNICODE string
-        tmp_offset_p = strcasestr( html_offset_p, "U+" );
+    //  Scan the entire buffer
+    while ( in_p < end_p )
+    {
+        entity_l = 0;
 
-        //  Did we find something to test ?
-        if ( tmp_offset_p != NULL )
+        //  Is this the start of an entity ?
+        if ( in_p[ 0 ] == '&' )
         {
-            //  YES:    Figure out the size of the replace string
-            memset( insert_str, '\0', sizeof( insert_str ) );
-            for ( replace_l = 2;
-                  ( isdigit( tmp_offset_p[ replace_l ] ) != 0 );
-                  replace_l += 1 )
+            //  YES:    Could it be incomplete ?
+            if ( in_p >= hold_p )
             {
-                //  Buffer overflow protection
-                if ( replace_l < 8 )
-                {
-                    //  Copy the numeric text character
-                    insert_str[ replace_l - 2 ] = tmp_offset_p[ replace_l ];
-                }
-            };
+                //  YES:    Leave it for next time
+                break;
+            }
 
-            //  Is this a valid UNICODE string ?
-            if (    ( replace_l > 4 )
-                 && ( replace_l < 8 ) )
+            //  Decode it
+            entity_l = HTML2TXT__entity_decode( (char*)in_p, &hex_code );
+        }
+        //  Could this be the start of a unicode string ?
+        else if ( toupper( in_p[ 0 ] ) == 'U' )
+        {
+            //  YES:    Could it be incomplete ?
+            if ( in_p >= hold_p )
             {
-                //  YES:    Translate the string
-                sscanf( insert_str, "%X", (int*)insert_str );
-
-                //  Replace the string with the character
-                text_replace( tmp_offset_p,
-                              strlen( tmp_offset_p ),
-                              0,
-                              insert_str,
-                              replace_l );
+                //  YES:    Leave it for next time
+                break;
             }
-            else
+
+            //  Is it a unicode string ?
+            if ( in_p[ 1 ] == '+' )
             {
-                //  NO:     Move the pointer past the stuff we already found.
-                tmp_offset_p += replace_l;
+                //  YES:    Decode it
+                entity_l = HTML2TXT__unicode_decode( (char*)in_p,
+                                                     &hex_code );
             }
-            //  Update the search starting position
-            html_offset_p = tmp_offset_p;
+        }
 
-            //  Change the flag to show something was found and translated
-            found = true;
+        //  Was something decoded ?
+        if ( entity_l > 0 )
+        {
+            //  YES:    Write the character it represents
+            *(out_p++) = hex_code;
+            in_p += entity_l;
+        }
+        //  Is this an extended ASCII character ?
+        else if ( in_p[ 0 ] >= 0x80 )
+        {
+            //  YES:    Replace it with a space
+            *(out_p++) = ' ';
+            in_p += 1;
+        }
+        else
+        {
+            //  NO:     Copy it and the run of characters after it
+            run_l = 1 + text_find_class( (char*)&in_p[ 1 ], end_p - in_p - 1,
+                                         &html_decode_class );
+            memmove( out_p, in_p, run_l );
+            out_p += run_l;
+            in_p  += run_l;
         }
+    }
+
+    //  Report how much was used
+    if ( used_l_p != NULL )
+    {
+        *used_l_p = ( (char*)in_p - html_p );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( (char*)out_p - html_p );
+}
+
+/****************************************************************************/
+/**
+ *  The html_str_2_char function will search a buffer for a HTML special
+ *  character string [example &equals;] and replace it in the buffer with
+ *  the character it represents.  In this example it will be a '=' equal
+ *  sign.
+ *
+ *  @param  html_p              Pointer to the HTML source buffer.
+ *
+ *  @return void
+ *
+ *  @note
+ *      Recognized are '&name;', '&#NNN;', '&#xHH;' and 'U+hhhh'.
+ *
+ ****************************************************************************/
+
+void
+HTML2TXT__str_2_char(
+    char                        *   html_p
+    )
+{
+    /**
+     *  @param  out_l           Size of the decoded text                    */
+    int                             out_l;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Decode the buffer in place
+    out_l = HTML2TXT__decode( html_p, strlen( html_p ), NULL );
+
+    //  Terminate the decoded text
+    html_p[ out_l ] = '\0';
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Decode the scanned text of a stream and deliver it.
+ *
+ *  @param  stream_p            Pointer to the stream.
+ *  @param  final               TRUE when the end of the document has been
+ *                              scanned, else an entity at the end of the
+ *                              text is kept until more text arrives.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+HTML2TXT__stream_flush(
+    struct  html2txt_stream_t   *   stream_p,
+    int                             final
+    )
+{
+    /**
+     *  @param  out_l           Size of the decoded text                    */
+    int                             out_l;
+    /**
+     *  @param  used_l          Characters of text that were decoded        */
+    int                             used_l;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Terminate the text so the entity decoder can't run off the end
+    stream_p->text[ stream_p->text_l ] = '\0';
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is this the end of the document ?
+    if ( final == true )
+    {
+        //  YES:    Decode everything
+        out_l  = HTML2TXT__decode( stream_p->text, stream_p->text_l, NULL );
+        used_l = stream_p->text_l;
+    }
+    else
+    {
+        //  NO:     Decode all but a possibly incomplete entity
+        out_l  = HTML2TXT__decode( stream_p->text, stream_p->text_l,
+                                   &used_l );
+    }
+
+    //  Is there text to deliver ?
+    if ( out_l > 0 )
+    {
+        //  YES:    Is there an output function ?
+        if ( stream_p->output_p != NULL )
+        {
+            //  YES:    Pass it on
+            stream_p->output_p( stream_p->parm_p, stream_p->text, out_l );
+        }
+        else
+        {
+            //  NO:     Collect it
+            mem_strbuf_append( &stream_p->collect, stream_p->text, out_l );
+        }
+    }
 
-    }   while ( found == true );
+    //  Move what was kept to the front of the buffer
+    stream_p->text_l -= used_l;
+    memmove( stream_p->text, &stream_p->text[ used_l ], stream_p->text_l );
 
     /************************************************************************
      *  Function Exit
@@ -45,6 +45,13 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+#define HTML_TAG_L              (   16 )
+/**
+ *  A '&' or 'U+' this close to the end of the text may be incomplete       */
+#define HTML_DECODE_HOLD_L      (   12 )
+/**
+ *  Largest piece of a document scanned at once by html2txt_stream_feed()   */
+#define HTML_STREAM_L           ( 64 * 1024 )
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -52,6 +59,19 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+/**
+ *  @param  html_scan_e         Tag scanner states                          */
+enum    html_scan_e
+{
+    HTML_SCAN_TEXT              =   0,      //  Text between tags
+    HTML_SCAN_OPEN              =   1,      //  Just read a '<'
+    HTML_SCAN_NAME              =   2,      //  Reading the tag name
+    HTML_SCAN_ATTR              =   3,      //  Skipping the tag attributes
+    HTML_SCAN_BANG              =   4,      //  Just read '<!'
+    HTML_SCAN_COMMENT           =   5,      //  Skipping a comment
+    HTML_SCAN_DECL              =   6,      //  Skipping to the next '>'
+    HTML_SCAN_RAW               =   7       //  Skipping a style or script
+};
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -67,6 +87,58 @@ struct  html_char_t
     unsigned char                   hex_code;
 };
 //----------------------------------------------------------------------------
+/**
+ *  @param  html_scan_t         Tag scanner state.  Carried from one piece
+ *                              of a document to the next.                  */
+struct  html_scan_t
+{
+    /**
+     *  @param  state           Current scanner state                       */
+    enum    html_scan_e             state;
+    /**
+     *  @param  name            Lowercase name of the current tag           */
+    char                            name[ HTML_TAG_L + 1 ];
+    /**
+     *  @param  name_l          Length of the name (HTML_TAG_L + 1 when it
+     *                          is too long to be a known tag)              */
+    int                             name_l;
+    /**
+     *  @param  end_tag         TRUE for a '</tag>'                         */
+    int                             end_tag;
+    /**
+     *  @param  self_close      TRUE when the tag ends with '/>'            */
+    int                             self_close;
+    /**
+     *  @param  match_l         Dashes seen in a comment, or characters of
+     *                          a style or script end tag matched           */
+    int                             match_l;
+};
+//----------------------------------------------------------------------------
+/**
+ *  @param  html2txt_stream_t   A document being converted piece by piece  */
+struct  html2txt_stream_t
+{
+    /**
+     *  @param  scan            Tag scanner state                           */
+    struct  html_scan_t             scan;
+    /**
+     *  @param  output_p        Called with each piece of text or NULL      */
+    void                            (*output_p)( void *, const char *, int );
+    /**
+     *  @param  parm_p          Passed to output_p                          */
+    void                        *   parm_p;
+    /**
+     *  @param  collect         The text when there is no output_p          */
+    struct  mem_strbuf_t            collect;
+    /**
+     *  @param  text_l          Characters in text not yet delivered        */
+    int                             text_l;
+    /**
+     *  @param  text            Scanned text waiting to be decoded          */
+    char                            text[ HTML_DECODE_HOLD_L
+                                          + HTML_STREAM_L + 2 ];
+};
+//----------------------------------------------------------------------------
 
 /****************************************************************************
  * Library Private Storage Allocation
@@ -81,33 +153,91 @@ struct  html_char_t
 
 //----------------------------------------------------------------------------
 char    *
-HTML2TXT__crlf_replace(
+HTML2TXT__remove_spaces(
     char                        *   html_p,
-    char                        *   tmp_p,
     int                             buffer_l
     );
 //----------------------------------------------------------------------------
+uint32_t
+HTML2TXT__name_hash(
+    const char                  *   name_p,
+    int                             name_l
+    );
+//----------------------------------------------------------------------------
 void
-HTML2TXT__remove_comments(
-    char                        *   html_p
+HTML2TXT__tag_init(
+    void
     );
 //----------------------------------------------------------------------------
-char    *
-HTML2TXT__remove_spaces(
-    char                        *   html_p,
-    int                             buffer_l
+int
+HTML2TXT__tag_lookup(
+    const char                  *   name_p,
+    int                             name_l
     );
 //----------------------------------------------------------------------------
-char    *
-HTML2TXT__remove_style(
-    char                        *   html_p,
-    int                             buffer_l
+void
+HTML2TXT__class_init(
+    void
+    );
+//----------------------------------------------------------------------------
+void
+HTML2TXT__scan_init(
+    struct  html_scan_t         *   scan_p
+    );
+//----------------------------------------------------------------------------
+int
+HTML2TXT__scan_tag(
+    struct  html_scan_t         *   scan_p,
+    char                        *   out_p
+    );
+//----------------------------------------------------------------------------
+int
+HTML2TXT__scan(
+    struct  html_scan_t         *   scan_p,
+    const char                  *   in_p,
+    int                             in_l,
+    char                        *   out_p
+    );
+//----------------------------------------------------------------------------
+int
+HTML2TXT__scan_finish(
+    struct  html_scan_t         *   scan_p,
+    char                        *   out_p
     );
 //----------------------------------------------------------------------------
 char    *
 HTML2TXT__tag_scan(
+    char                        *   html_p
+    );
+//----------------------------------------------------------------------------
+void
+HTML2TXT__entity_init(
+    void
+    );
+//----------------------------------------------------------------------------
+int
+HTML2TXT__entity_lookup(
+    const char                  *   name_p,
+    int                             name_l
+    );
+//----------------------------------------------------------------------------
+int
+HTML2TXT__entity_decode(
+    const char                  *   entity_p,
+    unsigned char               *   hex_code_p
+    );
+//----------------------------------------------------------------------------
+int
+HTML2TXT__unicode_decode(
+    const char                  *   unicode_p,
+    unsigned char               *   hex_code_p
+    );
+//----------------------------------------------------------------------------
+int
+HTML2TXT__decode(
     char                        *   html_p,
-    int                             buffer_l
+    int                             html_l,
+    int                         *   used_l_p
     );
 //----------------------------------------------------------------------------
 void
@@ -115,6 +245,12 @@ HTML2TXT__str_2_char(
     char                        *   html_p
     );
 //----------------------------------------------------------------------------
+void
+HTML2TXT__stream_flush(
+    struct  html2txt_stream_t   *   stream_p,
+    int                             final
+    );
+//----------------------------------------------------------------------------
 
 /****************************************************************************/
 
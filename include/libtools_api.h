@@ -68,6 +68,26 @@
 
 #define MID_VOID                    ( 0x0000 )
 //----------------------------------------------------------------------------
+/**
+ *  MID_DEBUG_x messages below this level are compiled out entirely.
+ *  Build with -DLIBTOOLS_MIN_LOG_LEVEL=MID_INFO to drop every debug call.  */
+#ifndef LIBTOOLS_MIN_LOG_LEVEL
+#define LIBTOOLS_MIN_LOG_LEVEL      ( MID_VOID )
+#endif
+#define MID_DEBUG_ANY               (  MID_DEBUG_3 | MID_DEBUG_2 \
+                                     | MID_DEBUG_1 | MID_DEBUG_0 )
+/**
+ *  true when a message ID survives LIBTOOLS_MIN_LOG_LEVEL                 */
+#define LOG_COMPILED( mid )         (    ( ( (mid) & MID_DEBUG_ANY ) == 0 ) \
+                                      || ( (mid) >= LIBTOOLS_MIN_LOG_LEVEL ) )
+/**
+ *  true when a message ID would be displayed or written.  One load.        */
+#define LOG_ENABLED( mid )          ( ( (mid)                               \
+                                        & (  MID_FATAL                       \
+                                           | __atomic_load_n(                \
+                                                &log_enabled_mask,           \
+                                                __ATOMIC_RELAXED ) ) ) != 0 )
+//----------------------------------------------------------------------------
 
 //----------------------------------------------------------------------------
 //  QUEUE
@@ -91,6 +111,18 @@
 #define TCPIP_DNS_RETRY_WAIT        (      5 )  //  Seconds
 //----------------------------------------------------------------------------
 
+//----------------------------------------------------------------------------
+//  Text
+//----------------------------------------------------------------------------
+/**
+ *  Maximum number of single characters in a text_class_t                  */
+#define TEXT_CLASS_SET_L            (      4 )
+//----------------------------------------------------------------------------
+/**
+ *  text_replacer_compile() flag:  Patterns match without regard to case   */
+#define TEXT_REPLACER_NOCASE        ( 0x0001 )
+//----------------------------------------------------------------------------
+
 /****************************************************************************
  * Library Public Enumerations
  ****************************************************************************/
@@ -105,6 +137,19 @@ enum    read_text_options_e
     RTO_INVALID                 =    0xFF
 };
 //----------------------------------------------------------------------------
+enum    file_reader_mode_e
+{
+    /**
+     *  mmap() a regular file, otherwise read it through a buffer           */
+    FILE_READER_AUTO            =   0,
+    /**
+     *  Map the whole file into memory (regular files only)                 */
+    FILE_READER_MMAP            =   1,
+    /**
+     *  Read through a large buffer (pipes, sockets, terminals...)          */
+    FILE_READER_STREAM          =   2
+};
+//----------------------------------------------------------------------------
 
 //----------------------------------------------------------------------------
 //  Queue
@@ -148,13 +193,105 @@ struct  file_info_t
     char                            file_name[ FILE_NAME_L + 1 ];
     char                            date_time[ FILE_DATE_L + 1 ];
     char                            file_size[ FILE_SIZE_L + 1 ];
+    /**
+     *  @param  size            File size in bytes                          */
+    int64_t                         size;
+    /**
+     *  @param  mtime           Time the file was last modified             */
+    time_t                          mtime;
+};
+//----------------------------------------------------------------------------
+struct  file_reader_t;
+//----------------------------------------------------------------------------
+enum    file_change_e
+{
+    /**
+     *  The file appeared (created or moved into the tree)                  */
+    FILE_CHANGE_ADDED           =   1,
+    /**
+     *  The file's size or modification time changed                        */
+    FILE_CHANGE_MODIFIED        =   2,
+    /**
+     *  The file went away (deleted or moved out of the tree)               */
+    FILE_CHANGE_DELETED         =   3
+};
+//----------------------------------------------------------------------------
+struct  file_change_t
+{
+    /**
+     *  @param  change          What happened to the file                   */
+    enum    file_change_e           change;
+    /**
+     *  @param  cursor          Position of the change in the journal       */
+    uint64_t                        cursor;
+    /**
+     *  @param  file_info       The file information after the change      */
+    struct  file_info_t             file_info;
 };
 //----------------------------------------------------------------------------
+struct  file_watch_t;
+//----------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------
+//  html2txt
+//----------------------------------------------------------------------------
+struct  html2txt_stream_t;
+//----------------------------------------------------------------------------
 
 //---------------------------------------------------------------------------
 //  List
 //---------------------------------------------------------------------------
 struct  list_base_t;
+struct  list_bucket_t;
+//---------------------------------------------------------------------------
+/**
+ *  @param  list_cursor_t       A position in a link-list.  The contents are
+ *                              managed by the list_cursor_* functions and
+ *                              should not be modified by the caller.       */
+struct  list_cursor_t
+{
+    /**
+     *  @param  list_base_p     The link-list the cursor belongs to         */
+    struct  list_base_t         *   list_base_p;
+    /**
+     *  @param  bucket_p        The current bucket (NULL = not positioned)  */
+    struct  list_bucket_t       *   bucket_p;
+    /**
+     *  @param  payload_p       Payload of the current bucket               */
+    void                        *   payload_p;
+    /**
+     *  @param  sequence        Sequence number of bucket_p                 */
+    uint64_t                        sequence;
+    /**
+     *  @param  generation      List generation when bucket_p was saved     */
+    uint32_t                        generation;
+    /**
+     *  @param  deleted         TRUE when another thread deleted the
+     *                          current bucket                              */
+    int                             deleted;
+};
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+//  Mem
+//---------------------------------------------------------------------------
+struct  mem_arena_t;
+//---------------------------------------------------------------------------
+/**
+ *  @param  mem_strbuf_t        A string buffer that grows geometrically.
+ *                              Managed by the mem_strbuf_* functions.     */
+struct  mem_strbuf_t
+{
+    /**
+     *  @param  data_p          The NUL terminated data (NULL when empty)   */
+    char                        *   data_p;
+    /**
+     *  @param  length          Number of bytes of data                     */
+    int                             length;
+    /**
+     *  @param  capacity        Allocated size of data_p                    */
+    int                             capacity;
+};
 //---------------------------------------------------------------------------
 
 //---------------------------------------------------------------------------
@@ -229,6 +366,79 @@ struct  tcpip_t
     int                             snd_data_l;
 };
 
+//----------------------------------------------------------------------------
+//  Text
+//----------------------------------------------------------------------------
+/**
+ *  @param  text_class_t        A set of characters to search for.  Built
+ *                              by text_class_init().                      */
+struct  text_class_t
+{
+    /**
+     *  @param  set             Single characters in the class              */
+    unsigned char                   set[ TEXT_CLASS_SET_L ];
+    /**
+     *  @param  set_l           Number of characters in set                 */
+    int                             set_l;
+    /**
+     *  @param  low             First character of the range                */
+    unsigned char                   low;
+    /**
+     *  @param  span            Last character of the range less low        */
+    unsigned char                   span;
+    /**
+     *  @param  range           TRUE when the class includes the range      */
+    int                             range;
+};
+//----------------------------------------------------------------------------
+/**
+ *  @param  text_pair_t         One search and replace pair for
+ *                              text_replacer_compile().                   */
+struct  text_pair_t
+{
+    /**
+     *  @param  find_p          The text to search for                      */
+    const char                  *   find_p;
+    /**
+     *  @param  replace_p       The text to replace it with                 */
+    const char                  *   replace_p;
+};
+//----------------------------------------------------------------------------
+struct  text_replacer_t;
+//----------------------------------------------------------------------------
+/**
+ *  @param  text_view_t         A piece of a string that is not copied and
+ *                              is not NUL terminated.  It is only good for
+ *                              as long as the string it points into.      */
+struct  text_view_t
+{
+    /**
+     *  @param  text_p          First character of the view                 */
+    const char                  *   text_p;
+    /**
+     *  @param  text_l          Number of characters in the view            */
+    size_t                          text_l;
+};
+//----------------------------------------------------------------------------
+/**
+ *  @param  text_qp_t           State of a quoted printable decoder.  It
+ *                              holds the start of an '=XX' that was split
+ *                              between two pieces of the input.           */
+struct  text_qp_t
+{
+    /**
+     *  @param  pending_l       Number of characters held in pending        */
+    int                             pending_l;
+    /**
+     *  @param  pending         '=' and the character after it              */
+    char                            pending[ 2 ];
+    /**
+     *  @param  fractions       TRUE to write =BC, =BD and =BE out as 1/4,
+     *                          1/2 and 3/4.  text_qp_init() clears it.     */
+    int                             fractions;
+};
+//----------------------------------------------------------------------------
+
 //----------------------------------------------------------------------------
 //  THREAD
 //----------------------------------------------------------------------------
@@ -250,6 +460,10 @@ thread_flow_t
  ****************************************************************************/
 
 //---------------------------------------------------------------------------
+/**
+ *  Every message ID that log_write() will display or write.  Only read
+ *  through LOG_ENABLED().                                                  */
+extern  uint16_t                    log_enabled_mask;
 //---------------------------------------------------------------------------
 
 /****************************************************************************
@@ -305,6 +519,35 @@ file_read_text(
     enum    read_text_options_e     options
    );
 //---------------------------------------------------------------------------
+struct  file_reader_t *
+file_reader_open(
+    const char                  *   file_name_p,
+    enum    file_reader_mode_e      mode
+    );
+//---------------------------------------------------------------------------
+struct  file_reader_t *
+file_reader_open_fd(
+    int                             fd,
+    enum    file_reader_mode_e      mode
+    );
+//---------------------------------------------------------------------------
+int
+file_reader_next_line(
+    struct  file_reader_t       *   reader_p,
+    struct  text_view_t         *   line_p
+    );
+//---------------------------------------------------------------------------
+int
+file_reader_read_text(
+    struct  file_reader_t       *   reader_p,
+    struct  text_view_t         *   line_p
+    );
+//---------------------------------------------------------------------------
+void
+file_reader_close(
+    struct  file_reader_t       *   reader_p
+    );
+//---------------------------------------------------------------------------
 size_t
 file_read_data(
     FILE                        *   file_fp,
@@ -325,12 +568,90 @@ file_ls(
     char                        *   include_ext_p
     );
 //---------------------------------------------------------------------------
+void
+file_scan(
+    struct  list_base_t         *   file_list_p,
+    const char                  *   dir_name_p,
+    const char                  *   include_ext_p,
+    int                             format
+    );
+//---------------------------------------------------------------------------
+void
+file_info_format(
+    struct  file_info_t         *   file_info_p
+    );
+//---------------------------------------------------------------------------
+long
+file_walk(
+    const char                  *   dir_name_p,
+    const char                  *   include_ext_p,
+    void                            (*callback_p)( void *,
+                                                   struct file_info_t * ),
+    void                        *   parm_p,
+    int                             thread_count
+    );
+//---------------------------------------------------------------------------
+struct  file_watch_t *
+file_watch_new(
+    const char                  *   dir_name_p,
+    const char                  *   include_ext_p
+    );
+//---------------------------------------------------------------------------
+int
+file_watch_poll(
+    struct  file_watch_t        *   watch_p,
+    int                             timeout_ms
+    );
+//---------------------------------------------------------------------------
+uint64_t
+file_watch_cursor(
+    struct  file_watch_t        *   watch_p
+    );
+//---------------------------------------------------------------------------
+int
+file_watch_changes(
+    struct  file_watch_t        *   watch_p,
+    uint64_t                    *   cursor_p,
+    struct  list_base_t         *   change_list_p
+    );
+//---------------------------------------------------------------------------
+void
+file_watch_list(
+    struct  file_watch_t        *   watch_p,
+    struct  list_base_t         *   file_list_p
+    );
+//---------------------------------------------------------------------------
+void
+file_watch_kill(
+    struct  file_watch_t        *   watch_p
+    );
+//---------------------------------------------------------------------------
+int
+file_copy(
+    const char                  *   src_name_p,
+    const char                  *   dst_name_p,
+    int                             sync
+    );
+//---------------------------------------------------------------------------
+int
+file_move(
+    const char                  *   src_name_p,
+    const char                  *   dst_name_p,
+    int                             sync
+    );
+//---------------------------------------------------------------------------
 char    *
 file_path_to_lib(
     void
     );
 //---------------------------------------------------------------------------
 int
+file_zip_extract(
+    const char                  *   zip_name_p,
+    const char                  *   extract_to_p
+    );
+//---------------------------------------------------------------------------
+int
 file_unzip(
     char                        *   path_p
     );
@@ -350,11 +671,35 @@ html2txt(
     char                        *   html_p
     );
 //---------------------------------------------------------------------------
+char    *
+html2txt_arena(
+    struct  mem_arena_t         *   arena_p,
+    char                        *   html_p
+    );
+//---------------------------------------------------------------------------
 void
 html2txt_str_2_char(
     char                        *   html_p
     );
 //---------------------------------------------------------------------------
+struct  html2txt_stream_t *
+html2txt_stream_new(
+    void                            (*output_p)( void *, const char *, int ),
+    void                        *   parm_p
+    );
+//---------------------------------------------------------------------------
+void
+html2txt_stream_feed(
+    struct  html2txt_stream_t   *   stream_p,
+    const char                  *   chunk_p,
+    int                             chunk_l
+    );
+//---------------------------------------------------------------------------
+char    *
+html2txt_stream_finish(
+    struct  html2txt_stream_t   *   stream_p
+    );
+//---------------------------------------------------------------------------
 
 //---------------------------------------------------------------------------
 //  List
@@ -470,6 +815,38 @@ list_fdelete(
     int                             access_key
     );
 //---------------------------------------------------------------------------
+//  Cursor mode.  A cursor remembers the bucket it is positioned on so the
+//  next, prev and delete functions don't have to search the list.  These
+//  functions take the list lock themselves and must NOT be called while
+//  holding a list_user_lock().
+//---------------------------------------------------------------------------
+void    *
+list_cursor_first(
+    struct  list_base_t         *   list_base_p,
+    struct  list_cursor_t       *   list_cursor_p
+    );
+//---------------------------------------------------------------------------
+void    *
+list_cursor_last(
+    struct  list_base_t         *   list_base_p,
+    struct  list_cursor_t       *   list_cursor_p
+    );
+//---------------------------------------------------------------------------
+void    *
+list_cursor_next(
+    struct  list_cursor_t       *   list_cursor_p
+    );
+//---------------------------------------------------------------------------
+void    *
+list_cursor_prev(
+    struct  list_cursor_t       *   list_cursor_p
+    );
+//---------------------------------------------------------------------------
+int
+list_cursor_delete(
+    struct  list_cursor_t       *   list_cursor_p
+    );
+//---------------------------------------------------------------------------
 int
 list_debug_dump_list(
     struct  list_base_t         *   list_base_p
@@ -485,12 +862,29 @@ log_init(
     );
 //---------------------------------------------------------------------------
 void
+log_init_async(
+    char                        *   log_file_name
+    );
+//---------------------------------------------------------------------------
+void
 log_write(
     uint16_t                        message_id,
     const char                  *   function_name,
     const char                  *   message_p, ...
     );
 //---------------------------------------------------------------------------
+/**
+ *  Front-end for log_write().  A message that is filtered out costs one
+ *  branch; the time stamp and the message are never formatted.           */
+#define log_write( mid, ... )                                               \
+    do                                                                      \
+    {                                                                       \
+        if ( LOG_COMPILED( mid ) && LOG_ENABLED( mid ) )                    \
+        {                                                                   \
+            log_write( mid, __VA_ARGS__ );                                  \
+        }                                                                   \
+    }   while( 0 )
+//---------------------------------------------------------------------------
 
 //---------------------------------------------------------------------------
 //  Mem
@@ -505,10 +899,65 @@ mem_malloc(
     int                             size
     );
 //---------------------------------------------------------------------------
+void *
+mem_malloc_nozero(
+    int                             size
+    );
+//---------------------------------------------------------------------------
+void *
+mem_malloc_tag(
+    int                             size,
+    const char                  *   tag_p
+    );
+//---------------------------------------------------------------------------
 void
 mem_free(
     void                        *   memory_p
     );
+//---------------------------------------------------------------------------
+void *
+mem_realloc(
+    void                        *   memory_p,
+    int                             size
+    );
+//---------------------------------------------------------------------------
+void
+mem_strbuf_init(
+    struct  mem_strbuf_t        *   strbuf_p
+    );
+//---------------------------------------------------------------------------
+void
+mem_strbuf_append(
+    struct  mem_strbuf_t        *   strbuf_p,
+    const char                  *   data_p,
+    int                             data_l
+    );
+//---------------------------------------------------------------------------
+char *
+mem_strbuf_detach(
+    struct  mem_strbuf_t        *   strbuf_p
+    );
+//---------------------------------------------------------------------------
+struct  mem_arena_t *
+mem_arena_new(
+    int                             chunk_l
+    );
+//---------------------------------------------------------------------------
+void *
+mem_arena_alloc(
+    struct  mem_arena_t         *   arena_p,
+    int                             size
+    );
+//---------------------------------------------------------------------------
+void
+mem_arena_reset(
+    struct  mem_arena_t         *   arena_p
+    );
+//---------------------------------------------------------------------------
+void
+mem_arena_free(
+    struct  mem_arena_t         *   arena_p
+    );
 //----------------------------------------------------------------------------
 int
 mem_sizeof(
@@ -561,6 +1010,21 @@ queue_get_payload(
     int                             queue_id
     );
 //---------------------------------------------------------------------------
+int
+queue_put_batch(
+    int                             queue_id,
+    void                        **  void_pp,
+    int                             count
+    );
+//---------------------------------------------------------------------------
+int
+queue_get_batch(
+    int                             queue_id,
+    void                        **  void_pp,
+    int                             max_count,
+    enum    queue_get_mode_e        mode
+    );
+//---------------------------------------------------------------------------
 
 //---------------------------------------------------------------------------
 //  SHA1
@@ -781,6 +1245,35 @@ text_replace(
     int                             text_remove_l
     );
 //---------------------------------------------------------------------------
+int
+text_insert_len(
+    char                        *   text_buffer_p,
+    int                             text_buffer_l,
+    int                             text_l,
+    int                             text_ndx,
+    const char                  *   text_data_p,
+    int                             text_data_l
+    );
+//---------------------------------------------------------------------------
+int
+text_remove_len(
+    char                        *   text_buffer_p,
+    int                             text_l,
+    int                             text_ndx,
+    int                             text_remove_l
+    );
+//---------------------------------------------------------------------------
+int
+text_replace_len(
+    char                        *   text_buffer_p,
+    int                             text_buffer_l,
+    int                             text_l,
+    int                             text_ndx,
+    const char                  *   text_data_p,
+    int                             text_data_l,
+    int                             text_remove_l
+    );
+//---------------------------------------------------------------------------
 void
 text_center(
     char                        *   text_buffer_p,
@@ -796,6 +1289,104 @@ text_join(
     int                             free_2
     );
 //---------------------------------------------------------------------------
+void
+text_class_init(
+    struct  text_class_t        *   class_p,
+    const char                  *   set_p,
+    int                             low,
+    int                             high
+    );
+//---------------------------------------------------------------------------
+size_t
+text_find_class(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    );
+//---------------------------------------------------------------------------
+struct  text_replacer_t *
+text_replacer_compile(
+    const struct text_pair_t    *   pairs_p,
+    int                             pairs_n,
+    int                             flags
+    );
+//---------------------------------------------------------------------------
+int
+text_replacer_apply(
+    const struct text_replacer_t *  replacer_p,
+    const char                  *   in_p,
+    struct  mem_strbuf_t        *   out_p
+    );
+//---------------------------------------------------------------------------
+void
+text_replacer_free(
+    struct  text_replacer_t     *   replacer_p
+    );
+//---------------------------------------------------------------------------
+void
+text_view_init(
+    struct  text_view_t         *   view_p,
+    const char                  *   text_p
+    );
+//---------------------------------------------------------------------------
+void
+text_view_skip_past_whitespace(
+    struct  text_view_t         *   view_p
+    );
+//---------------------------------------------------------------------------
+void
+text_view_strip_whitespace(
+    struct  text_view_t         *   view_p
+    );
+//---------------------------------------------------------------------------
+int
+text_view_next_word(
+    struct  text_view_t         *   line_p,
+    struct  text_view_t         *   word_p
+    );
+//---------------------------------------------------------------------------
+int
+text_view_compare(
+    const struct text_view_t    *   view_p,
+    const char                  *   text_p
+    );
+//---------------------------------------------------------------------------
+int
+text_view_casecompare(
+    const struct text_view_t    *   view_p,
+    const char                  *   text_p
+    );
+//---------------------------------------------------------------------------
+int
+text_view_to_long(
+    const struct text_view_t    *   view_p,
+    long                        *   value_p
+    );
+//---------------------------------------------------------------------------
+char *
+text_view_copy(
+    const struct text_view_t    *   view_p
+    );
+//---------------------------------------------------------------------------
+void
+text_qp_init(
+    struct  text_qp_t           *   qp_p
+    );
+//---------------------------------------------------------------------------
+void
+text_qp_decode_stream(
+    struct  text_qp_t           *   qp_p,
+    const char                  *   in_p,
+    size_t                          in_l,
+    struct  mem_strbuf_t        *   out_p
+    );
+//---------------------------------------------------------------------------
+void
+text_qp_finish(
+    struct  text_qp_t           *   qp_p,
+    struct  mem_strbuf_t        *   out_p
+    );
+//---------------------------------------------------------------------------
 
 //---------------------------------------------------------------------------
 //  Thread
@@ -23,6 +23,13 @@
  *  for large tables). Call must first call list_user_lock() any of the f_get
  *  functions can be used.
  *
+ *  The "cursor" access functions solve the same problem without holding the
+ *  list lock for the entire scan.  A cursor remembers the bucket it is on,
+ *  so next, prev and delete don't search the list.  Every delete bumps the
+ *  list generation number and a cursor only searches for its bucket when
+ *  the generation has changed.  When another thread has deleted the cursor
+ *  bucket the cursor reports it rather than restarting the scan.
+ *
  *  @note
  *
  ****************************************************************************/
@@ -1201,6 +1208,397 @@ list_fdelete(
     return( list_rc );
 }
 
+/****************************************************************************/
+/**
+ *  Position a cursor on the first bucket of the link-list.
+ *
+ *  @param  list_base_p         Pointer to the base of the link list.
+ *  @param  list_cursor_p       Pointer to the cursor to be positioned.
+ *
+ *  @return payload_p           Pointer to the first payload on the
+ *                              link-list.  When the link-list is empty, NULL
+ *                              is returned.
+ *
+ *  @note
+ *
+ ****************************************************************************/
+
+void    *
+list_cursor_first(
+    struct  list_base_t         *   list_base_p,
+    struct  list_cursor_t       *   list_cursor_p
+    )
+{
+    void                        *   payload_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Reset the payload pointer
+    payload_p = NULL;
+
+    //  Initialize the cursor
+    memset( list_cursor_p, 0x00, sizeof( struct list_cursor_t ) );
+    list_cursor_p->list_base_p = list_base_p;
+
+    /************************************************************************
+     *  Get the first bucket pointer from the link-list.
+     ************************************************************************/
+
+    //  Are we starting with a valid link-list base pointer ?
+    if ( LIST__verify( list_base_p ) == true )
+    {
+        //  YES:    Prevent thread collisions.
+        pthread_mutex_lock( &list_base_p->access_lock );
+
+        //  Save the first bucket and the current list generation.
+        list_cursor_p->bucket_p   = list_base_p->first_p;
+        list_cursor_p->generation = list_base_p->generation;
+
+        //  Was there something there ?
+        if ( list_cursor_p->bucket_p != NULL )
+        {
+            //  YES:    Set the payload pointer.
+            payload_p = list_cursor_p->bucket_p->payload_p;
+        }
+        list_cursor_p->payload_p = payload_p;
+        list_cursor_p->sequence  = ( list_cursor_p->bucket_p != NULL )
+                                 ? list_cursor_p->bucket_p->sequence : 0;
+
+        //  Allow access from other threads.
+        pthread_mutex_unlock( &list_base_p->access_lock );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( payload_p );
+}
+
+/****************************************************************************/
+/**
+ *  Position a cursor on the last bucket of the link-list.
+ *
+ *  @param  list_base_p         Pointer to the base of the link list.
+ *  @param  list_cursor_p       Pointer to the cursor to be positioned.
+ *
+ *  @return payload_p           Pointer to the last payload on the
+ *                              link-list.  When the link-list is empty, NULL
+ *                              is returned.
+ *
+ *  @note
+ *
+ ****************************************************************************/
+
+void    *
+list_cursor_last(
+    struct  list_base_t         *   list_base_p,
+    struct  list_cursor_t       *   list_cursor_p
+    )
+{
+    void                        *   payload_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Reset the payload pointer
+    payload_p = NULL;
+
+    //  Initialize the cursor
+    memset( list_cursor_p, 0x00, sizeof( struct list_cursor_t ) );
+    list_cursor_p->list_base_p = list_base_p;
+
+    /************************************************************************
+     *  Get the last bucket pointer from the link-list.
+     ************************************************************************/
+
+    //  Are we starting with a valid link-list base pointer ?
+    if ( LIST__verify( list_base_p ) == true )
+    {
+        //  YES:    Prevent thread collisions.
+        pthread_mutex_lock( &list_base_p->access_lock );
+
+        //  Save the last bucket and the current list generation.
+        list_cursor_p->bucket_p   = list_base_p->last_p;
+        list_cursor_p->generation = list_base_p->generation;
+
+        //  Was there something there ?
+        if ( list_cursor_p->bucket_p != NULL )
+        {
+            //  YES:    Set the payload pointer.
+            payload_p = list_cursor_p->bucket_p->payload_p;
+        }
+        list_cursor_p->payload_p = payload_p;
+        list_cursor_p->sequence  = ( list_cursor_p->bucket_p != NULL )
+                                 ? list_cursor_p->bucket_p->sequence : 0;
+
+        //  Allow access from other threads.
+        pthread_mutex_unlock( &list_base_p->access_lock );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( payload_p );
+}
+
+/****************************************************************************/
+/**
+ *  Move a cursor to the next bucket of the link-list.
+ *
+ *  @param  list_cursor_p       Pointer to a link-list cursor.
+ *
+ *  @return payload_p           Pointer to the next payload on the
+ *                              link-list.  NULL is returned at the end of
+ *                              the link-list or when another thread has
+ *                              deleted the bucket the cursor was on.  In the
+ *                              later case list_cursor_p->deleted is TRUE.
+ *
+ *  @note
+ *      A cursor that isn't positioned on a bucket (after deleting the first
+ *      bucket for instance) moves to the first bucket.
+ *
+ ****************************************************************************/
+
+void    *
+list_cursor_next(
+    struct  list_cursor_t       *   list_cursor_p
+    )
+{
+    struct  list_base_t         *   list_base_p;
+    void                        *   payload_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Reset the payload pointer
+    payload_p = NULL;
+
+    //  Get the link-list the cursor belongs to.
+    list_base_p = list_cursor_p->list_base_p;
+
+    /************************************************************************
+     *  Move to the next bucket
+     ************************************************************************/
+
+    //  Are we starting with a valid link-list base pointer ?
+    if (    ( LIST__verify( list_base_p ) == true  )
+         && ( list_cursor_p->deleted      == false ) )
+    {
+        //  YES:    Prevent thread collisions.
+        pthread_mutex_lock( &list_base_p->access_lock );
+
+        //  Is the cursor bucket still on the link-list ?
+        if ( LIST__cursor_sync( list_cursor_p ) == true )
+        {
+            //  YES:    Is the cursor positioned on a bucket ?
+            if ( list_cursor_p->bucket_p == NULL )
+            {
+                //  NO:     Use the first bucket
+                list_cursor_p->bucket_p = list_base_p->first_p;
+            }
+            else
+            {
+                //  YES:    Get the next bucket in the link-list.
+                list_cursor_p->bucket_p = list_cursor_p->bucket_p->next_p;
+            }
+
+            //  Was there something there ?
+            if ( list_cursor_p->bucket_p != NULL )
+            {
+                //  YES:    Set the payload pointer.
+                payload_p = list_cursor_p->bucket_p->payload_p;
+            }
+            list_cursor_p->payload_p = payload_p;
+            list_cursor_p->sequence  = ( list_cursor_p->bucket_p != NULL )
+                                     ? list_cursor_p->bucket_p->sequence : 0;
+        }
+
+        //  Allow access from other threads.
+        pthread_mutex_unlock( &list_base_p->access_lock );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( payload_p );
+}
+
+/****************************************************************************/
+/**
+ *  Move a cursor to the previous bucket of the link-list.
+ *
+ *  @param  list_cursor_p       Pointer to a link-list cursor.
+ *
+ *  @return payload_p           Pointer to the previous payload on the
+ *                              link-list.  NULL is returned at the start of
+ *                              the link-list or when another thread has
+ *                              deleted the bucket the cursor was on.  In the
+ *                              later case list_cursor_p->deleted is TRUE.
+ *
+ *  @note
+ *      A cursor that isn't positioned on a bucket moves to the last bucket.
+ *
+ ****************************************************************************/
+
+void    *
+list_cursor_prev(
+    struct  list_cursor_t       *   list_cursor_p
+    )
+{
+    struct  list_base_t         *   list_base_p;
+    void                        *   payload_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Reset the payload pointer
+    payload_p = NULL;
+
+    //  Get the link-list the cursor belongs to.
+    list_base_p = list_cursor_p->list_base_p;
+
+    /************************************************************************
+     *  Move to the previous bucket
+     ************************************************************************/
+
+    //  Are we starting with a valid link-list base pointer ?
+    if (    ( LIST__verify( list_base_p ) == true  )
+         && ( list_cursor_p->deleted      == false ) )
+    {
+        //  YES:    Prevent thread collisions.
+        pthread_mutex_lock( &list_base_p->access_lock );
+
+        //  Is the cursor bucket still on the link-list ?
+        if ( LIST__cursor_sync( list_cursor_p ) == true )
+        {
+            //  YES:    Is the cursor positioned on a bucket ?
+            if ( list_cursor_p->bucket_p == NULL )
+            {
+                //  NO:     Use the last bucket
+                list_cursor_p->bucket_p = list_base_p->last_p;
+            }
+            else
+            {
+                //  YES:    Get the previous bucket in the link-list.
+                list_cursor_p->bucket_p = list_cursor_p->bucket_p->prev_p;
+            }
+
+            //  Was there something there ?
+            if ( list_cursor_p->bucket_p != NULL )
+            {
+                //  YES:    Set the payload pointer.
+                payload_p = list_cursor_p->bucket_p->payload_p;
+            }
+            list_cursor_p->payload_p = payload_p;
+            list_cursor_p->sequence  = ( list_cursor_p->bucket_p != NULL )
+                                     ? list_cursor_p->bucket_p->sequence : 0;
+        }
+
+        //  Allow access from other threads.
+        pthread_mutex_unlock( &list_base_p->access_lock );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( payload_p );
+}
+
+/****************************************************************************/
+/**
+ *  Delete the bucket a cursor is positioned on.
+ *
+ *  @param  list_cursor_p       Pointer to a link-list cursor.
+ *
+ *  @return list_rc             TRUE when the bucket is successfully deleted
+ *                              from the link list, else FALSE.
+ *
+ *  @note
+ *      Like list_fdelete() the cursor is moved to the previous bucket so
+ *      the next call to list_cursor_next() returns the bucket that followed
+ *      the deleted one.
+ *
+ ****************************************************************************/
+
+int
+list_cursor_delete(
+    struct  list_cursor_t       *   list_cursor_p
+    )
+{
+    int                             list_rc;
+    struct  list_base_t         *   list_base_p;
+    struct  list_bucket_t       *   prev_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Assume fail and change the return code upon success.
+    list_rc = false;
+
+    //  Get the link-list the cursor belongs to.
+    list_base_p = list_cursor_p->list_base_p;
+
+    /************************************************************************
+     *  Delete the cursor bucket
+     ************************************************************************/
+
+    //  Are we starting with a valid link-list base pointer ?
+    if ( LIST__verify( list_base_p ) == true )
+    {
+        //  YES:    Prevent thread collisions.
+        pthread_mutex_lock( &list_base_p->access_lock );
+
+        //  Is the cursor positioned on a bucket that is still in the list ?
+        if (    ( LIST__cursor_sync( list_cursor_p ) == true )
+             && ( list_cursor_p->bucket_p            != NULL ) )
+        {
+            //  YES:    Save the previous bucket.
+            prev_p = list_cursor_p->bucket_p->prev_p;
+
+            //  Delete the current bucket.
+            list_rc = LIST__delete( list_base_p, list_cursor_p->bucket_p );
+
+            //  Make the previous bucket the current bucket.
+            list_cursor_p->bucket_p   = prev_p;
+            list_cursor_p->payload_p  = ( prev_p != NULL ) ? prev_p->payload_p : NULL;
+            list_cursor_p->sequence   = ( prev_p != NULL ) ? prev_p->sequence  : 0;
+            list_cursor_p->generation = list_base_p->generation;
+        }
+        else
+        {
+            //  NO:     Warn the user of the error.
+            log_write( MID_WARNING, "list_cursor_delete",
+                       "WARNING: The cursor for base '%p' is not positioned "
+                       "on a bucket.\n",
+                       list_base_p );
+        }
+
+        //  Allow access from other threads.
+        pthread_mutex_unlock( &list_base_p->access_lock );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( list_rc );
+}
+
 /****************************************************************************/
 /**
  *  Add a new payload to the end of a link-list.
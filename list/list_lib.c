@@ -501,8 +501,9 @@ LIST__put_first(
             //  YES:    Initialize the structure
             memset( list_bucket_p, 0x00, sizeof( struct list_bucket_t ) );
 
-            //  Set the payload pointer
+            //  Set the payload pointer and number the bucket
             list_bucket_p->payload_p = payload_p;
+            list_bucket_p->sequence  = ++list_base_p->sequence;
 
             //  Is the link-list currently empty ?
             if ( list_base_p->first_p == NULL )
@@ -587,8 +588,9 @@ LIST__put_last(
             //  YES:    Initialize the structure
             memset( list_bucket_p, 0x00, sizeof( struct list_bucket_t ) );
 
-            //  Set the payload pointer
+            //  Set the payload pointer and number the bucket
             list_bucket_p->payload_p = payload_p;
+            list_bucket_p->sequence  = ++list_base_p->sequence;
 
             //  Is the link-list currently empty ?
             if ( list_base_p->first_p == NULL )
@@ -806,6 +808,9 @@ LIST__delete(
 
     free( list_bucket_p );
 
+    //  Any cursor still holding a bucket pointer must now revalidate it.
+    list_base_p->generation += 1;
+
     //  Change the return code for success.
     list_rc = true;
 #endif
@@ -819,3 +824,93 @@ LIST__delete(
 }
 
 /****************************************************************************/
+
+/****************************************************************************/
+/**
+ *  Verify that the bucket a cursor is positioned on is still part of the
+ *  link-list.
+ *
+ *  @param  list_cursor_p       Pointer to a link-list cursor.
+ *
+ *  @return list_rc             TRUE when the cursor bucket is still in the
+ *                              link-list, else FALSE.
+ *
+ *  @note
+ *      The caller must be holding the link-list access lock.
+ *
+ *      When no bucket has been deleted since the cursor was last positioned
+ *      the generation numbers match and nothing more needs to be done.  Only
+ *      after a deletion is the (slow) search of the link-list required.
+ *
+ ****************************************************************************/
+
+int
+LIST__cursor_sync(
+    struct  list_cursor_t       *   list_cursor_p
+    )
+{
+    int                             list_rc;
+    struct  list_base_t         *   list_base_p;
+    struct  list_bucket_t       *   list_bucket_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Assume everything is still good.
+    list_rc = true;
+
+    //  Get the link-list the cursor belongs to.
+    list_base_p = list_cursor_p->list_base_p;
+
+    /************************************************************************
+     *  Revalidate the cursor bucket
+     ************************************************************************/
+
+    //  Has a bucket been deleted since the cursor was positioned ?
+    if (    ( list_cursor_p->bucket_p   !=                    NULL )
+         && ( list_cursor_p->generation != list_base_p->generation ) )
+    {
+        //  YES:    Search the link-list for the cursor bucket.
+        for ( list_bucket_p = list_base_p->first_p;
+              list_bucket_p != NULL;
+              list_bucket_p = list_bucket_p->next_p )
+        {
+            //  Is this the bucket (and payload) we are looking for ?
+            //  The sequence number tells it from a new bucket that reuses
+            //  the address of a deleted one.
+            if (    ( list_bucket_p            == list_cursor_p->bucket_p  )
+                 && ( list_bucket_p->payload_p == list_cursor_p->payload_p )
+                 && ( list_bucket_p->sequence  == list_cursor_p->sequence  ) )
+            {
+                //  YES:    Exit the search loop.
+                break;
+            }
+        }
+
+        //  Was the bucket located ?
+        if ( list_bucket_p == NULL )
+        {
+            //  NO:     Another thread deleted it out from under the cursor.
+            list_cursor_p->bucket_p  = NULL;
+            list_cursor_p->payload_p = NULL;
+            list_cursor_p->sequence  = 0;
+            list_cursor_p->deleted   = true;
+
+            //  Change the return code.
+            list_rc = false;
+        }
+
+        //  The cursor is now in sync with the link-list.
+        list_cursor_p->generation = list_base_p->generation;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( list_rc );
+}
+
+/****************************************************************************/
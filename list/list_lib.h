@@ -31,6 +31,7 @@
  ****************************************************************************/
 
                                 //*******************************************
+#include <stdint.h>             //  Alternative storage types
 #include <pthread.h>            //  pthread_*( );
                                 //*******************************************
 
@@ -78,6 +79,12 @@ struct  list_bucket_t
     /**
      *  Pointer to the bucket with the content.                             */
     void                        *   payload_p;
+
+    /**
+     *  Unique (per link-list) number given to the bucket when it is
+     *  created.  Used by the cursor functions to tell a bucket from a new
+     *  one that was allocated at the same address.                         */
+    uint64_t                        sequence;
 };
 //----------------------------------------------------------------------------
 /**
@@ -102,6 +109,13 @@ struct  list_base_t
     /**
      *  Fast search pointer                                                 */
     struct  list_bucket_t       *   f_key_p;
+    /**
+     *  Incremented every time a bucket is deleted from the list.  Used
+     *  by the cursor functions to detect a stale bucket pointer.           */
+    uint32_t                        generation;
+    /**
+     *  Sequence number of the last bucket created.                         */
+    uint64_t                        sequence;
 };
 //----------------------------------------------------------------------------
 
@@ -171,6 +185,11 @@ LIST__delete(
 #endif
     );
 //----------------------------------------------------------------------------
+int
+LIST__cursor_sync(
+    struct  list_cursor_t       *   list_cursor_p
+    );
+//----------------------------------------------------------------------------
 
 /****************************************************************************/
 
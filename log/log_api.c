@@ -12,13 +12,19 @@
  *  @note
  *      LOG_DIR_NAME        ~/.LibTools     Set in libtools_api.h
  *
+ *  @note
+ *      log_init_async() starts a writer thread.  From then on log_write()
+ *      formats each record straight into a lock-free ring and returns;
+ *      the writer thread keeps the log file open and writes the records
+ *      in batches.  MID_FATAL messages are written before exit.
+ *
  ****************************************************************************/
 
 /****************************************************************************
  *  Compiler directives
  ****************************************************************************/
 
-#define ALLOC_THREAD            ( "ALLOCATE STORAGE FOR THREAD" )
+#define ALLOC_LOG               ( "ALLOCATE STORAGE FOR LOG" )
 
 /****************************************************************************
  * System Function API
@@ -53,6 +59,10 @@
 #include "log_lib.h"            //  API for all LOG__*              PRIVATE
                                 //*******************************************
 
+//  This file defines the log_write() function itself; don't let the
+//  public macro front-end get in the way.
+#undef  log_write
+
 /****************************************************************************
  * API Enumerations
  ****************************************************************************/
@@ -75,9 +85,6 @@
 #define LOG_PRINT       (  MID_FATAL | MID_WARNING | MID_INFO | MID_TEMPORARY\
                          | MID_LOGONLY )
 //----------------------------------------------------------------------------
-uint16_t                            log_display_mask;
-uint16_t                            log_print_mask;
-//----------------------------------------------------------------------------
 
 /****************************************************************************
  * Private Structures
@@ -105,6 +112,7 @@ struct  log_file_t
 //----------------------------------------------------------------------------
     pthread_mutex_t                 log_thread_lock;
     char                            full_log_file_name[ FILE_NAME_L ];
+    uint16_t                        log_enabled_mask;
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -370,6 +378,77 @@ log_init(
     log_print_mask =   ( LOG_EVERYTHING );
 #endif
 
+    //  Publish the combined mask used by LOG_ENABLED()
+    __atomic_store_n( &log_enabled_mask,
+                      ( log_display_mask | log_print_mask ),
+                      __ATOMIC_RELAXED );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Initialization for the asynchronous log.  Everything log_init() does
+ *  plus a writer thread that owns the log file.
+ *
+ *  @param  log_file_name       Name of the log file.
+ *
+ *  @return void
+ *
+ *  @note
+ *      If the writer can't be started log_write() stays synchronous.
+ *
+ ****************************************************************************/
+
+void
+log_init_async(
+    char                        *   log_file_name
+    )
+{
+    /**
+     *  @param  ring_p          Pointer to the new log ring                 */
+    struct  log_ring_t          *   ring_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Do the normal initialization first
+    log_init( log_file_name );
+
+    /************************************************************************
+     *  Start the writer thread
+     ************************************************************************/
+
+    //  Is the asynchronous log already running ?
+    if ( atomic_load( &log_ring_p ) == NULL )
+    {
+        //  NO:     Create the log ring
+        ring_p = LOG__ring_new( full_log_file_name );
+
+        //  Was the ring created ?
+        if ( ring_p != NULL )
+        {
+            //  YES:    Start the writer thread and switch over to it.
+            thread_new( LOG__ring_writer, ring_p );
+            atomic_store( &log_ring_p, ring_p );
+
+            //  Don't lose anything still in the ring at exit.
+            atexit( LOG__ring_exit );
+        }
+        else
+        {
+            //  NO:     Stay synchronous.
+            log_write( MID_WARNING, "log_init_async",
+                       "Unable to start the log writer, logging is "
+                       "synchronous.\n" );
+        }
+    }
+
     /************************************************************************
      *  Function Exit
      ************************************************************************/
@@ -399,7 +478,7 @@ log_write(
     char                            time_string[ 35 ];
     /**
      *  Buffers for various forms of time of day.                       */
-    struct  tm                  *   current_time;
+    struct  tm                      current_time;
     struct  timeval                 time_of_day;
     time_t                          clock;
     /**
@@ -417,45 +496,28 @@ log_write(
     /**
      *  Pointer to the log file structure.                              */
     struct  log_file_t          *   log_file_p;
+    /**
+     *  Pointer to the asynchronous log ring.                           */
+    struct  log_ring_t          *   ring_p;
+    /**
+     *  Ring position the message was written to.                       */
+    size_t                          ring_pos;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
-    // Prevent all other threads from simultaneously writing to the log.
-    pthread_mutex_lock( &log_thread_lock );
+    //  Is the asynchronous writer running ?
+    ring_p = atomic_load_explicit( &log_ring_p, memory_order_acquire );
+    ring_pos = 0;
 
     //  Set the default output flags
     mdm = pdm = false;
 
-    /************************************************************************
-     *  Format the date & time string
-     ************************************************************************/
-
-    //  Get the current time of day
-    gettimeofday( &time_of_day, NULL );
-    clock = time( NULL );
-    current_time = localtime( &clock );
-
-    //  Format a date / time string for the message output.
-    snprintf( time_string, sizeof( time_string ),
-              "%04d/%02d/%02d-%02d:%02d:%02d.%06d",
-              current_time->tm_year + 1900,
-              current_time->tm_mon + 1,
-              current_time->tm_mday,
-              current_time->tm_hour,
-              current_time->tm_min,
-              current_time->tm_sec,
-              (int)time_of_day.tv_usec );
-
     /************************************************************************
      *  Decide if the message should be displayed.
      ************************************************************************/
 
-    //  By default the message is not displayed or written to the log file.
-    mdm = false;
-    pdm = false;
-
     //  Should the message be displayed on the screen ?
     if (    ( ( message_id & log_display_mask ) !=         0 )
          || ( ( message_id &        MID_FATAL ) == MID_FATAL ) )
@@ -472,67 +534,123 @@ log_write(
     }
 
     /************************************************************************
-     *  Format the user message
-     ************************************************************************/
-
-    //  Build the parameter list
-    va_start( message_parms, message_p );
-
-    //  Format the message string
-    vsnprintf( log_buffer, sizeof( log_buffer ), message_p, message_parms );
-
-    //  We are done formatting the message
-    va_end( message_parms );
-
-    /************************************************************************
-     *  Display the message
+     *  Format the date & time string
      ************************************************************************/
 
-    //  Should the message be written to the monitor ?
-    if ( mdm == true )
+    //  Is the message going anywhere ?
+    if ( ( mdm == true ) || ( pdm == true ) )
     {
-        //  YES:    Display the message to stdout
-        printf( "%s - %04X - %-20s %s",
-                time_string, message_id, function_name, log_buffer );
-        fflush( stdout );
+        //  Get the current time of day
+        gettimeofday( &time_of_day, NULL );
+        clock = time( NULL );
+        localtime_r( &clock, &current_time );
+
+        //  Format a date / time string for the message output.
+        snprintf( time_string, sizeof( time_string ),
+                  "%04d/%02d/%02d-%02d:%02d:%02d.%06d",
+                  current_time.tm_year + 1900,
+                  current_time.tm_mon + 1,
+                  current_time.tm_mday,
+                  current_time.tm_hour,
+                  current_time.tm_min,
+                  current_time.tm_sec,
+                  (int)time_of_day.tv_usec );
     }
 
     /************************************************************************
-     *  Print the message
+     *  Asynchronous log
      ************************************************************************/
 
-    //  Should the message be written to the monitor ?
-    if ( pdm == true )
+    //  Is the asynchronous writer running ?
+    if ( ring_p != NULL )
     {
-        //  Open the log file.
-        log_file_p = LOG__file_open( message_id );
-
-        //  The log file is open and locked.  Time to write the message.
-        fprintf( log_file_p->log_file_fp, "%s - %04X - %-20s %s",
-                 time_string, message_id, function_name, log_buffer );
-
-        //  Unlock the file to allow someone else to write to it.
-        LOG__file_close( log_file_p );
+        //  YES:    Is the message going anywhere ?
+        if ( ( mdm == true ) || ( pdm == true ) )
+        {
+            //  YES:    Format it directly into the log ring.
+            va_start( message_parms, message_p );
+            ring_pos = LOG__ring_put( ring_p, mdm, pdm, message_id,
+                                      time_string, function_name,
+                                      message_p, message_parms );
+            va_end( message_parms );
+        }
+
+        //  Are we supposed to be terminating the application ?
+        if ( ( message_id & MID_FATAL ) == MID_FATAL )
+        {
+            //  YES:    Wait for the message to be written then shut down.
+            LOG__ring_flush( ring_p, ring_pos );
+            exit( -1 );
+        }
     }
-
-    /************************************************************************
-     *  Application termination ?
-     ************************************************************************/
-
-    //  Are we supposed to be terminating the application ?
-    if ( ( message_id & MID_FATAL ) == MID_FATAL )
+    else if ( ( mdm == true ) || ( pdm == true ) )
     {
-        //  YES:    Shut it down.
-        exit( -1 );
+        //  Prevent all other threads from simultaneously writing to the log.
+        pthread_mutex_lock( &log_thread_lock );
+
+        /********************************************************************
+         *  Format the user message
+         ********************************************************************/
+
+        //  Build the parameter list
+        va_start( message_parms, message_p );
+
+        //  Format the message string
+        vsnprintf( log_buffer, sizeof( log_buffer ), message_p, message_parms );
+
+        //  We are done formatting the message
+        va_end( message_parms );
+
+        /********************************************************************
+         *  Display the message
+         ********************************************************************/
+
+        //  Should the message be written to the monitor ?
+        if ( mdm == true )
+        {
+            //  YES:    Display the message to stdout
+            printf( "%s - %04X - %-20s %s",
+                    time_string, message_id, function_name, log_buffer );
+            fflush( stdout );
+        }
+
+        /********************************************************************
+         *  Print the message
+         ********************************************************************/
+
+        //  Should the message be written to the monitor ?
+        if ( pdm == true )
+        {
+            //  Open the log file.
+            log_file_p = LOG__file_open( message_id );
+
+            //  The log file is open and locked.  Time to write the message.
+            fprintf( log_file_p->log_file_fp, "%s - %04X - %-20s %s",
+                     time_string, message_id, function_name, log_buffer );
+
+            //  Unlock the file to allow someone else to write to it.
+            LOG__file_close( log_file_p );
+        }
+
+        /********************************************************************
+         *  Application termination ?
+         ********************************************************************/
+
+        //  Are we supposed to be terminating the application ?
+        if ( ( message_id & MID_FATAL ) == MID_FATAL )
+        {
+            //  YES:    Shut it down.
+            exit( -1 );
+        }
+
+        // Release the thread lock on the log
+        pthread_mutex_unlock( &log_thread_lock );
     }
 
     /************************************************************************
      *  Function Exit
      ************************************************************************/
 
-    // Release the thread lock on the log
-    pthread_mutex_unlock( &log_thread_lock );
-
     //  DONE!
 }
 
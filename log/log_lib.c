@@ -27,6 +27,14 @@
 #include <stdbool.h>            //  TRUE, FALSE, etc.
 #include <stdio.h>              //  Standard I/O definitions
                                 //*******************************************
+#include <stdlib.h>             //  ANSI standard library.
+#include <string.h>             //  Functions for managing strings
+#include <unistd.h>             //  Access to the POSIX operating system API
+#include <fcntl.h>              //  open(), fcntl()
+#include <limits.h>             //  INT_MAX
+#include <sys/syscall.h>        //  syscall( SYS_futex )
+#include <linux/futex.h>        //  FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE
+                                //*******************************************
 
 /****************************************************************************
  * Application APIs
@@ -70,5 +78,643 @@
  * LIB Functions
  ****************************************************************************/
 
+/****************************************************************************/
+/**
+ *  Put the calling thread to sleep until the futex word changes.
+ *
+ *  @param  futex_p             Pointer to the futex word.
+ *  @param  value               The value the futex word had when the
+ *                              caller decided to sleep.
+ *
+ *  @return void
+ *
+ *  @note
+ *      When the futex word no longer contains 'value' the call returns
+ *      immediately.  This is what prevents a lost wake-up.
+ *
+ ****************************************************************************/
+
+void
+LOG__futex_wait(
+    atomic_uint                 *   futex_p,
+    unsigned int                    value
+    )
+{
+
+    /************************************************************************
+     *  Wait for the futex word to change
+     ************************************************************************/
+
+    //  Sleep until woken or the value has already changed.
+    syscall( SYS_futex, (unsigned int *)futex_p, FUTEX_WAIT_PRIVATE,
+             value, NULL, NULL, 0 );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Wake threads sleeping on a futex word.
+ *
+ *  @param  futex_p             Pointer to the futex word.
+ *  @param  count               Maximum number of threads to wake.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+LOG__futex_wake(
+    atomic_uint                 *   futex_p,
+    int                             count
+    )
+{
+
+    /************************************************************************
+     *  Wake up the sleeping threads
+     ************************************************************************/
+
+    //  Wake up to 'count' waiters.
+    syscall( SYS_futex, (unsigned int *)futex_p, FUTEX_WAKE_PRIVATE,
+             count, NULL, NULL, 0 );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Sleep until the writer thread has moved dequeue_pos past ring_pos.
+ *
+ *  @param  ring_p              Pointer to the log ring
+ *  @param  ring_pos            Ring position that must be written.
+ *
+ *  @return void
+ *
+ *  @note
+ *      The waiter count is raised before dequeue_pos is checked again and
+ *      the writer checks the count after it stores dequeue_pos, so one of
+ *      the two always sees the other.
+ *
+ ****************************************************************************/
+
+void
+LOG__ring_wait_written(
+    struct  log_ring_t          *   ring_p,
+    size_t                          ring_pos
+    )
+{
+    /**
+     *  @param  futex_value     Futex word value before going to sleep      */
+    unsigned int                    futex_value;
+
+    /************************************************************************
+     *  Wait for the writer thread
+     ************************************************************************/
+
+    //  Loop until the record has been written
+    while ( atomic_load( &ring_p->dequeue_pos ) <= ring_pos )
+    {
+        //  Tell the writer thread somebody is waiting.
+        futex_value = atomic_load( &ring_p->written );
+        atomic_fetch_add( &ring_p->written_waiters, 1 );
+
+        //  Last chance.  Was it written while we got ready ?
+        if ( atomic_load( &ring_p->dequeue_pos ) <= ring_pos )
+        {
+            //  NO:     Sleep until the writer thread makes progress.
+            LOG__futex_wait( &ring_p->written, futex_value );
+        }
+
+        //  No longer waiting.
+        atomic_fetch_sub( &ring_p->written_waiters, 1 );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Create a new asynchronous log ring and open the log file it will be
+ *  written to.  The file stays open for the life of the ring.
+ *
+ *  @param  log_file_name_p     Fully qualified log file name.
+ *
+ *  @return ring_p              Pointer to the new log ring or NULL if the
+ *                              ring could not be created.
+ *
+ ****************************************************************************/
+
+struct  log_ring_t  *
+LOG__ring_new(
+    char                        *   log_file_name_p
+    )
+{
+    /**
+     *  @param  ring_p          Pointer to the new log ring                 */
+    struct  log_ring_t          *   ring_p;
+    /**
+     *  @param  ring_ndx        Index into the record ring                  */
+    size_t                          ring_ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Allocate storage for the ring control structure and the records
+    ring_p = (struct log_ring_t*)malloc( sizeof( struct log_ring_t ) );
+
+    //  Was the allocation successful ?
+    if ( ring_p != NULL )
+    {
+        //  YES:    Initialize the new storage.
+        memset( ring_p, 0x00, sizeof( struct log_ring_t ) );
+
+        //  Allocate the records
+        ring_p->record_p = (struct log_record_t*)malloc(
+                ( sizeof( struct log_record_t ) * LOG_RING_L ) );
+
+        //  Was the allocation successful ?
+        if ( ring_p->record_p == NULL )
+        {
+            //  NO:     Forget it
+            free( ring_p );
+            ring_p = NULL;
+        }
+    }
+
+    /************************************************************************
+     *  Initialize the ring
+     ************************************************************************/
+
+    //  Is there a ring to initialize ?
+    if ( ring_p != NULL )
+    {
+        //  YES:    Every record starts out free at its own position
+        for ( ring_ndx = 0;
+              ring_ndx < LOG_RING_L;
+              ring_ndx += 1 )
+        {
+            atomic_init( &ring_p->record_p[ ring_ndx ].sequence, ring_ndx );
+            ring_p->record_p[ ring_ndx ].length = 0;
+        }
+        atomic_init( &ring_p->enqueue_pos, 0 );
+        atomic_init( &ring_p->dequeue_pos, 0 );
+        atomic_init( &ring_p->not_empty, 0 );
+        atomic_init( &ring_p->writer_waiting, false );
+        atomic_init( &ring_p->written, 0 );
+        atomic_init( &ring_p->written_waiters, 0 );
+
+        //  Open the log file for append
+        ring_p->fd = open( log_file_name_p,
+                           ( O_WRONLY | O_APPEND | O_CREAT ), 0664 );
+
+        //  Was the log file opened ?
+        if ( ring_p->fd == -1 )
+        {
+            //  NO:     No ring then.
+            free( ring_p->record_p );
+            free( ring_p );
+            ring_p = NULL;
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( ring_p );
+}
+
+/****************************************************************************/
+/**
+ *  Claim the next record in the log ring, format the message directly
+ *  into it and hand it to the writer thread.  When the ring is full the
+ *  caller sleeps until the writer thread frees a record.  The writer
+ *  thread is only woken when it is sleeping on an empty ring.
+ *
+ *  @param  ring_p              Pointer to the log ring
+ *  @param  mdm                 true when the message is displayed
+ *  @param  pdm                 true when the message is written to the file
+ *  @param  message_id          Message ID
+ *  @param  time_string_p       Formatted time of day
+ *  @param  function_name       Name of the calling function
+ *  @param  message_p           printf style format string
+ *  @param  message_parms       Parameters for the format string
+ *
+ *  @return ring_pos            Ring position the message was written to.
+ *
+ ****************************************************************************/
+
+size_t
+LOG__ring_put(
+    struct  log_ring_t          *   ring_p,
+    int                             mdm,
+    int                             pdm,
+    uint16_t                        message_id,
+    const char                  *   time_string_p,
+    const char                  *   function_name,
+    const char                  *   message_p,
+    va_list                         message_parms
+    )
+{
+    /**
+     *  @param  ring_pos        Ring position being claimed                 */
+    size_t                          ring_pos;
+    /**
+     *  @param  sequence        Sequence number of the record               */
+    size_t                          sequence;
+    /**
+     *  @param  record_p        Pointer to the claimed record               */
+    struct  log_record_t        *   record_p;
+    /**
+     *  @param  length          Length of the formatted text                */
+    int                             length;
+    /**
+     *  @param  claimed         Flag showing the record is claimed          */
+    int                             claimed;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Nothing has been claimed yet
+    claimed = false;
+    record_p = NULL;
+    ring_pos = atomic_load_explicit( &ring_p->enqueue_pos,
+                                     memory_order_relaxed );
+
+    /************************************************************************
+     *  Claim a record
+     ************************************************************************/
+
+    //  Loop until a record has been claimed
+    while ( claimed == false )
+    {
+        record_p = &ring_p->record_p[ ring_pos % LOG_RING_L ];
+        sequence = atomic_load_explicit( &record_p->sequence,
+                                         memory_order_acquire );
+
+        //  Is the record free at this position ?
+        if ( sequence == ring_pos )
+        {
+            //  YES:    Try to claim it
+            claimed = atomic_compare_exchange_weak_explicit(
+                    &ring_p->enqueue_pos, &ring_pos, ring_pos + 1,
+                    memory_order_relaxed, memory_order_relaxed );
+        }
+        //  Is the ring full ?
+        else if ( sequence < ring_pos )
+        {
+            //  YES:    Wait for the writer thread to free the record
+            LOG__ring_wait_written( ring_p, ( ring_pos - LOG_RING_L ) );
+            ring_pos = atomic_load_explicit( &ring_p->enqueue_pos,
+                                             memory_order_relaxed );
+        }
+        else
+        {
+            //  NO:     Another thread got it first
+            ring_pos = atomic_load_explicit( &ring_p->enqueue_pos,
+                                             memory_order_relaxed );
+        }
+    }
+
+    /************************************************************************
+     *  Format the record
+     ************************************************************************/
+
+    //  Format the record header
+    length = snprintf( record_p->text, sizeof( record_p->text ),
+                       "%s - %04X - %-20s ",
+                       time_string_p, message_id, function_name );
+
+    //  Add the message
+    if (    ( length >= 0 )
+         && ( length < (int)sizeof( record_p->text ) ) )
+    {
+        length += vsnprintf( &record_p->text[ length ],
+                             ( sizeof( record_p->text ) - length ),
+                             message_p, message_parms );
+    }
+
+    //  Was the record truncated ?
+    if (    ( length < 0 )
+         || ( length >= (int)sizeof( record_p->text ) ) )
+    {
+        //  YES:    Use what fit.
+        length = strlen( record_p->text );
+    }
+
+    //  Save everything the writer thread needs
+    record_p->length  = length;
+    record_p->display = mdm;
+    record_p->print   = pdm;
+
+    //  Publish the record to the writer thread
+    //  @NOTE   Sequentially consistent so the writer_waiting check below
+    //          can't be ordered ahead of it.
+    atomic_store( &record_p->sequence, ring_pos + 1 );
+
+    //  Is the writer thread sleeping on an empty ring ?
+    if ( atomic_load( &ring_p->writer_waiting ) == true )
+    {
+        //  YES:    Wake it up.
+        atomic_fetch_add( &ring_p->not_empty, 1 );
+        LOG__futex_wake( &ring_p->not_empty, 1 );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( ring_pos );
+}
+
+/****************************************************************************/
+/**
+ *  Wait for the writer thread to write out every record up to and
+ *  including the one at ring_pos.
+ *
+ *  @param  ring_p              Pointer to the log ring
+ *  @param  ring_pos            Last ring position that must be written.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+LOG__ring_flush(
+    struct  log_ring_t          *   ring_p,
+    size_t                          ring_pos
+    )
+{
+
+    /************************************************************************
+     *  Wait for the writer thread
+     ************************************************************************/
+
+    //  Sleep until the record has been written
+    LOG__ring_wait_written( ring_p, ring_pos );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  The log writer thread.  Records are gathered from the ring in batches
+ *  of up to LOG_BATCH_L, the display records are written to stdout and the
+ *  print records are written to the log file with one writev() call.  The
+ *  log file is only locked around each batch.
+ *
+ *  @param  void_p              Pointer to the log ring
+ *
+ *  @return void
+ *
+ *  @note
+ *      This thread never terminates.
+ *
+ ****************************************************************************/
+
+void
+LOG__ring_writer(
+    void                        *   void_p
+    )
+{
+    /**
+     *  @param  ring_p          Pointer to the log ring                     */
+    struct  log_ring_t          *   ring_p;
+    /**
+     *  @param  record_p        Pointer to a record in the ring             */
+    struct  log_record_t        *   record_p;
+    /**
+     *  @param  ring_pos        First ring position of the batch            */
+    size_t                          ring_pos;
+    /**
+     *  @param  batch_count     Number of records in the batch              */
+    int                             batch_count;
+    /**
+     *  @param  batch_ndx       Index into the batch                        */
+    int                             batch_ndx;
+    /**
+     *  @param  iov_count       Number of records to write to the file      */
+    int                             iov_count;
+    /**
+     *  @param  display_count   Number of records written to stdout         */
+    int                             display_count;
+    /**
+     *  @param  iov             Gather list for writev()                    */
+    struct  iovec                   iov[ LOG_BATCH_L ];
+    /**
+     *  @param  lock            File lock structure                         */
+    struct  flock                   lock;
+    /**
+     *  @param  futex_value     Futex word value before going to sleep      */
+    unsigned int                    futex_value;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    ring_p = (struct log_ring_t*)void_p;
+
+    //  Initialize the file lock structure.
+    memset( &lock, 0x00, sizeof( lock ) );
+    lock.l_whence = SEEK_SET;
+    lock.l_start  = 0;
+    lock.l_len    = 0;
+
+    /************************************************************************
+     *  Write records forever
+     ************************************************************************/
+
+    while ( true )
+    {
+        //  This thread is the only one that moves dequeue_pos
+        ring_pos = atomic_load_explicit( &ring_p->dequeue_pos,
+                                         memory_order_relaxed );
+        iov_count = 0;
+        display_count = 0;
+
+        //  Gather a batch of published records
+        for ( batch_count = 0;
+              batch_count < LOG_BATCH_L;
+              batch_count += 1 )
+        {
+            record_p = &ring_p->record_p[ ( ring_pos + batch_count )
+                                          % LOG_RING_L ];
+
+            //  Has this record been published ?
+            if ( atomic_load_explicit( &record_p->sequence,
+                                       memory_order_acquire )
+                 != ( ring_pos + batch_count + 1 ) )
+            {
+                //  NO:     End of the batch
+                break;
+            }
+
+            //  Should the record be displayed ?
+            if ( record_p->display == true )
+            {
+                //  YES:    Write it to stdout
+                fwrite( record_p->text, 1, record_p->length, stdout );
+                display_count += 1;
+            }
+
+            //  Should the record be written to the log file ?
+            if ( record_p->print == true )
+            {
+                //  YES:    Add it to the gather list
+                iov[ iov_count ].iov_base = record_p->text;
+                iov[ iov_count ].iov_len  = record_p->length;
+                iov_count += 1;
+            }
+        }
+
+        //  Is the ring empty ?
+        if ( batch_count == 0 )
+        {
+            //  YES:    Tell the writers of log messages we are sleeping.
+            futex_value = atomic_load( &ring_p->not_empty );
+            atomic_store( &ring_p->writer_waiting, true );
+
+            //  Last chance.  Was something published while we got ready ?
+            record_p = &ring_p->record_p[ ring_pos % LOG_RING_L ];
+            if ( atomic_load( &record_p->sequence ) != ( ring_pos + 1 ) )
+            {
+                //  NO:     Sleep until a record is published.
+                LOG__futex_wait( &ring_p->not_empty, futex_value );
+            }
+
+            //  No longer sleeping.
+            atomic_store( &ring_p->writer_waiting, false );
+        }
+        else
+        {
+            //  Flush the display output once per batch
+            if ( display_count > 0 )
+            {
+                fflush( stdout );
+            }
+
+            //  Is there anything to write to the log file ?
+            if ( iov_count > 0 )
+            {
+                //  YES:    Lock the file, write the batch and unlock it.
+                lock.l_type = F_WRLCK;
+                fcntl( ring_p->fd, F_SETLKW, &lock );
+
+                if ( writev( ring_p->fd, iov, iov_count ) == -1 )
+                {
+                    //  The log itself can't be used to report this.
+                    printf( "LOG__ring_writer: writev failed on the "
+                            "log file.\n" );
+                    fflush( stdout );
+                }
+
+                lock.l_type = F_UNLCK;
+                fcntl( ring_p->fd, F_SETLK, &lock );
+            }
+
+            //  Release the records for reuse
+            for ( batch_ndx = 0;
+                  batch_ndx < batch_count;
+                  batch_ndx += 1 )
+            {
+                record_p = &ring_p->record_p[ ( ring_pos + batch_ndx )
+                                              % LOG_RING_L ];
+                atomic_store_explicit( &record_p->sequence,
+                                       ( ring_pos + batch_ndx + LOG_RING_L ),
+                                       memory_order_release );
+            }
+
+            //  Let anyone waiting on a flush know how far we are
+            atomic_store( &ring_p->dequeue_pos, ( ring_pos + batch_count ) );
+
+            //  Is anyone sleeping until records are written ?
+            if ( atomic_load( &ring_p->written_waiters ) > 0 )
+            {
+                //  YES:    Wake them all, each checks its own position.
+                atomic_fetch_add( &ring_p->written, 1 );
+                LOG__futex_wake( &ring_p->written, INT_MAX );
+            }
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Registered with atexit() when the asynchronous log is started.  Waits
+ *  for every message logged so far to be written.
+ *
+ *  @param  void
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+LOG__ring_exit(
+    void
+    )
+{
+    /**
+     *  @param  ring_p          Pointer to the log ring                     */
+    struct  log_ring_t          *   ring_p;
+    /**
+     *  @param  ring_pos        Last claimed ring position                  */
+    size_t                          ring_pos;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    ring_p = atomic_load( &log_ring_p );
+
+    /************************************************************************
+     *  Drain the ring
+     ************************************************************************/
+
+    //  Is there anything that could still be in the ring ?
+    if ( ring_p != NULL )
+    {
+        ring_pos = atomic_load( &ring_p->enqueue_pos );
+
+        //  Has anything ever been logged ?
+        if ( ring_pos > 0 )
+        {
+            //  YES:    Wait for the last of it to be written
+            LOG__ring_flush( ring_p, ( ring_pos - 1 ) );
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
 
 /****************************************************************************/
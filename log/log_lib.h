@@ -31,6 +31,9 @@
  ****************************************************************************/
 
                                 //*******************************************
+#include <stdatomic.h>          //  Atomic ring positions
+#include <stdarg.h>             //  va_list
+#include <sys/uio.h>            //  struct iovec, writev()
                                 //*******************************************
 
 /****************************************************************************
@@ -48,6 +51,16 @@
 #define LOG_FILE_NAME           "/var/log/ria/RecipeImportAssist.log"
 //#define LOG_FILE_NAME           "RecipeImportAssist.log"
 //----------------------------------------------------------------------------
+/**
+ *  Number of records in the asynchronous log ring.                         */
+#define LOG_RING_L              ( 1024 )
+/**
+ *  Size of a single formatted log record (header + message)                */
+#define LOG_RECORD_L            ( 1024 + 128 )
+/**
+ *  Maximum number of records written with a single writev() call          */
+#define LOG_BATCH_L             ( 64 )
+//----------------------------------------------------------------------------
 
 /****************************************************************************
  * Library Private Enumerations
@@ -61,8 +74,8 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
-uint16_t                            log_display_mask;
-uint16_t                            log_print_mask;
+LOG_EXT uint16_t                    log_display_mask;
+LOG_EXT uint16_t                    log_print_mask;
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -70,6 +83,53 @@ uint16_t                            log_print_mask;
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+struct  log_record_t
+{
+    /**
+     *  Ring sequence number.  Equal to the ring position when the record
+     *  is free and to the ring position + 1 once it holds a message.       */
+    atomic_size_t                   sequence;
+    /**
+     *  true when the record is to be displayed on stdout                   */
+    int                             display;
+    /**
+     *  true when the record is to be written to the log file               */
+    int                             print;
+    /**
+     *  Number of valid bytes in text                                       */
+    size_t                          length;
+    /**
+     *  The fully formatted log record                                      */
+    char                            text[ LOG_RECORD_L ];
+};
+//----------------------------------------------------------------------------
+struct  log_ring_t
+{
+    /**
+     *  Next ring position to be claimed by a writer of log messages        */
+    atomic_size_t                   enqueue_pos;
+    /**
+     *  Next ring position to be written out by the writer thread           */
+    atomic_size_t                   dequeue_pos;
+    /**
+     *  Futex word changed when a record is published to a sleeping writer  */
+    atomic_uint                     not_empty;
+    /**
+     *  true while the writer thread is sleeping on not_empty               */
+    atomic_int                      writer_waiting;
+    /**
+     *  Futex word changed after the writer thread advances dequeue_pos     */
+    atomic_uint                     written;
+    /**
+     *  Number of threads sleeping on written (flush or a full ring)        */
+    atomic_int                      written_waiters;
+    /**
+     *  Log file descriptor (kept open for the life of the ring)            */
+    int                             fd;
+    /**
+     *  The ring of log records                                             */
+    struct  log_record_t        *   record_p;
+};
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -77,6 +137,9 @@ uint16_t                            log_print_mask;
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+/**
+ *  Asynchronous log ring.  NULL when log_write() is synchronous.           */
+LOG_EXT _Atomic(struct log_ring_t *)    log_ring_p;
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -84,6 +147,56 @@ uint16_t                            log_print_mask;
  ****************************************************************************/
 
 //---------------------------------------------------------------------------
+void
+LOG__futex_wait(
+    atomic_uint                 *   futex_p,
+    unsigned int                    value
+    );
+//---------------------------------------------------------------------------
+void
+LOG__futex_wake(
+    atomic_uint                 *   futex_p,
+    int                             count
+    );
+//---------------------------------------------------------------------------
+void
+LOG__ring_wait_written(
+    struct  log_ring_t          *   ring_p,
+    size_t                          ring_pos
+    );
+//---------------------------------------------------------------------------
+struct  log_ring_t  *
+LOG__ring_new(
+    char                        *   log_file_name_p
+    );
+//---------------------------------------------------------------------------
+size_t
+LOG__ring_put(
+    struct  log_ring_t          *   ring_p,
+    int                             mdm,
+    int                             pdm,
+    uint16_t                        message_id,
+    const char                  *   time_string_p,
+    const char                  *   function_name,
+    const char                  *   message_p,
+    va_list                         message_parms
+    );
+//---------------------------------------------------------------------------
+void
+LOG__ring_flush(
+    struct  log_ring_t          *   ring_p,
+    size_t                          ring_pos
+    );
+//---------------------------------------------------------------------------
+void
+LOG__ring_writer(
+    void                        *   void_p
+    );
+//---------------------------------------------------------------------------
+void
+LOG__ring_exit(
+    void
+    );
 //---------------------------------------------------------------------------
 
 /****************************************************************************/
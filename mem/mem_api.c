@@ -10,6 +10,15 @@
  *  library components of the 'mem' library.
  *
  *  @note
+ *      Every buffer is preceded by a small header holding its size, a
+ *      magic number and an optional call-site tag, and is followed by a
+ *      canary.  mem_sizeof() is O(1) and mem_free() catches double
+ *      frees, foreign pointers and overruns in every build.
+ *
+ *  @note
+ *      With MEM_SLAB, blocks up to 4K (header included) come from per
+ *      thread size-class caches backed by a central depot.  Only a cache
+ *      miss or overflow takes a (per class) lock.
  *
  ****************************************************************************/
 
@@ -21,6 +30,9 @@
 
 #define MEM_LEAK_DETECT         ( 0 )
 
+//  Serve small buffers from per-thread slab caches instead of malloc()
+#define MEM_SLAB                ( 1 )
+
 /****************************************************************************
  * System Function API
  ****************************************************************************/
@@ -103,8 +115,8 @@ mem_init(
      *  Function
      ************************************************************************/
 
-    //  Create a new list
-    malloc_info_p = list_new( );
+    //  Initialize the allocation tracker
+    MEM__info_init( );
 
     /************************************************************************
      *  Function Exit
@@ -115,7 +127,8 @@ mem_init(
 
 /****************************************************************************/
 /**
- *  Allocate and initialize a buffer.
+ *  Allocate a buffer without clearing it.  The contents are undefined, so
+ *  this is for callers that fill the whole buffer anyway.
  *
  *  @param  size                The amount of memory (in bytes) requested.
  *
@@ -129,18 +142,22 @@ mem_init(
  ****************************************************************************/
 
 void *
-mem_malloc(
-    int                             size  
+mem_malloc_nozero(
+    int                             size
     )
 {
     /**
      *  @param  memory_p        Pointer to the allocated memory             */
     char                        *   memory_p;
-#if MEM_LEAK_DETECT
     /**
-     *  @param  malloc_data_p   Pointer to a sizeof structure               */
-    struct  malloc_data_t       *   malloc_data_p;
-#endif
+     *  @param  header_p        Pointer to the buffer header                */
+    struct  mem_header_t        *   header_p;
+    /**
+     *  @param  canary          Canary value                                */
+    uint32_t                        canary;
+    /**
+     *  @param  block_l         Size of the block including the header      */
+    size_t                          block_l;
     
     /************************************************************************
      *  Function Initialization
@@ -153,45 +170,41 @@ mem_malloc(
      *  Allocate memory as requested.
      ************************************************************************/
 
-    //  Allocate the requested number of bytes.
-    memory_p = (char*)malloc( size );
+    //  Allocate the requested number of bytes plus the header and canary.
+    block_l = ( sizeof( struct mem_header_t ) + size + MEM_CANARY_L );
+#if MEM_SLAB
+    header_p = MEM__slab_alloc( block_l );
+#else
+    header_p = (struct mem_header_t*)malloc( block_l );
+#endif
 
     //  Was the memory allocation successful ?
-    if ( memory_p == NULL )
+    if ( header_p == NULL )
     {
         //  NO:     A very bad situation indeed.
         log_write( MID_FATAL, "mem_malloc",
                    "Unable to allocate memory!\n" );
     }
 
-    //  Now that we have established that memory was actually allocated,
-    //  initialize it.
-    memset( memory_p, 0x00, size );
+    //  Fill in the header
+    header_p->tag_p = NULL;
+    header_p->size  = size;
+    header_p->magic = MEM_MAGIC_LIVE;
+
+    //  The caller's data follows the header
+    memory_p = (char*)( header_p + 1 );
+
+    //  Mark the end of the buffer
+    canary = MEM_CANARY;
+    memcpy( &memory_p[ size ], &canary, MEM_CANARY_L );
 
     /************************************************************************
      *  Update the malloc information list
      ************************************************************************/
 
 #if MEM_LEAK_DETECT
-    //  Allocate a new malloc data structure
-    malloc_data_p = (struct malloc_data_t*)malloc( sizeof( struct malloc_data_t ) );
-
-    //  Was the memory allocation successful ?
-    if ( malloc_data_p == NULL )
-    {
-        //  NO:     A very bad situation indeed.
-        log_write( MID_FATAL, "mem_malloc",
-                   "Unable to allocate memory for a new malloc data structure!\n" );
-    }
-
-    //  Save the pointer
-    malloc_data_p->address = memory_p;
-
-    //  Save the size
-    malloc_data_p->size = size;
-
-    //  Append to the malloc information list
-    list_put_last( malloc_info_p, malloc_data_p );
+    //  Add the new buffer to the allocation tracker
+    MEM__info_put( memory_p, size );
 #endif
     
     /************************************************************************
@@ -206,6 +219,90 @@ mem_malloc(
     return( (void*)memory_p );
 }
 
+/****************************************************************************/
+/**
+ *  Allocate and initialize a buffer.
+ *
+ *  @param  size                The amount of memory (in bytes) requested.
+ *
+ *  @return memory_p            Pointer to the allocated memory.
+ *
+ *  @note
+ *      It is assumed that the caller of this function will be using the
+ *      requested memory.  Thus, if the memory allocation fails the entire
+ *      module will be terminated.
+ *
+ ****************************************************************************/
+
+void *
+mem_malloc(
+    int                             size  
+    )
+{
+    /**
+     *  @param  memory_p        Pointer to the allocated memory             */
+    void                        *   memory_p;
+
+    /************************************************************************
+     *  Allocate memory as requested.
+     ************************************************************************/
+
+    //  Allocate the requested number of bytes.
+    memory_p = mem_malloc_nozero( size );
+
+    //  Now that we have established that memory was actually allocated,
+    //  initialize it.
+    memset( memory_p, 0x00, size );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( memory_p );
+}
+
+/****************************************************************************/
+/**
+ *  Allocate and initialize a buffer that carries a call-site tag.  The tag
+ *  is reported by mem_dump() and by the overrun check in mem_free().
+ *
+ *  @param  size                The amount of memory (in bytes) requested.
+ *  @param  tag_p               Call-site tag.  Must be a string that lives
+ *                              as long as the buffer (a literal or __func__)
+ *
+ *  @return memory_p            Pointer to the allocated memory.
+ *
+ ****************************************************************************/
+
+void *
+mem_malloc_tag(
+    int                             size,
+    const char                  *   tag_p
+    )
+{
+    /**
+     *  @param  memory_p        Pointer to the allocated memory             */
+    void                        *   memory_p;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Allocate the buffer
+    memory_p = mem_malloc( size );
+
+    //  Tag it
+    MEM_HEADER( memory_p )->tag_p = tag_p;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( memory_p );
+}
+
 /****************************************************************************/
 /**
  *  Release previously allocated storage.
@@ -223,6 +320,9 @@ mem_free(
     void                        *   memory_p
     )
 {
+    /**
+     *  @param  header_p        Pointer to the buffer header                */
+    struct  mem_header_t        *   header_p;
 
     /************************************************************************
      *  Function Initialization
@@ -240,13 +340,25 @@ mem_free(
         log_write( MID_DEBUG_0, "mem_free",
                    "[ %p ]\n", memory_p );
 
+        //  Make sure the buffer is still intact
+        header_p = MEM__header_check( memory_p, "mem_free" );
+
 #if MEM_LEAK_DETECT    
         //  Remove the malloc information from the information list
         MEM__info_remove( memory_p );
 #endif
         
+        //  Mark it released so a second mem_free() is caught.  The store is
+        //  volatile, otherwise the compiler drops it as dead before free().
+        *(volatile uint32_t*)&header_p->magic = MEM_MAGIC_FREE;
+
         //  Release the previously allocated memory buffer.
-        free( memory_p );
+#if MEM_SLAB
+        MEM__slab_free( header_p, ( sizeof( struct mem_header_t )
+                                    + header_p->size + MEM_CANARY_L ) );
+#else
+        free( header_p );
+#endif
     }
     else
     {
@@ -260,10 +372,306 @@ mem_free(
     //  DONE!
 }
 
+/****************************************************************************/
+/**
+ *  Change the size of a buffer previously allocated with mem_malloc().
+ *  The contents are kept up to the lesser of the old and new sizes and
+ *  any added bytes are cleared.
+ *
+ *  @param  memory_p            Pointer to allocated memory or NULL.
+ *  @param  size                The new size (in bytes) of the buffer.
+ *
+ *  @return new_p               Pointer to the resized buffer.  It may be
+ *                              the same as memory_p.
+ *
+ *  @note
+ *      A slab block grows in place while the new size stays in the same
+ *      size class.  Blocks too big for a slab use realloc().  Only a
+ *      block moving between size classes is copied.
+ *
+ ****************************************************************************/
+
+void *
+mem_realloc(
+    void                        *   memory_p,
+    int                             size
+    )
+{
+    /**
+     *  @param  new_p           Pointer to the resized buffer               */
+    char                        *   new_p;
+    /**
+     *  @param  header_p        Pointer to the buffer header                */
+    struct  mem_header_t        *   header_p;
+    /**
+     *  @param  old_l           Size of the buffer before the change        */
+    int                             old_l;
+    /**
+     *  @param  old_block_l     Size of the old block including the header  */
+    size_t                          old_block_l;
+    /**
+     *  @param  new_block_l     Size of the new block including the header  */
+    size_t                          new_block_l;
+    /**
+     *  @param  in_place        true when the block can be resized in place */
+    int                             in_place;
+    /**
+     *  @param  canary          Canary value                                */
+    uint32_t                        canary;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Is there a buffer to resize ?
+    if ( memory_p == NULL )
+    {
+        //  NO:     This is just an allocation
+        return( mem_malloc( size ) );
+    }
+
+    //  Make sure the buffer is still intact
+    header_p = MEM__header_check( memory_p, "mem_realloc" );
+
+    old_l       = header_p->size;
+    old_block_l = ( sizeof( struct mem_header_t ) + old_l + MEM_CANARY_L );
+    new_block_l = ( sizeof( struct mem_header_t ) + size  + MEM_CANARY_L );
+
+    /************************************************************************
+     *  Resize the block
+     ************************************************************************/
+
+#if MEM_SLAB
+    //  Will the block stay in the same slab size class ?
+    in_place = (    ( MEM__class_index( old_block_l ) >= 0 )
+                 && (    MEM__class_index( old_block_l )
+                      == MEM__class_index( new_block_l ) ) );
+
+#if MEM_LEAK_DETECT
+    //  Is it being resized in its slab ?
+    if ( in_place == true )
+    {
+        //  YES:    Track it with its new size
+        MEM__info_remove( memory_p );
+        MEM__info_put( memory_p, size );
+    }
+#endif
+
+    //  Are both the old and the new block too big for a slab ?
+    if (    ( MEM__class_index( old_block_l ) < 0 )
+         && ( MEM__class_index( new_block_l ) < 0 ) )
+#else
+    in_place = false;
+#endif
+    {
+        //  YES:    The block came from malloc() and will stay there
+#if MEM_LEAK_DETECT
+        MEM__info_remove( memory_p );
+#endif
+        header_p = (struct mem_header_t*)realloc( header_p, new_block_l );
+
+        //  Was the memory allocation successful ?
+        if ( header_p == NULL )
+        {
+            //  NO:     A very bad situation indeed.
+            log_write( MID_FATAL, "mem_realloc",
+                       "Unable to allocate memory!\n" );
+        }
+
+        in_place = true;
+#if MEM_LEAK_DETECT
+        MEM__info_put( (char*)( header_p + 1 ), size );
+#endif
+    }
+
+    //  Can the block be resized in place ?
+    if ( in_place == true )
+    {
+        //  YES:    Update the header and move the canary
+        new_p = (char*)( header_p + 1 );
+        header_p->size = size;
+        canary = MEM_CANARY;
+        memcpy( &new_p[ size ], &canary, MEM_CANARY_L );
+    }
+    else
+    {
+        //  NO:     Move the data to a new block
+        new_p = mem_malloc_nozero( size );
+        memcpy( new_p, memory_p, ( old_l < size ) ? old_l : size );
+        MEM_HEADER( new_p )->tag_p = header_p->tag_p;
+        mem_free( memory_p );
+    }
+
+    //  Clear the bytes that were added
+    if ( size > old_l )
+    {
+        memset( &new_p[ old_l ], 0x00, ( size - old_l ) );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  Log the change
+    log_write( MID_DEBUG_0, "mem_realloc",
+               "[ %p ] %04X -> [ %p ] %04X\n",
+               memory_p, old_l, new_p, size );
+
+    //  DONE!
+    return( (void*)new_p );
+}
+
+/****************************************************************************/
+/**
+ *  Initialize a string buffer.  No storage is allocated until the first
+ *  append.
+ *
+ *  @param  strbuf_p            Pointer to the string buffer.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+mem_strbuf_init(
+    struct  mem_strbuf_t        *   strbuf_p
+    )
+{
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    strbuf_p->data_p    = NULL;
+    strbuf_p->length    = 0;
+    strbuf_p->capacity  = 0;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Append data to a string buffer.  The buffer at least doubles each time
+ *  it has to grow so a long run of appends costs a linear number of
+ *  copies.
+ *
+ *  @param  strbuf_p            Pointer to the string buffer.
+ *  @param  data_p              Pointer to the data to append.
+ *  @param  data_l              Number of bytes to append.
+ *
+ *  @return void
+ *
+ *  @note
+ *      The data is always followed by a NUL so strbuf_p->data_p can be
+ *      used as a string.
+ *
+ ****************************************************************************/
+
+void
+mem_strbuf_append(
+    struct  mem_strbuf_t        *   strbuf_p,
+    const char                  *   data_p,
+    int                             data_l
+    )
+{
+    /**
+     *  @param  need_l          Space needed for the data and the NUL       */
+    int                             need_l;
+    /**
+     *  @param  capacity        New capacity of the buffer                  */
+    int                             capacity;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    need_l = strbuf_p->length + data_l + 1;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is the buffer big enough ?
+    if ( need_l > strbuf_p->capacity )
+    {
+        //  NO:     Is this the first append ?
+        if ( strbuf_p->capacity == 0 )
+        {
+            //  YES:    Allocate exactly what is needed
+            capacity = need_l;
+        }
+        else
+        {
+            //  NO:     Grow it geometrically
+            capacity = strbuf_p->capacity * 2;
+
+            if ( capacity < need_l )
+            {
+                capacity = need_l;
+            }
+        }
+
+        strbuf_p->data_p   = mem_realloc( strbuf_p->data_p, capacity );
+        strbuf_p->capacity = capacity;
+    }
+
+    //  Append the data
+    memcpy( &strbuf_p->data_p[ strbuf_p->length ], data_p, data_l );
+    strbuf_p->length += data_l;
+    strbuf_p->data_p[ strbuf_p->length ] = '\0';
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Take the data out of a string buffer.  The buffer is left empty.
+ *
+ *  @param  strbuf_p            Pointer to the string buffer.
+ *
+ *  @return data_p              The string (release it with mem_free()) or
+ *                              NULL when nothing was ever appended.
+ *
+ ****************************************************************************/
+
+char *
+mem_strbuf_detach(
+    struct  mem_strbuf_t        *   strbuf_p
+    )
+{
+    /**
+     *  @param  data_p          The string                                  */
+    char                        *   data_p;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    data_p = strbuf_p->data_p;
+
+    //  Leave the buffer empty
+    mem_strbuf_init( strbuf_p );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( data_p );
+}
+
 /****************************************************************************/
 /**
  *  Lookup and return the size of a memory buffer previously allocated using
- *  list_malloc( size );
+ *  mem_malloc( size );
  *
  *  @param  address             Pointer to the previously allocated memory.
  *
@@ -279,8 +687,8 @@ mem_sizeof(
     )
 {
     /**
-     *  @param  malloc_data_p   Pointer to the information structure        */
-    struct  malloc_data_t       *   malloc_data_p;
+     *  @param  size            Size of the addressed buffer                */
+    int                             size;
 
     /************************************************************************
      *  Function Initialization
@@ -291,15 +699,254 @@ mem_sizeof(
      *  Function
      ************************************************************************/
 
-    //  Get the 'sizeof' the addressed buffer
-    malloc_data_p = MEM__info_get( address );
+    //  Get the 'sizeof' the addressed buffer from its header
+    size = MEM__header_check( address, "mem_sizeof" )->size;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( size );
+}
+
+/****************************************************************************/
+/**
+ *  Create a new memory arena.  Everything allocated from an arena is
+ *  released at once by mem_arena_reset() or mem_arena_free().
+ *
+ *  @param  chunk_l             Size of the arena's memory chunks or zero
+ *                              for the default (64K).
+ *
+ *  @return arena_p             Pointer to the new arena.
+ *
+ ****************************************************************************/
+
+struct  mem_arena_t *
+mem_arena_new(
+    int                             chunk_l
+    )
+{
+    /**
+     *  @param  arena_p         Pointer to the new arena                    */
+    struct  mem_arena_t         *   arena_p;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Allocate the arena control structure
+    arena_p = (struct mem_arena_t*)mem_malloc( sizeof( struct mem_arena_t ) );
+
+    //  Set the chunk size
+    if ( chunk_l > 0 )
+    {
+        arena_p->chunk_l = ( ( chunk_l + MEM_ARENA_ALIGN - 1 )
+                             & ~( MEM_ARENA_ALIGN - 1 ) );
+    }
+    else
+    {
+        arena_p->chunk_l = MEM_ARENA_CHUNK_L;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( arena_p );
+}
+
+/****************************************************************************/
+/**
+ *  Allocate and initialize a buffer from an arena.
+ *
+ *  @param  arena_p             Pointer to an arena or NULL.
+ *  @param  size                The amount of memory (in bytes) requested.
+ *
+ *  @return memory_p            Pointer to the allocated memory.
+ *
+ *  @note
+ *      When arena_p is NULL the buffer comes from mem_malloc() and must
+ *      be released with mem_free().  Arena buffers are never released
+ *      individually.
+ *
+ ****************************************************************************/
+
+void *
+mem_arena_alloc(
+    struct  mem_arena_t         *   arena_p,
+    int                             size
+    )
+{
+    /**
+     *  @param  memory_p        Pointer to the allocated memory             */
+    void                        *   memory_p;
+    /**
+     *  @param  chunk_p         Pointer to the chunk                        */
+    struct  mem_chunk_t         *   chunk_p;
+    /**
+     *  @param  size_l          Size rounded up to the arena alignment      */
+    size_t                          size_l;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is there an arena ?
+    if ( arena_p == NULL )
+    {
+        //  NO:     Use the heap
+        memory_p = mem_malloc( size );
+    }
+    else
+    {
+        //  YES:    Round the size up
+        size_l = ( ( (size_t)size + MEM_ARENA_ALIGN - 1 )
+                   & ~( (size_t)MEM_ARENA_ALIGN - 1 ) );
+
+        chunk_p = arena_p->chunk_p;
+
+        //  Does it fit in the current chunk ?
+        if (    ( chunk_p == NULL )
+             || ( ( chunk_p->size - chunk_p->used ) < size_l ) )
+        {
+            //  NO:     Get another chunk
+            chunk_p = MEM__arena_chunk( arena_p, size_l );
+
+            //  Is it a standard chunk or is there no current chunk ?
+            if (    ( arena_p->chunk_p == NULL )
+                 || ( chunk_p->size == arena_p->chunk_l ) )
+            {
+                //  YES:    It becomes the current chunk
+                chunk_p->next_p = arena_p->chunk_p;
+                arena_p->chunk_p = chunk_p;
+            }
+            else
+            {
+                //  NO:     Keep the current chunk in front, its free space
+                //          is still usable.
+                chunk_p->next_p = arena_p->chunk_p->next_p;
+                arena_p->chunk_p->next_p = chunk_p;
+            }
+        }
+
+        //  Carve the buffer out of the chunk
+        memory_p = &chunk_p->data[ chunk_p->used ];
+        chunk_p->used += size_l;
+
+        //  Initialize it
+        memset( memory_p, 0x00, size );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( memory_p );
+}
+
+/****************************************************************************/
+/**
+ *  Release everything allocated from an arena.  The arena can be used
+ *  again and keeps its standard chunks for reuse.
+ *
+ *  @param  arena_p             Pointer to the arena.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+mem_arena_reset(
+    struct  mem_arena_t         *   arena_p
+    )
+{
+    /**
+     *  @param  chunk_p         Pointer to a chunk                          */
+    struct  mem_chunk_t         *   chunk_p;
+    /**
+     *  @param  next_p          Pointer to the next chunk                   */
+    struct  mem_chunk_t         *   next_p;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Look at every chunk in use
+    for ( chunk_p = arena_p->chunk_p;
+          chunk_p != NULL;
+          chunk_p = next_p )
+    {
+        next_p = chunk_p->next_p;
+
+        //  Is this a standard chunk ?
+        if ( chunk_p->size == arena_p->chunk_l )
+        {
+            //  YES:    Keep it for reuse
+            chunk_p->next_p = arena_p->spare_p;
+            arena_p->spare_p = chunk_p;
+        }
+        else
+        {
+            //  NO:     Release it
+            free( chunk_p );
+        }
+    }
+
+    //  Nothing is in use
+    arena_p->chunk_p = NULL;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Release an arena and everything allocated from it.
+ *
+ *  @param  arena_p             Pointer to the arena.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+mem_arena_free(
+    struct  mem_arena_t         *   arena_p
+    )
+{
+    /**
+     *  @param  chunk_p         Pointer to a chunk                          */
+    struct  mem_chunk_t         *   chunk_p;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Move everything to the spare list
+    mem_arena_reset( arena_p );
+
+    //  Release the spare chunks
+    while ( arena_p->spare_p != NULL )
+    {
+        chunk_p = arena_p->spare_p;
+        arena_p->spare_p = chunk_p->next_p;
+        free( chunk_p );
+    }
+
+    //  Release the arena
+    mem_free( arena_p );
 
     /************************************************************************
      *  Function Exit
      ************************************************************************/
 
     //  DONE!
-    return( malloc_data_p->size );
 }
 
 /****************************************************************************/
@@ -321,12 +968,6 @@ mem_dump(
 {
     
 #if MEM_LEAK_DETECT
-    /**
-     *  @param  malloc_data_k   List Lock Key                               */
-    int                             malloc_data_k;
-    /**
-     *  @param  malloc_data_p   Pointer to the information structure        */
-    struct  malloc_data_t       *   malloc_data_p;
     /** @param  count           Number of buffers allocated                 */
     static int                      count;
 
@@ -343,48 +984,21 @@ mem_dump(
     if ( count == 0 )
     {
         //  YES:    Save the current stack size
-        count = list_query_count( malloc_info_p );
+        count = MEM__info_count( );
     }
 
     //  Has there been a change in the memory stack size ?
     else
-    if ( list_query_count( malloc_info_p ) > count )
+    if ( MEM__info_count( ) > count )
     {
         //  YES:    Then go ahead and dump the stack
-        count = list_query_count( malloc_info_p );
+        count = MEM__info_count( );
 
         log_write( MID_DEBUG_2, "mem_dump", "There are %d buffers allocated\n",
-                   list_query_count( malloc_info_p ) );
-
-        //  Lock the list for fast(er) access
-        malloc_data_k = list_user_lock( malloc_info_p );
-
-        //  Scan the list for the search address
-        for( malloc_data_p = list_fget_first( malloc_info_p, malloc_data_k );
-             malloc_data_p != NULL;
-             malloc_data_p = list_fget_next( malloc_info_p, malloc_data_p, malloc_data_k ) )
-        {
-            char * tmp_p;
-            //  Log this allocated buffer
-            log_write( MID_DEBUG_2, "mem_dump", "[%p] - %4X\n",
-                       malloc_data_p->address, malloc_data_p->size );
-
-            tmp_p = (char*)malloc_data_p->address;
-
-            //  Is this a text buffer ?
-            if (    ( malloc_data_p->size > 4 )
-                 && ( isprint( tmp_p[ 0 ] ) != 0 )
-                 && ( isprint( tmp_p[ 1 ] ) != 0 )
-                 && ( isprint( tmp_p[ 2 ] ) != 0 )
-                 && ( isprint( tmp_p[ 3 ] ) != 0 ) )
-            {
-                //  Log the data
-                log_write( MID_DEBUG_2, "mem_dump", "\t\t'%s'\n", tmp_p );
-            }
-        }
+                   count );
 
-        //  UnLock the list
-        list_user_unlock( malloc_info_p, malloc_data_k );
+        //  Log every allocated buffer
+        MEM__info_dump( );
 
         //  Stop
         log_write( MID_FATAL, "mem_dump",
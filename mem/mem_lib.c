@@ -28,6 +28,9 @@
 #include <stdio.h>              //  Standard I/O definitions
                                 //*******************************************
 #include <stdlib.h>             //  ANSI standard library.
+#include <string.h>             //  Functions for managing strings
+#include <ctype.h>              //  Determine the type contained
+#include <pthread.h>            //  Shard locks
                                 //*******************************************
 
 /****************************************************************************
@@ -67,6 +70,19 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+/**
+ *  One time initialization of the slab depot                               */
+pthread_once_t                      mem_slab_once = PTHREAD_ONCE_INIT;
+/**
+ *  Key used to flush a thread cache back to the depot at thread exit       */
+pthread_key_t                       mem_slab_key;
+/**
+ *  The central depot, one per size class                                   */
+struct  mem_depot_t                 mem_depot[ MEM_CLASS_COUNT ];
+/**
+ *  The thread cache                                                        */
+__thread
+struct  mem_cache_t                 mem_cache;
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -75,74 +91,274 @@
 
 /****************************************************************************/
 /**
- *  Lookup and return the size of a memory buffer previously allocated using
- *  list_malloc( size );
+ *  Hash an address for the allocation tracker.  The low MEM_SHARD_BITS of
+ *  the result select the shard, the remaining bits select the slot.
  *
- *  @param  address             Pointer to the previously allocated memory.
+ *  @param  address             Address of an allocated buffer.
+ *
+ *  @return hash                Well mixed 64 bit hash of the address.
+ *
+ ****************************************************************************/
+
+uint64_t
+MEM__info_hash(
+    void                        *   address
+    )
+{
+    /**
+     *  @param  hash            The hash value being built                  */
+    uint64_t                        hash;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Heap addresses are aligned, so mix every bit into every other bit.
+    hash  = (uint64_t)(uintptr_t)address;
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( hash );
+}
+
+/****************************************************************************/
+/**
+ *  Double the size of a shard table and rehash everything in it.
  *
- *  @return size                The size (in bytes) of the addressed buffer.
+ *  @param  shard_p             Pointer to a locked shard.
+ *
+ *  @return void
  *
  *  @note
+ *      The tracker uses malloc() directly so it never tracks itself.
  *
  ****************************************************************************/
 
-struct  malloc_data_t   *
-MEM__info_get(
-    void                        *   address
+void
+MEM__info_grow(
+    struct  mem_shard_t         *   shard_p
     )
 {
     /**
-     *  @param  malloc_data_k   List Lock Key                               */
-    int                             malloc_data_k;
+     *  @param  old_slot_p      The table being replaced                    */
+    struct  malloc_data_t       *   old_slot_p;
     /**
-     *  @param  malloc_data_p   Pointer to the information structure        */
-    struct  malloc_data_t       *   malloc_data_p;
+     *  @param  old_capacity    Number of slots in the old table            */
+    size_t                          old_capacity;
+    /**
+     *  @param  old_ndx         Index into the old table                    */
+    size_t                          old_ndx;
+    /**
+     *  @param  slot_ndx        Index into the new table                    */
+    size_t                          slot_ndx;
+    /**
+     *  @param  mask            Slot index mask for the new table           */
+    size_t                          mask;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
-    //  Lock the list for fast(er) access
-    malloc_data_k = list_user_lock( malloc_info_p );
+    old_slot_p   = shard_p->slot_p;
+    old_capacity = shard_p->capacity;
+
+    //  Is this the first table for the shard ?
+    if ( old_capacity == 0 )
+    {
+        //  YES:    Start small
+        shard_p->capacity = MEM_SHARD_INITIAL_L;
+    }
+    else
+    {
+        //  NO:     Double it
+        shard_p->capacity = ( old_capacity * 2 );
+    }
+
+    //  Allocate the new table
+    shard_p->slot_p = (struct malloc_data_t*)calloc(
+            shard_p->capacity, sizeof( struct malloc_data_t ) );
+
+    //  Was the memory allocation successful ?
+    if ( shard_p->slot_p == NULL )
+    {
+        //  NO:     A very bad situation indeed.
+        log_write( MID_FATAL, "MEM__info_grow",
+                   "Unable to allocate memory for the allocation tracker!\n" );
+    }
 
     /************************************************************************
-     *  Function
+     *  Rehash
      ************************************************************************/
 
-    //  Scan the list for the search address
-    for( malloc_data_p = list_fget_first( malloc_info_p, malloc_data_k );
-         malloc_data_p != NULL;
-         malloc_data_p = list_fget_next( malloc_info_p, malloc_data_p, malloc_data_k ) )
+    mask = ( shard_p->capacity - 1 );
+
+    //  Move everything from the old table to the new one
+    for ( old_ndx = 0;
+          old_ndx < old_capacity;
+          old_ndx += 1 )
     {
-        //  Do the addresses match ?
-        if ( malloc_data_p->address == address )
+        //  Is this slot in use ?
+        if ( old_slot_p[ old_ndx ].address != NULL )
         {
-            //  YES:    This is it, stop looking
-            break;
+            //  YES:    Find a free slot for it in the new table
+            for ( slot_ndx = ( ( MEM__info_hash( old_slot_p[ old_ndx ].address )
+                                 >> MEM_SHARD_BITS ) & mask );
+                  shard_p->slot_p[ slot_ndx ].address != NULL;
+                  slot_ndx = ( ( slot_ndx + 1 ) & mask ) )
+            {
+                //  Keep looking
+            }
+
+            shard_p->slot_p[ slot_ndx ] = old_slot_p[ old_ndx ];
         }
     }
 
+    //  The old table is no longer needed
+    free( old_slot_p );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Initialize the allocation tracker.
+ *
+ *  @param  void
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+MEM__info_init(
+    void
+    )
+{
+    /**
+     *  @param  shard_ndx       Index into the shard array                  */
+    int                             shard_ndx;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Every shard starts out empty; tables are allocated on first use.
+    for ( shard_ndx = 0;
+          shard_ndx < MEM_SHARD_COUNT;
+          shard_ndx += 1 )
+    {
+        pthread_mutex_init( &mem_shard[ shard_ndx ].lock, NULL );
+        mem_shard[ shard_ndx ].capacity = 0;
+        mem_shard[ shard_ndx ].count    = 0;
+        mem_shard[ shard_ndx ].slot_p   = NULL;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Add a newly allocated buffer to the allocation tracker.
+ *
+ *  @param  address             Pointer to the allocated memory.
+ *  @param  size                The size (in bytes) of the buffer.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+MEM__info_put(
+    void                        *   address,
+    int                             size
+    )
+{
+    /**
+     *  @param  hash            Hash of the address                         */
+    uint64_t                        hash;
+    /**
+     *  @param  shard_p         Pointer to the shard for this address       */
+    struct  mem_shard_t         *   shard_p;
+    /**
+     *  @param  slot_ndx        Index into the shard table                  */
+    size_t                          slot_ndx;
+    /**
+     *  @param  mask            Slot index mask                             */
+    size_t                          mask;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    hash    = MEM__info_hash( address );
+    shard_p = &mem_shard[ hash & ( MEM_SHARD_COUNT - 1 ) ];
+
+    //  Lock the shard
+    pthread_mutex_lock( &shard_p->lock );
+
+    /************************************************************************
+     *  Add the buffer
+     ************************************************************************/
+
+    //  Will the table be more than 3/4 full ?
+    if ( ( ( shard_p->count + 1 ) * 4 ) > ( shard_p->capacity * 3 ) )
+    {
+        //  YES:    Make it bigger
+        MEM__info_grow( shard_p );
+    }
+
+    mask = ( shard_p->capacity - 1 );
+
+    //  Find a free slot
+    for ( slot_ndx = ( ( hash >> MEM_SHARD_BITS ) & mask );
+          shard_p->slot_p[ slot_ndx ].address != NULL;
+          slot_ndx = ( ( slot_ndx + 1 ) & mask ) )
+    {
+        //  Keep looking
+    }
+
+    //  Save the address and size
+    shard_p->slot_p[ slot_ndx ].address = address;
+    shard_p->slot_p[ slot_ndx ].size    = size;
+    shard_p->count += 1;
+
     /************************************************************************
      *  Function Exit
      ************************************************************************/
 
-    //  UnLock the list
-    list_user_unlock( malloc_info_p, malloc_data_k );
+    //  UnLock the shard
+    pthread_mutex_unlock( &shard_p->lock );
 
     //  DONE!
-    return( malloc_data_p );
 }
 
 /****************************************************************************/
 /**
- *  Lookup and return the size of a memory buffer previously allocated using
- *  list_malloc( size );
+ *  Remove a buffer from the allocation tracker.
  *
  *  @param  address             Pointer to the previously allocated memory.
  *
- *  @return size                The size (in bytes) of the addressed buffer.
+ *  @return void
  *
  *  @note
+ *      Entries that follow the removed one in its probe run are shifted
+ *      back so no tombstones are needed.
  *
  ****************************************************************************/
 
@@ -152,50 +368,976 @@ MEM__info_remove(
     )
 {
     /**
-     *  @param  malloc_data_k   List Lock Key                               */
-    int                             malloc_data_k;
+     *  @param  hash            Hash of the address                         */
+    uint64_t                        hash;
     /**
-     *  @param  malloc_data_p   Pointer to the information structure        */
-    struct  malloc_data_t       *   malloc_data_p;
+     *  @param  shard_p         Pointer to the shard for this address       */
+    struct  mem_shard_t         *   shard_p;
+    /**
+     *  @param  slot_ndx        Index into the shard table                  */
+    size_t                          slot_ndx;
+    /**
+     *  @param  next_ndx        Index of the slot being examined for a shift*/
+    size_t                          next_ndx;
+    /**
+     *  @param  home_ndx        Preferred slot of the entry at next_ndx     */
+    size_t                          home_ndx;
+    /**
+     *  @param  mask            Slot index mask                             */
+    size_t                          mask;
+    /**
+     *  @param  found           Flag showing the address was found          */
+    int                             found;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
-    //  Lock the list for fast(er) access
-    malloc_data_k = list_user_lock( malloc_info_p );
+    found   = false;
+    slot_ndx = 0;
+    hash    = MEM__info_hash( address );
+    shard_p = &mem_shard[ hash & ( MEM_SHARD_COUNT - 1 ) ];
+
+    //  Lock the shard
+    pthread_mutex_lock( &shard_p->lock );
+
+    mask = ( shard_p->capacity - 1 );
+
+    /************************************************************************
+     *  Find the address
+     ************************************************************************/
+
+    //  Does the shard have a table ?
+    if ( shard_p->capacity != 0 )
+    {
+        //  YES:    Probe for the search address
+        for ( slot_ndx = ( ( hash >> MEM_SHARD_BITS ) & mask );
+              shard_p->slot_p[ slot_ndx ].address != NULL;
+              slot_ndx = ( ( slot_ndx + 1 ) & mask ) )
+        {
+            //  Do the addresses match ?
+            if ( shard_p->slot_p[ slot_ndx ].address == address )
+            {
+                //  YES:    This is it, stop looking
+                found = true;
+                break;
+            }
+        }
+    }
+
+    /************************************************************************
+     *  Remove it
+     ************************************************************************/
+
+    //  Was the address found ?
+    if ( found == true )
+    {
+        //  YES:    Empty the slot
+        shard_p->slot_p[ slot_ndx ].address = NULL;
+        shard_p->count -= 1;
+
+        //  Shift back anything in the probe run that can move closer
+        //  to its preferred slot.
+        for ( next_ndx = ( ( slot_ndx + 1 ) & mask );
+              shard_p->slot_p[ next_ndx ].address != NULL;
+              next_ndx = ( ( next_ndx + 1 ) & mask ) )
+        {
+            home_ndx = ( ( MEM__info_hash( shard_p->slot_p[ next_ndx ].address )
+                           >> MEM_SHARD_BITS ) & mask );
+
+            //  Does the empty slot lie between the preferred slot and
+            //  where the entry is now (cyclically) ?
+            if ( ( ( next_ndx - home_ndx ) & mask )
+                 >= ( ( next_ndx - slot_ndx ) & mask ) )
+            {
+                //  YES:    Move it into the empty slot
+                shard_p->slot_p[ slot_ndx ] = shard_p->slot_p[ next_ndx ];
+                shard_p->slot_p[ next_ndx ].address = NULL;
+                slot_ndx = next_ndx;
+            }
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  UnLock the shard
+    pthread_mutex_unlock( &shard_p->lock );
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Count the number of buffers currently being tracked.
+ *
+ *  @param  void
+ *
+ *  @return count               Number of allocated buffers.
+ *
+ ****************************************************************************/
+
+int
+MEM__info_count(
+    void
+    )
+{
+    /**
+     *  @param  shard_ndx       Index into the shard array                  */
+    int                             shard_ndx;
+    /**
+     *  @param  count           Number of allocated buffers                 */
+    int                             count;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    count = 0;
+
+    //  Add up the shards
+    for ( shard_ndx = 0;
+          shard_ndx < MEM_SHARD_COUNT;
+          shard_ndx += 1 )
+    {
+        pthread_mutex_lock( &mem_shard[ shard_ndx ].lock );
+        count += (int)mem_shard[ shard_ndx ].count;
+        pthread_mutex_unlock( &mem_shard[ shard_ndx ].lock );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( count );
+}
+
+/****************************************************************************/
+/**
+ *  Log every buffer currently being tracked.
+ *
+ *  @param  void
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+MEM__info_dump(
+    void
+    )
+{
+    /**
+     *  @param  shard_ndx       Index into the shard array                  */
+    int                             shard_ndx;
+    /**
+     *  @param  slot_ndx        Index into the shard table                  */
+    size_t                          slot_ndx;
+    /**
+     *  @param  malloc_data_p   Pointer to the information structure        */
+    struct  malloc_data_t       *   malloc_data_p;
+    /**
+     *  @param  tmp_p           Pointer to the buffer contents              */
+    char                        *   tmp_p;
+    /**
+     *  @param  tag_p           Call-site tag of the buffer                 */
+    const char                  *   tag_p;
 
     /************************************************************************
      *  Function
      ************************************************************************/
 
-    //  Scan the list for the search address
-    for( malloc_data_p = list_fget_first( malloc_info_p, malloc_data_k );
-         malloc_data_p != NULL;
-         malloc_data_p = list_fget_next( malloc_info_p, malloc_data_p, malloc_data_k ) )
+    //  Scan every shard
+    for ( shard_ndx = 0;
+          shard_ndx < MEM_SHARD_COUNT;
+          shard_ndx += 1 )
     {
-        //  Do the addresses match ?
-        if ( malloc_data_p->address == address )
+        //  Lock the shard
+        pthread_mutex_lock( &mem_shard[ shard_ndx ].lock );
+
+        //  Scan the table
+        for ( slot_ndx = 0;
+              slot_ndx < mem_shard[ shard_ndx ].capacity;
+              slot_ndx += 1 )
         {
-            //  Remove it from the information list
-            list_fdelete( malloc_info_p, malloc_data_p, malloc_data_k );
+            malloc_data_p = &mem_shard[ shard_ndx ].slot_p[ slot_ndx ];
+
+            //  Is this slot in use ?
+            if ( malloc_data_p->address != NULL )
+            {
+                //  YES:    Where was it allocated from ?
+                tag_p = MEM_HEADER( malloc_data_p->address )->tag_p;
+
+                if ( tag_p == NULL )
+                {
+                    tag_p = "";
+                }
+
+                //  Log this allocated buffer
+                log_write( MID_DEBUG_2, "mem_dump", "[%p] - %4X %s\n",
+                           malloc_data_p->address, malloc_data_p->size,
+                           tag_p );
+
+                tmp_p = (char*)malloc_data_p->address;
+
+                //  Is this a text buffer ?
+                if (    ( malloc_data_p->size > 4 )
+                     && ( isprint( tmp_p[ 0 ] ) != 0 )
+                     && ( isprint( tmp_p[ 1 ] ) != 0 )
+                     && ( isprint( tmp_p[ 2 ] ) != 0 )
+                     && ( isprint( tmp_p[ 3 ] ) != 0 ) )
+                {
+                    //  Log the data
+                    log_write( MID_DEBUG_2, "mem_dump", "\t\t'%s'\n", tmp_p );
+                }
+            }
+        }
+
+        //  UnLock the shard
+        pthread_mutex_unlock( &mem_shard[ shard_ndx ].lock );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Verify the header and canary of a buffer returned by mem_malloc().
+ *  Double frees, foreign pointers and buffer overruns are fatal.
+ *
+ *  @param  memory_p            Pointer to the previously allocated memory.
+ *  @param  function_name       Name of the calling function (for the log).
+ *
+ *  @return header_p            Pointer to the header of the buffer.
+ *
+ ****************************************************************************/
+
+struct  mem_header_t    *
+MEM__header_check(
+    void                        *   memory_p,
+    const char                  *   function_name
+    )
+{
+    /**
+     *  @param  header_p        Pointer to the buffer header                */
+    struct  mem_header_t        *   header_p;
+    /**
+     *  @param  canary          Copy of the trailing canary                 */
+    uint32_t                        canary;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
 
-            //  Release it's storage
-            free( malloc_data_p );
+    header_p = MEM_HEADER( memory_p );
+
+    /************************************************************************
+     *  Check the header
+     ************************************************************************/
 
-            //  This is it, stop looking
-            break;
+    //  Is this a live buffer ?
+    if ( header_p->magic != MEM_MAGIC_LIVE )
+    {
+        //  NO:     Has it already been released ?
+        if ( header_p->magic == MEM_MAGIC_FREE )
+        {
+            //  YES:    Double free
+            log_write( MID_FATAL, function_name,
+                       "[ %p ] has already been released.\n", memory_p );
+        }
+        else
+        {
+            //  NO:     Not ours or the header was overwritten
+            log_write( MID_FATAL, function_name,
+                       "[ %p ] was not allocated by mem_malloc() or its "
+                       "header is damaged.\n", memory_p );
         }
     }
 
+    /************************************************************************
+     *  Check the canary
+     ************************************************************************/
+
+    //  The canary isn't aligned, copy it out.
+    memcpy( &canary, ( (char*)memory_p + header_p->size ), MEM_CANARY_L );
+
+    //  Was the end of the buffer overwritten ?
+    if ( canary != MEM_CANARY )
+    {
+        //  YES:    Buffer overrun
+        log_write( MID_FATAL, function_name,
+                   "[ %p ] %04X - buffer overrun detected %s\n",
+                   memory_p, header_p->size,
+                   ( header_p->tag_p != NULL ) ? header_p->tag_p : "" );
+    }
+
     /************************************************************************
      *  Function Exit
      ************************************************************************/
 
-    //  UnLock the list
-    list_user_unlock( malloc_info_p, malloc_data_k );
+    //  DONE!
+    return( header_p );
+}
+
+/****************************************************************************/
+/**
+ *  Find the slab size class for a block.
+ *
+ *  @param  block_l             Block size (header and canary included).
+ *
+ *  @return class_ndx           Size class, or -1 if the block is too big
+ *                              for a slab.
+ *
+ *  @note
+ *      Classes alternate between 2^k and 1.5 * 2^k starting at 64 bytes.
+ *
+ ****************************************************************************/
+
+int
+MEM__class_index(
+    size_t                          block_l
+    )
+{
+    /**
+     *  @param  class_ndx       The size class                              */
+    int                             class_ndx;
+    /**
+     *  @param  bit_ndx         2^bit_ndx < block_l <= 2^(bit_ndx+1)        */
+    int                             bit_ndx;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is this too big for a slab ?
+    if ( block_l > MEM_CLASS_MAX_L )
+    {
+        //  YES:    malloc() it
+        class_ndx = -1;
+    }
+    //  Does it fit in the smallest class ?
+    else if ( block_l <= 64 )
+    {
+        //  YES:    Class 0
+        class_ndx = 0;
+    }
+    else
+    {
+        //  NO:     Is it in the 1.5 * 2^k or the 2^(k+1) class ?
+        bit_ndx = ( 63 - __builtin_clzll(
+                                (unsigned long long)( block_l - 1 ) ) );
+
+        if ( block_l <= ( (size_t)3 << ( bit_ndx - 1 ) ) )
+        {
+            class_ndx = ( ( ( bit_ndx - 6 ) * 2 ) + 1 );
+        }
+        else
+        {
+            class_ndx = ( ( ( bit_ndx - 6 ) * 2 ) + 2 );
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( class_ndx );
+}
+
+/****************************************************************************/
+/**
+ *  Get the block size of a slab size class.
+ *
+ *  @param  class_ndx           Size class
+ *
+ *  @return block_l             Size of every block in the class.
+ *
+ ****************************************************************************/
+
+size_t
+MEM__class_size(
+    int                             class_ndx
+    )
+{
+    /**
+     *  @param  block_l         Size of a block in the class                */
+    size_t                          block_l;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is it the first class ?
+    if ( class_ndx == 0 )
+    {
+        block_l = 64;
+    }
+    //  Is it a 1.5 * 2^k class ?
+    else if ( ( class_ndx & 1 ) != 0 )
+    {
+        block_l = ( (size_t)3 << ( ( ( class_ndx - 1 ) / 2 ) + 5 ) );
+    }
+    else
+    {
+        block_l = ( (size_t)1 << ( ( class_ndx / 2 ) + 6 ) );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( block_l );
+}
+
+/****************************************************************************/
+/**
+ *  One time initialization of the slab depot.
+ *
+ *  @param  void
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+MEM__slab_init(
+    void
+    )
+{
+    /**
+     *  @param  class_ndx       Index into the depot                        */
+    int                             class_ndx;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Every depot starts out empty
+    for ( class_ndx = 0;
+          class_ndx < MEM_CLASS_COUNT;
+          class_ndx += 1 )
+    {
+        pthread_mutex_init( &mem_depot[ class_ndx ].lock, NULL );
+        mem_depot[ class_ndx ].batch_p = NULL;
+    }
+
+    //  Thread caches are handed back to the depot when a thread exits.
+    pthread_key_create( &mem_slab_key, MEM__slab_thread_exit );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Thread exit handler.  Everything in the exiting thread's cache goes
+ *  back to the depot.
+ *
+ *  @param  void_p              Pointer to the thread cache.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+MEM__slab_thread_exit(
+    void                        *   void_p
+    )
+{
+    /**
+     *  @param  cache_p         Pointer to the thread cache                 */
+    struct  mem_cache_t         *   cache_p;
+    /**
+     *  @param  class_ndx       Size class                                  */
+    int                             class_ndx;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    cache_p = (struct mem_cache_t*)void_p;
+
+    //  Hand back every class
+    for ( class_ndx = 0;
+          class_ndx < MEM_CLASS_COUNT;
+          class_ndx += 1 )
+    {
+        //  Is there anything cached for this class ?
+        if ( cache_p->free_p[ class_ndx ] != NULL )
+        {
+            //  YES:    Give it to the depot
+            MEM__slab_release( class_ndx, cache_p->free_p[ class_ndx ] );
+            cache_p->free_p[ class_ndx ] = NULL;
+            cache_p->count[ class_ndx ] = 0;
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Make sure this thread's cache is handed back to the depot when the
+ *  thread exits.
+ *
+ *  @param  void
+ *
+ *  @return void
+ *
+ *  @note
+ *      Called by both MEM__slab_refill() and MEM__slab_free(); a thread
+ *      that only frees blocks allocated by another one still builds up a
+ *      cache.
+ *
+ ****************************************************************************/
+
+void
+MEM__slab_register(
+    void
+    )
+{
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is the cache already registered ?
+    if ( mem_cache.registered == false )
+    {
+        //  NO:     The key is created by MEM__slab_init()
+        pthread_once( &mem_slab_once, MEM__slab_init );
+        pthread_setspecific( mem_slab_key, &mem_cache );
+        mem_cache.registered = true;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Refill an empty thread cache class with a batch from the depot, or
+ *  with a newly carved slab when the depot is empty.
+ *
+ *  @param  class_ndx           Size class to refill.
+ *
+ *  @return void
+ *
+ *  @note
+ *      When no memory is available the class is left empty.
+ *
+ ****************************************************************************/
+
+void
+MEM__slab_refill(
+    int                             class_ndx
+    )
+{
+    /**
+     *  @param  depot_p         Pointer to the depot for the class          */
+    struct  mem_depot_t         *   depot_p;
+    /**
+     *  @param  chain_p         The batch being moved to the cache          */
+    struct  mem_header_t        *   chain_p;
+    /**
+     *  @param  block_p         A block in the batch                        */
+    struct  mem_header_t        *   block_p;
+    /**
+     *  @param  slab_p          A newly allocated slab                      */
+    char                        *   slab_p;
+    /**
+     *  @param  block_l         Size of a block in this class               */
+    size_t                          block_l;
+    /**
+     *  @param  count           Number of blocks in the batch               */
+    int                             count;
+    /**
+     *  @param  block_ndx       Index of a block in a new slab              */
+    int                             block_ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    depot_p = &mem_depot[ class_ndx ];
+    block_l = MEM__class_size( class_ndx );
+    count = 0;
+
+    //  Make sure this thread's cache is flushed when the thread exits.
+    MEM__slab_register( );
+
+    /************************************************************************
+     *  Take a batch from the depot
+     ************************************************************************/
+
+    pthread_mutex_lock( &depot_p->lock );
+
+    chain_p = depot_p->batch_p;
+
+    //  Is there a batch in the depot ?
+    if ( chain_p != NULL )
+    {
+        //  YES:    Take it
+        depot_p->batch_p = (struct mem_header_t*)chain_p->link_p[ 1 ];
+    }
+
+    pthread_mutex_unlock( &depot_p->lock );
+
+    /************************************************************************
+     *  Carve a new slab
+     ************************************************************************/
+
+    //  Did the depot have anything ?
+    if ( chain_p == NULL )
+    {
+        //  NO:     Allocate a slab for a full batch
+        slab_p = (char*)malloc( block_l * MEM_BATCH_L );
+
+        //  Was the allocation successful ?
+        if ( slab_p != NULL )
+        {
+            //  YES:    Link the blocks together
+            for ( block_ndx = 0;
+                  block_ndx < MEM_BATCH_L;
+                  block_ndx += 1 )
+            {
+                block_p = (struct mem_header_t*)( slab_p
+                                                  + ( block_l * block_ndx ) );
+
+                if ( block_ndx < ( MEM_BATCH_L - 1 ) )
+                {
+                    block_p->link_p[ 0 ] = ( slab_p
+                                             + ( block_l * ( block_ndx + 1 ) ) );
+                }
+                else
+                {
+                    block_p->link_p[ 0 ] = NULL;
+                }
+                block_p->magic = MEM_MAGIC_FREE;
+            }
+            chain_p = (struct mem_header_t*)slab_p;
+        }
+    }
+
+    /************************************************************************
+     *  Move the batch into the cache
+     ************************************************************************/
+
+    //  Count the blocks in the batch
+    for ( block_p = chain_p;
+          block_p != NULL;
+          block_p = (struct mem_header_t*)block_p->link_p[ 0 ] )
+    {
+        count += 1;
+    }
+
+    mem_cache.free_p[ class_ndx ] = chain_p;
+    mem_cache.count[ class_ndx ] = count;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Give a chain of free blocks to the depot.
+ *
+ *  @param  class_ndx           Size class of the blocks.
+ *  @param  chain_p             First block of a NULL terminated chain.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+MEM__slab_release(
+    int                             class_ndx,
+    struct  mem_header_t        *   chain_p
+    )
+{
+    /**
+     *  @param  depot_p         Pointer to the depot for the class          */
+    struct  mem_depot_t         *   depot_p;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    depot_p = &mem_depot[ class_ndx ];
+
+    pthread_mutex_lock( &depot_p->lock );
+
+    //  The chain becomes the first batch in the depot
+    chain_p->link_p[ 1 ] = depot_p->batch_p;
+    depot_p->batch_p = chain_p;
+
+    pthread_mutex_unlock( &depot_p->lock );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Allocate a block from the thread cache.
+ *
+ *  @param  block_l             Block size (header and canary included).
+ *
+ *  @return header_p            Pointer to the block or NULL when no memory
+ *                              is available.
+ *
+ ****************************************************************************/
+
+struct  mem_header_t    *
+MEM__slab_alloc(
+    size_t                          block_l
+    )
+{
+    /**
+     *  @param  header_p        Pointer to the block                        */
+    struct  mem_header_t        *   header_p;
+    /**
+     *  @param  class_ndx       Size class of the block                     */
+    int                             class_ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    class_ndx = MEM__class_index( block_l );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is this a slab block ?
+    if ( class_ndx < 0 )
+    {
+        //  NO:     Too big, use malloc
+        header_p = (struct mem_header_t*)malloc( block_l );
+    }
+    else
+    {
+        //  YES:    Is the cache for this class empty ?
+        if ( mem_cache.free_p[ class_ndx ] == NULL )
+        {
+            //  YES:    Fill it up
+            pthread_once( &mem_slab_once, MEM__slab_init );
+            MEM__slab_refill( class_ndx );
+        }
+
+        //  Take the first block off the free list
+        header_p = mem_cache.free_p[ class_ndx ];
+
+        if ( header_p != NULL )
+        {
+            mem_cache.free_p[ class_ndx ] =
+                    (struct mem_header_t*)header_p->link_p[ 0 ];
+            mem_cache.count[ class_ndx ] -= 1;
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( header_p );
+}
+
+/****************************************************************************/
+/**
+ *  Return a block to the thread cache.
+ *
+ *  @param  header_p            Pointer to the block.
+ *  @param  block_l             Block size (header and canary included).
+ *
+ *  @return void
+ *
+ *  @note
+ *      Blocks may be freed by a different thread than the one that
+ *      allocated them; they simply join the freeing thread's cache.
+ *
+ ****************************************************************************/
+
+void
+MEM__slab_free(
+    struct  mem_header_t        *   header_p,
+    size_t                          block_l
+    )
+{
+    /**
+     *  @param  class_ndx       Size class of the block                     */
+    int                             class_ndx;
+    /**
+     *  @param  block_p         Last block of the batch being given back    */
+    struct  mem_header_t        *   block_p;
+    /**
+     *  @param  block_ndx       Index into the batch                        */
+    int                             block_ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    class_ndx = MEM__class_index( block_l );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is this a slab block ?
+    if ( class_ndx < 0 )
+    {
+        //  NO:     It came from malloc
+        free( header_p );
+    }
+    else
+    {
+        //  YES:    Make sure the cache is flushed when the thread exits
+        MEM__slab_register( );
+
+        //  Put it at the front of the free list
+        header_p->link_p[ 0 ] = mem_cache.free_p[ class_ndx ];
+        mem_cache.free_p[ class_ndx ] = header_p;
+        mem_cache.count[ class_ndx ] += 1;
+
+        //  Is the cache holding too much for this class ?
+        if ( mem_cache.count[ class_ndx ] >= MEM_CACHE_MAX )
+        {
+            //  YES:    Split off a batch and give it to the depot
+            block_p = header_p;
+
+            for ( block_ndx = 1;
+                  block_ndx < MEM_BATCH_L;
+                  block_ndx += 1 )
+            {
+                block_p = (struct mem_header_t*)block_p->link_p[ 0 ];
+            }
+
+            mem_cache.free_p[ class_ndx ] =
+                    (struct mem_header_t*)block_p->link_p[ 0 ];
+            mem_cache.count[ class_ndx ] -= MEM_BATCH_L;
+            block_p->link_p[ 0 ] = NULL;
+
+            pthread_once( &mem_slab_once, MEM__slab_init );
+            MEM__slab_release( class_ndx, header_p );
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Get a chunk that can hold at least size bytes.  A standard chunk comes
+ *  from the spare list when possible.  Larger requests get a chunk of
+ *  their own.
+ *
+ *  @param  arena_p             Pointer to the arena
+ *  @param  size                Number of bytes needed.
+ *
+ *  @return chunk_p             Pointer to an empty chunk.
+ *
+ ****************************************************************************/
+
+struct  mem_chunk_t     *
+MEM__arena_chunk(
+    struct  mem_arena_t         *   arena_p,
+    size_t                          size
+    )
+{
+    /**
+     *  @param  chunk_p         Pointer to the new chunk                    */
+    struct  mem_chunk_t         *   chunk_p;
+    /**
+     *  @param  chunk_l         Number of usable bytes in the chunk         */
+    size_t                          chunk_l;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    chunk_p = NULL;
+
+    //  Will a standard chunk do ?
+    if ( size <= arena_p->chunk_l )
+    {
+        //  YES:    Use a spare one if there is one
+        chunk_l = arena_p->chunk_l;
+        chunk_p = arena_p->spare_p;
+
+        if ( chunk_p != NULL )
+        {
+            arena_p->spare_p = chunk_p->next_p;
+        }
+    }
+    else
+    {
+        //  NO:     This one gets a chunk of its own
+        chunk_l = size;
+    }
+
+    /************************************************************************
+     *  Allocate a new chunk
+     ************************************************************************/
+
+    //  Do we need a new chunk ?
+    if ( chunk_p == NULL )
+    {
+        //  YES:    Allocate it
+        chunk_p = (struct mem_chunk_t*)malloc( sizeof( struct mem_chunk_t )
+                                               + chunk_l );
+
+        //  Was the memory allocation successful ?
+        if ( chunk_p == NULL )
+        {
+            //  NO:     A very bad situation indeed.
+            log_write( MID_FATAL, "mem_arena_alloc",
+                       "Unable to allocate memory!\n" );
+        }
+
+        chunk_p->size = chunk_l;
+    }
+
+    //  The chunk is empty
+    chunk_p->next_p = NULL;
+    chunk_p->used = 0;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
 
     //  DONE!
+    return( chunk_p );
 }
 
 /****************************************************************************/
@@ -45,6 +45,45 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+/**
+ *  The allocation tracker is split into 2^MEM_SHARD_BITS shards, each with
+ *  its own lock and open-addressing hash table keyed by address.          */
+#define MEM_SHARD_BITS          ( 6 )
+#define MEM_SHARD_COUNT         ( 1 << MEM_SHARD_BITS )
+/**
+ *  Initial number of slots in a shard table (must be a power of two)      */
+#define MEM_SHARD_INITIAL_L     ( 256 )
+//----------------------------------------------------------------------------
+/**
+ *  Header magic for a live buffer ("MEML") and a freed buffer ("MEMF")     */
+#define MEM_MAGIC_LIVE          ( 0x4D454D4CU )
+#define MEM_MAGIC_FREE          ( 0x4D454D46U )
+/**
+ *  Canary written immediately after the last byte of every buffer         */
+#define MEM_CANARY              ( 0xFDFDFDFDU )
+#define MEM_CANARY_L            ( sizeof( uint32_t ) )
+/**
+ *  Locate the header of a buffer returned by mem_malloc()                  */
+#define MEM_HEADER( memory_p )  ( ( (struct mem_header_t*)(memory_p) ) - 1 )
+//----------------------------------------------------------------------------
+/**
+ *  Slab size classes run 64, 96, 128, 192 ... 3072, 4096 bytes (header
+ *  and canary included).  Larger blocks come straight from malloc().     */
+#define MEM_CLASS_COUNT         ( 13 )
+#define MEM_CLASS_MAX_L         ( 4096 )
+/**
+ *  Number of blocks moved between a thread cache and the depot at once   */
+#define MEM_BATCH_L             ( 32 )
+/**
+ *  A thread cache holding this many blocks of a class gives a batch back */
+#define MEM_CACHE_MAX           ( MEM_BATCH_L * 2 )
+//----------------------------------------------------------------------------
+/**
+ *  Default size of an arena chunk                                         */
+#define MEM_ARENA_CHUNK_L       ( 64 * 1024 )
+/**
+ *  Alignment of every arena allocation                                    */
+#define MEM_ARENA_ALIGN         ( 16 )
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -65,6 +104,100 @@ struct  malloc_data_t
     int                             size;
 };
 //----------------------------------------------------------------------------
+/**
+ *  Every buffer returned by mem_malloc() is preceded by this header.  It
+ *  is 32 bytes so the caller's data keeps malloc()'s alignment.           */
+struct  mem_header_t
+{
+    /**
+     *  Left for the allocator.  free() writes its free-list links here, so
+     *  they don't land on magic and a double free can be recognized.      */
+    void                        *   link_p[ 2 ];
+    /**
+     *  Optional call-site tag supplied to mem_malloc_tag()                 */
+    const char                  *   tag_p;
+    /**
+     *  Number of bytes requested by the caller                             */
+    int32_t                         size;
+    /**
+     *  MEM_MAGIC_LIVE or MEM_MAGIC_FREE                                    */
+    uint32_t                        magic;
+};
+//----------------------------------------------------------------------------
+struct  mem_cache_t
+{
+    /**
+     *  Per class list of free blocks (linked through link_p[ 0 ])         */
+    struct  mem_header_t        *   free_p[ MEM_CLASS_COUNT ];
+    /**
+     *  Number of blocks on each free list                                  */
+    int                             count[ MEM_CLASS_COUNT ];
+    /**
+     *  true once the thread exit handler knows about this cache            */
+    int                             registered;
+};
+//----------------------------------------------------------------------------
+struct  mem_depot_t
+{
+    /**
+     *  Lock for the batch list                                             */
+    pthread_mutex_t                 lock;
+    /**
+     *  List of batches (linked through link_p[ 1 ] of the first block)    */
+    struct  mem_header_t        *   batch_p;
+};
+//----------------------------------------------------------------------------
+/**
+ *  A chunk of arena memory.  The header is 32 bytes so data[] keeps
+ *  MEM_ARENA_ALIGN alignment.                                             */
+struct  mem_chunk_t
+{
+    /**
+     *  Next chunk in the arena (or on its spare list)                      */
+    struct  mem_chunk_t         *   next_p;
+    /**
+     *  Number of usable bytes in data[]                                    */
+    size_t                          size;
+    /**
+     *  Number of bytes of data[] handed out                                */
+    size_t                          used;
+    /**
+     *  Unused, keeps the header size a multiple of MEM_ARENA_ALIGN         */
+    size_t                          reserved;
+    /**
+     *  The memory handed out by mem_arena_alloc()                          */
+    char                            data[ ];
+};
+//----------------------------------------------------------------------------
+struct  mem_arena_t
+{
+    /**
+     *  Chunks in use, the current chunk first                              */
+    struct  mem_chunk_t         *   chunk_p;
+    /**
+     *  Standard size chunks released by mem_arena_reset()                  */
+    struct  mem_chunk_t         *   spare_p;
+    /**
+     *  Size of a standard chunk                                            */
+    size_t                          chunk_l;
+};
+//----------------------------------------------------------------------------
+struct  mem_shard_t
+{
+    /**
+     *  Lock for everything in this shard                                   */
+    pthread_mutex_t                 lock;
+    /**
+     *  Number of slots in the table (a power of two or zero)              */
+    size_t                          capacity;
+    /**
+     *  Number of slots in use                                              */
+    size_t                          count;
+    /**
+     *  The table, an unused slot has a NULL address                        */
+    struct  malloc_data_t       *   slot_p;
+};
+//----------------------------------------------------------------------------
 
 /****************************************************************************
  * Library Private Storage Allocation
@@ -72,7 +205,7 @@ struct  malloc_data_t
 
 //----------------------------------------------------------------------------
 MEM_EXT
-struct  list_base_t        *   malloc_info_p;
+struct  mem_shard_t             mem_shard[ MEM_SHARD_COUNT ];
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -80,16 +213,101 @@ struct  list_base_t        *   malloc_info_p;
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
-struct  malloc_data_t   *
-MEM__info_get(
+uint64_t
+MEM__info_hash(
     void                        *   address
     );
 //----------------------------------------------------------------------------
 void
+MEM__info_grow(
+    struct  mem_shard_t         *   shard_p
+    );
+//----------------------------------------------------------------------------
+void
+MEM__info_init(
+    void
+    );
+//----------------------------------------------------------------------------
+void
+MEM__info_put(
+    void                        *   address,
+    int                             size
+    );
+//----------------------------------------------------------------------------
+void
 MEM__info_remove(
     void                        *   address
     );
 //----------------------------------------------------------------------------
+int
+MEM__info_count(
+    void
+    );
+//----------------------------------------------------------------------------
+void
+MEM__info_dump(
+    void
+    );
+//----------------------------------------------------------------------------
+int
+MEM__class_index(
+    size_t                          block_l
+    );
+//----------------------------------------------------------------------------
+size_t
+MEM__class_size(
+    int                             class_ndx
+    );
+//----------------------------------------------------------------------------
+void
+MEM__slab_init(
+    void
+    );
+//----------------------------------------------------------------------------
+void
+MEM__slab_thread_exit(
+    void                        *   void_p
+    );
+//----------------------------------------------------------------------------
+void
+MEM__slab_register(
+    void
+    );
+//----------------------------------------------------------------------------
+void
+MEM__slab_refill(
+    int                             class_ndx
+    );
+//----------------------------------------------------------------------------
+void
+MEM__slab_release(
+    int                             class_ndx,
+    struct  mem_header_t        *   chain_p
+    );
+//----------------------------------------------------------------------------
+struct  mem_header_t    *
+MEM__slab_alloc(
+    size_t                          block_l
+    );
+//----------------------------------------------------------------------------
+void
+MEM__slab_free(
+    struct  mem_header_t        *   header_p,
+    size_t                          block_l
+    );
+//----------------------------------------------------------------------------
+struct  mem_chunk_t     *
+MEM__arena_chunk(
+    struct  mem_arena_t         *   arena_p,
+    size_t                          size
+    );
+//----------------------------------------------------------------------------
+struct  mem_header_t    *
+MEM__header_check(
+    void                        *   memory_p,
+    const char                  *   function_name
+    );
+//----------------------------------------------------------------------------
 
 /****************************************************************************/
 
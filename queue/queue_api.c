@@ -25,6 +25,12 @@
  *      The queue does not move the contents of a payload.  Only the
  *      payload pointer passed through the queue.
  *
+ *  @note   queue depth:
+ *      A queue created with a queue_depth of two or more uses a lock-free
+ *      ring of payload pointers.  Producers and consumers only sleep when
+ *      the ring is full or empty.  A queue_depth of zero (unlimited) keeps
+ *      using a link-list.
+ *
  *  @note
  *
  ****************************************************************************/
@@ -144,6 +150,12 @@ queue_init(
                           "base list structure 'queue_name_id_base_p' [%p].\n",
                           queue_name_id_base_p );
         }
+
+        //  Allocate the Queue-ID and Queue-Name lookup tables.
+        atomic_store( &queue_id_table_p,
+                      QUEUE__table_new( QUEUE_ID_TABLE_L ) );
+        atomic_store( &queue_name_hash_p,
+                      QUEUE__table_new( QUEUE_NAME_HASH_L ) );
     }
 
     /************************************************************************
@@ -598,3 +610,143 @@ queue_get_payload(
 }
 
 /****************************************************************************/
+
+/****************************************************************************/
+/**
+ *  Put a batch of payloads on the defined queue.
+ *
+ *  @param  queue_id        A Queue-ID number (handle)
+ *  @param  void_pp         Array of payload pointers that will be added to
+ *                          the queue (in array order).
+ *  @param  count           Number of payload pointers in the array.
+ *
+ *  @return put_count       Number of payloads put on the queue.  When less
+ *                          then zero see queue_rc_e for a list of failure
+ *                          codes.
+ *
+ *  @note
+ *      Like queue_put_payload() this waits while the queue is full.
+ *
+ ****************************************************************************/
+
+int
+queue_put_batch(
+    int                             queue_id,
+    void                        **  void_pp,
+    int                             count
+    )
+{
+    /**
+     *  @param  put_count       Number of payloads put on the queue         */
+    int                             put_count;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+
+    /************************************************************************
+     *  Add the new payload pointers to the queue.
+     ************************************************************************/
+
+    //  Put the batch on the queue
+    put_count = QUEUE__put_batch( queue_id, void_pp, count );
+
+    /************************************************************************
+     *  Log the results
+     ************************************************************************/
+
+    //  Was the whole batch successfully put on the queue ?
+    if ( put_count == count )
+    {
+        //  YES:    Log the count and Queue-ID
+        log_write( MID_DEBUG_0, "queue_put_batch",
+                      "%d payloads successfully put on messaging queue %04d.\n",
+                      put_count, queue_id );
+    }
+    else
+    {
+        //  NO:     Log the failure
+        log_write( MID_FATAL, "queue_put_batch",
+                      "Putting %d payloads on messaging queue %04d FAILED.\n",
+                      count, queue_id );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( put_count );
+}
+
+/****************************************************************************/
+/**
+ *  Return a batch of payload pointers from the queue.
+ *
+ *  @param  queue_id        A Queue-ID number (handle)
+ *  @param  void_pp         Array the payload pointers are returned in.
+ *  @param  max_count       Number of entries in the array.
+ *  @param  mode            QUEUE_WAIT to wait until there is at least one
+ *                          payload, QUEUE_NO_WAIT to return immediately.
+ *
+ *  @return get_count       Number of payloads returned.  Zero when the
+ *                          queue is empty and mode is QUEUE_NO_WAIT.
+ *
+ *  @note
+ *
+ ****************************************************************************/
+
+int
+queue_get_batch(
+    int                             queue_id,
+    void                        **  void_pp,
+    int                             max_count,
+    enum    queue_get_mode_e        mode
+    )
+{
+    /**
+     *  @param  get_count       Number of payloads removed from the queue   */
+    int                             get_count;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+
+    /************************************************************************
+     *  Get the payload pointers from the queue.
+     ************************************************************************/
+
+    //  Get the batch from the queue
+    get_count = QUEUE__get_batch( queue_id, void_pp, max_count, mode );
+
+    /************************************************************************
+     *  Log the results
+     ************************************************************************/
+
+    //  Was the queue found ?
+    if ( get_count >= 0 )
+    {
+        //  YES:    Log the count and Queue-ID
+        log_write( MID_DEBUG_0, "queue_get_batch",
+                      "Successfully pulled %d payloads from Queue-ID %04d.\n",
+                      get_count, queue_id );
+    }
+    else
+    {
+        //  NO:     Log the failure
+        log_write( MID_FATAL, "queue_get_batch",
+                      "Pulling from messaging queue %04d FAILED.\n",
+                      queue_id );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( get_count );
+}
+
+/****************************************************************************/
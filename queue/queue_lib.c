@@ -30,6 +30,8 @@
 #include <string.h>             //  Functions for managing strings
 #include <stdlib.h>             //  ANSI standard library.
 #include <unistd.h>             //  Access to the POSIX operating system API
+#include <sys/syscall.h>        //  syscall( SYS_futex )
+#include <linux/futex.h>        //  FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE
                                 //*******************************************
 
 /****************************************************************************
@@ -127,6 +129,59 @@ QUEUE__verify_queue_name(
     return( queue_rc );
 }
 
+/****************************************************************************/
+/**
+ *  Compute the hash table index for a Queue-Name.
+ *
+ *  @param  queue_name      The space expanded queue name.
+ *
+ *  @return hash           The hash value.  Mask it with the table size
+ *                          minus one to get the home slot.
+ *
+ *  @note
+ *      FNV-1a over the first QUEUE_NAME_L characters.
+ *
+ ****************************************************************************/
+
+uint32_t
+QUEUE__name_hash(
+    char                        *   queue_name
+    )
+{
+    /**
+     *  @param  hash            The hash value                              */
+    uint32_t                        hash;
+    /**
+     *  @param  ndx             Index into the queue name                   */
+    int                             ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  FNV offset basis
+    hash = 2166136261u;
+
+    /************************************************************************
+     *  Hash the name
+     ************************************************************************/
+
+    for ( ndx = 0;
+          ( ndx < QUEUE_NAME_L ) && ( queue_name[ ndx ] != '\0' );
+          ndx ++ )
+    {
+        hash ^= (uint8_t)queue_name[ ndx ];
+        hash *= 16777619u;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( hash );
+}
+
 /****************************************************************************/
 /**
  *  Search the messaging queue list for a queue-name match.
@@ -139,6 +194,7 @@ QUEUE__verify_queue_name(
  *                          list of failure codes.
  *
  *  @note
+ *      The hash table is insert only, so the search doesn't need a lock.
  *
  ****************************************************************************/
 
@@ -154,8 +210,11 @@ QUEUE__find_queue_name(
      *  @param  queue_cb_p      Pointer to a queue control block            */
     struct  queue_cb_t          *   queue_cb_p;
     /**
-     *  @param  access_key      Performance access key for a list           */
-    int                             access_key;
+     *  @param  hash_table_p    The Queue-Name hash table                   */
+    struct  queue_table_t       *   hash_table_p;
+    /**
+     *  @param  hash_ndx        Hash table index                            */
+    uint32_t                        hash_ndx;
     /**
      *  @param  queue_name      Expanded form of the queue_name             */
     char                            queue_name[ QUEUE_NAME_L + 1 ];
@@ -167,8 +226,9 @@ QUEUE__find_queue_name(
     //  Set the default return code.
     queue_id = QUEUE_RC_SUCCESS;
 
-    //  Prevent other threads from modifying the queue list.
-    access_key = list_user_lock( queue_name_id_base_p );
+    //  Get the current hash table.
+    hash_table_p = atomic_load_explicit( &queue_name_hash_p,
+                                         memory_order_acquire );
 
     //  Build the space expanded queue_name
     //  @NOTE   This instruction should but can't use QUEUE_NAME_L
@@ -176,27 +236,30 @@ QUEUE__find_queue_name(
               "%-8s", queue_name_p );
 
     /************************************************************************
-     *  Locate the queue name in the list of queues.
+     *  Locate the queue name in the hash table.
      ************************************************************************/
 
-    //  Should we continue ?
-    if ( queue_id == QUEUE_RC_SUCCESS )
-    {
-        queue_cb_p = list_fget_first( queue_name_id_base_p, access_key );
-        for ( queue_cb_p = list_fget_first( queue_name_id_base_p, access_key );
-              queue_cb_p != NULL;
-              queue_cb_p = list_fget_next( queue_name_id_base_p,
-                                           queue_cb_p,
-                                           access_key ) )
-        {
-            //  Is this the queue name we are looking for ?
-            if ( strncmp( queue_cb_p->queue_name,
-                          queue_name, QUEUE_NAME_L ) == 0 )
-            {
-                //  YES:    We are done looking
-                break;
-            }
+    //  Start at the home slot for this name.
+    hash_ndx = QUEUE__name_hash( queue_name )
+             & ( hash_table_p->table_l - 1 );
+
+    //  Probe until the name or an empty slot is found.
+    for ( queue_cb_p = atomic_load_explicit( &hash_table_p->cb_p[ hash_ndx ],
+                                             memory_order_acquire );
+          queue_cb_p != NULL;
+          queue_cb_p = atomic_load_explicit( &hash_table_p->cb_p[ hash_ndx ],
+                                             memory_order_acquire ) )
+    {
+        //  Is this the queue name we are looking for ?
+        if ( strncmp( queue_cb_p->queue_name,
+                      queue_name, QUEUE_NAME_L ) == 0 )
+        {
+            //  YES:    We are done looking
+            break;
         }
+
+        //  Try the next slot.
+        hash_ndx = ( hash_ndx + 1 ) & ( hash_table_p->table_l - 1 );
     }
 
     /************************************************************************
@@ -219,9 +282,6 @@ QUEUE__find_queue_name(
      *  Function Exit
      ************************************************************************/
 
-    //  Allow other threads access to the queue list again.
-    list_user_unlock( queue_name_id_base_p, access_key );
-
     //  All done.
     return( queue_id );
 }
@@ -317,6 +377,15 @@ QUEUE__new(
         //  Set the maximum queue depth
         queue_cb_p->queue_depth = queue_depth;
 
+        //  Does the queue have a fixed depth ?
+        //  @NOTE   The ring sequence numbers can't tell a full slot from
+        //          an empty one with less than two slots.
+        if ( queue_depth >= QUEUE_RING_MIN_DEPTH )
+        {
+            //  YES:    Use the lock-free ring for the payloads.
+            queue_cb_p->ring_p = QUEUE__ring_new( queue_depth );
+        }
+
         //  There isn't anything on the queue yet.
         queue_cb_p->queue_state.queue_msg_count = 0;
 
@@ -342,6 +411,20 @@ QUEUE__new(
         list_fput_last( queue_name_id_base_p, queue_cb_p, access_key );
     }
 
+    /************************************************************************
+     *  Publish it in the lookup tables
+     ************************************************************************/
+
+    //  Should we continue ?
+    if ( queue_rc == QUEUE_RC_SUCCESS )
+    {
+        //  Publish the control block by Queue-ID.
+        QUEUE__id_table_put( queue_cb_p );
+
+        //  Publish the control block by Queue-Name.
+        QUEUE__name_hash_put( queue_cb_p );
+    }
+
     /************************************************************************
      *  Function Exit
      ************************************************************************/
@@ -362,73 +445,326 @@ QUEUE__new(
 
 /****************************************************************************/
 /**
- *  Return a pointer to the Queue base structure for the Queue-ID
+ *  Allocate an empty queue lookup table.
  *
- *  @param  queue_id        A Queue-ID number (handle)
+ *  @param  table_l         Number of entries in the table.
  *
- *  @return queue_rc        See queue_rc_e for a list of return codes.
+ *  @return table_p         Pointer to the new table.
  *
  *  @note
  *
  ****************************************************************************/
 
-struct  queue_cb_t *
-QUEUE__find_queue_cb(
-    int                             queue_id
+struct  queue_table_t *
+QUEUE__table_new(
+    int                             table_l
     )
 {
     /**
-     *  @param  queue_rc        Return code                                 */
-    enum    queue_rc_e              queue_rc;
+     *  @param  table_p         Pointer to the new table                    */
+    struct  queue_table_t       *   table_p;
     /**
-     *  @param  queue_cb_p      Pointer to a queue control block    */
-    struct  queue_cb_t          *   queue_cb_p;
+     *  @param  ndx             Index into the table                        */
+    int                             ndx;
+
+    /************************************************************************
+     *  Allocate the table
+     ************************************************************************/
+
+    //  Allocate storage for the table and all of its entries.
+    table_p = (struct queue_table_t*)malloc( sizeof( struct queue_table_t )
+                    + ( sizeof( table_p->cb_p[ 0 ] ) * (size_t)table_l ) );
+
+    //  Was the allocation successful ?
+    if ( table_p == NULL )
+    {
+        //  NO:     Kill everything
+        log_write( MID_FATAL, "QUEUE__table_new",
+                   "Unable to allocate storage for a %d entry queue "
+                   "table.\n", table_l );
+    }
+
+    /************************************************************************
+     *  Initialize the table
+     ************************************************************************/
+
+    //  Nothing has been replaced yet.
+    table_p->retired_p = NULL;
+    table_p->table_l   = table_l;
+
+    //  Every entry starts out empty.
+    for ( ndx = 0;
+          ndx < table_l;
+          ndx ++ )
+    {
+        atomic_init( &table_p->cb_p[ ndx ], NULL );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( table_p );
+}
+
+/****************************************************************************/
+/**
+ *  Publish a queue control block in the Queue-ID table.
+ *
+ *  @param  queue_cb_p      Pointer to a queue control block
+ *
+ *  @return void
+ *
+ *  @note
+ *      The caller MUST hold the Name/ID list lock.  When the Queue-ID
+ *      doesn't fit, a table twice the size is filled in and published
+ *      before the new entry is written.  The old table is kept on the
+ *      retired_p chain because a lock-free reader may still be using it.
+ *
+ ****************************************************************************/
+
+void
+QUEUE__id_table_put(
+    struct  queue_cb_t          *   queue_cb_p
+    )
+{
     /**
-     *  @param  access_key      Lock key for a list                         */
-    int                             access_key;
+     *  @param  table_p         The current Queue-ID table                  */
+    struct  queue_table_t       *   table_p;
+    /**
+     *  @param  grow_p          The replacement Queue-ID table              */
+    struct  queue_table_t       *   grow_p;
+    /**
+     *  @param  ndx             Index into the table                        */
+    int                             ndx;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
-    //  Set the default return code.
-    queue_rc = QUEUE_RC_SUCCESS;
+    //  Get the current table.
+    table_p = atomic_load_explicit( &queue_id_table_p,
+                                    memory_order_relaxed );
 
-    //  Prevent other threads from modifying the queue list.
-    access_key = list_user_lock( queue_name_id_base_p );
+    /************************************************************************
+     *  Grow the table
+     ************************************************************************/
+
+    //  Is there room in the table for this Queue-ID ?
+    if ( queue_cb_p->queue_id >= table_p->table_l )
+    {
+        //  NO:     Allocate a table twice the size.
+        grow_p = QUEUE__table_new( table_p->table_l * 2 );
+
+        //  Copy everything that is already published.
+        for ( ndx = 0;
+              ndx < table_p->table_l;
+              ndx ++ )
+        {
+            atomic_init( &grow_p->cb_p[ ndx ],
+                         atomic_load_explicit( &table_p->cb_p[ ndx ],
+                                               memory_order_relaxed ) );
+        }
+
+        //  Keep the old table around for readers that are still using it.
+        grow_p->retired_p = table_p;
+
+        //  Publish the new table.
+        atomic_store_explicit( &queue_id_table_p, grow_p,
+                               memory_order_release );
+        table_p = grow_p;
+    }
 
     /************************************************************************
-     *  Locate the queue name in the list of queues.
+     *  Publish the control block
      ************************************************************************/
 
-    //  Should we continue ?
-    if ( queue_rc == QUEUE_RC_SUCCESS )
+    //  Add it to the table.
+    atomic_store_explicit( &table_p->cb_p[ queue_cb_p->queue_id ],
+                           queue_cb_p, memory_order_release );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+}
+
+/****************************************************************************/
+/**
+ *  Publish a queue control block in the Queue-Name hash table.
+ *
+ *  @param  queue_cb_p      Pointer to a queue control block
+ *
+ *  @return void
+ *
+ *  @note
+ *      The caller MUST hold the Name/ID list lock.  Queues are never
+ *      removed, so the number of names is the last Queue-ID.  Before the
+ *      table would be half full every name is re-hashed into a table
+ *      twice the size, which is then published.  The old table is kept on
+ *      the retired_p chain because a lock-free reader may still be using
+ *      it.
+ *
+ ****************************************************************************/
+
+void
+QUEUE__name_hash_put(
+    struct  queue_cb_t          *   queue_cb_p
+    )
+{
+    /**
+     *  @param  table_p         The current Queue-Name hash table           */
+    struct  queue_table_t       *   table_p;
+    /**
+     *  @param  grow_p          The replacement Queue-Name hash table       */
+    struct  queue_table_t       *   grow_p;
+    /**
+     *  @param  entry_p         A control block being re-hashed             */
+    struct  queue_cb_t          *   entry_p;
+    /**
+     *  @param  ndx             Index into the old table                    */
+    int                             ndx;
+    /**
+     *  @param  hash_ndx        Index into the new table                    */
+    uint32_t                        hash_ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Get the current table.
+    table_p = atomic_load_explicit( &queue_name_hash_p,
+                                    memory_order_relaxed );
+
+    /************************************************************************
+     *  Grow the table
+     ************************************************************************/
+
+    //  Will the table be at least half full ?
+    if ( ( queue_cb_p->queue_id * 2 ) >= table_p->table_l )
     {
-        //  Not entirely sure why this is here (Empty queue ? )
-        queue_cb_p = list_fget_first( queue_name_id_base_p, access_key );
+        //  YES:    Allocate a table twice the size.
+        grow_p = QUEUE__table_new( table_p->table_l * 2 );
 
-        //  Loop through all queues.
-        for ( queue_cb_p = list_fget_first( queue_name_id_base_p, access_key );
-              queue_cb_p != NULL;
-              queue_cb_p = list_fget_next( queue_name_id_base_p,
-                                           queue_cb_p,
-                                           access_key ) )
+        //  Re-hash every name that is already published.
+        for ( ndx = 0;
+              ndx < table_p->table_l;
+              ndx ++ )
         {
-            //  Is this the queue name we are looking for ?
-            if ( queue_cb_p->queue_id == queue_id )
+            //  Is this slot in use ?
+            entry_p = atomic_load_explicit( &table_p->cb_p[ ndx ],
+                                            memory_order_relaxed );
+
+            if ( entry_p != NULL )
             {
-                //  YES:    We are done looking.
-                break;
+                //  YES:    Find an empty slot in the new table.
+                for ( hash_ndx = QUEUE__name_hash( entry_p->queue_name )
+                               & ( grow_p->table_l - 1 );
+                      atomic_load_explicit( &grow_p->cb_p[ hash_ndx ],
+                                            memory_order_relaxed ) != NULL;
+                      hash_ndx = ( hash_ndx + 1 ) & ( grow_p->table_l - 1 ) )
+                {
+                    //  Keep looking.
+                }
+
+                //  Move it.
+                atomic_init( &grow_p->cb_p[ hash_ndx ], entry_p );
             }
         }
+
+        //  Keep the old table around for readers that are still using it.
+        grow_p->retired_p = table_p;
+
+        //  Publish the new table.
+        atomic_store_explicit( &queue_name_hash_p, grow_p,
+                               memory_order_release );
+        table_p = grow_p;
+    }
+
+    /************************************************************************
+     *  Publish the control block
+     ************************************************************************/
+
+    //  Find an empty slot for the Queue-Name.
+    for ( hash_ndx = QUEUE__name_hash( queue_cb_p->queue_name )
+                   & ( table_p->table_l - 1 );
+          atomic_load_explicit( &table_p->cb_p[ hash_ndx ],
+                                memory_order_relaxed ) != NULL;
+          hash_ndx = ( hash_ndx + 1 ) & ( table_p->table_l - 1 ) )
+    {
+        //  Keep looking.
     }
 
+    //  Add it to the table.
+    atomic_store_explicit( &table_p->cb_p[ hash_ndx ],
+                           queue_cb_p, memory_order_release );
+
     /************************************************************************
      *  Function Exit
      ************************************************************************/
 
-    //  Allow other threads access to the queue list again.
-    list_user_unlock( queue_name_id_base_p, access_key );
+    //  All done.
+}
+
+/****************************************************************************/
+/**
+ *  Return a pointer to the Queue base structure for the Queue-ID
+ *
+ *  @param  queue_id        A Queue-ID number (handle)
+ *
+ *  @return queue_cb_p      Pointer to the queue control block or NULL when
+ *                          the Queue-ID doesn't exist.
+ *
+ *  @note
+ *      This is called for every payload put or get so it doesn't take any
+ *      lock.  A table entry is written once, before the Queue-ID is
+ *      returned to anyone, and never changes after that.  A grown table is
+ *      published after the old entries are copied into it, so either table
+ *      has every Queue-ID that was returned before it was loaded.
+ *
+ ****************************************************************************/
+
+struct  queue_cb_t *
+QUEUE__find_queue_cb(
+    int                             queue_id
+    )
+{
+    /**
+     *  @param  queue_cb_p      Pointer to a queue control block    */
+    struct  queue_cb_t          *   queue_cb_p;
+    /**
+     *  @param  table_p         The current Queue-ID table                  */
+    struct  queue_table_t       *   table_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Assume the Queue-ID doesn't exist.
+    queue_cb_p = NULL;
+
+    //  Get the current table.
+    table_p = atomic_load_explicit( &queue_id_table_p,
+                                    memory_order_acquire );
+
+    /************************************************************************
+     *  Locate the queue control block in the Queue-ID table.
+     ************************************************************************/
+
+    //  Is the Queue-ID inside the table ?
+    if (    ( queue_id >                 0 )
+         && ( queue_id < table_p->table_l ) )
+    {
+        //  YES:    Get the queue control block.
+        queue_cb_p = atomic_load_explicit( &table_p->cb_p[ queue_id ],
+                                           memory_order_acquire );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
 
     //  All done.
     return( queue_cb_p );
@@ -488,6 +824,13 @@ QUEUE__get_count(
      *  Function Exit
      ************************************************************************/
 
+    //  Is this a ring queue ?
+    if ( queue_cb_p->ring_p != NULL )
+    {
+        //  YES:    The ring keeps its own count.
+        queue_cb_p->queue_state.queue_msg_count = QUEUE__ring_get_count( queue_cb_p->ring_p );
+    }
+
     //  All done.
     return( queue_cb_p->queue_state.queue_msg_count );
 }
@@ -546,12 +889,25 @@ QUEUE__put_payload(
         }
     }
 
+    /************************************************************************
+     *  Put the new payload on a fixed depth (ring) queue
+     ************************************************************************/
+
+    //  Should we continue ?
+    if (    ( queue_rc           == true )
+         && ( queue_cb_p->ring_p != NULL ) )
+    {
+        //  YES:    The ring handles the depth limit and all signaling.
+        queue_rc = QUEUE__ring_put( queue_cb_p, override, void_p );
+    }
+
     /************************************************************************
      *  Append the new payload to the end of the queue
      ************************************************************************/
 
     //  Should we continue ?
-    if ( queue_rc == true )
+    if (    ( queue_rc           == true )
+         && ( queue_cb_p->ring_p == NULL ) )
     {
         //  YES:    Is the queue full ?
         if (    ( override == false )
@@ -599,7 +955,8 @@ QUEUE__put_payload(
      ************************************************************************/
 
     //  Should we continue ?
-    if ( queue_rc == true )
+    if (    ( queue_rc           == true )
+         && ( queue_cb_p->ring_p == NULL ) )
     {
         //  YES:    Is the receive thread waiting for another payload ?
         if ( queue_cb_p->msg_dequeue_state == MSGQSTATE_DEQUEUE_BLOCK )
@@ -681,12 +1038,25 @@ QUEUE__get_payload(
         }
     }
 
+    /************************************************************************
+     *  Get the next payload from a fixed depth (ring) queue
+     ************************************************************************/
+
+    //  Should we continue ?
+    if (    ( queue_rc           == QUEUE_RC_SUCCESS )
+         && ( queue_cb_p->ring_p !=             NULL ) )
+    {
+        //  YES:    The ring handles waiting and all signaling.
+        void_p = QUEUE__ring_get( queue_cb_p );
+    }
+
     /************************************************************************
      *  Get the next payload from the queue
      ************************************************************************/
 
     //  Should we continue ?
-    if ( queue_rc == QUEUE_RC_SUCCESS )
+    if (    ( queue_rc           == QUEUE_RC_SUCCESS )
+         && ( queue_cb_p->ring_p ==             NULL ) )
     {
         //  Is there anything on in the queue ?
         if ( queue_cb_p->queue_state.queue_msg_count == 0 )
@@ -752,3 +1122,1442 @@ QUEUE__get_payload(
 }
 
 /****************************************************************************/
+/****************************************************************************/
+/**
+ *  Put the calling thread to sleep until the futex word changes.
+ *
+ *  @param  futex_p         Pointer to the futex word.
+ *  @param  value           The value the futex word had when the caller
+ *                          decided to sleep.
+ *
+ *  @return void
+ *
+ *  @note
+ *      When the futex word no longer contains 'value' the call returns
+ *      immediately.  This is what prevents a lost wake-up.
+ *
+ ****************************************************************************/
+
+void
+QUEUE__futex_wait(
+    atomic_uint                 *   futex_p,
+    unsigned int                    value
+    )
+{
+
+    /************************************************************************
+     *  Wait for the futex word to change
+     ************************************************************************/
+
+    //  Sleep until woken or the value has already changed.
+    syscall( SYS_futex, (unsigned int *)futex_p, FUTEX_WAIT_PRIVATE,
+             value, NULL, NULL, 0 );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+}
+
+/****************************************************************************/
+/**
+ *  Wake threads sleeping on a futex word.
+ *
+ *  @param  futex_p         Pointer to the futex word.
+ *  @param  count           Maximum number of threads to wake.
+ *
+ *  @return void
+ *
+ *  @note
+ *
+ ****************************************************************************/
+
+void
+QUEUE__futex_wake(
+    atomic_uint                 *   futex_p,
+    int                             count
+    )
+{
+
+    /************************************************************************
+     *  Wake up a sleeping thread
+     ************************************************************************/
+
+    //  Wake up to 'count' waiters.
+    syscall( SYS_futex, (unsigned int *)futex_p, FUTEX_WAKE_PRIVATE,
+             count, NULL, NULL, 0 );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+}
+
+/****************************************************************************/
+/**
+ *  Allocate and initialize a lock-free ring for a fixed depth queue.
+ *
+ *  @param  queue_depth     MAX number of payloads in the ring.
+ *
+ *  @return queue_ring_p    Pointer to the new ring.
+ *
+ *  @note
+ *      Every slot starts with a sequence number equal to its index.  A
+ *      producer may fill the slot when sequence == position and a consumer
+ *      may empty it when sequence == position + 1.
+ *
+ ****************************************************************************/
+
+struct  queue_ring_t    *
+QUEUE__ring_new(
+    int                             queue_depth
+    )
+{
+    /**
+     *  @param  queue_ring_p    Pointer to the new ring                     */
+    struct  queue_ring_t        *   queue_ring_p;
+    /**
+     *  @param  ndx             Slot index                                  */
+    size_t                          ndx;
+
+    /************************************************************************
+     *  Allocate the ring
+     ************************************************************************/
+
+    //  Allocate storage for the ring control structure.
+    queue_ring_p = (struct queue_ring_t*)malloc( sizeof( struct queue_ring_t ) );
+
+    //  Was the allocation successful ?
+    if ( queue_ring_p == NULL )
+    {
+        //  NO:     Kill everything
+        log_write( MID_FATAL, "QUEUE__ring_new",
+                   "Unable to allocate storage for a new queue ring.\n" );
+    }
+
+    //  Initialize the structure.
+    memset( queue_ring_p, 0x00, sizeof( struct queue_ring_t ) );
+    queue_ring_p->capacity = (size_t)queue_depth;
+
+    //  Allocate storage for the slots.
+    queue_ring_p->slot_p = (struct queue_slot_t*)malloc( sizeof( struct queue_slot_t )
+                                                         * queue_ring_p->capacity );
+
+    //  Was the allocation successful ?
+    if ( queue_ring_p->slot_p == NULL )
+    {
+        //  NO:     Kill everything
+        log_write( MID_FATAL, "QUEUE__ring_new",
+                   "Unable to allocate storage for %d queue ring slots.\n",
+                   queue_depth );
+    }
+
+    /************************************************************************
+     *  Initialize the ring
+     ************************************************************************/
+
+    //  Set the starting sequence number for every slot.
+    for ( ndx = 0;
+          ndx < queue_ring_p->capacity;
+          ndx ++ )
+    {
+        atomic_init( &queue_ring_p->slot_p[ ndx ].sequence, ndx );
+        queue_ring_p->slot_p[ ndx ].payload_p = NULL;
+    }
+
+    //  Both ends of the ring start at position zero.
+    atomic_init( &queue_ring_p->enqueue_pos,     0 );
+    atomic_init( &queue_ring_p->dequeue_pos,     0 );
+    atomic_init( &queue_ring_p->not_empty,       0 );
+    atomic_init( &queue_ring_p->not_full,        0 );
+    atomic_init( &queue_ring_p->dequeue_waiters, 0 );
+    atomic_init( &queue_ring_p->enqueue_waiters, 0 );
+    atomic_init( &queue_ring_p->overflow_count,  0 );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( queue_ring_p );
+}
+
+/****************************************************************************/
+/**
+ *  Return the number of payloads on a ring queue.
+ *
+ *  @param  queue_ring_p    Pointer to the ring.
+ *
+ *  @return queue_msg_count The number of payloads on the ring.
+ *
+ *  @note
+ *      With producers and consumers running the count is a snapshot.
+ *
+ ****************************************************************************/
+
+int
+QUEUE__ring_get_count(
+    struct  queue_ring_t        *   queue_ring_p
+    )
+{
+    /**
+     *  @param  dequeue_pos     Snapshot of the consumer position           */
+    size_t                          dequeue_pos;
+    /**
+     *  @param  enqueue_pos     Snapshot of the producer position           */
+    size_t                          enqueue_pos;
+    /**
+     *  @param  queue_msg_count Number of payloads in the queue             */
+    int                             queue_msg_count;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Read the consumer side first so the difference can't go negative.
+    dequeue_pos = atomic_load( &queue_ring_p->dequeue_pos );
+    enqueue_pos = atomic_load( &queue_ring_p->enqueue_pos );
+
+    /************************************************************************
+     *  Compute the count
+     ************************************************************************/
+
+    //  A producer that claimed a slot counts as being on the queue.
+    if ( enqueue_pos - dequeue_pos > queue_ring_p->capacity )
+    {
+        queue_msg_count = (int)queue_ring_p->capacity;
+    }
+    else
+    {
+        queue_msg_count = (int)( enqueue_pos - dequeue_pos );
+    }
+
+    //  Add anything that was put past the depth limit.
+    queue_msg_count += atomic_load( &queue_ring_p->overflow_count );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( queue_msg_count );
+}
+
+/****************************************************************************/
+/**
+ *  Try to put a payload on a ring without waiting.
+ *
+ *  @param  queue_ring_p    Pointer to the ring.
+ *  @param  void_p          Pointer to the payload that goes into the queue.
+ *
+ *  @return queue_rc        TRUE when the payload was put on the ring,
+ *                          FALSE when the ring is full.
+ *
+ *  @note
+ *
+ ****************************************************************************/
+
+int
+QUEUE__ring_try_put(
+    struct  queue_ring_t        *   queue_ring_p,
+    void                        *   void_p
+    )
+{
+    /**
+     *  @param  queue_rc        Return code                                 */
+    int                             queue_rc;
+    /**
+     *  @param  queue_slot_p    Pointer to the slot at 'position'           */
+    struct  queue_slot_t        *   queue_slot_p;
+    /**
+     *  @param  position        The ring position being claimed             */
+    size_t                          position;
+    /**
+     *  @param  sequence        The slot sequence number                    */
+    size_t                          sequence;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Assume the ring is full.
+    queue_rc = false;
+
+    //  Start with the current producer position.
+    position = atomic_load_explicit( &queue_ring_p->enqueue_pos,
+                                     memory_order_relaxed );
+
+    /************************************************************************
+     *  Claim a slot
+     ************************************************************************/
+
+    for ( ; ; )
+    {
+        //  Get the slot for this position.
+        queue_slot_p = &queue_ring_p->slot_p[ position % queue_ring_p->capacity ];
+        sequence = atomic_load_explicit( &queue_slot_p->sequence,
+                                         memory_order_acquire );
+
+        //  Is the slot empty and waiting for this position ?
+        if ( sequence == position )
+        {
+            //  YES:    Try to claim it.
+            if ( atomic_compare_exchange_weak_explicit( &queue_ring_p->enqueue_pos,
+                                                        &position, position + 1,
+                                                        memory_order_relaxed,
+                                                        memory_order_relaxed ) )
+            {
+                //  The slot is ours.
+                queue_rc = true;
+                break;
+            }
+            //  Another producer beat us to it.  'position' was reloaded.
+        }
+
+        //  Is the slot still holding a payload from the last lap ?
+        else if ( (intptr_t)( sequence - position ) < 0 )
+        {
+            //  YES:    The ring is full.
+            break;
+        }
+
+        else
+        {
+            //  Another producer took this position.  Try again.
+            position = atomic_load_explicit( &queue_ring_p->enqueue_pos,
+                                             memory_order_relaxed );
+        }
+    }
+
+    /************************************************************************
+     *  Fill the slot
+     ************************************************************************/
+
+    //  Did we claim a slot ?
+    if ( queue_rc == true )
+    {
+        //  YES:    Store the payload and hand the slot to the consumers.
+        queue_slot_p->payload_p = void_p;
+        atomic_store_explicit( &queue_slot_p->sequence, position + 1,
+                               memory_order_release );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( queue_rc );
+}
+
+/****************************************************************************/
+/**
+ *  Try to get a payload from a ring without waiting.
+ *
+ *  @param  queue_ring_p    Pointer to the ring.
+ *  @param  void_pp         Where the payload pointer is returned.
+ *
+ *  @return queue_rc        TRUE when a payload was removed from the ring,
+ *                          FALSE when the ring is empty.
+ *
+ *  @note
+ *
+ ****************************************************************************/
+
+int
+QUEUE__ring_try_get(
+    struct  queue_ring_t        *   queue_ring_p,
+    void                        **  void_pp
+    )
+{
+    /**
+     *  @param  queue_rc        Return code                                 */
+    int                             queue_rc;
+    /**
+     *  @param  queue_slot_p    Pointer to the slot at 'position'           */
+    struct  queue_slot_t        *   queue_slot_p;
+    /**
+     *  @param  position        The ring position being claimed             */
+    size_t                          position;
+    /**
+     *  @param  sequence        The slot sequence number                    */
+    size_t                          sequence;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Assume the ring is empty.
+    queue_rc = false;
+
+    //  Start with the current consumer position.
+    position = atomic_load_explicit( &queue_ring_p->dequeue_pos,
+                                     memory_order_relaxed );
+
+    /************************************************************************
+     *  Claim a slot
+     ************************************************************************/
+
+    for ( ; ; )
+    {
+        //  Get the slot for this position.
+        queue_slot_p = &queue_ring_p->slot_p[ position % queue_ring_p->capacity ];
+        sequence = atomic_load_explicit( &queue_slot_p->sequence,
+                                         memory_order_acquire );
+
+        //  Has a producer filled the slot for this position ?
+        if ( sequence == position + 1 )
+        {
+            //  YES:    Try to claim it.
+            if ( atomic_compare_exchange_weak_explicit( &queue_ring_p->dequeue_pos,
+                                                        &position, position + 1,
+                                                        memory_order_relaxed,
+                                                        memory_order_relaxed ) )
+            {
+                //  The slot is ours.
+                queue_rc = true;
+                break;
+            }
+            //  Another consumer beat us to it.  'position' was reloaded.
+        }
+
+        //  Is the slot still waiting for a producer ?
+        else if ( (intptr_t)( sequence - ( position + 1 ) ) < 0 )
+        {
+            //  YES:    The ring is empty.
+            break;
+        }
+
+        else
+        {
+            //  Another consumer took this position.  Try again.
+            position = atomic_load_explicit( &queue_ring_p->dequeue_pos,
+                                             memory_order_relaxed );
+        }
+    }
+
+    /************************************************************************
+     *  Empty the slot
+     ************************************************************************/
+
+    //  Did we claim a slot ?
+    if ( queue_rc == true )
+    {
+        //  YES:    Take the payload and hand the slot to the next lap.
+        *void_pp = queue_slot_p->payload_p;
+        atomic_store_explicit( &queue_slot_p->sequence,
+                               position + queue_ring_p->capacity,
+                               memory_order_release );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( queue_rc );
+}
+
+/****************************************************************************/
+/**
+ *  Move payloads from the overflow list back onto a ring queue.
+ *
+ *  @param  queue_cb_p      Pointer to a queue control block
+ *
+ *  @return move_count      Number of payloads moved onto the ring.
+ *
+ *  @note
+ *      Payloads are moved from the head of the overflow list in the order
+ *      they were put.  While the overflow list isn't empty every put goes
+ *      to the overflow list (or waits), so everything on the ring is older
+ *      than everything on the overflow list and FIFO order is kept.
+ *
+ ****************************************************************************/
+
+int
+QUEUE__ring_refill(
+    struct  queue_cb_t          *   queue_cb_p
+    )
+{
+    /**
+     *  @param  move_count      Number of payloads moved onto the ring      */
+    int                             move_count;
+    /**
+     *  @param  void_p          Pointer to the first overflow payload       */
+    void                        *   void_p;
+    /**
+     *  @param  access_key      Lock key for a list                         */
+    int                             access_key;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Nothing has been moved yet.
+    move_count = 0;
+
+    /************************************************************************
+     *  Move the overflow payloads onto the ring
+     ************************************************************************/
+
+    //  Is there anything on the overflow list ?
+    if ( atomic_load( &queue_cb_p->ring_p->overflow_count ) > 0 )
+    {
+        //  YES:    Lock the list so nothing is added while we move them.
+        access_key = list_user_lock( queue_cb_p->queue_base_p );
+
+        //  Move payloads until the list is empty or the ring is full.
+        while ( ( void_p = list_fget_first( queue_cb_p->queue_base_p,
+                                            access_key ) ) != NULL )
+        {
+            //  Is there room on the ring ?
+            if ( QUEUE__ring_try_put( queue_cb_p->ring_p, void_p ) == false )
+            {
+                //  NO:     Leave the rest for later.
+                break;
+            }
+
+            //  Remove it from the overflow list.
+            list_fdelete( queue_cb_p->queue_base_p, void_p, access_key );
+            atomic_fetch_sub( &queue_cb_p->ring_p->overflow_count, 1 );
+            move_count += 1;
+        }
+
+        //  Release the list.
+        list_user_unlock( queue_cb_p->queue_base_p, access_key );
+    }
+
+    /************************************************************************
+     *  Signal the receive thread(s) there are new payloads
+     ************************************************************************/
+
+    //  Was anything moved ?
+    if ( move_count > 0 )
+    {
+        //  YES:    Wake the consumers.
+        QUEUE__ring_signal_not_empty( queue_cb_p->ring_p, move_count );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( move_count );
+}
+
+/****************************************************************************/
+/**
+ *  Tell consumers that payloads were put on a ring queue.
+ *
+ *  @param  queue_ring_p    Pointer to the ring.
+ *  @param  count           Number of payloads that were put on the ring.
+ *
+ *  @return void
+ *
+ *  @note
+ *
+ ****************************************************************************/
+
+void
+QUEUE__ring_signal_not_empty(
+    struct  queue_ring_t        *   queue_ring_p,
+    int                             count
+    )
+{
+
+    /************************************************************************
+     *  Signal the receive thread(s) there is a new payload
+     ************************************************************************/
+
+    //  Let any consumer that is about to sleep know something changed.
+    atomic_fetch_add( &queue_ring_p->not_empty, 1 );
+
+    //  Is a consumer sleeping ?
+    if ( atomic_load( &queue_ring_p->dequeue_waiters ) > 0 )
+    {
+        //  YES:    Wake up one consumer for each payload.
+        QUEUE__futex_wake( &queue_ring_p->not_empty, count );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+}
+
+/****************************************************************************/
+/**
+ *  Tell producers that payloads were removed from a ring queue.
+ *
+ *  @param  queue_ring_p    Pointer to the ring.
+ *  @param  count           Number of payloads that were removed.
+ *
+ *  @return void
+ *
+ *  @note
+ *
+ ****************************************************************************/
+
+void
+QUEUE__ring_signal_not_full(
+    struct  queue_ring_t        *   queue_ring_p,
+    int                             count
+    )
+{
+
+    /************************************************************************
+     *  Signal the send thread(s) there is room
+     ************************************************************************/
+
+    //  Let any producer that is about to sleep know something changed.
+    atomic_fetch_add( &queue_ring_p->not_full, 1 );
+
+    //  Is a producer sleeping ?
+    if ( atomic_load( &queue_ring_p->enqueue_waiters ) > 0 )
+    {
+        //  YES:    Wake up one producer for each free slot.
+        QUEUE__futex_wake( &queue_ring_p->not_full, count );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+}
+
+/****************************************************************************/
+/**
+ *  Put a payload on a ring queue, waiting while the queue is full.
+ *
+ *  @param  queue_cb_p      Pointer to a queue control block
+ *  @param  override        Override queue depth limitation
+ *  @param  void_p          Pointer to the payload that goes into the queue.
+ *
+ *  @return queue_rc        TRUE when the payload was put on the queue.
+ *
+ *  @note
+ *      A full ring is retried QUEUE_RING_SPIN times before the thread
+ *      sleeps.  An override put never waits; when the ring is full the
+ *      payload goes on the overflow list instead.  While the overflow list
+ *      isn't empty the ring counts as full, so newer payloads can't get
+ *      ahead of the ones waiting on the overflow list.
+ *
+ ****************************************************************************/
+
+int
+QUEUE__ring_put(
+    struct  queue_cb_t          *   queue_cb_p,
+    int                             override,
+    void                        *   void_p
+    )
+{
+    /**
+     *  @param  queue_rc        Return code                                 */
+    int                             queue_rc;
+    /**
+     *  @param  queue_ring_p    Pointer to the ring                         */
+    struct  queue_ring_t        *   queue_ring_p;
+    /**
+     *  @param  spin            Number of failed attempts                   */
+    int                             spin;
+    /**
+     *  @param  futex_value     Futex word value before going to sleep      */
+    unsigned int                    futex_value;
+    /**
+     *  @param  access_key      Lock key for a list                         */
+    int                             access_key;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Set the default return code.
+    queue_rc = false;
+
+    //  Get the ring.
+    queue_ring_p = queue_cb_p->ring_p;
+
+    /************************************************************************
+     *  Put the payload on the ring
+     ************************************************************************/
+
+    for ( spin = 0; queue_rc == false; spin ++ )
+    {
+        //  Is the depth limit being overridden ?
+        if ( override == true )
+        {
+            //  YES:    Lock the overflow list so it can't drain under us.
+            access_key = list_user_lock( queue_cb_p->queue_base_p );
+
+            //  Is the overflow list empty and is there room on the ring ?
+            if (    ( atomic_load( &queue_ring_p->overflow_count ) == 0 )
+                 && ( QUEUE__ring_try_put( queue_ring_p, void_p ) == true ) )
+            {
+                //  YES:    Done.
+                queue_rc = true;
+            }
+            else
+            {
+                //  NO:     Put it at the end of the overflow list.
+                queue_rc = list_fput_last( queue_cb_p->queue_base_p,
+                                           void_p, access_key );
+                atomic_fetch_add( &queue_ring_p->overflow_count, 1 );
+            }
+
+            //  Release the list.
+            list_user_unlock( queue_cb_p->queue_base_p, access_key );
+        }
+
+        //  Is the overflow list empty and is there room on the ring ?
+        else if (    ( atomic_load( &queue_ring_p->overflow_count ) == 0 )
+                  && ( QUEUE__ring_try_put( queue_ring_p, void_p ) == true ) )
+        {
+            //  YES:    Done.
+            queue_rc = true;
+        }
+
+        //  Should we keep spinning ?
+        else if ( spin < QUEUE_RING_SPIN )
+        {
+            //  YES:    Give the consumers a moment.
+            QUEUE_CPU_RELAX( );
+        }
+
+        else
+        {
+            //  NO:     Tell the consumers somebody is waiting.
+            atomic_fetch_add( &queue_ring_p->enqueue_waiters, 1 );
+            futex_value = atomic_load( &queue_ring_p->not_full );
+
+            //  Last chance.  Did a slot open up ?
+            if (    ( atomic_load( &queue_ring_p->overflow_count ) == 0 )
+                 && ( QUEUE__ring_try_put( queue_ring_p, void_p ) == true ) )
+            {
+                //  YES:    Done.
+                queue_rc = true;
+            }
+            else
+            {
+                //  NO:     Set the waiting flag so DeQueue can wake us up
+                queue_cb_p->msg_enqueue_state = MSGQSTATE_ENQUEUE_BLOCK;
+
+                //  Log the state change
+                log_write( MID_DEBUG_0, "QUEUE__ring_put",
+                              "[ %03d ] Thread block [DEPTH = %d]\n",
+                              queue_cb_p->queue_id,
+                              QUEUE__ring_get_count( queue_ring_p ) );
+
+                //  Wait for a consumer to make room.
+                QUEUE__futex_wait( &queue_ring_p->not_full, futex_value );
+
+                //  Change the EnQueue state to idle.
+                queue_cb_p->msg_enqueue_state = MSGQSTATE_IDLE;
+
+                //  Log the state change
+                log_write( MID_DEBUG_0, "QUEUE__ring_put",
+                              "[ %03d ] Thread resume [DEPTH = %d]\n",
+                              queue_cb_p->queue_id,
+                              QUEUE__ring_get_count( queue_ring_p ) );
+
+                //  Start spinning again.
+                spin = 0;
+            }
+
+            //  No longer waiting.
+            atomic_fetch_sub( &queue_ring_p->enqueue_waiters, 1 );
+        }
+    }
+
+    /************************************************************************
+     *  Signal the receive thread there is a new payload
+     ************************************************************************/
+
+    //  Wake a consumer if one is sleeping.
+    QUEUE__ring_signal_not_empty( queue_ring_p, 1 );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( queue_rc );
+}
+
+/****************************************************************************/
+/**
+ *  Get the next payload from a ring queue, waiting while the queue is empty.
+ *
+ *  @param  queue_cb_p      Pointer to a queue control block
+ *
+ *  @return void_p          A pointer to a payload.
+ *
+ *  @note
+ *      An empty ring is retried QUEUE_RING_SPIN times before the thread
+ *      sleeps.
+ *
+ ****************************************************************************/
+
+void    *
+QUEUE__ring_get(
+    struct  queue_cb_t          *   queue_cb_p
+    )
+{
+    /**
+     *  @param  queue_ring_p    Pointer to the ring                         */
+    struct  queue_ring_t        *   queue_ring_p;
+    /**
+     *  @param  void_p          Pointer to the return information           */
+    void                        *   void_p;
+    /**
+     *  @param  found           TRUE once a payload has been removed        */
+    int                             found;
+    /**
+     *  @param  spin            Number of failed attempts                   */
+    int                             spin;
+    /**
+     *  @param  futex_value     Futex word value before going to sleep      */
+    unsigned int                    futex_value;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Nothing found yet.
+    void_p = NULL;
+    found  = false;
+
+    //  Get the ring.
+    queue_ring_p = queue_cb_p->ring_p;
+
+    /************************************************************************
+     *  Get the payload from the ring
+     ************************************************************************/
+
+    for ( spin = 0; found == false; spin ++ )
+    {
+        //  Is there anything on the ring ?
+        if ( QUEUE__ring_try_get( queue_ring_p, &void_p ) == true )
+        {
+            //  YES:    Done.
+            found = true;
+        }
+
+        //  Was anything moved from the overflow list to the ring ?
+        else if ( QUEUE__ring_refill( queue_cb_p ) > 0 )
+        {
+            //  YES:    Try the ring again.
+            spin = 0;
+        }
+
+        //  Should we keep spinning ?
+        else if ( spin < QUEUE_RING_SPIN )
+        {
+            //  YES:    Give the producers a moment.
+            QUEUE_CPU_RELAX( );
+        }
+
+        else
+        {
+            //  NO:     Tell the producers somebody is waiting.
+            atomic_fetch_add( &queue_ring_p->dequeue_waiters, 1 );
+            futex_value = atomic_load( &queue_ring_p->not_empty );
+
+            //  Last chance.  Did something show up ?
+            if ( QUEUE__ring_try_get( queue_ring_p, &void_p ) == true )
+            {
+                //  YES:    Done.
+                found = true;
+            }
+
+            //  Is there something on the overflow list ?
+            else if ( atomic_load( &queue_ring_p->overflow_count ) > 0 )
+            {
+                //  YES:    Go back and move it to the ring.
+                spin = 0;
+            }
+            else
+            {
+                //  NO:     Change the queue state to waiting.
+                queue_cb_p->msg_dequeue_state = MSGQSTATE_DEQUEUE_BLOCK;
+
+                //  Log the state change
+                log_write( MID_DEBUG_0, "QUEUE__ring_get",
+                              "[ %03d ] Thread block [DEPTH = %d]\n",
+                              queue_cb_p->queue_id,
+                              QUEUE__ring_get_count( queue_ring_p ) );
+
+                //  Wait for a producer to put something on the ring.
+                QUEUE__futex_wait( &queue_ring_p->not_empty, futex_value );
+
+                //  Change the queue state to idle.
+                queue_cb_p->msg_dequeue_state = MSGQSTATE_IDLE;
+
+                //  Log the state change
+                log_write( MID_DEBUG_0, "QUEUE__ring_get",
+                              "[ %03d ] Thread resume [DEPTH = %d]\n",
+                              queue_cb_p->queue_id,
+                              QUEUE__ring_get_count( queue_ring_p ) );
+
+                //  Start spinning again.
+                spin = 0;
+            }
+
+            //  No longer waiting.
+            atomic_fetch_sub( &queue_ring_p->dequeue_waiters, 1 );
+        }
+    }
+
+    /************************************************************************
+     *  Signal the send thread there is room
+     ************************************************************************/
+
+    //  Fill the free slot from the overflow list first.
+    QUEUE__ring_refill( queue_cb_p );
+
+    //  Wake a producer if one is sleeping.
+    QUEUE__ring_signal_not_full( queue_ring_p, 1 );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  Return the payload pointer.
+    return( void_p );
+}
+
+/****************************************************************************/
+/****************************************************************************/
+/**
+ *  Put a batch of payloads on a ring queue.
+ *
+ *  @param  queue_cb_p      Pointer to a queue control block
+ *  @param  void_pp         Array of payload pointers.
+ *  @param  count           Number of payload pointers in the array.
+ *
+ *  @return put_count       Number of payloads put on the queue.
+ *
+ *  @note
+ *      Consumers are only signaled once for the whole batch, unless the
+ *      ring fills up part way through.  Then the payloads put so far are
+ *      signaled and the remainder waits for room like QUEUE__ring_put().
+ *
+ ****************************************************************************/
+
+int
+QUEUE__ring_put_batch(
+    struct  queue_cb_t          *   queue_cb_p,
+    void                        **  void_pp,
+    int                             count
+    )
+{
+    /**
+     *  @param  put_count       Number of payloads put on the queue         */
+    int                             put_count;
+    /**
+     *  @param  signal_count    Payloads put but not yet signaled           */
+    int                             signal_count;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Nothing has been put yet.
+    put_count    = 0;
+    signal_count = 0;
+
+    /************************************************************************
+     *  Put the payloads on the ring
+     ************************************************************************/
+
+    while ( put_count < count )
+    {
+        //  Is the overflow list empty and is there room on the ring ?
+        if (    ( atomic_load( &queue_cb_p->ring_p->overflow_count ) == 0 )
+             && ( QUEUE__ring_try_put( queue_cb_p->ring_p,
+                                       void_pp[ put_count ] ) == true ) )
+        {
+            //  YES:    On to the next one.
+            put_count    += 1;
+            signal_count += 1;
+        }
+        else
+        {
+            //  NO:     Let the consumers have what we have put so far.
+            if ( signal_count > 0 )
+            {
+                QUEUE__ring_signal_not_empty( queue_cb_p->ring_p,
+                                              signal_count );
+                signal_count = 0;
+            }
+
+            //  Wait for room and put this one.
+            QUEUE__ring_put( queue_cb_p, false, void_pp[ put_count ] );
+            put_count += 1;
+        }
+    }
+
+    /************************************************************************
+     *  Signal the receive thread(s) there are new payloads
+     ************************************************************************/
+
+    //  Is there anything left to signal ?
+    if ( signal_count > 0 )
+    {
+        //  YES:    Wake the consumers.
+        QUEUE__ring_signal_not_empty( queue_cb_p->ring_p, signal_count );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( put_count );
+}
+
+/****************************************************************************/
+/**
+ *  Get a batch of payloads from a ring queue.
+ *
+ *  @param  queue_cb_p      Pointer to a queue control block
+ *  @param  void_pp         Array the payload pointers are returned in.
+ *  @param  max_count       Number of entries in the array.
+ *  @param  mode            QUEUE_WAIT to wait for at least one payload,
+ *                          QUEUE_NO_WAIT to return immediately.
+ *
+ *  @return get_count       Number of payloads removed from the queue.
+ *
+ *  @note
+ *
+ ****************************************************************************/
+
+int
+QUEUE__ring_get_batch(
+    struct  queue_cb_t          *   queue_cb_p,
+    void                        **  void_pp,
+    int                             max_count,
+    enum    queue_get_mode_e        mode
+    )
+{
+    /**
+     *  @param  get_count       Number of payloads removed from the queue   */
+    int                             get_count;
+    /**
+     *  @param  signal_count    Payloads removed but not yet signaled       */
+    int                             signal_count;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Nothing has been removed yet.
+    get_count    = 0;
+    signal_count = 0;
+
+    /************************************************************************
+     *  Get the payloads from the ring
+     ************************************************************************/
+
+    while ( get_count < max_count )
+    {
+        //  Is there anything on the ring ?
+        if ( QUEUE__ring_try_get( queue_cb_p->ring_p,
+                                  &void_pp[ get_count ] ) == true )
+        {
+            //  YES:    On to the next one.
+            get_count    += 1;
+            signal_count += 1;
+        }
+
+        //  Was anything moved from the overflow list to the ring ?
+        else if ( QUEUE__ring_refill( queue_cb_p ) > 0 )
+        {
+            //  YES:    Try the ring again.
+        }
+
+        //  Should we wait for the first payload ?
+        else if (    ( get_count ==          0 )
+                  && ( mode      == QUEUE_WAIT ) )
+        {
+            //  YES:    Wait for a payload.
+            void_pp[ get_count ] = QUEUE__ring_get( queue_cb_p );
+            get_count += 1;
+        }
+
+        else
+        {
+            //  NO:     The queue is empty.
+            break;
+        }
+    }
+
+    /************************************************************************
+     *  Signal the send thread(s) there is room
+     ************************************************************************/
+
+    //  Is there anything left to signal ?
+    if ( signal_count > 0 )
+    {
+        //  YES:    Fill the free slots from the overflow list first.
+        QUEUE__ring_refill( queue_cb_p );
+
+        //  Wake the producers.
+        QUEUE__ring_signal_not_full( queue_cb_p->ring_p, signal_count );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( get_count );
+}
+
+/****************************************************************************/
+/**
+ *  Put a batch of payloads on the queue.
+ *
+ *  @param  queue_id        A Queue-ID number (handle)
+ *  @param  void_pp         Array of payload pointers.
+ *  @param  count           Number of payload pointers in the array.
+ *
+ *  @return put_count       Number of payloads put on the queue.  When less
+ *                          then zero see queue_rc_e for a list of failure
+ *                          codes.
+ *
+ *  @note
+ *      The list lock is taken, the receive thread is signaled and the
+ *      state changes are logged once for each group of payloads instead of
+ *      once per payload.  When the queue has a depth limit the batch is
+ *      split into groups that fit, waiting for room in between.
+ *
+ ****************************************************************************/
+
+int
+QUEUE__put_batch(
+    int                             queue_id,
+    void                        **  void_pp,
+    int                             count
+    )
+{
+    /**
+     *  @param  put_count       Number of payloads put / return code        */
+    int                             put_count;
+    /**
+     *  @param  queue_cb_p      Pointer to a queue control block            */
+    struct  queue_cb_t          *   queue_cb_p;
+    /**
+     *  @param  group_count     Number of payloads in this group            */
+    int                             group_count;
+    /**
+     *  @param  access_key      Lock key for a list                         */
+    int                             access_key;
+    /**
+     *  @param  ndx             Index into the group                        */
+    int                             ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Nothing has been put yet.
+    put_count = 0;
+
+    /************************************************************************
+     *  Locate the Queue control block for the queue.
+     ************************************************************************/
+
+    //  Get the queue base for the requested Queue-ID
+    queue_cb_p = QUEUE__find_queue_cb( queue_id );
+
+    //  Did we find a Queue-ID match ?
+    if ( queue_cb_p == NULL )
+    {
+        //  NO:     It doesn't exist.
+        put_count = QUEUE_RC_NO_MATCHING_QUEUE_ID;
+    }
+
+    /************************************************************************
+     *  Put the batch on a fixed depth (ring) queue
+     ************************************************************************/
+
+    //  Is this a ring queue ?
+    else if ( queue_cb_p->ring_p != NULL )
+    {
+        //  YES:    The ring handles the depth limit and all signaling.
+        put_count = QUEUE__ring_put_batch( queue_cb_p, void_pp, count );
+    }
+
+    /************************************************************************
+     *  Append the batch to the end of the queue
+     ************************************************************************/
+
+    else
+    {
+        while ( put_count < count )
+        {
+            //  Assume everything that is left will fit.
+            group_count = count - put_count;
+
+            //  Does the queue have a depth limit ?
+            if ( queue_cb_p->queue_depth != 0 )
+            {
+                //  YES:    Lock the EnQueue side of the Queue-ID.
+                pthread_mutex_lock( &queue_cb_p->enqueue_lock );
+
+                //  Is the queue full ?
+                if ( queue_cb_p->queue_state.queue_msg_count >= queue_cb_p->queue_depth )
+                {
+                    //  YES:    Set the waiting flag so DeQueue can wake us up
+                    queue_cb_p->msg_enqueue_state = MSGQSTATE_ENQUEUE_BLOCK;
+
+                    //  Log the state change
+                    log_write( MID_DEBUG_0, "QUEUE__put_batch",
+                                  "[ %03d ] Thread block [DEPTH = %d]\n",
+                                  queue_id,
+                                  queue_cb_p->queue_state.queue_msg_count );
+
+                    // Wait for a signal that there is room in the queue.
+                    pthread_cond_wait( &queue_cb_p->enqueue_signal,
+                                       &queue_cb_p->enqueue_lock );
+
+                    //  Change the EnQueue state to idle.
+                    queue_cb_p->msg_enqueue_state = MSGQSTATE_IDLE;
+
+                    //  Log the state change
+                    log_write( MID_DEBUG_0, "QUEUE__put_batch",
+                                  "[ %03d ] Thread resume [DEPTH = %d]\n",
+                                  queue_id,
+                                  queue_cb_p->queue_state.queue_msg_count );
+                }
+
+                //  Only put as many as there is room for.
+                if ( group_count > queue_cb_p->queue_depth
+                                 - queue_cb_p->queue_state.queue_msg_count )
+                {
+                    group_count = queue_cb_p->queue_depth
+                                - queue_cb_p->queue_state.queue_msg_count;
+                }
+
+                //  Unlock the EnQueue side of the queue.
+                pthread_mutex_unlock( &queue_cb_p->enqueue_lock );
+            }
+
+            //  Is there room for anything ?
+            if ( group_count > 0 )
+            {
+                //  YES:    Lock the list once for the whole group.
+                access_key = list_user_lock( queue_cb_p->queue_base_p );
+
+                //  Append the group to the end of the queue
+                for ( ndx = 0;
+                      ndx < group_count;
+                      ndx ++ )
+                {
+                    list_fput_last( queue_cb_p->queue_base_p,
+                                    void_pp[ put_count + ndx ], access_key );
+                }
+
+                //  Increment the number of payloads in the queue.
+                queue_cb_p->queue_state.queue_msg_count += group_count;
+
+                //  Release the list.
+                list_user_unlock( queue_cb_p->queue_base_p, access_key );
+
+                //  Count them.
+                put_count += group_count;
+
+                //  Is the receive thread waiting for another payload ?
+                if ( queue_cb_p->msg_dequeue_state == MSGQSTATE_DEQUEUE_BLOCK )
+                {
+                    //  YES:    Lock the DeQueue side of the Queue-ID.
+                    pthread_mutex_lock( &queue_cb_p->dequeue_lock );
+
+                    //  Wake up the DeQueue side.
+                    pthread_cond_broadcast( &queue_cb_p->dequeue_signal );
+
+                    //  Release the queue lock.
+                    pthread_mutex_unlock( &queue_cb_p->dequeue_lock );
+                }
+            }
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( put_count );
+}
+
+/****************************************************************************/
+/**
+ *  Get a batch of payloads from a queue.
+ *
+ *  @param  queue_id        A Queue-ID number (handle)
+ *  @param  void_pp         Array the payload pointers are returned in.
+ *  @param  max_count       Number of entries in the array.
+ *  @param  mode            QUEUE_WAIT to wait for at least one payload,
+ *                          QUEUE_NO_WAIT to return immediately.
+ *
+ *  @return get_count       Number of payloads removed from the queue.  When
+ *                          less then zero see queue_rc_e for a list of
+ *                          failure codes.
+ *
+ *  @note
+ *
+ ****************************************************************************/
+
+int
+QUEUE__get_batch(
+    int                             queue_id,
+    void                        **  void_pp,
+    int                             max_count,
+    enum    queue_get_mode_e        mode
+    )
+{
+    /**
+     *  @param  get_count       Number of payloads removed / return code    */
+    int                             get_count;
+    /**
+     *  @param  queue_cb_p      Pointer to a queue control block            */
+    struct  queue_cb_t          *   queue_cb_p;
+    /**
+     *  @param  access_key      Lock key for a list                         */
+    int                             access_key;
+    /**
+     *  @param  void_p          Pointer to a payload                        */
+    void                        *   void_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  Nothing has been removed yet.
+    get_count = 0;
+
+    /************************************************************************
+     *  Locate the Queue control block for the queue.
+     ************************************************************************/
+
+    //  Get the queue base for the requested Queue-ID
+    queue_cb_p = QUEUE__find_queue_cb( queue_id );
+
+    //  Did we find a Queue-ID match ?
+    if ( queue_cb_p == NULL )
+    {
+        //  NO:     It doesn't exist.
+        get_count = QUEUE_RC_NO_MATCHING_QUEUE_ID;
+    }
+
+    /************************************************************************
+     *  Get the batch from a fixed depth (ring) queue
+     ************************************************************************/
+
+    //  Is this a ring queue ?
+    else if ( queue_cb_p->ring_p != NULL )
+    {
+        //  YES:    The ring handles waiting and all signaling.
+        get_count = QUEUE__ring_get_batch( queue_cb_p, void_pp,
+                                           max_count, mode );
+    }
+
+    /************************************************************************
+     *  Get the batch from the front of the queue
+     ************************************************************************/
+
+    else
+    {
+        while (    ( get_count ==         0 )
+                && ( max_count >          0 ) )
+        {
+            //  Is there anything on in the queue ?
+            if ( queue_cb_p->queue_state.queue_msg_count == 0 )
+            {
+                //  NO:     Should we wait for something ?
+                if ( mode == QUEUE_NO_WAIT )
+                {
+                    //  NO:     Done.
+                    break;
+                }
+
+                //  Lock the DeQueue side of the Queue-ID.
+                pthread_mutex_lock( &queue_cb_p->dequeue_lock );
+
+                //  Change the queue state to waiting.
+                queue_cb_p->msg_dequeue_state = MSGQSTATE_DEQUEUE_BLOCK;
+
+                //  Log the state change
+                log_write( MID_DEBUG_0, "QUEUE__get_batch",
+                              "[ %03d ] Thread block [DEPTH = %d]\n",
+                              queue_id,
+                              queue_cb_p->queue_state.queue_msg_count );
+
+                // Wait for a signal that there is a new payload in the queue.
+                pthread_cond_wait( &queue_cb_p->dequeue_signal,
+                                   &queue_cb_p->dequeue_lock );
+
+                //  Change the queue state to idle.
+                queue_cb_p->msg_dequeue_state = MSGQSTATE_IDLE;
+
+                //  Log the state change
+                log_write( MID_DEBUG_0, "QUEUE__get_batch",
+                              "[ %03d ] Thread resume [DEPTH = %d]\n",
+                              queue_id,
+                              queue_cb_p->queue_state.queue_msg_count );
+
+                //  Release the DeQueue lock.
+                pthread_mutex_unlock( &queue_cb_p->dequeue_lock );
+            }
+
+            //  Lock the list once for the whole batch.
+            access_key = list_user_lock( queue_cb_p->queue_base_p );
+
+            //  Take payloads from the front of the queue.
+            //  @NOTE   list_fdelete() leaves the fast key before the first
+            //          bucket so list_fget_next() returns the new first.
+            for ( void_p = list_fget_first( queue_cb_p->queue_base_p, access_key );
+                  ( void_p != NULL ) && ( get_count < max_count );
+                  void_p = list_fget_next( queue_cb_p->queue_base_p, void_p, access_key ) )
+            {
+                list_fdelete( queue_cb_p->queue_base_p, void_p, access_key );
+                void_pp[ get_count ++ ] = void_p;
+            }
+
+            //  Decrement the number of payloads in the queue.
+            queue_cb_p->queue_state.queue_msg_count -= get_count;
+
+            //  Release the list.
+            list_user_unlock( queue_cb_p->queue_base_p, access_key );
+        }
+
+        //  Is the EnQueue side waiting ?
+        if (    ( get_count                     >                        0 )
+             && ( queue_cb_p->msg_enqueue_state == MSGQSTATE_ENQUEUE_BLOCK ) )
+        {
+            //  YES:    Lock the EnQueue side of the Queue-ID.
+            pthread_mutex_lock( &queue_cb_p->enqueue_lock );
+
+            //  YES:    Wake up the EnQueue side.
+            pthread_cond_broadcast( &queue_cb_p->enqueue_signal );
+
+            //  Release the EnQueue lock.
+            pthread_mutex_unlock( &queue_cb_p->enqueue_lock );
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  All done.
+    return( get_count );
+}
+
+/****************************************************************************/
@@ -31,7 +31,10 @@
  ****************************************************************************/
 
                                 //*******************************************
+#include <stdint.h>             //  Alternative storage types
 #include <pthread.h>            //  pthread_*( );
+#include <stdatomic.h>          //  atomic_*( );
+#include <sched.h>              //  sched_yield( );
                                 //*******************************************
 
 /****************************************************************************
@@ -46,6 +49,31 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+/**
+ *  @param  QUEUE_RING_SPIN     Number of times a ring queue operation is
+ *                              retried before the thread goes to sleep.    */
+#define QUEUE_RING_SPIN             (    128 )
+/**
+ *  @param  QUEUE_RING_MIN_DEPTH    Smallest queue depth that uses a ring.  */
+#define QUEUE_RING_MIN_DEPTH        (      2 )
+//----------------------------------------------------------------------------
+/**
+ *  @param  QUEUE_ID_TABLE_L    Starting size of the Queue-ID lookup table.
+ *                              The table doubles whenever it fills up.     */
+#define QUEUE_ID_TABLE_L            (     64 )
+/**
+ *  @param  QUEUE_NAME_HASH_L   Starting number of Queue-Name hash table
+ *                              entries.  MUST be a power of two.  The table
+ *                              doubles before it is half full.             */
+#define QUEUE_NAME_HASH_L           (    128 )
+//----------------------------------------------------------------------------
+/**
+ *  @param  QUEUE_CPU_RELAX     Tell the CPU we are in a spin loop          */
+#if defined( __x86_64__ ) || defined( __i386__ )
+    #define QUEUE_CPU_RELAX( )      __builtin_ia32_pause( )
+#else
+    #define QUEUE_CPU_RELAX( )      sched_yield( )
+#endif
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -66,6 +94,72 @@ enum    msg_queue_state_e
  * Library Private Structures
  ****************************************************************************/
 
+//----------------------------------------------------------------------------
+/**
+ *  @param  queue_table_t       A lookup table of queue control blocks that
+ *                              is read without a lock.                     */
+struct  queue_table_t
+{
+    /**
+     *  @param  retired_p       The smaller table this one replaced.  It is
+     *                          kept because a lock-free reader may still be
+     *                          using it.                                   */
+    struct  queue_table_t       *   retired_p;
+    /**
+     *  @param  table_l         Number of entries in the table              */
+    int                             table_l;
+    /**
+     *  @param  cb_p            The entries                                 */
+    _Atomic( struct queue_cb_t * )  cb_p[ ];
+};
+//----------------------------------------------------------------------------
+/**
+ *  @param  queue_slot_t        One payload slot of a ring queue.           */
+struct  queue_slot_t
+{
+    /**
+     *  @param  sequence        Slot sequence number.  Tells producers and
+     *                          consumers whose turn it is to use the slot. */
+    atomic_size_t                   sequence;
+    /**
+     *  @param  payload_p       The payload pointer                         */
+    void                        *   payload_p;
+};
+//----------------------------------------------------------------------------
+/**
+ *  @param  queue_ring_t        A bounded lock-free multi-producer
+ *                              multi-consumer ring of payload pointers.    */
+struct  queue_ring_t
+{
+    /**
+     *  @param  enqueue_pos     Next position a producer will fill          */
+    atomic_size_t                   enqueue_pos;
+    /**
+     *  @param  dequeue_pos     Next position a consumer will empty         */
+    atomic_size_t                   dequeue_pos;
+    /**
+     *  @param  not_empty       Futex word changed after every EnQueue      */
+    atomic_uint                     not_empty;
+    /**
+     *  @param  not_full        Futex word changed after every DeQueue      */
+    atomic_uint                     not_full;
+    /**
+     *  @param  dequeue_waiters Number of consumers sleeping on not_empty   */
+    atomic_int                      dequeue_waiters;
+    /**
+     *  @param  enqueue_waiters Number of producers sleeping on not_full    */
+    atomic_int                      enqueue_waiters;
+    /**
+     *  @param  overflow_count  Payloads put past the ring capacity by
+     *                          queue_override_put_payload()                */
+    atomic_int                      overflow_count;
+    /**
+     *  @param  capacity        Number of slots (the queue depth)           */
+    size_t                          capacity;
+    /**
+     *  @param  slot_p          The slots                                   */
+    struct  queue_slot_t        *   slot_p;
+};
 //----------------------------------------------------------------------------
 struct  queue_cb_t
 {
@@ -79,6 +173,12 @@ struct  queue_cb_t
     pthread_cond_t                  enqueue_signal;
 
     struct  list_base_t         *   queue_base_p;
+    /**
+     *  @param  ring_p          Lock-free ring used in place of queue_base_p
+     *                          when the queue has a fixed depth.  For a ring
+     *                          queue, queue_base_p only holds payloads put
+     *                          past the depth by an override put.          */
+    struct  queue_ring_t        *   ring_p;
     /**
      *  @param  msg_dequeue_state                                           */
     enum    msg_queue_state_e       msg_dequeue_state;
@@ -109,6 +209,23 @@ QUEUE_EXT
 QUEUE_EXT
     int                             last_used_queue_id;
 //----------------------------------------------------------------------------
+/**
+ *  @param  queue_id_table_p    Queue control blocks indexed by Queue-ID.
+ *                              Entries are published once by QUEUE__new()
+ *                              and never change so they are read without
+ *                              a lock.  A full table is replaced by a
+ *                              larger copy.                                */
+QUEUE_EXT
+    _Atomic( struct queue_table_t * )   queue_id_table_p;
+//----------------------------------------------------------------------------
+/**
+ *  @param  queue_name_hash_p   Open addressing hash table of queue control
+ *                              blocks keyed by the (expanded) Queue-Name.
+ *                              Replaced by a larger copy before it is half
+ *                              full.                                       */
+QUEUE_EXT
+    _Atomic( struct queue_table_t * )   queue_name_hash_p;
+//----------------------------------------------------------------------------
 
 /****************************************************************************
  * Library Private Prototypes
@@ -120,6 +237,31 @@ QUEUE__verify_queue_name(
     char                        *   queue_name_p
     );
 //----------------------------------------------------------------------------
+uint32_t
+QUEUE__name_hash(
+    char                        *   queue_name
+    );
+//----------------------------------------------------------------------------
+struct  queue_table_t *
+QUEUE__table_new(
+    int                             table_l
+    );
+//----------------------------------------------------------------------------
+void
+QUEUE__id_table_put(
+    struct  queue_cb_t          *   queue_cb_p
+    );
+//----------------------------------------------------------------------------
+void
+QUEUE__name_hash_put(
+    struct  queue_cb_t          *   queue_cb_p
+    );
+//----------------------------------------------------------------------------
+struct  queue_cb_t *
+QUEUE__find_queue_cb(
+    int                             queue_id
+    );
+//----------------------------------------------------------------------------
 int
 QUEUE__find_queue_name(
     char                        *   queue_name_p
@@ -148,6 +290,99 @@ QUEUE__get_payload(
     int                             queue_id
     );
 //----------------------------------------------------------------------------
+void
+QUEUE__futex_wait(
+    atomic_uint                 *   futex_p,
+    unsigned int                    value
+    );
+//----------------------------------------------------------------------------
+void
+QUEUE__futex_wake(
+    atomic_uint                 *   futex_p,
+    int                             count
+    );
+//----------------------------------------------------------------------------
+struct  queue_ring_t    *
+QUEUE__ring_new(
+    int                             queue_depth
+    );
+//----------------------------------------------------------------------------
+int
+QUEUE__ring_get_count(
+    struct  queue_ring_t        *   queue_ring_p
+    );
+//----------------------------------------------------------------------------
+int
+QUEUE__ring_try_put(
+    struct  queue_ring_t        *   queue_ring_p,
+    void                        *   void_p
+    );
+//----------------------------------------------------------------------------
+int
+QUEUE__ring_try_get(
+    struct  queue_ring_t        *   queue_ring_p,
+    void                        **  void_pp
+    );
+//----------------------------------------------------------------------------
+int
+QUEUE__ring_refill(
+    struct  queue_cb_t          *   queue_cb_p
+    );
+//----------------------------------------------------------------------------
+void
+QUEUE__ring_signal_not_empty(
+    struct  queue_ring_t        *   queue_ring_p,
+    int                             count
+    );
+//----------------------------------------------------------------------------
+void
+QUEUE__ring_signal_not_full(
+    struct  queue_ring_t        *   queue_ring_p,
+    int                             count
+    );
+//----------------------------------------------------------------------------
+int
+QUEUE__ring_put(
+    struct  queue_cb_t          *   queue_cb_p,
+    int                             override,
+    void                        *   void_p
+    );
+//----------------------------------------------------------------------------
+void    *
+QUEUE__ring_get(
+    struct  queue_cb_t          *   queue_cb_p
+    );
+//----------------------------------------------------------------------------
+int
+QUEUE__ring_put_batch(
+    struct  queue_cb_t          *   queue_cb_p,
+    void                        **  void_pp,
+    int                             count
+    );
+//----------------------------------------------------------------------------
+int
+QUEUE__ring_get_batch(
+    struct  queue_cb_t          *   queue_cb_p,
+    void                        **  void_pp,
+    int                             max_count,
+    enum    queue_get_mode_e        mode
+    );
+//----------------------------------------------------------------------------
+int
+QUEUE__put_batch(
+    int                             queue_id,
+    void                        **  void_pp,
+    int                             count
+    );
+//----------------------------------------------------------------------------
+int
+QUEUE__get_batch(
+    int                             queue_id,
+    void                        **  void_pp,
+    int                             max_count,
+    enum    queue_get_mode_e        mode
+    );
+//----------------------------------------------------------------------------
 
 /****************************************************************************/
 
@@ -196,26 +196,18 @@ text_to_uppercase(
     char                        *   text_p
     )
 {
-    int                             index;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
+    TEXT__simd( );
 
     /************************************************************************
      *  Convert a text string to UPPERCASE
      ************************************************************************/
 
-    for( index = 0;
-          text_p[ index ] != '\0';
-          index ++ )
-    {
-        if( islower( text_p[ index ] ) )
-        {
-            text_p[ index ] = toupper( text_p[ index ] );
-        }
-    }
+    text_case_map_f( text_p, strlen( text_p ), 'a', 'z' );
 
     /************************************************************************
      *  Function Exit
@@ -240,26 +232,18 @@ text_to_lowercase(
     char                        *   text_p
     )
 {
-    int                             index;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
+    TEXT__simd( );
 
     /************************************************************************
-     *  Convert a text string to UPPERCASE
+     *  Convert a text string to lowercase
      ************************************************************************/
 
-    for( index = 0;
-          text_p[ index ] != '\0';
-          index ++ )
-    {
-        if( isupper( text_p[ index ] ) )
-        {
-            text_p[ index ] = tolower( text_p[ index ] );
-        }
-    }
+    text_case_map_f( text_p, strlen( text_p ), 'A', 'Z' );
 
     /************************************************************************
      *  Function Exit
@@ -951,43 +935,36 @@ text_next_word(
     )
 {
     char                          *  new_dst_string_p;
+    /**
+     *  @param  line            What is left of the source string          */
+    struct  text_view_t             line;
+    /**
+     *  @param  word            The next word                               */
+    struct  text_view_t             word;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
+    text_view_init( &line, src_string_p );
 
     /************************************************************************
      *  Function Body
      ************************************************************************/
 
-    //  Initialize the destination buffer
-    dst_string_p[ 0 ] = '\0';
-
-    //  Skip over any leading white space
-    for( new_dst_string_p = src_string_p;
-         (    ( isblank( new_dst_string_p[ 0 ] ) != 0 )
-           && ( new_dst_string_p[ 0 ] != '\0' ) );
-         new_dst_string_p ++ )
-    {
-    }
-    //  Did we just jump to the end of the line ?
-    if( new_dst_string_p[ 0 ] != '\0' )
+    //  Is there another word ?
+    if ( text_view_next_word( &line, &word ) == true )
     {
-        //  NO:     Skip over any leading white space
-        for ( ;
-              (    ( isblank( new_dst_string_p[ 0 ] ) == 0 )
-                && ( new_dst_string_p[ 0 ] != '\0' ) );
-              new_dst_string_p++ )
-        {
-            //  Copy a character from the source string buffer to the
-            //         destination string buffer.
-            strncat( dst_string_p, new_dst_string_p, 1 );
-        }
+        //  YES:    Copy it to the destination buffer
+        memcpy( dst_string_p, word.text_p, word.text_l );
+        dst_string_p[ word.text_l ] = '\0';
+
+        new_dst_string_p = (char*)line.text_p;
     }
     else
     {
         //  The source buffer is empty
+        dst_string_p[ 0 ] = '\0';
         new_dst_string_p = NULL;
     }
 
@@ -1037,6 +1014,9 @@ text_datastring_to_ascii(
     /**
      *  @param  xlate_char      ASCII character translation                 */
     char                            xlate_char;
+    /**
+     *  @param  scratch_p       Arena for the temporary buffers             */
+    struct  mem_arena_t         *   scratch_p;
 
     /************************************************************************
      *  Function Initialization
@@ -1045,13 +1025,10 @@ text_datastring_to_ascii(
     //  The size of the source data buffer
     src_data_l = ( strlen( src_data_p ) + 1 );
 
-    //  Allocate a temporary data buffer
-    render_p = mem_malloc( src_data_l );
-    log_write( MID_DEBUG_1, "text_api.c", "Line: %d\n", __LINE__ );
-
-    //  Allocate a temporary data buffer
-    tmp_p = mem_malloc( src_data_l );
-    log_write( MID_DEBUG_1, "text_api.c", "Line: %d\n", __LINE__ );
+    //  Allocate the temporary data buffers from the scratch arena
+    scratch_p = TEXT__scratch( );
+    render_p = mem_arena_alloc( scratch_p, src_data_l );
+    tmp_p = mem_arena_alloc( scratch_p, src_data_l );
 
     //  Make two copies of the source data
     memcpy( render_p, src_data_p, src_data_l );
@@ -1132,9 +1109,8 @@ text_datastring_to_ascii(
     memset( src_data_p, '\0', src_data_l );
     memcpy( src_data_p, render_p, src_data_l );
 
-    //  Release the allocated buffer
-    mem_free( tmp_p );
-    mem_free( render_p );
+    //  Release the temporary buffers
+    mem_arena_reset( scratch_p );
 
     //  DONE!
 }
@@ -1154,6 +1130,9 @@ text_datastring_to_ascii(
  *      If the buffer is not large enough to add insert the new data a
  *      hard fault is thrown.
  *  @note
+ *      The text is moved in place.  See text_insert_len() when the string
+ *      lengths are already known.
+ *  @note
  *      Sometime in the future I will want to replace the text_ndx with a text
  *      string that is to be replaced.
  *      THIS WILL NOT WORK!
@@ -1171,63 +1150,13 @@ text_insert(
     char                        *   text_data_p
     )
 {
-    /**
-     *  @param  tmp_p           Pointer to a temporary data buffer          */
-    char                        *   tmp_p;
-
-    /************************************************************************
-     *  Function Initialization
-     ************************************************************************/
-
-    //  Allocate the temporary data buffer
-    tmp_p = mem_malloc( text_buffer_l );
-
-    /************************************************************************
-     *  Verify the data will fit
-     ************************************************************************/
-
-    //  Is there enough room in the buffer ?
-    if ( text_buffer_l < ( strlen( text_buffer_p ) + strlen( text_data_p ) ) )
-    {
-        //  NO:     This is a fatal error.
-        log_write( MID_WARNING, "text_insert", "%s\n",
-                   "Text buffer is not large enough for the inserted text" );
-        log_write( MID_FATAL, "text_api.c", "Line: %d\n", __LINE__ );
-    }
 
     /************************************************************************
      *  Insert the data
      ************************************************************************/
 
-    //  Are we inserting from the buffer head ?
-    if ( text_ndx != 0 )
-    {
-        //  NO:     Then copy the buffer head to the temporary data buffer.
-        memcpy( tmp_p, text_buffer_p, text_ndx );
-    }
-
-    //  Insert the new data string into the temporary buffer
-    strncat( tmp_p, text_data_p, ( text_buffer_l - strlen( tmp_p ) ) );
-
-    //  Are we inserting a tail to the buffer ?
-    if ( text_ndx < strlen( text_buffer_p ) )
-    {
-        //  NO:     Copy the buffer tail to the temporary data buffer.
-        strncat( tmp_p, &text_buffer_p[ text_ndx ],
-                 ( text_buffer_l - strlen( tmp_p ) ) );
-    }
-
-    //  Wipe the source buffer clean
-    memset( text_buffer_p, '\0', text_buffer_l );
-
-    //  Finally, put the new string in the old buffer.
-    memcpy( text_buffer_p, tmp_p, strlen( tmp_p ) );
-
-    /************************************************************************
-     *  Function Cleanup
-     ************************************************************************/
-
-    mem_free( tmp_p );
+    text_insert_len( text_buffer_p, text_buffer_l, strlen( text_buffer_p ),
+                     text_ndx, text_data_p, strlen( text_data_p ) );
 
     /************************************************************************
      *  Function Exit
@@ -1247,6 +1176,9 @@ text_insert(
  *  @return void
  *
  *  @note
+ *      The text is moved in place.  See text_remove_len() when the string
+ *      length is already known.
+ *  @note
  *      Sometime in the future I will want to replace the text_ndx with a text
  *      string that is to be replaced.
  *      THIS WILL NOT WORK!
@@ -1263,54 +1195,13 @@ text_remove(
     int                             text_remove_l
     )
 {
-    /**
-     *  @param  tmp_p           Pointer to a temporary data buffer          */
-    char                        *   tmp_p;
-    /**
-     *  @param  text_buffer_l   Number of bytes in the text data buffer     */
-    int                             text_buffer_l;
-
-    /************************************************************************
-     *  Function Initialization
-     ************************************************************************/
-
-    //  set the size of the text buffer.
-    text_buffer_l = strlen( text_buffer_p );
-
-    //  Allocate the temporary data buffer
-    tmp_p = mem_malloc( text_buffer_l + 1 );
 
     /************************************************************************
      *  Remove the data
      ************************************************************************/
 
-    //  Are we removing from the buffer head ?
-    if ( text_ndx != 0 )
-    {
-        //  NO:     Then copy the buffer head to the temporary data buffer.
-        memcpy( tmp_p, text_buffer_p, text_ndx );
-    }
-
-    //  Are we removing the tail of the buffer ?
-    if ( ( text_ndx + text_remove_l ) < text_buffer_l )
-    {
-        //  NO:     Copy the buffer tail to the temporary data buffer.
-        strncat( &tmp_p[ text_ndx ],
-                 &text_buffer_p[ text_ndx + text_remove_l ],
-                 ( text_buffer_l - strlen( tmp_p ) ) );
-    }
-
-    //  Wipe the source buffer clean
-    memset( text_buffer_p, '\0', text_buffer_l );
-
-    //  Finally, put the new string in the old buffer.
-    memcpy( text_buffer_p, tmp_p, strlen( tmp_p ) );
-
-    /************************************************************************
-     *  Function Cleanup
-     ************************************************************************/
-
-    mem_free( tmp_p );
+    text_remove_len( text_buffer_p, strlen( text_buffer_p ),
+                     text_ndx, text_remove_l );
 
     /************************************************************************
      *  Function Exit
@@ -1335,6 +1226,9 @@ text_remove(
  *      If the buffer is not large enough to add insert the new data a
  *      hard fault is thrown.
  *  @note
+ *      The text is moved in place.  See text_replace_len() when the string
+ *      lengths are already known.
+ *  @note
  *      Sometime in the future I will want to replace the text_ndx with a text
  *      string that is to be replaced.
  *      THIS WILL NOT WORK!
@@ -1354,31 +1248,187 @@ text_replace(
     )
 {
 
+    /************************************************************************
+     *  Replace the data
+     ************************************************************************/
+
+    text_replace_len( text_buffer_p, text_buffer_l, strlen( text_buffer_p ),
+                      text_ndx, text_data_p, strlen( text_data_p ),
+                      text_remove_l );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Replace text_remove_l bytes of text_buffer_p at text_ndx with
+ *  text_data_l bytes of text_data_p.
+ *
+ *  @param  text_buffer_p       Pointer to the data buffer.
+ *  @param  text_buffer_l       Size (in bytes) of the text buffer.
+ *  @param  text_l              Current length of the string in the buffer.
+ *  @param  text_ndx            Index to replace data.
+ *  @param  text_data_p         Pointer to the data to insert.
+ *  @param  text_data_l         Number of bytes of data to insert.
+ *  @param  text_remove_l       Number of bytes to remove from the buffer.
+ *
+ *  @return new_l               New length of the string in the buffer.
+ *
+ *  @note
+ *      If the buffer is not large enough to hold the new string a hard
+ *      fault is thrown.
+ *  @note
+ *      Only the tail of the string is moved, once.  Nothing is allocated.
+ *
+ ****************************************************************************/
+
+int
+text_replace_len(
+    char                        *   text_buffer_p,
+    int                             text_buffer_l,
+    int                             text_l,
+    int                             text_ndx,
+    const char                  *   text_data_p,
+    int                             text_data_l,
+    int                             text_remove_l
+    )
+{
+    /**
+     *  @param  new_l           New length of the string                    */
+    int                             new_l;
+
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
+    //  Is the index past the end of the string ?
+    if ( text_ndx > text_l )
+    {
+        //  YES:    Append to the end of the string
+        text_ndx = text_l;
+    }
+
+    //  Does the removed text run past the end of the string ?
+    if ( text_remove_l > ( text_l - text_ndx ) )
+    {
+        //  YES:    Only remove what is there
+        text_remove_l = text_l - text_ndx;
+    }
+
+    new_l = text_l - text_remove_l + text_data_l;
 
     /************************************************************************
-     *  Insert the data
+     *  Verify the data will fit
+     ************************************************************************/
+
+    //  Is there enough room in the buffer ?
+    if ( text_buffer_l < new_l )
+    {
+        //  NO:     This is a fatal error.
+        log_write( MID_WARNING, "text_replace_len", "%s\n",
+                   "Text buffer is not large enough for the inserted text" );
+        log_write( MID_FATAL, "text_api.c", "Line: %d\n", __LINE__ );
+    }
+
+    /************************************************************************
+     *  Replace the data
      ************************************************************************/
 
-    //  Remove the old text
-    text_remove( text_buffer_p, text_ndx, text_remove_l );
+    //  Move the tail of the string to where it goes
+    memmove( &text_buffer_p[ text_ndx + text_data_l ],
+             &text_buffer_p[ text_ndx + text_remove_l ],
+             text_l - text_ndx - text_remove_l );
 
-    //  Insert the new text
-    text_insert( text_buffer_p, text_buffer_l, text_ndx, text_data_p );
+    //  Put the new data in the hole
+    memcpy( &text_buffer_p[ text_ndx ], text_data_p, text_data_l );
+
+    //  Is there room for the string terminator ?
+    if ( new_l < text_buffer_l )
+    {
+        //  YES:    Terminate the string
+        text_buffer_p[ new_l ] = '\0';
+    }
 
     /************************************************************************
-     *  Function Cleanup
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( new_l );
+}
+
+/****************************************************************************/
+/**
+ *  Insert text_data_l bytes of text_data_p into text_buffer_p at text_ndx.
+ *
+ *  @param  text_buffer_p       Pointer to the data buffer.
+ *  @param  text_buffer_l       Size (in bytes) of the text buffer.
+ *  @param  text_l              Current length of the string in the buffer.
+ *  @param  text_ndx            Index to insert data.
+ *  @param  text_data_p         Pointer to the data to insert.
+ *  @param  text_data_l         Number of bytes of data to insert.
+ *
+ *  @return new_l               New length of the string in the buffer.
+ *
+ *  @note
+ *      If the buffer is not large enough to hold the new string a hard
+ *      fault is thrown.
+ *
+ ****************************************************************************/
+
+int
+text_insert_len(
+    char                        *   text_buffer_p,
+    int                             text_buffer_l,
+    int                             text_l,
+    int                             text_ndx,
+    const char                  *   text_data_p,
+    int                             text_data_l
+    )
+{
+
+    /************************************************************************
+     *  Function Exit
      ************************************************************************/
 
+    //  DONE!
+    return( text_replace_len( text_buffer_p, text_buffer_l, text_l,
+                              text_ndx, text_data_p, text_data_l, 0 ) );
+}
+
+/****************************************************************************/
+/**
+ *  Remove text_remove_l bytes from text_buffer_p at text_ndx.
+ *
+ *  @param  text_buffer_p       Pointer to the data buffer.
+ *  @param  text_l              Current length of the string in the buffer.
+ *  @param  text_ndx            Index to remove data buffer.
+ *  @param  text_remove_l       Number of bytes to remove from the buffer.
+ *
+ *  @return new_l               New length of the string in the buffer.
+ *
+ ****************************************************************************/
+
+int
+text_remove_len(
+    char                        *   text_buffer_p,
+    int                             text_l,
+    int                             text_ndx,
+    int                             text_remove_l
+    )
+{
 
     /************************************************************************
      *  Function Exit
      ************************************************************************/
 
     //  DONE!
+    return( text_replace_len( text_buffer_p, text_l + 1, text_l,
+                              text_ndx, "", 0, text_remove_l ) );
 }
 
 /****************************************************************************/
@@ -1451,6 +1501,8 @@ text_center(
  *  @return join_p              Pointer to the new data buffer
  *
  *  @note
+ *      When free_1 is TRUE string 1 is grown with mem_realloc() and string
+ *      2 appended to it, so it is often joined without a copy.
  *
  ****************************************************************************/
 
@@ -1463,41 +1515,70 @@ text_join(
     )
 {
     /**
-     *  @param  join_l              Size in bytes of the two data buffers   */
-    int                             join_l;
+     *  @param  string_1_l          Size in bytes of string-1               */
+    int                             string_1_l;
+    /**
+     *  @param  string_2_l          Size in bytes of string-2               */
+    int                             string_2_l;
     /**
      *  @param  join_p              Buffer with both string-1 and string-2  */
     char                        *   join_p;
+    /**
+     *  @param  string_2_off        Offset of string-2 inside of string-1   */
+    size_t                          string_2_off;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
+    string_1_l = strlen( string_1_p );
+    string_2_l = strlen( string_2_p );
+
+    //  Is string 2 part of string 1 ?
+    if (    ( (uintptr_t)string_2_p >= (uintptr_t)string_1_p )
+         && (    (uintptr_t)string_2_p
+              <= (uintptr_t)string_1_p + string_1_l ) )
+    {
+        //  YES:    It moves with string 1
+        string_2_off = (uintptr_t)string_2_p - (uintptr_t)string_1_p;
+    }
+    else
+    {
+        string_2_off = SIZE_MAX;
+    }
 
     /************************************************************************
      *  Insert the data
      ************************************************************************/
 
-    //  Allocate storage for both string_1 and string_2
-    join_l = strlen( string_1_p ) + strlen( string_2_p ) + 1;
+    //  Can string 1 be reused ?
+    if ( free_1 == true )
+    {
+        //  YES:    Grow it to hold both string_1 and string_2
+        join_p = mem_realloc( string_1_p, string_1_l + string_2_l + 1 );
 
-    //  Allocate storage for both string_1 and string_2
-    join_p = mem_malloc( join_l );
+        //  Did string 2 move with it ?
+        if ( string_2_off != SIZE_MAX )
+        {
+            //  YES:    The old copy may be gone
+            string_2_p = &join_p[ string_2_off ];
+        }
+    }
+    else
+    {
+        //  NO:     Allocate storage for both string_1 and string_2
+        join_p = mem_malloc_nozero( string_1_l + string_2_l + 1 );
+        memcpy( join_p, string_1_p, string_1_l );
+    }
 
-    //  Join both buffers into a single buffer
-    snprintf( join_p, join_l, "%s%s", string_1_p, string_2_p );
+    //  Append string 2
+    memcpy( &join_p[ string_1_l ], string_2_p, string_2_l );
+    join_p[ string_1_l + string_2_l ] = '\0';
 
     /************************************************************************
      *  Function Cleanup
      ************************************************************************/
 
-    //  Should we free storage for string 1 ?
-    if ( free_1 == true )
-    {
-        //  YES:    Free the data buffer
-        mem_free( string_1_p );
-    }
-
     //  Should we free storage for string 2 ?
     if ( free_2 == true )
     {
@@ -1513,3 +1594,1108 @@ text_join(
     return( join_p );
 }
 /****************************************************************************/
+
+/****************************************************************************/
+/**
+ *  Build a character class for text_find_class().
+ *
+ *  @param  class_p             Pointer to the class to be built.
+ *  @param  set_p               Up to TEXT_CLASS_SET_L single characters in
+ *                              the class, or NULL.
+ *  @param  low                 First character of a range in the class.
+ *  @param  high                Last character of a range in the class.
+ *
+ *  @return void
+ *
+ *  @note
+ *      When high is less than low the class has no range.  Only the range
+ *      can include x'00.
+ *
+ ****************************************************************************/
+
+void
+text_class_init(
+    struct  text_class_t        *   class_p,
+    const char                  *   set_p,
+    int                             low,
+    int                             high
+    )
+{
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    memset( class_p, 0x00, sizeof( struct text_class_t ) );
+
+    //  Is there a set of single characters ?
+    if ( set_p != NULL )
+    {
+        //  YES:    Will it fit ?
+        class_p->set_l = strlen( set_p );
+
+        if ( class_p->set_l > TEXT_CLASS_SET_L )
+        {
+            //  NO:     Too many characters
+            log_write( MID_FATAL, "text_class_init",
+                       "The set '%s' has more than %d characters.\n",
+                       set_p, TEXT_CLASS_SET_L );
+        }
+
+        //  Save the set
+        memcpy( class_p->set, set_p, class_p->set_l );
+    }
+
+    /************************************************************************
+     *  Build the class
+     ************************************************************************/
+
+    //  Is there a range ?
+    if ( high >= low )
+    {
+        //  YES:    Save it
+        class_p->range = true;
+        class_p->low   = low;
+        class_p->span  = high - low;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Find the first character of the text that is in a character class.
+ *
+ *  @param  text_p              Pointer to the text.
+ *  @param  text_l              Number of characters of text.
+ *  @param  class_p             Pointer to a class from text_class_init().
+ *
+ *  @return ndx                 Offset of the first character in the class
+ *                              or text_l when there is none.
+ *
+ *  @note
+ *      The search is done 16 or 32 characters at a time on processors
+ *      with SSE2 or AVX2.
+ *
+ ****************************************************************************/
+
+size_t
+text_find_class(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    )
+{
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    TEXT__simd( );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( text_find_class_f( text_p, text_l, class_p ) );
+}
+
+/****************************************************************************/
+
+/****************************************************************************/
+/**
+ *  Build a replacer that does a whole table of search and replace pairs
+ *  in a single pass over the text.
+ *
+ *  @param  pairs_p             Pointer to the search and replace pairs.
+ *  @param  pairs_n             Number of pairs.
+ *  @param  flags               TEXT_REPLACER_NOCASE or zero.
+ *
+ *  @return replacer_p          Pointer to the replacer.  Release it with
+ *                              text_replacer_free().
+ *
+ *  @note
+ *      The strings are copied so the pairs need not be kept.  When a
+ *      search string is listed more than once the first pair is used.
+ *  @note
+ *      A replacer is never changed by text_replacer_apply() so one can be
+ *      shared by any number of threads.
+ *
+ ****************************************************************************/
+
+struct  text_replacer_t *
+text_replacer_compile(
+    const struct text_pair_t    *   pairs_p,
+    int                             pairs_n,
+    int                             flags
+    )
+{
+    /**
+     *  @param  replacer_p      Pointer to the new replacer                 */
+    struct  text_replacer_t     *   replacer_p;
+    /**
+     *  @param  pair_ndx        Index into the pairs                        */
+    int                             pair_ndx;
+    /**
+     *  @param  char_ndx        Index into a search string                  */
+    int                             char_ndx;
+    /**
+     *  @param  in_char         A character of a search string              */
+    int                             in_char;
+    /**
+     *  @param  state_max       Most states the trie can need               */
+    int                             state_max;
+    /**
+     *  @param  state           Current trie state                          */
+    int32_t                         state;
+    /**
+     *  @param  next_p          Transition out of state                     */
+    int32_t                     *   next_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    replacer_p = mem_malloc( sizeof( struct text_replacer_t ) );
+
+    replacer_p->flags       = flags;
+    replacer_p->pairs_n     = pairs_n;
+    replacer_p->find_l_p    = mem_malloc( ( pairs_n + 1 ) * sizeof( int ) );
+    replacer_p->replace_l_p = mem_malloc( ( pairs_n + 1 ) * sizeof( int ) );
+    replacer_p->replace_pp  = mem_malloc( ( pairs_n + 1 ) * sizeof( char* ) );
+
+    //  Class zero is every character that is not in a search string
+    replacer_p->class_n = 1;
+    state_max = 1;
+
+    /************************************************************************
+     *  Give every character used in a search string its own class
+     ************************************************************************/
+
+    for ( pair_ndx = 0;
+          pair_ndx < pairs_n;
+          pair_ndx += 1 )
+    {
+        replacer_p->find_l_p[ pair_ndx ] = strlen( pairs_p[ pair_ndx ].find_p );
+
+        //  Is the search string empty ?
+        if ( replacer_p->find_l_p[ pair_ndx ] == 0 )
+        {
+            //  YES:    It would match everywhere
+            log_write( MID_FATAL, "text_replacer_compile",
+                       "Search string %d is empty.\n", pair_ndx );
+        }
+
+        replacer_p->replace_pp[ pair_ndx ] =
+                text_copy_to_new( (char*)pairs_p[ pair_ndx ].replace_p );
+        replacer_p->replace_l_p[ pair_ndx ] =
+                strlen( replacer_p->replace_pp[ pair_ndx ] );
+
+        for ( char_ndx = 0;
+              char_ndx < replacer_p->find_l_p[ pair_ndx ];
+              char_ndx += 1 )
+        {
+            in_char = (unsigned char)pairs_p[ pair_ndx ].find_p[ char_ndx ];
+
+            //  Is case ignored ?
+            if ( ( flags & TEXT_REPLACER_NOCASE ) != 0 )
+            {
+                //  YES:    Use the lowercase character
+                in_char = tolower( in_char );
+            }
+
+            //  Does the character have a class yet ?
+            if ( replacer_p->class_map[ in_char ] == 0 )
+            {
+                //  NO:     Give it one
+                replacer_p->class_map[ in_char ] = replacer_p->class_n++;
+            }
+        }
+
+        state_max += replacer_p->find_l_p[ pair_ndx ];
+    }
+
+    //  Is case ignored ?
+    if ( ( flags & TEXT_REPLACER_NOCASE ) != 0 )
+    {
+        //  YES:    Uppercase characters share the lowercase class
+        for ( in_char = 'A';
+              in_char <= 'Z';
+              in_char += 1 )
+        {
+            replacer_p->class_map[ in_char ] =
+                    replacer_p->class_map[ tolower( in_char ) ];
+        }
+    }
+
+    /************************************************************************
+     *  Build the trie of search strings
+     ************************************************************************/
+
+    replacer_p->delta_p = mem_malloc_nozero( state_max * replacer_p->class_n
+                                             * sizeof( int32_t ) );
+    replacer_p->depth_p = mem_malloc( state_max * sizeof( int32_t ) );
+    replacer_p->fail_p  = mem_malloc( state_max * sizeof( int32_t ) );
+    replacer_p->match_p = mem_malloc_nozero( state_max * sizeof( int32_t ) );
+
+    //  Every transition and match is missing
+    memset( replacer_p->delta_p, 0xFF,
+            state_max * replacer_p->class_n * sizeof( int32_t ) );
+    memset( replacer_p->match_p, 0xFF, state_max * sizeof( int32_t ) );
+
+    //  Start with only the root
+    replacer_p->state_n = 1;
+
+    for ( pair_ndx = 0;
+          pair_ndx < pairs_n;
+          pair_ndx += 1 )
+    {
+        //  Follow or add the states for the search string
+        for ( char_ndx = 0, state = 0;
+              char_ndx < replacer_p->find_l_p[ pair_ndx ];
+              char_ndx += 1 )
+        {
+            in_char = (unsigned char)pairs_p[ pair_ndx ].find_p[ char_ndx ];
+            next_p  = &replacer_p->delta_p[ ( state * replacer_p->class_n )
+                                   + replacer_p->class_map[ in_char ] ];
+
+            //  Is there a state for this character ?
+            if ( *next_p < 0 )
+            {
+                //  NO:     Add one
+                *next_p = replacer_p->state_n++;
+                replacer_p->depth_p[ *next_p ] = char_ndx + 1;
+            }
+
+            state = *next_p;
+        }
+
+        //  Is this the first pair with this search string ?
+        if ( replacer_p->match_p[ state ] < 0 )
+        {
+            //  YES:    This state ends it
+            replacer_p->match_p[ state ] = pair_ndx;
+        }
+    }
+
+    /************************************************************************
+     *  Turn the trie into an automaton
+     ************************************************************************/
+
+    TEXT__replacer_link( replacer_p );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( replacer_p );
+}
+
+/****************************************************************************/
+/**
+ *  Replace every search string of a replacer that is found in the text.
+ *
+ *  @param  replacer_p          Pointer to a replacer from
+ *                              text_replacer_compile().
+ *  @param  in_p                Pointer to the text.
+ *  @param  out_p               String buffer the new text is appended to.
+ *
+ *  @return replace_n           Number of replacements made.
+ *
+ *  @note
+ *      Matches do not overlap.  Where they would, the one that starts first
+ *      is used, and of those the longest.  Replacement text is never
+ *      searched again.
+ *  @note
+ *      A match is only written out once no longer or earlier match can
+ *      still be found, then the search starts over just past it.
+ *
+ ****************************************************************************/
+
+int
+text_replacer_apply(
+    const struct text_replacer_t *  replacer_p,
+    const char                  *   in_p,
+    struct  mem_strbuf_t        *   out_p
+    )
+{
+    /**
+     *  @param  replace_n       Number of replacements made                 */
+    int                             replace_n;
+    /**
+     *  @param  in_l            Length of the text                          */
+    int                             in_l;
+    /**
+     *  @param  ndx             Index of the next character to search       */
+    int                             ndx;
+    /**
+     *  @param  done_l          Characters of text already written out      */
+    int                             done_l;
+    /**
+     *  @param  state           Current automaton state                     */
+    int32_t                         state;
+    /**
+     *  @param  pair            Pair of the longest match ending here       */
+    int32_t                         pair;
+    /**
+     *  @param  found_ndx       Where the best match so far starts, or -1   */
+    int                             found_ndx;
+    /**
+     *  @param  found_pair      Pair of the best match so far               */
+    int32_t                         found_pair;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    replace_n  = 0;
+    in_l       = strlen( in_p );
+    ndx        = 0;
+    done_l     = 0;
+    state      = 0;
+    found_ndx  = -1;
+    found_pair = -1;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    while (    ( ndx       < in_l )
+            || ( found_ndx >=  0  ) )
+    {
+        //  Is there more text ?
+        if ( ndx < in_l )
+        {
+            //  YES:    Move to the next state
+            state = replacer_p->delta_p[ ( state * replacer_p->class_n )
+                        + replacer_p->class_map[ (unsigned char)in_p[ ndx ] ] ];
+            ndx  += 1;
+
+            //  Does a pattern end here that starts no later than the best ?
+            pair = replacer_p->match_p[ state ];
+
+            if (    ( pair >= 0 )
+                 && (    ( found_ndx < 0 )
+                      || ( ndx - replacer_p->find_l_p[ pair ] <= found_ndx ) ) )
+            {
+                //  YES:    It is the new best match
+                found_ndx  = ndx - replacer_p->find_l_p[ pair ];
+                found_pair = pair;
+            }
+        }
+
+        //  Can a match that is earlier or longer than the best still end
+        //  later on ?
+        if (    ( found_ndx >= 0 )
+             && (    ( ndx >= in_l )
+                  || ( ndx - replacer_p->depth_p[ state ] > found_ndx ) ) )
+        {
+            //  NO:     Write out the text before it and the replacement
+            mem_strbuf_append( out_p, &in_p[ done_l ], found_ndx - done_l );
+            mem_strbuf_append( out_p, replacer_p->replace_pp[ found_pair ],
+                               replacer_p->replace_l_p[ found_pair ] );
+            replace_n += 1;
+
+            //  Start over just past the match
+            done_l    = found_ndx + replacer_p->find_l_p[ found_pair ];
+            ndx       = done_l;
+            state     = 0;
+            found_ndx = -1;
+        }
+    }
+
+    //  Write out the rest of the text
+    mem_strbuf_append( out_p, &in_p[ done_l ], in_l - done_l );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( replace_n );
+}
+
+/****************************************************************************/
+/**
+ *  Release a replacer.
+ *
+ *  @param  replacer_p          Pointer to a replacer from
+ *                              text_replacer_compile().
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+text_replacer_free(
+    struct  text_replacer_t     *   replacer_p
+    )
+{
+    /**
+     *  @param  pair_ndx        Index into the pairs                        */
+    int                             pair_ndx;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    for ( pair_ndx = 0;
+          pair_ndx < replacer_p->pairs_n;
+          pair_ndx += 1 )
+    {
+        mem_free( replacer_p->replace_pp[ pair_ndx ] );
+    }
+
+    mem_free( replacer_p->replace_pp );
+    mem_free( replacer_p->replace_l_p );
+    mem_free( replacer_p->find_l_p );
+    mem_free( replacer_p->delta_p );
+    mem_free( replacer_p->depth_p );
+    mem_free( replacer_p->fail_p );
+    mem_free( replacer_p->match_p );
+    mem_free( replacer_p );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+
+/****************************************************************************/
+/**
+ *  Point a view at a whole string.
+ *
+ *  @param  view_p              Pointer to the view.
+ *  @param  text_p              Pointer to a NUL terminated string.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+text_view_init(
+    struct  text_view_t         *   view_p,
+    const char                  *   text_p
+    )
+{
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    view_p->text_p = text_p;
+    view_p->text_l = strlen( text_p );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Move the start of a view past any leading whitespace.
+ *
+ *  @param  view_p              Pointer to the view.
+ *
+ *  @return void
+ *
+ *  @note
+ *      Like text_skip_past_whitespace() everything but a printable
+ *      character is whitespace.
+ *
+ ****************************************************************************/
+
+void
+text_view_skip_past_whitespace(
+    struct  text_view_t         *   view_p
+    )
+{
+    /**
+     *  @param  skip_l          Number of whitespace characters             */
+    size_t                          skip_l;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    TEXT__simd( );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    skip_l = text_find_class_f( view_p->text_p, view_p->text_l,
+                                &text_graph_class );
+
+    view_p->text_p += skip_l;
+    view_p->text_l -= skip_l;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Move the end of a view in front of any trailing spaces and tabs.
+ *
+ *  @param  view_p              Pointer to the view.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+text_view_strip_whitespace(
+    struct  text_view_t         *   view_p
+    )
+{
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    TEXT__simd( );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    view_p->text_l -= text_rspan_class_f( view_p->text_p, view_p->text_l,
+                                          &text_blank_class );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Take the next word off the front of a line.
+ *
+ *  @param  line_p              Pointer to a view of the line.  It is moved
+ *                              to just past the word.
+ *  @param  word_p              Pointer to a view that is set to the word.
+ *
+ *  @return word_found          TRUE when a word was found, FALSE when the
+ *                              line holds nothing but spaces and tabs.
+ *
+ *  @note
+ *      Words are separated by spaces and tabs, the same as
+ *      text_next_word(), but nothing is copied.
+ *
+ ****************************************************************************/
+
+int
+text_view_next_word(
+    struct  text_view_t         *   line_p,
+    struct  text_view_t         *   word_p
+    )
+{
+    /**
+     *  @param  word_found      TRUE when a word was found                  */
+    int                             word_found;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    word_found = false;
+
+    TEXT__simd( );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Skip over any leading spaces and tabs
+    while (    ( line_p->text_l > 0 )
+            && (    ( line_p->text_p[ 0 ] ==  ' ' )
+                 || ( line_p->text_p[ 0 ] == '\t' ) ) )
+    {
+        line_p->text_p += 1;
+        line_p->text_l -= 1;
+    }
+
+    //  Is there anything left ?
+    if ( line_p->text_l > 0 )
+    {
+        //  YES:    The word runs up to the next space or tab
+        word_p->text_p = line_p->text_p;
+        word_p->text_l = text_find_class_f( line_p->text_p, line_p->text_l,
+                                            &text_blank_class );
+
+        line_p->text_p += word_p->text_l;
+        line_p->text_l -= word_p->text_l;
+
+        word_found = true;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( word_found );
+}
+
+/****************************************************************************/
+/**
+ *  Compare a view with a string.
+ *
+ *  @param  view_p              Pointer to the view.
+ *  @param  text_p              Pointer to a NUL terminated string.
+ *
+ *  @return compare_rc          Less than, equal to or greater than zero
+ *                              the same as strcmp().
+ *
+ ****************************************************************************/
+
+int
+text_view_compare(
+    const struct text_view_t    *   view_p,
+    const char                  *   text_p
+    )
+{
+    /**
+     *  @param  compare_rc      Result of the compare                       */
+    int                             compare_rc;
+    /**
+     *  @param  text_l          Length of the string                        */
+    size_t                          text_l;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    text_l = strlen( text_p );
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Compare the characters both have
+    compare_rc = memcmp( view_p->text_p, text_p,
+                         ( view_p->text_l < text_l ) ? view_p->text_l
+                                                     : text_l );
+
+    //  Are they the same that far ?
+    if ( compare_rc == 0 )
+    {
+        //  YES:    The shorter one is less
+        compare_rc = ( view_p->text_l > text_l )
+                   - ( view_p->text_l < text_l );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( compare_rc );
+}
+
+/****************************************************************************/
+/**
+ *  Compare a view with a string without regard to case.
+ *
+ *  @param  view_p              Pointer to the view.
+ *  @param  text_p              Pointer to a NUL terminated string.
+ *
+ *  @return compare_rc          Less than, equal to or greater than zero
+ *                              the same as strcasecmp().
+ *
+ ****************************************************************************/
+
+int
+text_view_casecompare(
+    const struct text_view_t    *   view_p,
+    const char                  *   text_p
+    )
+{
+    /**
+     *  @param  compare_rc      Result of the compare                       */
+    int                             compare_rc;
+    /**
+     *  @param  ndx             Index into the view                         */
+    size_t                          ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    compare_rc = 0;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    for ( ndx = 0;
+          ( ndx < view_p->text_l ) && ( compare_rc == 0 );
+          ndx += 1 )
+    {
+        //  A NUL in text_p ends the string so the view is greater
+        compare_rc = tolower( (unsigned char)view_p->text_p[ ndx ] )
+                   - tolower( (unsigned char)text_p[ ndx ] );
+    }
+
+    //  Is the string longer than the view ?
+    if (    ( compare_rc == 0 )
+         && ( text_p[ ndx ] != '\0' ) )
+    {
+        //  YES:    The view is less
+        compare_rc = -1;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( compare_rc );
+}
+
+/****************************************************************************/
+/**
+ *  Convert a view to a number.
+ *
+ *  @param  view_p              Pointer to the view.
+ *  @param  value_p             Where the number goes.
+ *
+ *  @return number_rc           TRUE when the whole view is a number.
+ *                              FALSE and value_p is not changed when not.
+ *
+ *  @note
+ *      The same as text_to_long(), a number starting with '0x' is hex.
+ *      Otherwise it is decimal with an optional sign.
+ *
+ ****************************************************************************/
+
+int
+text_view_to_long(
+    const struct text_view_t    *   view_p,
+    long                        *   value_p
+    )
+{
+    /**
+     *  @param  number_rc       TRUE when the whole view is a number        */
+    int                             number_rc;
+    /**
+     *  @param  ndx             Index into the view                         */
+    size_t                          ndx;
+    /**
+     *  @param  base            Number base                                 */
+    int                             base;
+    /**
+     *  @param  negative        TRUE when there was a '-'                   */
+    int                             negative;
+    /**
+     *  @param  digit           Value of a digit or -1                      */
+    int                             digit;
+    /**
+     *  @param  value           The number                                  */
+    unsigned long                   value;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    ndx      = 0;
+    base     = 10;
+    negative = false;
+    value    = 0;
+
+    /************************************************************************
+     *  Find the base and the sign
+     ************************************************************************/
+
+    //  Does the view start with '0x' ?
+    if (    ( view_p->text_l > 2 )
+         && ( view_p->text_p[ 0 ] == '0' )
+         && ( toupper( (unsigned char)view_p->text_p[ 1 ] ) == 'X' ) )
+    {
+        //  YES:    It is a hex number
+        base = 16;
+        ndx  = 2;
+    }
+    //  Does it start with a sign ?
+    else if (    ( view_p->text_l > 1 )
+              && (    ( view_p->text_p[ 0 ] == '-' )
+                   || ( view_p->text_p[ 0 ] == '+' ) ) )
+    {
+        //  YES:    Remember it
+        negative = ( view_p->text_p[ 0 ] == '-' );
+        ndx      = 1;
+    }
+
+    //  Is there at least one digit ?
+    number_rc = ( ndx < view_p->text_l );
+
+    /************************************************************************
+     *  Convert the digits
+     ************************************************************************/
+
+    for ( ;
+          ( ndx < view_p->text_l ) && ( number_rc == true );
+          ndx += 1 )
+    {
+        digit = toupper( (unsigned char)view_p->text_p[ ndx ] );
+
+        //  What is it worth ?
+        if ( isdigit( digit ) != 0 )
+        {
+            digit -= '0';
+        }
+        else if ( ( base == 16 ) && ( isxdigit( digit ) != 0 ) )
+        {
+            digit -= ( 'A' - 10 );
+        }
+        else
+        {
+            //  Not a digit
+            number_rc = false;
+        }
+
+        value = ( value * base ) + digit;
+    }
+
+    //  Was it a number ?
+    if ( number_rc == true )
+    {
+        //  YES:    Pass it back
+        *value_p = ( negative == true ) ? -(long)value : (long)value;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( number_rc );
+}
+
+/****************************************************************************/
+/**
+ *  Copy a view to a new NUL terminated string.
+ *
+ *  @param  view_p              Pointer to the view.
+ *
+ *  @return copy_of_p           Pointer to the copy.  Release it with
+ *                              mem_free().
+ *
+ ****************************************************************************/
+
+char *
+text_view_copy(
+    const struct text_view_t    *   view_p
+    )
+{
+    /**
+     *  @param copy_of_p        Pointer to the copied data                  */
+    char                        *   copy_of_p;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  NOTE:   mem_malloc() zeros the buffer so it is NUL terminated.
+    copy_of_p = mem_malloc( view_p->text_l + 1 );
+
+    memcpy( copy_of_p, view_p->text_p, view_p->text_l );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( copy_of_p );
+}
+
+/****************************************************************************/
+/**
+ *  Get a quoted printable decoder ready for a new message.
+ *
+ *  @param  qp_p                Pointer to the decoder state.
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+text_qp_init(
+    struct  text_qp_t           *   qp_p
+    )
+{
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    qp_p->pending_l = 0;
+    qp_p->fractions = false;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Decode the next piece of a quoted printable message.
+ *
+ *  @param  qp_p                Pointer to the decoder state.
+ *  @param  in_p                Pointer to the next piece of the message.
+ *  @param  in_l                Number of characters in the piece.
+ *  @param  out_p               Pointer to where the decoded text is
+ *                              appended.
+ *
+ *  @return void
+ *
+ *  @note
+ *      '=XX' is replaced by the character it represents and the soft line
+ *      breaks '=' LF and '=' CR LF are removed.  An '=' that does not
+ *      start either one is left alone.  Nothing else is changed unless
+ *      qp_p->fractions was set after text_qp_init().
+ *  @note
+ *      The message may be split anywhere, even in the middle of an '=XX'.
+ *      Each character is looked at once and the text between escapes is
+ *      copied as a block.
+ *  @note
+ *      Call text_qp_finish() after the last piece.
+ *
+ ****************************************************************************/
+
+void
+text_qp_decode_stream(
+    struct  text_qp_t           *   qp_p,
+    const char                  *   in_p,
+    size_t                          in_l,
+    struct  mem_strbuf_t        *   out_p
+    )
+{
+    /**
+     *  @param  in_ndx          Offset of the next input character          */
+    size_t                          in_ndx;
+    /**
+     *  @param  equal_p         Pointer to the next '='                     */
+    const char                  *   equal_p;
+    /**
+     *  @param  run_l           Number of characters that need no decoding  */
+    size_t                          run_l;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    in_ndx = 0;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    while ( in_ndx < in_l )
+    {
+        //  Is an escape being decoded ?
+        if ( qp_p->pending_l > 0 )
+        {
+            //  YES:    Give it the next character
+            in_ndx += TEXT__qp_escape( qp_p, in_p[ in_ndx ], out_p );
+        }
+        else
+        {
+            //  NO:     Copy everything up to the next '='
+            equal_p = memchr( &in_p[ in_ndx ], '=', in_l - in_ndx );
+
+            if ( equal_p == NULL )
+            {
+                run_l = in_l - in_ndx;
+            }
+            else
+            {
+                run_l = equal_p - &in_p[ in_ndx ];
+            }
+
+            if ( run_l > 0 )
+            {
+                mem_strbuf_append( out_p, &in_p[ in_ndx ], run_l );
+                in_ndx += run_l;
+            }
+
+            //  Was an '=' found ?
+            if ( equal_p != NULL )
+            {
+                //  YES:    Start a new escape
+                qp_p->pending[ 0 ] = '=';
+                qp_p->pending_l = 1;
+                in_ndx += 1;
+            }
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Finish decoding a quoted printable message.
+ *
+ *  @param  qp_p                Pointer to the decoder state.
+ *  @param  out_p               Pointer to where the decoded text is
+ *                              appended.
+ *
+ *  @return void
+ *
+ *  @note
+ *      An escape that was not finished is copied as is.  The decoder is
+ *      ready for a new message.
+ *
+ ****************************************************************************/
+
+void
+text_qp_finish(
+    struct  text_qp_t           *   qp_p,
+    struct  mem_strbuf_t        *   out_p
+    )
+{
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is there an unfinished escape ?
+    if ( qp_p->pending_l > 0 )
+    {
+        //  YES:    Copy it as is
+        mem_strbuf_append( out_p, qp_p->pending, qp_p->pending_l );
+        qp_p->pending_l = 0;
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
@@ -28,6 +28,7 @@
                                 //*******************************************
 #include <ctype.h>              //  Determine the type contained
 #include <string.h>             //  Functions for managing strings
+#include <pthread.h>            //  Thread specific scratch arena
                                 //*******************************************
 
 /****************************************************************************
@@ -66,6 +67,42 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+/**
+ *  One time creation of the scratch arena key                              */
+pthread_once_t                      text_scratch_once = PTHREAD_ONCE_INIT;
+/**
+ *  Key used to release a thread's scratch arena at thread exit            */
+pthread_key_t                       text_scratch_key;
+/**
+ *  This thread's scratch arena                                             */
+__thread
+struct  mem_arena_t             *   text_scratch_p;
+//----------------------------------------------------------------------------
+/**
+ *  One time selection of the scanning kernels                              */
+pthread_once_t                      text_simd_once = PTHREAD_ONCE_INIT;
+//----------------------------------------------------------------------------
+/**
+ *  Value of a hexadecimal digit, -1 for anything else                     */
+const int8_t                        text_hex_value[ 256 ] =
+{
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'00'
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'10'
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'20'
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,   //  x'30'
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'40'
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'50'
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'60'
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'70'
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'80'
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'90'
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'A0'
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'B0'
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'C0'
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'D0'
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,   //  x'E0'
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1    //  x'F0'
+};
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -95,23 +132,15 @@ TEXT__skip_past_whitespace(
      *  Function Initialization
      ************************************************************************/
 
+    TEXT__simd( );
 
     /************************************************************************
      *  Locate the first non-whitespace character
      ************************************************************************/
 
-    //  Scan the whole text buffer.
-    for ( first_char_p = line_of_text_p;
-          first_char_p[ 0 ] != '\0';
-          first_char_p ++ )
-    {
-        //  Is this an alpha or numeric character ?
-        if ( isgraph( first_char_p[ 0 ] ) !=  0  )
-        {
-            //  YES:    We are done here so exit the loop.
-            break;
-        }
-    }
+    //  Scan for the first printable character or the end of the text.
+    first_char_p = &line_of_text_p[ text_find_class_str_f( line_of_text_p,
+                                                      &text_graph_class ) ];
 
     /************************************************************************
      *  Function Exit
@@ -138,26 +167,39 @@ TEXT__remove_crlf(
     char                        *   line_of_text_p
     )
 {
+    char                        *   first_p;
     char                        *   s_char_p;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
+    TEXT__simd( );
 
     /************************************************************************
      *  Delete any CR or LF characters at the trailing end of the line
      ************************************************************************/
 
-    s_char_p = strchr( line_of_text_p, '\r' );
-    if ( s_char_p != NULL )
-    {
-        s_char_p[ 0 ] = ' ';
-    }
-    s_char_p = strchr( line_of_text_p, '\n' );
-    if ( s_char_p != NULL )
+    //  Find the first CR or LF
+    first_p = &line_of_text_p[ text_find_class_str_f( line_of_text_p,
+                                                      &text_crlf_class ) ];
+
+    //  Was one found ?
+    if ( first_p[ 0 ] != '\0' )
     {
-        s_char_p[ 0 ] = ' ';
+        //  YES:    The first of the other one can only come after it
+        s_char_p = strchr( &first_p[ 1 ],
+                           ( first_p[ 0 ] == '\r' ) ? '\n' : '\r' );
+
+        //  Was it found ?
+        if ( s_char_p != NULL )
+        {
+            //  YES:    Get rid of it
+            s_char_p[ 0 ] = ' ';
+        }
+
+        //  Get rid of the first one
+        first_p[ 0 ] = ' ';
     }
 
     /************************************************************************
@@ -183,35 +225,23 @@ TEXT__strip_whitespace(
     char                        *   line_of_text_p
     )
 {
-    int                             ndx;
+    size_t                          text_l;
 
     /************************************************************************
      *  Function Initialization
      ************************************************************************/
 
+    TEXT__simd( );
+
+    text_l = strlen( line_of_text_p );
 
     /************************************************************************
      *  Strip off any trailing white space from a string.
      ************************************************************************/
 
-    for ( ndx = strlen( line_of_text_p );
-          ndx >= 0;
-          ndx -= 1 )
-    {
-        //  Is this a white space character
-        if (    ( line_of_text_p[ ndx ] == '\0' )
-             || ( line_of_text_p[ ndx ] ==  ' ' )
-             || ( line_of_text_p[ ndx ] == '\t' ) )
-        {
-            //  YES:    Get rid of it.
-            line_of_text_p[ ndx ] = '\0';
-        }
-        else
-        {
-            //  NO:     Get out of here.  Nothing else to do.
-            break;
-        }
-    }
+    //  Terminate the string in front of the trailing spaces and tabs
+    line_of_text_p[ text_l - text_rspan_class_f( line_of_text_p, text_l,
+                                                 &text_blank_class ) ] = '\0';
 
     /************************************************************************
      *  Function Exit
@@ -290,8 +320,7 @@ TEXT__is_blank_line(
  *
  *  @note
  *      When there is a two characters sequence where both characters are
- *      greater than or equal to 0x80 or is equal to 0x00 the data string
- *      is defined to be binary.
+ *      equal to 0x00 the data string is defined to be binary.
  *
  ****************************************************************************/
 
@@ -315,50 +344,213 @@ TEXT__is_binary(
     //   The assumption is that this is NOT binary
     text_rc = false;
 
+    TEXT__simd( );
+
     /************************************************************************
      *  How many printable characters in the data
      ************************************************************************/
 
-    //  Is the text buffer empty ?
-    if ( data_l > 0 )
+    //  Scan the text buffer for a x'00 that has another one after it.
+    for ( char_ndx = 0;
+          char_ndx < data_l - 1;
+          char_ndx += 1 )
     {
-        //  NO:     Scan the text buffer for binary data.
-        for ( char_ndx = 0;
-              char_ndx < data_l - 1;
-              char_ndx ++ )
+        //  Skip to the next x'00
+        char_ndx += text_find_class_f( &data_p[ char_ndx ],
+                                       data_l - 1 - char_ndx,
+                                       &text_nul_class );
+
+        //  Are the next two characters x'00 ?
+        if (    ( char_ndx            < data_l - 1 )
+             && ( data_p[ char_ndx + 1 ] == 0x00 ) )
         {
-#if 1
-            //  Are the next two characters >= 0x80 ?
-            if (    (    ( data_p[ char_ndx     ] == 0x00 )
-                      || ( data_p[ char_ndx     ] >= 0x80 ) )
-                 && (    ( data_p[ char_ndx + 1 ] == 0x00 )
-                      || ( data_p[ char_ndx + 1 ] >= 0x80 ) ) )
-            {
-                //  YES:    Then this is a binary data string
-                text_rc = true;
+            //  YES:    Then this is a binary data string
+            text_rc = true;
+            //  We can stop looking
+            break;
+        }
+    }
 
-                //  We can stop looking
-                break;
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( text_rc );
+}
+
+/****************************************************************************/
+/**
+ *  Create the key used to release scratch arenas at thread exit.
+ *
+ *  @param  void
+ *
+ *  @return void
+ *
+ ****************************************************************************/
+
+void
+TEXT__scratch_init(
+    void
+    )
+{
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Scratch arenas are released when their thread exits
+    pthread_key_create( &text_scratch_key,
+                        (void (*)( void * ))mem_arena_free );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Get this thread's scratch arena for the temporary buffers of a single
+ *  text function call.  The caller resets it before returning.
+ *
+ *  @param  void
+ *
+ *  @return arena_p             Pointer to the scratch arena.
+ *
+ *  @note
+ *      Scratch buffers must not live past the call that allocated them.
+ *
+ ****************************************************************************/
+
+struct  mem_arena_t *
+TEXT__scratch(
+    void
+    )
+{
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Does this thread have a scratch arena yet ?
+    if ( text_scratch_p == NULL )
+    {
+        //  NO:     Create one
+        pthread_once( &text_scratch_once, TEXT__scratch_init );
+        text_scratch_p = mem_arena_new( 0 );
+        pthread_setspecific( text_scratch_key, text_scratch_p );
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( text_scratch_p );
+}
+
+/****************************************************************************/
+/**
+ *  Add the failure links to a text replacer's trie.
+ *
+ *  @param  replacer_p          Pointer to a replacer holding the trie of
+ *                              search strings.  Missing transitions are -1.
+ *
+ *  @return void
+ *
+ *  @note
+ *      The states are visited breadth first so a state's failure link is
+ *      always complete before it is used.  Each missing transition is
+ *      replaced with the failure link's transition, and each state takes
+ *      the match of its failure link when it does not end a pattern.
+ *
+ ****************************************************************************/
+
+void
+TEXT__replacer_link(
+    struct  text_replacer_t     *   replacer_p
+    )
+{
+    /**
+     *  @param  queue_p         Breadth first list of states                */
+    int32_t                     *   queue_p;
+    /**
+     *  @param  head            Next state to take off the queue            */
+    int                             head;
+    /**
+     *  @param  tail            Number of states put on the queue           */
+    int                             tail;
+    /**
+     *  @param  state           The state being linked                      */
+    int32_t                         state;
+    /**
+     *  @param  next            The state after state for a class           */
+    int32_t                         next;
+    /**
+     *  @param  class           Character class                             */
+    int                             class;
+    /**
+     *  @param  row_p           Transitions of state                        */
+    int32_t                     *   row_p;
+    /**
+     *  @param  fail_row_p      Transitions of the failure link of state    */
+    int32_t                     *   fail_row_p;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    queue_p = mem_malloc( replacer_p->state_n * sizeof( int32_t ) );
+
+    //  The root fails to itself
+    queue_p[ 0 ] = 0;
+    replacer_p->fail_p[ 0 ] = 0;
+    head = 0;
+    tail = 1;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    while ( head < tail )
+    {
+        state      = queue_p[ head++ ];
+        row_p      = &replacer_p->delta_p[ state * replacer_p->class_n ];
+        fail_row_p = &replacer_p->delta_p[ replacer_p->fail_p[ state ]
+                                           * replacer_p->class_n ];
+
+        for ( class = 0;
+              class < replacer_p->class_n;
+              class += 1 )
+        {
+            next = row_p[ class ];
+
+            //  Is there a transition for this class ?
+            if ( next < 0 )
+            {
+                //  NO:     Use the one from the failure link
+                row_p[ class ] = ( state == 0 ) ? 0 : fail_row_p[ class ];
             }
-#else
-            //  Is this character NOT a printable character ?
-            if (    ( isprint( data_p[ char_ndx ] ) == 0 )
-                 && ( isblank( data_p[ char_ndx ] ) == 0 ) )
+            else
             {
-                //  NO:     Is it x'00 ?
-                if( data_p[ char_ndx ] == 0x00 )
-                {
-                    //  YES:    Then it's binary
-                    text_rc = true;
+                //  YES:    Its failure link is where the failure link of
+                //          this state goes for the same class.
+                replacer_p->fail_p[ next ] =
+                        ( state == 0 ) ? 0 : fail_row_p[ class ];
 
-                    //  We can stop looking
-                    break;
+                //  Does it end a pattern ?
+                if ( replacer_p->match_p[ next ] < 0 )
+                {
+                    //  NO:     The longest pattern ending there is the one
+                    //          ending at the failure link.
+                    replacer_p->match_p[ next ] =
+                            replacer_p->match_p[ replacer_p->fail_p[ next ] ];
                 }
 
-                //  Not binary and not printable, make it a space.
-                data_p[ char_ndx ] = ' ';
+                queue_p[ tail++ ] = next;
             }
-#endif
         }
     }
 
@@ -366,7 +558,888 @@ TEXT__is_binary(
      *  Function Exit
      ************************************************************************/
 
+    mem_free( queue_p );
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Test a single character against a character class.
+ *
+ *  @param  class_p             Pointer to the character class.
+ *  @param  test_char           The character to test.
+ *
+ *  @return in_class            TRUE when the character is in the class.
+ *
+ ****************************************************************************/
+
+int
+TEXT__in_class(
+    const struct text_class_t   *   class_p,
+    unsigned char                   test_char
+    )
+{
+    /**
+     *  @param  in_class        TRUE when the character is in the class    */
+    int                             in_class;
+    /**
+     *  @param  ndx             Index into the class set                    */
+    int                             ndx;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    in_class = false;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is the character in the range ?
+    if (    ( class_p->range == true )
+         && ( (unsigned char)( test_char - class_p->low ) <= class_p->span ) )
+    {
+        //  YES:    It is in the class
+        in_class = true;
+    }
+    else
+    {
+        //  NO:     Is it one of the set ?
+        for ( ndx = 0;
+              ndx < class_p->set_l;
+              ndx += 1 )
+        {
+            if ( test_char == class_p->set[ ndx ] )
+            {
+                //  YES:    It is in the class
+                in_class = true;
+                break;
+            }
+        }
+    }
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( in_class );
+}
+
+/****************************************************************************/
+/**
+ *  Scalar kernels.  Used where there is no SSE2.
+ *
+ *  @param  text_p              Pointer to the text.
+ *  @param  text_l              Number of characters of text.
+ *  @param  class_p             Pointer to the character class.
+ *
+ *  @return ndx                 TEXT__find_class_*:  Offset of the first
+ *                              character in the class or text_l.
+ *                              TEXT__find_class_str_*:  Offset of the first
+ *                              character in the class or of the NUL.
+ *                              TEXT__rspan_class_*:  Number of characters
+ *                              in the class at the end of the text.
+ *
+ ****************************************************************************/
+
+size_t
+TEXT__find_class_scalar(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    )
+{
+    /**
+     *  @param  ndx             Index into the text                         */
+    size_t                          ndx;
+
+    for ( ndx = 0;
+          ndx < text_l;
+          ndx += 1 )
+    {
+        if ( TEXT__in_class( class_p, text_p[ ndx ] ) == true )
+        {
+            break;
+        }
+    }
+
+    //  DONE!
+    return( ndx );
+}
+
+//----------------------------------------------------------------------------
+
+size_t
+TEXT__find_class_str_scalar(
+    const char                  *   text_p,
+    const struct text_class_t   *   class_p
+    )
+{
+    /**
+     *  @param  ndx             Index into the text                         */
+    size_t                          ndx;
+
+    for ( ndx = 0;
+          text_p[ ndx ] != '\0';
+          ndx += 1 )
+    {
+        if ( TEXT__in_class( class_p, text_p[ ndx ] ) == true )
+        {
+            break;
+        }
+    }
+
+    //  DONE!
+    return( ndx );
+}
+
+//----------------------------------------------------------------------------
+
+size_t
+TEXT__rspan_class_scalar(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    )
+{
+    /**
+     *  @param  span_l          Characters in the class at the end          */
+    size_t                          span_l;
+
+    for ( span_l = 0;
+          span_l < text_l;
+          span_l += 1 )
+    {
+        if ( TEXT__in_class( class_p,
+                             text_p[ text_l - span_l - 1 ] ) == false )
+        {
+            break;
+        }
+    }
+
+    //  DONE!
+    return( span_l );
+}
+
+/****************************************************************************/
+/**
+ *  Flip the case of every character from 'low' through 'high'.
+ *
+ *  @param  text_p              Pointer to the text.
+ *  @param  text_l              Number of characters of text.
+ *  @param  low                 First character to change.
+ *  @param  high                Last character to change.
+ *
+ *  @return void
+ *
+ *  @note
+ *      Only meant for 'a' - 'z' and 'A' - 'Z', the case is flipped by
+ *      toggling the x'20 bit.
+ *
+ ****************************************************************************/
+
+void
+TEXT__case_map_scalar(
+    char                        *   text_p,
+    size_t                          text_l,
+    unsigned char                   low,
+    unsigned char                   high
+    )
+{
+    /**
+     *  @param  ndx             Index into the text                         */
+    size_t                          ndx;
+
+    for ( ndx = 0;
+          ndx < text_l;
+          ndx += 1 )
+    {
+        if ( (unsigned char)( text_p[ ndx ] - low )
+                                    <= (unsigned char)( high - low ) )
+        {
+            text_p[ ndx ] ^= 0x20;
+        }
+    }
+
     //  DONE!
-    return( text_rc );
 }
+
+#if TEXT_SIMD
+/****************************************************************************/
+/**
+ *  SSE2 kernels.  16 characters at a time.  Only called when cpuid says
+ *  the processor has SSE2, which a 32-bit build can't assume.
+ *
+ *  @note
+ *      TEXT__find_class_str_sse2() reads whole aligned blocks, which may
+ *      be past the NUL but never cross into the next page.
+ *
+ ****************************************************************************/
+
+__attribute__(( target( "sse2" ) ))
+__m128i
+TEXT__class_mask_sse2(
+    __m128i                         data,
+    const struct text_class_t   *   class_p
+    )
+{
+    /**
+     *  @param  mask            0xFF for each character in the class        */
+    __m128i                         mask;
+    /**
+     *  @param  offset          Each character less the range low           */
+    __m128i                         offset;
+    /**
+     *  @param  ndx             Index into the class set                    */
+    int                             ndx;
+
+    mask = _mm_setzero_si128( );
+
+    //  Is there a range ?
+    if ( class_p->range == true )
+    {
+        //  YES:    offset <= span  when  min( offset, span ) == offset
+        offset = _mm_sub_epi8( data, _mm_set1_epi8( class_p->low ) );
+        mask   = _mm_cmpeq_epi8(
+                    _mm_min_epu8( offset, _mm_set1_epi8( class_p->span ) ),
+                    offset );
+    }
+
+    //  Add the set
+    for ( ndx = 0;
+          ndx < class_p->set_l;
+          ndx += 1 )
+    {
+        mask = _mm_or_si128( mask,
+                    _mm_cmpeq_epi8( data,
+                                    _mm_set1_epi8( class_p->set[ ndx ] ) ) );
+    }
+
+    //  DONE!
+    return( mask );
+}
+
+//----------------------------------------------------------------------------
+
+__attribute__(( target( "sse2" ) ))
+size_t
+TEXT__find_class_sse2(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    )
+{
+    /**
+     *  @param  ndx             Index into the text                         */
+    size_t                          ndx;
+    /**
+     *  @param  bits            One bit for each character in the class     */
+    unsigned int                    bits;
+
+    for ( ndx = 0;
+          ( ndx + 16 ) <= text_l;
+          ndx += 16 )
+    {
+        bits = _mm_movemask_epi8( TEXT__class_mask_sse2(
+                    _mm_loadu_si128( (const __m128i*)&text_p[ ndx ] ),
+                    class_p ) );
+
+        if ( bits != 0 )
+        {
+            return( ndx + __builtin_ctz( bits ) );
+        }
+    }
+
+    //  DONE!
+    return( ndx + TEXT__find_class_scalar( &text_p[ ndx ], text_l - ndx,
+                                           class_p ) );
+}
+
+//----------------------------------------------------------------------------
+
+//  Aligned loads never cross a page, so reading past the NUL can't fault.
+__attribute__(( target( "sse2" ), no_sanitize_address ))
+size_t
+TEXT__find_class_str_sse2(
+    const char                  *   text_p,
+    const struct text_class_t   *   class_p
+    )
+{
+    /**
+     *  @param  block_p         Aligned block holding the text              */
+    const char                  *   block_p;
+    /**
+     *  @param  data            Characters of the block                     */
+    __m128i                         data;
+    /**
+     *  @param  bits            One bit for each character in the class     */
+    unsigned int                    bits;
+
+    //  Start with the aligned block holding the first character
+    block_p = (const char*)( (uintptr_t)text_p & ~(uintptr_t)15 );
+
+    data = _mm_load_si128( (const __m128i*)block_p );
+    bits = _mm_movemask_epi8( _mm_or_si128(
+                TEXT__class_mask_sse2( data, class_p ),
+                _mm_cmpeq_epi8( data, _mm_setzero_si128( ) ) ) );
+
+    //  Ignore what comes before the text
+    bits >>= ( text_p - block_p );
+
+    while ( bits == 0 )
+    {
+        block_p += 16;
+
+        data = _mm_load_si128( (const __m128i*)block_p );
+        bits = _mm_movemask_epi8( _mm_or_si128(
+                    TEXT__class_mask_sse2( data, class_p ),
+                    _mm_cmpeq_epi8( data, _mm_setzero_si128( ) ) ) );
+
+        if ( bits != 0 )
+        {
+            return( ( block_p - text_p ) + __builtin_ctz( bits ) );
+        }
+    }
+
+    //  DONE!
+    return( __builtin_ctz( bits ) );
+}
+
+//----------------------------------------------------------------------------
+
+__attribute__(( target( "sse2" ) ))
+size_t
+TEXT__rspan_class_sse2(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    )
+{
+    /**
+     *  @param  span_l          Characters in the class at the end          */
+    size_t                          span_l;
+    /**
+     *  @param  bits            One bit for each character not in the class */
+    unsigned int                    bits;
+
+    for ( span_l = 0;
+          ( span_l + 16 ) <= text_l;
+          span_l += 16 )
+    {
+        bits = ~_mm_movemask_epi8( TEXT__class_mask_sse2(
+                    _mm_loadu_si128(
+                        (const __m128i*)&text_p[ text_l - span_l - 16 ] ),
+                    class_p ) ) & 0xFFFF;
+
+        if ( bits != 0 )
+        {
+            return( span_l + __builtin_clz( bits ) - 16 );
+        }
+    }
+
+    //  DONE!
+    return( span_l + TEXT__rspan_class_scalar( text_p, text_l - span_l,
+                                               class_p ) );
+}
+
+//----------------------------------------------------------------------------
+
+__attribute__(( target( "sse2" ) ))
+void
+TEXT__case_map_sse2(
+    char                        *   text_p,
+    size_t                          text_l,
+    unsigned char                   low,
+    unsigned char                   high
+    )
+{
+    /**
+     *  @param  ndx             Index into the text                         */
+    size_t                          ndx;
+    /**
+     *  @param  data            Characters of the text                      */
+    __m128i                         data;
+    /**
+     *  @param  offset          Each character less low                     */
+    __m128i                         offset;
+    /**
+     *  @param  flip            x'20 for each character to change           */
+    __m128i                         flip;
+
+    for ( ndx = 0;
+          ( ndx + 16 ) <= text_l;
+          ndx += 16 )
+    {
+        data   = _mm_loadu_si128( (const __m128i*)&text_p[ ndx ] );
+        offset = _mm_sub_epi8( data, _mm_set1_epi8( low ) );
+        flip   = _mm_and_si128(
+                    _mm_cmpeq_epi8( _mm_min_epu8( offset,
+                                        _mm_set1_epi8( high - low ) ),
+                                    offset ),
+                    _mm_set1_epi8( 0x20 ) );
+        _mm_storeu_si128( (__m128i*)&text_p[ ndx ],
+                          _mm_xor_si128( data, flip ) );
+    }
+
+    //  DONE!
+    TEXT__case_map_scalar( &text_p[ ndx ], text_l - ndx, low, high );
+}
+
+/****************************************************************************/
+/**
+ *  AVX2 kernels.  32 characters at a time.  Only called when cpuid says
+ *  the processor has AVX2.
+ *
+ ****************************************************************************/
+
+__attribute__(( target( "avx2" ) ))
+__m256i
+TEXT__class_mask_avx2(
+    __m256i                         data,
+    const struct text_class_t   *   class_p
+    )
+{
+    /**
+     *  @param  mask            0xFF for each character in the class        */
+    __m256i                         mask;
+    /**
+     *  @param  offset          Each character less the range low           */
+    __m256i                         offset;
+    /**
+     *  @param  ndx             Index into the class set                    */
+    int                             ndx;
+
+    mask = _mm256_setzero_si256( );
+
+    //  Is there a range ?
+    if ( class_p->range == true )
+    {
+        //  YES:    offset <= span  when  min( offset, span ) == offset
+        offset = _mm256_sub_epi8( data, _mm256_set1_epi8( class_p->low ) );
+        mask   = _mm256_cmpeq_epi8(
+                    _mm256_min_epu8( offset,
+                                     _mm256_set1_epi8( class_p->span ) ),
+                    offset );
+    }
+
+    //  Add the set
+    for ( ndx = 0;
+          ndx < class_p->set_l;
+          ndx += 1 )
+    {
+        mask = _mm256_or_si256( mask,
+                    _mm256_cmpeq_epi8( data,
+                                _mm256_set1_epi8( class_p->set[ ndx ] ) ) );
+    }
+
+    //  DONE!
+    return( mask );
+}
+
+//----------------------------------------------------------------------------
+
+__attribute__(( target( "avx2" ) ))
+size_t
+TEXT__find_class_avx2(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    )
+{
+    /**
+     *  @param  ndx             Index into the text                         */
+    size_t                          ndx;
+    /**
+     *  @param  bits            One bit for each character in the class     */
+    unsigned int                    bits;
+
+    for ( ndx = 0;
+          ( ndx + 32 ) <= text_l;
+          ndx += 32 )
+    {
+        bits = _mm256_movemask_epi8( TEXT__class_mask_avx2(
+                    _mm256_loadu_si256( (const __m256i*)&text_p[ ndx ] ),
+                    class_p ) );
+
+        if ( bits != 0 )
+        {
+            return( ndx + __builtin_ctz( bits ) );
+        }
+    }
+
+    //  DONE!
+    return( ndx + TEXT__find_class_sse2( &text_p[ ndx ], text_l - ndx,
+                                         class_p ) );
+}
+
+//----------------------------------------------------------------------------
+
+//  Aligned loads never cross a page, so reading past the NUL can't fault.
+__attribute__(( target( "avx2" ), no_sanitize_address ))
+size_t
+TEXT__find_class_str_avx2(
+    const char                  *   text_p,
+    const struct text_class_t   *   class_p
+    )
+{
+    /**
+     *  @param  block_p         Aligned block holding the text              */
+    const char                  *   block_p;
+    /**
+     *  @param  data            Characters of the block                     */
+    __m256i                         data;
+    /**
+     *  @param  bits            One bit for each character in the class     */
+    unsigned int                    bits;
+
+    //  Start with the aligned block holding the first character
+    block_p = (const char*)( (uintptr_t)text_p & ~(uintptr_t)31 );
+
+    data = _mm256_load_si256( (const __m256i*)block_p );
+    bits = _mm256_movemask_epi8( _mm256_or_si256(
+                TEXT__class_mask_avx2( data, class_p ),
+                _mm256_cmpeq_epi8( data, _mm256_setzero_si256( ) ) ) );
+
+    //  Ignore what comes before the text
+    bits >>= ( text_p - block_p );
+
+    while ( bits == 0 )
+    {
+        block_p += 32;
+
+        data = _mm256_load_si256( (const __m256i*)block_p );
+        bits = _mm256_movemask_epi8( _mm256_or_si256(
+                    TEXT__class_mask_avx2( data, class_p ),
+                    _mm256_cmpeq_epi8( data, _mm256_setzero_si256( ) ) ) );
+
+        if ( bits != 0 )
+        {
+            return( ( block_p - text_p ) + __builtin_ctz( bits ) );
+        }
+    }
+
+    //  DONE!
+    return( __builtin_ctz( bits ) );
+}
+
+//----------------------------------------------------------------------------
+
+__attribute__(( target( "avx2" ) ))
+size_t
+TEXT__rspan_class_avx2(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    )
+{
+    /**
+     *  @param  span_l          Characters in the class at the end          */
+    size_t                          span_l;
+    /**
+     *  @param  bits            One bit for each character not in the class */
+    unsigned int                    bits;
+
+    for ( span_l = 0;
+          ( span_l + 32 ) <= text_l;
+          span_l += 32 )
+    {
+        bits = ~(unsigned int)_mm256_movemask_epi8( TEXT__class_mask_avx2(
+                    _mm256_loadu_si256(
+                        (const __m256i*)&text_p[ text_l - span_l - 32 ] ),
+                    class_p ) );
+
+        if ( bits != 0 )
+        {
+            return( span_l + __builtin_clz( bits ) );
+        }
+    }
+
+    //  DONE!
+    return( span_l + TEXT__rspan_class_sse2( text_p, text_l - span_l,
+                                             class_p ) );
+}
+
+//----------------------------------------------------------------------------
+
+__attribute__(( target( "avx2" ) ))
+void
+TEXT__case_map_avx2(
+    char                        *   text_p,
+    size_t                          text_l,
+    unsigned char                   low,
+    unsigned char                   high
+    )
+{
+    /**
+     *  @param  ndx             Index into the text                         */
+    size_t                          ndx;
+    /**
+     *  @param  data            Characters of the text                      */
+    __m256i                         data;
+    /**
+     *  @param  offset          Each character less low                     */
+    __m256i                         offset;
+    /**
+     *  @param  flip            x'20 for each character to change           */
+    __m256i                         flip;
+
+    for ( ndx = 0;
+          ( ndx + 32 ) <= text_l;
+          ndx += 32 )
+    {
+        data   = _mm256_loadu_si256( (const __m256i*)&text_p[ ndx ] );
+        offset = _mm256_sub_epi8( data, _mm256_set1_epi8( low ) );
+        flip   = _mm256_and_si256(
+                    _mm256_cmpeq_epi8( _mm256_min_epu8( offset,
+                                        _mm256_set1_epi8( high - low ) ),
+                                       offset ),
+                    _mm256_set1_epi8( 0x20 ) );
+        _mm256_storeu_si256( (__m256i*)&text_p[ ndx ],
+                             _mm256_xor_si256( data, flip ) );
+    }
+
+    //  DONE!
+    TEXT__case_map_sse2( &text_p[ ndx ], text_l - ndx, low, high );
+}
+#endif
+
+/****************************************************************************/
+/**
+ *  Carry a quoted printable escape one character further.
+ *
+ *  @param  qp_p                Pointer to the decoder state.  It holds the
+ *                              '=' (and maybe the character after it).
+ *  @param  next_char           The next character of the input.
+ *  @param  out_p               Pointer to the decoded output.
+ *
+ *  @return used_l              1 when next_char was used, 0 when it is not
+ *                              part of the escape and must be looked at
+ *                              again.
+ *
+ *  @note
+ *      '=XX' is decoded, '=' LF and '=' CR LF are soft line breaks and are
+ *      dropped.  Anything else is not an escape and is copied as is.
+ *  @note
+ *      When qp_p->fractions is set x'BC, x'BD and x'BE are written out as
+ *      1/4, 1/2 and 3/4.
+ *
+ ****************************************************************************/
+
+size_t
+TEXT__qp_escape(
+    struct  text_qp_t           *   qp_p,
+    char                            next_char,
+    struct  mem_strbuf_t        *   out_p
+    )
+{
+    /**
+     *  @param  used_l          1 when next_char was used                   */
+    size_t                          used_l;
+    /**
+     *  @param  xlate_char      The translated character                    */
+    unsigned char                   xlate_char;
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    used_l = 1;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    //  Is this the character right after the '=' ?
+    if ( qp_p->pending_l == 1 )
+    {
+        //  YES:    Is it the first hex digit or a CR ?
+        if (    ( text_hex_value[ (unsigned char)next_char ] >= 0 )
+             || ( next_char == '\r' ) )
+        {
+            //  YES:    Hold onto it
+            qp_p->pending[ 1 ] = next_char;
+            qp_p->pending_l = 2;
+            return( used_l );
+        }
+        //  Is it a soft line break ?
+        else if ( next_char != '\n' )
+        {
+            //  NO:     The '=' is just an '='
+            mem_strbuf_append( out_p, qp_p->pending, 1 );
+            used_l = 0;
+        }
+    }
+    //  Is this a soft line break ?
+    else if ( qp_p->pending[ 1 ] == '\r' )
+    {
+        //  MAYBE:  Only when it is CR LF
+        if ( next_char != '\n' )
+        {
+            //  NO:     Copy them as they are
+            mem_strbuf_append( out_p, qp_p->pending, 2 );
+            used_l = 0;
+        }
+    }
+    //  Is this the second hex digit ?
+    else if ( text_hex_value[ (unsigned char)next_char ] >= 0 )
+    {
+        //  YES:    Convert the two digits to a single character
+        xlate_char = (   text_hex_value[ (unsigned char)qp_p->pending[ 1 ] ]
+                       << 4 )
+                   | text_hex_value[ (unsigned char)next_char ];
+
+        //  Are fractions written out ?
+        if ( qp_p->fractions == false )
+        {
+            //  NO:     Keep the character as it is
+            mem_strbuf_append( out_p, (char*)&xlate_char, 1 );
+        }
+        else
+        {
+            //  YES:    Is it one of them ?
+            switch( xlate_char )
+            {
+                case    0xBC:
+                {
+                    mem_strbuf_append( out_p, "1/4", 3 );
+                }   break;
+                case    0xBD:
+                {
+                    mem_strbuf_append( out_p, "1/2", 3 );
+                }   break;
+                case    0xBE:
+                {
+                    mem_strbuf_append( out_p, "3/4", 3 );
+                }   break;
+                default:
+                {
+                    mem_strbuf_append( out_p, (char*)&xlate_char, 1 );
+                }
+            }
+        }
+    }
+    else
+    {
+        //  NO:     Copy them as they are
+        mem_strbuf_append( out_p, qp_p->pending, 2 );
+        used_l = 0;
+    }
+
+    //  The escape is finished
+    qp_p->pending_l = 0;
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+    return( used_l );
+}
+
+/****************************************************************************/
+/**
+ *  Pick the fastest kernels this processor can run.  Called once.
+ *
+ *  @param  void
+ *
+ *  @return void
+ *
+ *  @note
+ *      GCC's __builtin_cpu_supports() reads cpuid, and for AVX2 also
+ *      checks that the operating system saves the YMM registers.
+ *
+ ****************************************************************************/
+
+void
+TEXT__simd_init(
+    void
+    )
+{
+
+    /************************************************************************
+     *  Function Initialization
+     ************************************************************************/
+
+    //  The character classes used by the TEXT__* functions
+    text_class_init( &text_graph_class, NULL,  0x21, 0x7E );
+    text_class_init( &text_crlf_class,  "\r\n", 1,    0 );
+    text_class_init( &text_blank_class, " \t",  1,    0 );
+    text_class_init( &text_nul_class,   NULL,  0x00, 0x00 );
+
+    //  Start with the scalar kernels
+    text_find_class_f       = TEXT__find_class_scalar;
+    text_find_class_str_f   = TEXT__find_class_str_scalar;
+    text_rspan_class_f      = TEXT__rspan_class_scalar;
+    text_case_map_f         = TEXT__case_map_scalar;
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+#if TEXT_SIMD
+    __builtin_cpu_init( );
+
+    //  Does the processor have SSE2 ?
+    if ( __builtin_cpu_supports( "sse2" ) )
+    {
+        //  YES:    Use it
+        text_find_class_f       = TEXT__find_class_sse2;
+        text_find_class_str_f   = TEXT__find_class_str_sse2;
+        text_rspan_class_f      = TEXT__rspan_class_sse2;
+        text_case_map_f         = TEXT__case_map_sse2;
+    }
+
+    //  Does the processor have AVX2 ?
+    if ( __builtin_cpu_supports( "avx2" ) )
+    {
+        //  YES:    Use it
+        text_find_class_f       = TEXT__find_class_avx2;
+        text_find_class_str_f   = TEXT__find_class_str_avx2;
+        text_rspan_class_f      = TEXT__rspan_class_avx2;
+        text_case_map_f         = TEXT__case_map_avx2;
+    }
+#endif
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
+/****************************************************************************/
+/**
+ *  Make sure the kernels for this processor have been picked.
+ *
+ *  @param  void
+ *
+ *  @return void
+ *
+ *  @note
+ *      Call this before using any of the text_*_f kernel pointers.
+ *
+ ****************************************************************************/
+
+void
+TEXT__simd(
+    void
+    )
+{
+
+    /************************************************************************
+     *  Function
+     ************************************************************************/
+
+    pthread_once( &text_simd_once, TEXT__simd_init );
+
+    /************************************************************************
+     *  Function Exit
+     ************************************************************************/
+
+    //  DONE!
+}
+
 /****************************************************************************/
@@ -31,6 +31,9 @@
  ****************************************************************************/
 
                                 //*******************************************
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <immintrin.h>          //  SSE2 and AVX2 intrinsics
+#endif
                                 //*******************************************
 
 /****************************************************************************
@@ -45,6 +48,13 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+/**
+ *  The SSE2 and AVX2 kernels are only built for x86 processors.           */
+#if defined( __x86_64__ ) || defined( __i386__ )
+   #define TEXT_SIMD            ( 1 )
+#else
+   #define TEXT_SIMD            ( 0 )
+#endif
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -59,6 +69,52 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+/**
+ *  @param  text_replacer_t     An Aho-Corasick automaton built from the
+ *                              search strings of a set of text_pair_t.
+ *                              The failure links are folded into delta so
+ *                              every character is a single table lookup.  */
+struct  text_replacer_t
+{
+    /**
+     *  @param  flags           TEXT_REPLACER_xxx flags                     */
+    int                             flags;
+    /**
+     *  @param  class_map       Character class of every character.  Class
+     *                          zero is every character not in a pattern.   */
+    unsigned char                   class_map[ 256 ];
+    /**
+     *  @param  class_n         Number of character classes                 */
+    int                             class_n;
+    /**
+     *  @param  state_n         Number of states.  State zero is the root.  */
+    int                             state_n;
+    /**
+     *  @param  delta_p         Next state for [ state * class_n + class ]  */
+    int32_t                     *   delta_p;
+    /**
+     *  @param  depth_p         Length of the text each state represents    */
+    int32_t                     *   depth_p;
+    /**
+     *  @param  fail_p          Longest proper suffix that is also a state  */
+    int32_t                     *   fail_p;
+    /**
+     *  @param  match_p         Pair of the longest pattern that ends in
+     *                              each state, or -1                       */
+    int32_t                     *   match_p;
+    /**
+     *  @param  pairs_n         Number of search and replace pairs          */
+    int                             pairs_n;
+    /**
+     *  @param  find_l_p        Length of each search string                */
+    int                         *   find_l_p;
+    /**
+     *  @param  replace_pp      Copy of each replacement string             */
+    char                        **  replace_pp;
+    /**
+     *  @param  replace_l_p     Length of each replacement string           */
+    int                         *   replace_l_p;
+};
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -66,6 +122,41 @@
  ****************************************************************************/
 
 //----------------------------------------------------------------------------
+/**
+ *  The scanning kernels picked for this processor by TEXT__simd_init()    */
+TEXT_EXT
+size_t                          ( * text_find_class_f )(
+                                        const char *, size_t,
+                                        const struct text_class_t * );
+TEXT_EXT
+size_t                          ( * text_find_class_str_f )(
+                                        const char *,
+                                        const struct text_class_t * );
+TEXT_EXT
+size_t                          ( * text_rspan_class_f )(
+                                        const char *, size_t,
+                                        const struct text_class_t * );
+TEXT_EXT
+void                            ( * text_case_map_f )(
+                                        char *, size_t,
+                                        unsigned char, unsigned char );
+//----------------------------------------------------------------------------
+/**
+ *  Printable characters other than a space                                 */
+TEXT_EXT
+struct  text_class_t                text_graph_class;
+/**
+ *  Carriage return and line feed                                           */
+TEXT_EXT
+struct  text_class_t                text_crlf_class;
+/**
+ *  Space and tab                                                           */
+TEXT_EXT
+struct  text_class_t                text_blank_class;
+/**
+ *  x'00                                                                    */
+TEXT_EXT
+struct  text_class_t                text_nul_class;
 //----------------------------------------------------------------------------
 
 /****************************************************************************
@@ -99,6 +190,147 @@ TEXT__is_binary(
     int                         data_l
     );
 //----------------------------------------------------------------------------
+void
+TEXT__scratch_init(
+    void
+    );
+//----------------------------------------------------------------------------
+struct  mem_arena_t *
+TEXT__scratch(
+    void
+    );
+//----------------------------------------------------------------------------
+int
+TEXT__in_class(
+    const struct text_class_t   *   class_p,
+    unsigned char                   test_char
+    );
+//----------------------------------------------------------------------------
+size_t
+TEXT__find_class_scalar(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    );
+//----------------------------------------------------------------------------
+size_t
+TEXT__find_class_str_scalar(
+    const char                  *   text_p,
+    const struct text_class_t   *   class_p
+    );
+//----------------------------------------------------------------------------
+size_t
+TEXT__rspan_class_scalar(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    );
+//----------------------------------------------------------------------------
+void
+TEXT__case_map_scalar(
+    char                        *   text_p,
+    size_t                          text_l,
+    unsigned char                   low,
+    unsigned char                   high
+    );
+#if TEXT_SIMD
+//----------------------------------------------------------------------------
+__m128i
+TEXT__class_mask_sse2(
+    __m128i                         data,
+    const struct text_class_t   *   class_p
+    );
+//----------------------------------------------------------------------------
+size_t
+TEXT__find_class_sse2(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    );
+//----------------------------------------------------------------------------
+size_t
+TEXT__find_class_str_sse2(
+    const char                  *   text_p,
+    const struct text_class_t   *   class_p
+    );
+//----------------------------------------------------------------------------
+size_t
+TEXT__rspan_class_sse2(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    );
+//----------------------------------------------------------------------------
+void
+TEXT__case_map_sse2(
+    char                        *   text_p,
+    size_t                          text_l,
+    unsigned char                   low,
+    unsigned char                   high
+    );
+//----------------------------------------------------------------------------
+__attribute__(( target( "avx2" ) ))
+__m256i
+TEXT__class_mask_avx2(
+    __m256i                         data,
+    const struct text_class_t   *   class_p
+    );
+//----------------------------------------------------------------------------
+__attribute__(( target( "avx2" ) ))
+size_t
+TEXT__find_class_avx2(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    );
+//----------------------------------------------------------------------------
+__attribute__(( target( "avx2" ) ))
+size_t
+TEXT__find_class_str_avx2(
+    const char                  *   text_p,
+    const struct text_class_t   *   class_p
+    );
+//----------------------------------------------------------------------------
+__attribute__(( target( "avx2" ) ))
+size_t
+TEXT__rspan_class_avx2(
+    const char                  *   text_p,
+    size_t                          text_l,
+    const struct text_class_t   *   class_p
+    );
+//----------------------------------------------------------------------------
+__attribute__(( target( "avx2" ) ))
+void
+TEXT__case_map_avx2(
+    char                        *   text_p,
+    size_t                          text_l,
+    unsigned char                   low,
+    unsigned char                   high
+    );
+#endif
+//----------------------------------------------------------------------------
+void
+TEXT__replacer_link(
+    struct  text_replacer_t     *   replacer_p
+    );
+//----------------------------------------------------------------------------
+size_t
+TEXT__qp_escape(
+    struct  text_qp_t           *   qp_p,
+    char                            next_char,
+    struct  mem_strbuf_t        *   out_p
+    );
+//----------------------------------------------------------------------------
+void
+TEXT__simd_init(
+    void
+    );
+//----------------------------------------------------------------------------
+void
+TEXT__simd(
+    void
+    );
+//----------------------------------------------------------------------------
 
 /****************************************************************************/
 